@@ -1607,8 +1607,8 @@ bool is_permutation_aux(ForwardIter1 first1, ForwardIter1 last1,
     && orange_stl::is_random_access_iterator<ForwardIter2>::value;
   if (is_ra_it)
   {
-    auto len1 = last1 - first1;
-    auto len2 = last2 - first2;
+    auto len1 = orange_stl::distance(first1, last1);
+    auto len2 = orange_stl::distance(first2, last2);
     if (len1 != len2)
       return false;
   }
@@ -2414,7 +2414,9 @@ void unchecked_insertion_sort(RandomIter first, RandomIter last)
 {
   for (auto i = first; i != last; ++i)
   {
-    orange_stl::unchecked_linear_insert(i, *i);
+    // value 须是副本，unchecked_linear_insert 会覆盖 *i
+    auto value = *i;
+    orange_stl::unchecked_linear_insert(i, value);
   }
 }
 
@@ -2528,7 +2530,8 @@ void unchecked_insertion_sort(RandomIter first, RandomIter last,
 {
   for (auto i = first; i != last; ++i)
   {
-    orange_stl::unchecked_linear_insert(i, *i, comp);
+    auto value = *i;
+    orange_stl::unchecked_linear_insert(i, value, comp);
   }
 }
 
@@ -4,6 +4,11 @@
 #include <new>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#include "orange_construct.h"
+#include "orange_util.h"
 
 namespace orange_stl
 {
@@ -33,74 +38,158 @@ namespace orange_stl
     enum { ESmallObjectBytes = 4096 };
 
     //FreeList的个数
-    /*  区间        间隔    个数 
-        0-128       8       16  
+    /*  区间        间隔    个数
+        0-128       8       16
         128-256     16      8
         265-512     32      8
         512-1024    64      8
         1024-2048   128     8
         2048-4096   256     8
 
-        加起来总共有56个链表     
+        加起来总共有56个链表
      */
     enum { EFreeListsNumber = 56 };
 
+    //线程缓存与中心仓库之间一次批量转移的区块个数：约为 EBatchBytes 字节，介于 EBatchMin 与 EBatchMax 之间
+    enum
+    {
+        EBatchBytes = 8192,
+        EBatchMin = 4,
+        EBatchMax = 64
+    };
+
     //空间配置类alloc
     //当内存较大的时候(>4096)，直接调用std::malloc与std::free
-    //当内存较小的时候，以内存池管理，每次配置一块大的内存，并维护对应的自由链表
+    //当内存较小的时候，以两级内存池管理：
+    //  1. 每个线程持有一份线程缓存(alloc_thread_cache)，分配与回收都只操作本线程的自由链表，不需要加锁
+    //  2. 所有线程共享一个中心仓库(alloc_central)，由互斥锁保护，每次配置一块大的内存并切分成区块
+    //  线程缓存为空时从中心仓库批量取回区块，缓存过多时批量归还，线程退出时归还全部区块
+    //alloc 是线程安全的；一个线程配置的区块可以在另一个线程中释放
     class alloc
     {
-    private:
-        static char* start_free;    //内存池起始位置
-        static char* end_free;      //内存池结束位置
-        static size_t heap_size;     //申请heap空间附加值的大小
-
-        static FreeList* free_list[EFreeListsNumber];    //自由链表
+        friend class alloc_central;
+        friend struct alloc_thread_cache;
 
     private:
         static size_t O_align(size_t bytes);
         static size_t O_round_up(size_t bytes);
         static size_t O_freelist_index(size_t bytes);
-        static void* O_refill(size_t n);
-        static char* O_chunk_alloc(size_t size, size_t &nblock);
+        static size_t O_index_bytes(size_t index);
+        static size_t O_batch_count(size_t bytes);
+        static void* O_refill(size_t index, size_t bytes);
+        static void  O_release(size_t index, size_t bytes);
     public:
         static void* allocate(size_t n);
         static void  deallocate(void *p, size_t n);
         static void* reallocate(void *p, size_t old_size, size_t new_size);
     };
 
-    //静态成员变量的初始化
-    char*  alloc::start_free = nullptr;
-    char*  alloc::end_free = nullptr;
-    size_t alloc::heap_size = 0;
-
-    FreeList* alloc::free_list[EFreeListsNumber] = {
-    nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-    nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-    nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-    nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-    nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-    nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-    nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr
+    //中心仓库：管理内存池与所有线程共享的自由链表
+    class alloc_central
+    {
+    private:
+        std::mutex mutex_;
+        char*  start_free_;     //内存池起始位置
+        char*  end_free_;       //内存池结束位置
+        size_t heap_size_;      //申请heap空间附加值的大小
+
+        FreeList* free_list_[EFreeListsNumber];    //自由链表
+
+    public:
+        //中心仓库在第一次使用时创建且从不析构，保证其他静态对象析构时仍可归还内存
+        static alloc_central& instance()
+        {
+            static alloc_central* central = new alloc_central();
+            return *central;
+        }
+
+        size_t fetch(size_t index, size_t bytes, size_t nblock, FreeList*& head);
+        void   release(size_t index, FreeList* head, FreeList* tail);
+
+    private:
+        alloc_central() : start_free_(nullptr), end_free_(nullptr), heap_size_(0)
+        {
+            for (size_t i = 0; i < EFreeListsNumber; ++i)
+                free_list_[i] = nullptr;
+        }
+
+        char* O_chunk_alloc(size_t size, size_t &nblock);
+        void  O_push(size_t index, char* p);
+    };
+
+    //线程缓存：每个线程一份，只由所属线程访问
+    //缓存本身是平凡类型(零初始化，无析构)，线程退出时由 alloc_thread_reaper 把区块归还中心仓库，
+    //之后再次访问的请求(例如其他 thread_local 对象的析构)直接走中心仓库
+    struct alloc_thread_cache
+    {
+        FreeList* free_list[EFreeListsNumber];   //本线程的自由链表
+        size_t    count[EFreeListsNumber];       //各链表中的区块个数
+        bool      registered;                    //是否已登记线程退出时的归还动作
+        bool      retired;                       //线程已退出，缓存不再可用
+
+        static alloc_thread_cache& instance()
+        {
+            static thread_local alloc_thread_cache cache;
+            return cache;
+        }
+
+        void enroll();
+        void flush();
+    };
+
+    //线程退出时析构，把本线程缓存的区块全部归还中心仓库
+    struct alloc_thread_reaper
+    {
+        ~alloc_thread_reaper()
+        {
+            alloc_thread_cache& cache = alloc_thread_cache::instance();
+            cache.flush();
+            cache.retired = true;
+        }
     };
 
+    inline void alloc_thread_cache::enroll()
+    {
+        static thread_local alloc_thread_reaper reaper;
+        (void)reaper;
+        registered = true;
+    }
+
+    inline void alloc_thread_cache::flush()
+    {
+        alloc_central& central = alloc_central::instance();
+        for (size_t i = 0; i < EFreeListsNumber; ++i)
+        {
+            FreeList* head = free_list[i];
+            if (!head)
+                continue;
+            FreeList* tail = head;
+            while (tail->next)
+                tail = tail->next;
+            central.release(i, head, tail);
+            free_list[i] = nullptr;
+            count[i] = 0;
+        }
+    }
+
     //分配大小为n的空间，n>0
     inline void* alloc::allocate(size_t n)
     {
-        FreeList* my_free_list;
-        FreeList* result;
-
-        if(n>static_cast<int>(ESmallObjectBytes))
-            return std::malloc(n);
-        
-        my_free_list = free_list[O_freelist_index(n)];
-        result = my_free_list;
-        if(!result) //自由链表的该内存块位置为空
+        if(n>static_cast<size_t>(ESmallObjectBytes))
         {
-            void* res=O_refill(O_round_up(n));
-            return res;
+            void* p = std::malloc(n);
+            if(!p)
+                throw std::bad_alloc();
+            return p;
         }
-        my_free_list=result->next;
+
+        const size_t index = O_freelist_index(n);
+        alloc_thread_cache& cache = alloc_thread_cache::instance();
+        FreeList* result = cache.free_list[index];
+        if(!result) //线程缓存中该大小的区块为空，从中心仓库批量取回
+            return O_refill(index, O_round_up(n));
+        cache.free_list[index] = result->next;
+        --cache.count[index];
         return result;
     }
 
@@ -112,11 +201,22 @@ namespace orange_stl
             std::free(p);
             return;
         }
+
+        const size_t index = O_freelist_index(n);
+        alloc_thread_cache& cache = alloc_thread_cache::instance();
         FreeList *q=reinterpret_cast<FreeList*>(p);
-        FreeList *my_free_list;
-        my_free_list=free_list[O_freelist_index(n)];
-        q->next=my_free_list;
-        my_free_list=q;
+        if(cache.retired)
+        {
+            alloc_central::instance().release(index, q, q);
+            return;
+        }
+        if(!cache.registered)
+            cache.enroll();
+        q->next=cache.free_list[index];
+        cache.free_list[index]=q;
+        //缓存的区块超过两个批次时，归还一个批次给中心仓库，避免单个线程囤积内存
+        if(++cache.count[index] > 2*O_batch_count(O_index_bytes(index)))
+            O_release(index, O_index_bytes(index));
     }
     //重新分配空间，接受三个参数，参数1位指向新空间的指针，参数2为原来空间的大小，参数3为申请空间的大小
     inline void* alloc::reallocate(void *p, size_t old_size, size_t new_size)
@@ -126,7 +226,7 @@ namespace orange_stl
         return p;
     }
     //上调bytes的大小
-    size_t alloc::O_align(size_t bytes)
+    inline size_t alloc::O_align(size_t bytes)
     {
         if (bytes <= 512)
         {
@@ -139,83 +239,148 @@ namespace orange_stl
             : EAlign4096;
     }
     //将byte上调至对应区间的大小
-    size_t alloc::O_round_up(size_t bytes)
+    inline size_t alloc::O_round_up(size_t bytes)
     {
         return ((bytes+O_align(bytes)-1)&~(O_align(bytes)-1));
     }
     //根据区块的大小，选择第n个free lists
-    size_t alloc::O_freelist_index(size_t bytes)
+    inline size_t alloc::O_freelist_index(size_t bytes)
     {
         if (bytes <= 512)
         {
             return bytes <= 256
-            ? bytes <= 128 
-                ? ((bytes + EAlign128 - 1) / EAlign128 - 1) 
+            ? bytes <= 128
+                ? ((bytes + EAlign128 - 1) / EAlign128 - 1)
                 : (15 + (bytes + EAlign256 - 129) / EAlign256)
             : (23 + (bytes + EAlign512 - 257) / EAlign512);
         }
         return bytes <= 2048
-            ? bytes <= 1024 
+            ? bytes <= 1024
             ? (31 + (bytes + EAlign1024 - 513) / EAlign1024)
             : (39 + (bytes + EAlign2048 - 1025) / EAlign2048)
             : (47 + (bytes + EAlign4096 - 2049) / EAlign4096);
     }
-    //重新填充freelist,单个对象的大小为n
-    void* alloc::O_refill(size_t n)
+    //O_freelist_index 的逆运算：第index个free list中区块的大小
+    inline size_t alloc::O_index_bytes(size_t index)
+    {
+        if (index < 16) return (index + 1) * EAlign128;
+        if (index < 24) return 128 + (index - 15) * EAlign256;
+        if (index < 32) return 256 + (index - 23) * EAlign512;
+        if (index < 40) return 512 + (index - 31) * EAlign1024;
+        if (index < 48) return 1024 + (index - 39) * EAlign2048;
+        return 2048 + (index - 47) * EAlign4096;
+    }
+    //大小为bytes的区块一次批量转移的个数
+    inline size_t alloc::O_batch_count(size_t bytes)
+    {
+        const size_t n = EBatchBytes / bytes;
+        const size_t lo = static_cast<size_t>(EBatchMin);
+        const size_t hi = static_cast<size_t>(EBatchMax);
+        return n < lo ? lo : (n > hi ? hi : n);
+    }
+    //重新填充线程缓存的第index个free list，单个对象的大小为bytes，返回其中一个区块
+    inline void* alloc::O_refill(size_t index, size_t bytes)
+    {
+        alloc_thread_cache& cache = alloc_thread_cache::instance();
+        FreeList* head = nullptr;
+        if(cache.retired)
+        {
+            alloc_central::instance().fetch(index, bytes, 1, head);
+            return head;
+        }
+        if(!cache.registered)
+            cache.enroll();
+
+        const size_t nblock = alloc_central::instance().fetch(index, bytes, O_batch_count(bytes), head);
+        //第一个区块返回给调用者，其余纳入线程缓存
+        cache.free_list[index] = head->next;
+        cache.count[index] = nblock - 1;
+        return head;
+    }
+    //把线程缓存第index个free list中的一个批次归还中心仓库
+    inline void alloc::O_release(size_t index, size_t bytes)
+    {
+        alloc_thread_cache& cache = alloc_thread_cache::instance();
+        const size_t nblock = O_batch_count(bytes);
+        FreeList* head = cache.free_list[index];
+        FreeList* tail = head;
+        for (size_t i = 1; i < nblock; ++i)
+            tail = tail->next;
+        cache.free_list[index] = tail->next;
+        cache.count[index] -= nblock;
+        alloc_central::instance().release(index, head, tail);
+    }
+
+    //从中心仓库取出至多nblock个大小为bytes的区块，以链表形式由head返回，返回实际取得的个数(至少为1)
+    inline size_t alloc_central::fetch(size_t index, size_t bytes, size_t nblock, FreeList*& head)
     {
-        //缺省取得10个新节点（新区块），若内存池空间不足，可能取得数量少于10
-        size_t nblock=10;
-        char *c=O_chunk_alloc(n, nblock);
-
-        FreeList* my_free_list;
-        FreeList* result, *cur, *next;
-        //如果只有一个内存块，就把这个内存块返回给调用者，freelist没有增加新的节点
-        if(nblock==1)
-            return c;
-        //否则把一个区块给调用者，剩下的纳入free list作为新的节点
-        my_free_list=free_list[O_freelist_index(n)];
-        result=(FreeList*)c;
-        //使freelist指向新配置的空间
-        my_free_list=next=(FreeList*)(c+n);
-
-        //以下将freelist的各个节点串接起来，从1开始，第0个返回给客户端
+        std::lock_guard<std::mutex> lock(mutex_);
+        //优先使用其他线程归还的区块
+        if(free_list_[index])
+        {
+            head = free_list_[index];
+            FreeList* tail = head;
+            size_t n = 1;
+            for (; n < nblock && tail->next; ++n)
+                tail = tail->next;
+            free_list_[index] = tail->next;
+            tail->next = nullptr;
+            return n;
+        }
+
+        //否则从内存池中切分，若内存池空间不足，可能取得数量少于nblock
+        char *c=O_chunk_alloc(bytes, nblock);
+        FreeList *cur, *next;
+        head=next=reinterpret_cast<FreeList*>(c);
+        //以下将取得的区块串接起来
         for(size_t i=1; ;++i)
         {
             cur=next;
-            next=(FreeList*)((char*)next+n);
-            if(i==nblock-1)
+            next=reinterpret_cast<FreeList*>(reinterpret_cast<char*>(next)+bytes);
+            if(i==nblock)
             {
                 cur->next=nullptr;
                 break;
             }
-            else
-            {
-                cur->next=next;
-            }
+            cur->next=next;
         }
-        return result;
+        return nblock;
     }
-    //从内存池中取空间给free list，条件不允许时，会调整nblock
-    char* alloc::O_chunk_alloc(size_t size, size_t &nblock)
+    //把[head, tail]这一串区块归还到第index个free list
+    inline void alloc_central::release(size_t index, FreeList* head, FreeList* tail)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tail->next=free_list_[index];
+        free_list_[index]=head;
+    }
+    //把p指向的区块放入第index个free list，调用者须持有锁
+    inline void alloc_central::O_push(size_t index, char* p)
+    {
+        FreeList* q=reinterpret_cast<FreeList*>(p);
+        q->next=free_list_[index];
+        free_list_[index]=q;
+    }
+    //从内存池中取空间给free list，条件不允许时，会调整nblock，调用者须持有锁
+    inline char* alloc_central::O_chunk_alloc(size_t size, size_t &nblock)
     {
         char *result;
         size_t need_bytes = size*nblock;
-        size_t pool_bytes = end_free - start_free;
+        size_t pool_bytes = end_free_ - start_free_;
 
         //如果内存池大小完全满足需求量，返回该值
         if(pool_bytes >= need_bytes)
         {
-            result=start_free;
-            start_free += need_bytes;
+            result=start_free_;
+            start_free_ += need_bytes;
             return result;
         }
         // 如果内存池剩余大小不能完全满足需求量，但是可以分配至少一个或者一个以上的内存块，就返回它
-        else if(pool_bytes > size)
+        else if(pool_bytes >= size)
         {
             nblock = pool_bytes / size;
             need_bytes = size * nblock;
-            result=start_free;
-            start_free += need_bytes;
+            result=start_free_;
+            start_free_ += need_bytes;
             return result;
         }
         //如果内存池的剩余大小连一个区块都无法满足
@@ -223,39 +388,120 @@ namespace orange_stl
         {
             if(pool_bytes > 0)
             {
-                //若内存池还有剩余，就先把剩余的空间加入到free list中
-                FreeList *my_free_list = free_list[O_freelist_index(pool_bytes)];
-                ((FreeList*)start_free)->next=my_free_list;
-                my_free_list=(FreeList*)start_free;
+                //若内存池还有剩余，就先把剩余的空间加入到不超过其大小的最大区块的free list中
+                size_t index = alloc::O_freelist_index(pool_bytes);
+                if(alloc::O_index_bytes(index) > pool_bytes)
+                    --index;
+                O_push(index, start_free_);
             }
             //申请堆栈空间
-            size_t bytes_to_get=(need_bytes<<1)+O_round_up(heap_size>>4);
-            start_free = (char*)std::malloc(bytes_to_get);
-            if(!start_free)
+            size_t bytes_to_get=(need_bytes<<1)+alloc::O_round_up(heap_size_>>4);
+            start_free_ = static_cast<char*>(std::malloc(bytes_to_get));
+            if(!start_free_)
             {
-                //堆空间不够用
-                FreeList *my_free_list, *p;
-                //试着查找有无未用的区块，且足够大的free list   
-                for(size_t i=size; i<ESmallObjectBytes; i+=O_align(i))
+                //堆空间不够用，试着查找有无未用的区块，且足够大的free list
+                for(size_t i=alloc::O_freelist_index(size); i<EFreeListsNumber; ++i)
                 {
-                    my_free_list=free_list[O_freelist_index(i)];
-                    p=my_free_list;
+                    FreeList* p=free_list_[i];
                     if(p)
                     {
-                        my_free_list=p->next;
-                        start_free=(char*)p;
-                        end_free=start_free+i;
+                        free_list_[i]=p->next;
+                        start_free_=reinterpret_cast<char*>(p);
+                        end_free_=start_free_+alloc::O_index_bytes(i);
                         return O_chunk_alloc(size, nblock);
                     }
                 }
                 std::printf("out of memory!!!");
-                end_free=nullptr;
+                end_free_=nullptr;
                 throw std::bad_alloc();
             }
-            end_free=start_free+bytes_to_get;
-            heap_size += bytes_to_get;
+            end_free_=start_free_+bytes_to_get;
+            heap_size_ += bytes_to_get;
             return O_chunk_alloc(size, nblock);
         }
     }
+
+    //模板类：pool_allocator
+    //以 alloc 为底层的空间配置器，接口与 allocator 相同，适合 list、rb_tree、hashtable 等频繁配置单个节点的容器：
+    //  orange_stl::map<int, int, orange_stl::less<int>, orange_stl::pool_allocator<orange_stl::pair<const int, int>>>
+    //alloc 的区块只保证 8 字节对齐，对齐要求更高的类型直接使用 ::operator new
+    template <class T>
+    class pool_allocator
+    {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef T&          reference;
+        typedef const T&    const_reference;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef pool_allocator<U> other;
+        };
+
+    private:
+        static constexpr bool use_pool = alignof(T) <= static_cast<size_t>(EAlign128);
+
+    public:
+        static T* allocate()
+        {
+            return allocate(1);
+        }
+        static T* allocate(size_type n)
+        {
+            if(n==0)
+                return nullptr;
+            if(!use_pool)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            return static_cast<T*>(alloc::allocate(n * sizeof(T)));
+        }
+
+        static void deallocate(T* ptr)
+        {
+            deallocate(ptr, 1);
+        }
+        static void deallocate(T* ptr, size_type n)
+        {
+            if(ptr==nullptr)
+                return;
+            if(!use_pool)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+            alloc::deallocate(ptr, n * sizeof(T));
+        }
+
+        static void construct(T* ptr)
+        {
+            orange_stl::construct(ptr);
+        }
+        static void construct(T* ptr, const T& value)
+        {
+            orange_stl::construct(ptr, value);
+        }
+        static void construct(T* ptr, T&& value)
+        {
+            orange_stl::construct(ptr, orange_stl::move(value));
+        }
+        template <class... Args>
+        static void construct(T* ptr, Args&& ...args)
+        {
+            orange_stl::construct(ptr, orange_stl::forward<Args>(args)...);
+        }
+
+        static void destroy(T* ptr)
+        {
+            orange_stl::destroy(ptr);
+        }
+        static void destroy(T* first, T* last)
+        {
+            orange_stl::destroy(first, last);
+        }
+    };
 }
-#endif // !__ORANGE_ALLOC_H__
\ No newline at end of file
+#endif // !__ORANGE_ALLOC_H__
@@ -9,6 +9,10 @@ namespace orange_stl
 
 //模板类：allocator
 //模板函数代表数据类型
+//orange_stl 的容器以模板参数 Alloc 接收空间配置器，自定义配置器需要满足与 allocator 相同的要求：
+//  1. 提供 value_type、pointer、size_type 等型别定义
+//  2. 以静态成员函数的形式提供 allocate / deallocate / construct / destroy，容器不保存配置器对象
+//  3. 提供 rebind<U>::other，容器借此得到节点类型(如 rb_tree_node、hashtable_node)的配置器
 template <class T>
 class allocator
 {
@@ -20,6 +24,13 @@ public:
     typedef const T&    const_reference;
     typedef size_t      size_type;
     typedef ptrdiff_t   difference_type;
+
+    //将配置器重新绑定到另一种类型上
+    template <class U>
+    struct rebind
+    {
+        typedef allocator<U> other;
+    };
 public:
     static T* allocate();
     static T* allocate(size_type n);
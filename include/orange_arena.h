@@ -0,0 +1,267 @@
+#ifndef __ORANGE_ARENA_H__
+#define __ORANGE_ARENA_H__
+
+// 这个头文件包含单调内存区 monotonic_arena 以及以它为底层的空间配置器 arena_allocator
+// 适用于“构建 -> 查询 -> 整体丢弃”的容器：节点以指针递增的方式配置，单个节点的释放不做任何事，
+// 用完之后调用一次 reset 即可整体归还
+
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+
+#include "orange_construct.h"
+#include "orange_util.h"
+
+namespace orange_stl
+{
+
+// 第一个内存块的缺省大小与内存块大小的上限
+enum { EArenaInitChunkBytes = 4096, EArenaMaxChunkBytes = 1 << 20 };
+
+// 类：monotonic_arena
+// 以链表串接若干内存块，在当前内存块上移动指针完成配置，空间不足时申请一块新的(大小倍增，直到上限)
+// deallocate 不做任何事，reset 一次性收回全部空间，之后 arena 可以重复使用
+// 不可复制，也不是线程安全的：一个 arena 同一时刻只应被一个线程使用
+class monotonic_arena
+{
+private:
+    // 每个内存块头部的管理信息，之后紧跟可用空间
+    struct chunk_header
+    {
+        chunk_header* next;   // 上一个申请的内存块
+        size_t        size;   // 可用空间的大小
+    };
+
+    chunk_header* head_;          // 最近申请的内存块
+    char*         cur_;           // 当前内存块中下一次配置的位置
+    char*         end_;           // 当前内存块的结束位置
+    size_t        next_size_;     // 下一个内存块的大小
+    size_t        used_;          // 已配置出去的字节数
+
+public:
+    explicit monotonic_arena(size_t init_bytes = EArenaInitChunkBytes)
+        :head_(nullptr), cur_(nullptr), end_(nullptr),
+         next_size_(init_bytes == 0 ? static_cast<size_t>(EArenaInitChunkBytes) : init_bytes),
+         used_(0)
+    {
+    }
+
+    monotonic_arena(const monotonic_arena&) = delete;
+    monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+    ~monotonic_arena()
+    {
+        release();
+    }
+
+public:
+    // 配置 bytes 字节、以 align 对齐的空间，align 须为 2 的幂
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t))
+    {
+        char* p = align_up(cur_, align);
+        // 先检查对齐填充本身是否已经越过当前内存块，否则 end_ - p 为负数
+        if (cur_ == nullptr || p > end_ || bytes > static_cast<size_t>(end_ - p))
+        {
+            new_chunk(bytes + align);
+            p = align_up(cur_, align);
+        }
+        cur_ = p + bytes;
+        used_ += bytes;
+        return p;
+    }
+
+    // 单个对象的释放不做任何事，空间在 reset 或析构时整体收回
+    void deallocate(void* /*p*/, size_t /*bytes*/) noexcept
+    {
+    }
+
+    // 收回全部空间：只保留最近(也是最大)的内存块，其余归还系统
+    void reset() noexcept
+    {
+        if (head_ == nullptr)
+            return;
+        free_chunks(head_->next);
+        head_->next = nullptr;
+        cur_ = reinterpret_cast<char*>(head_ + 1);
+        end_ = cur_ + head_->size;
+        used_ = 0;
+    }
+
+    // 收回全部空间并把所有内存块归还系统
+    void release() noexcept
+    {
+        free_chunks(head_);
+        head_ = nullptr;
+        cur_ = end_ = nullptr;
+        used_ = 0;
+    }
+
+    // 已配置出去的字节数
+    size_t bytes_used() const noexcept { return used_; }
+
+private:
+    static char* align_up(char* p, size_t align)
+    {
+        const size_t addr = reinterpret_cast<size_t>(p);
+        return p + ((align - addr % align) % align);
+    }
+
+    static void free_chunks(chunk_header* c) noexcept
+    {
+        while (c)
+        {
+            chunk_header* next = c->next;
+            std::free(c);
+            c = next;
+        }
+    }
+
+    // 申请一块至少能容纳 need 字节的新内存块
+    void new_chunk(size_t need)
+    {
+        size_t size = next_size_;
+        while (size < need)
+            size <<= 1;
+        chunk_header* c = static_cast<chunk_header*>(std::malloc(sizeof(chunk_header) + size));
+        if (c == nullptr)
+            throw std::bad_alloc();
+        c->next = head_;
+        c->size = size;
+        head_ = c;
+        cur_ = reinterpret_cast<char*>(c + 1);
+        end_ = cur_ + size;
+        if (next_size_ < static_cast<size_t>(EArenaMaxChunkBytes))
+            next_size_ <<= 1;
+    }
+};
+
+// 缺省的 arena 标签
+struct default_arena_tag {};
+
+// 类：arena_binding
+// orange_stl 的配置器是无状态的，容器不保存配置器对象，因此 arena_allocator 通过标签 Tag 找到所用的 arena：
+// 每个线程、每个 Tag 对应一个 arena，缺省是线程自己持有的 arena，也可以通过 arena_scope 临时换成调用者的 arena
+template <class Tag>
+struct arena_binding
+{
+    static monotonic_arena*& current() noexcept
+    {
+        static thread_local monotonic_arena* cur = nullptr;
+        return cur;
+    }
+
+    static monotonic_arena& arena()
+    {
+        monotonic_arena*& cur = current();
+        if (cur == nullptr)
+        {
+            static thread_local monotonic_arena owned;
+            cur = &owned;
+        }
+        return *cur;
+    }
+};
+
+// 类：arena_scope
+// 在作用域内把标签 Tag 的 arena 换成 a，离开作用域时恢复
+template <class Tag = default_arena_tag>
+class arena_scope
+{
+private:
+    monotonic_arena* prev_;
+
+public:
+    explicit arena_scope(monotonic_arena& a) noexcept
+        :prev_(arena_binding<Tag>::current())
+    {
+        arena_binding<Tag>::current() = &a;
+    }
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+
+    ~arena_scope()
+    {
+        arena_binding<Tag>::current() = prev_;
+    }
+};
+
+// 模板类：arena_allocator
+// 从标签 Tag 当前绑定的 arena 中配置空间，接口与 allocator 相同，rebind 时保留 Tag：
+//   orange_stl::monotonic_arena a;
+//   {
+//       orange_stl::arena_scope<> scope(a);
+//       orange_stl::map<int, int, orange_stl::less<int>,
+//                       orange_stl::arena_allocator<orange_stl::pair<const int, int>>> m;
+//       ...
+//   }
+//   a.reset();
+// 容器必须在 arena 被 reset 或析构之前销毁，且销毁时须处于同一个绑定之下
+template <class T, class Tag = default_arena_tag>
+class arena_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef arena_allocator<U, Tag> other;
+    };
+
+public:
+    static T* allocate()
+    {
+        return allocate(1);
+    }
+    static T* allocate(size_type n)
+    {
+        if (n == 0)
+            return nullptr;
+        return static_cast<T*>(arena_binding<Tag>::arena().allocate(n * sizeof(T), alignof(T)));
+    }
+
+    static void deallocate(T* /*ptr*/)
+    {
+    }
+    static void deallocate(T* /*ptr*/, size_type /*n*/)
+    {
+    }
+
+    static void construct(T* ptr)
+    {
+        orange_stl::construct(ptr);
+    }
+    static void construct(T* ptr, const T& value)
+    {
+        orange_stl::construct(ptr, value);
+    }
+    static void construct(T* ptr, T&& value)
+    {
+        orange_stl::construct(ptr, orange_stl::move(value));
+    }
+    template <class... Args>
+    static void construct(T* ptr, Args&& ...args)
+    {
+        orange_stl::construct(ptr, orange_stl::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr)
+    {
+        orange_stl::destroy(ptr);
+    }
+    static void destroy(T* first, T* last)
+    {
+        orange_stl::destroy(first, last);
+    }
+};
+
+}
+
+#endif // !__ORANGE_ARENA_H__
@@ -0,0 +1,1612 @@
+#ifndef __ORANGE_BASIC_STRING_H__
+#define __ORANGE_BASIC_STRING_H__
+
+// 这个头文件包含模板类 char_traits 与 basic_string
+// basic_string 采用短字符串优化(SSO)：长度不超过内部缓冲区容量的字符串直接存放在对象内部，不配置堆空间
+// 对 char / wchar_t 的查找与比较交给 memchr / memcmp / wmemchr / wmemcmp
+
+#include <initializer_list>
+#include <iostream>
+#include <cctype>
+#include <cstring>
+#include <cwchar>
+
+#include "orange_iterator.h"
+#include "orange_memory.h"
+#include "orange_functional.h"
+#include "orange_exceptdef.h"
+
+namespace orange_stl
+{
+
+// 模板类 char_traits，提供字符串操作所需的基本字符操作
+template <class CharType>
+struct char_traits
+{
+    typedef CharType char_type;
+
+    static size_t length(const char_type* str)
+    {
+        size_t len = 0;
+        for (; *str != char_type(0); ++str)
+            ++len;
+        return len;
+    }
+
+    static int compare(const char_type* s1, const char_type* s2, size_t n)
+    {
+        for (; n != 0; --n, ++s1, ++s2)
+        {
+            if (*s1 < *s2)
+                return -1;
+            if (*s2 < *s1)
+                return 1;
+        }
+        return 0;
+    }
+
+    static const char_type* find(const char_type* s, size_t n, const char_type& ch)
+    {
+        for (; n != 0; --n, ++s)
+        {
+            if (*s == ch)
+                return s;
+        }
+        return nullptr;
+    }
+
+    static char_type* copy(char_type* dst, const char_type* src, size_t n)
+    {
+        ORANGE_STL_DEBUG(src + n <= dst || dst + n <= src);
+        char_type* r = dst;
+        for (; n != 0; --n, ++dst, ++src)
+            *dst = *src;
+        return r;
+    }
+
+    static char_type* move(char_type* dst, const char_type* src, size_t n)
+    {
+        char_type* r = dst;
+        if (dst < src)
+        {
+            for (; n != 0; --n, ++dst, ++src)
+                *dst = *src;
+        }
+        else if (src < dst)
+        {
+            dst += n;
+            src += n;
+            for (; n != 0; --n)
+                *--dst = *--src;
+        }
+        return r;
+    }
+
+    static char_type* fill(char_type* dst, char_type ch, size_t count)
+    {
+        char_type* r = dst;
+        for (; count > 0; --count, ++dst)
+            *dst = ch;
+        return r;
+    }
+};
+
+// Partialized. char_traits<char>
+template <>
+struct char_traits<char>
+{
+    typedef char char_type;
+
+    static size_t length(const char_type* str) noexcept
+    {
+        return std::strlen(str);
+    }
+
+    static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
+    {
+        return n == 0 ? 0 : std::memcmp(s1, s2, n);
+    }
+
+    static const char_type* find(const char_type* s, size_t n, const char_type& ch) noexcept
+    {
+        return n == 0 ? nullptr : static_cast<const char_type*>(std::memchr(s, ch, n));
+    }
+
+    static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
+    {
+        ORANGE_STL_DEBUG(src + n <= dst || dst + n <= src);
+        return n == 0 ? dst : static_cast<char_type*>(std::memcpy(dst, src, n));
+    }
+
+    static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
+    {
+        return n == 0 ? dst : static_cast<char_type*>(std::memmove(dst, src, n));
+    }
+
+    static char_type* fill(char_type* dst, char_type ch, size_t count) noexcept
+    {
+        return count == 0 ? dst : static_cast<char_type*>(std::memset(dst, ch, count));
+    }
+};
+
+// Partialized. char_traits<wchar_t>
+template <>
+struct char_traits<wchar_t>
+{
+    typedef wchar_t char_type;
+
+    static size_t length(const char_type* str) noexcept
+    {
+        return std::wcslen(str);
+    }
+
+    static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
+    {
+        return n == 0 ? 0 : std::wmemcmp(s1, s2, n);
+    }
+
+    static const char_type* find(const char_type* s, size_t n, const char_type& ch) noexcept
+    {
+        return n == 0 ? nullptr : std::wmemchr(s, ch, n);
+    }
+
+    static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
+    {
+        ORANGE_STL_DEBUG(src + n <= dst || dst + n <= src);
+        return n == 0 ? dst : std::wmemcpy(dst, src, n);
+    }
+
+    static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
+    {
+        return n == 0 ? dst : std::wmemmove(dst, src, n);
+    }
+
+    static char_type* fill(char_type* dst, char_type ch, size_t count) noexcept
+    {
+        return count == 0 ? dst : std::wmemset(dst, ch, count);
+    }
+};
+
+// 对象内部缓冲区的字节数，char 可以就地存放 23 个字符(另留一个位置给结尾的 0)
+enum { EStringLocalBytes = 24 };
+
+// 模板类 basic_string
+// 参数一代表字符类型，参数二代表萃取字符类型的方式，参数三代表空间配置器类型
+// 数据布局：ptr_ 指向字符数组，size_ 为长度；短字符串时 ptr_ 指向内部缓冲区 buf_，
+// 长字符串时 buf_ 的位置改存堆空间的容量 cap_。字符数组总以 0 结尾，因此 data() 与 c_str() 相同
+template <class CharType, class CharTraits = orange_stl::char_traits<CharType>,
+          class Alloc = orange_stl::allocator<CharType>>
+class basic_string
+{
+public:
+    typedef CharTraits                                       traits_type;
+    typedef CharTraits                                       char_traits;
+
+    typedef Alloc                                            allocator_type;
+    typedef typename Alloc::template rebind<CharType>::other data_allocator;
+
+    typedef CharType                                         value_type;
+    typedef value_type*                                      pointer;
+    typedef const value_type*                                const_pointer;
+    typedef value_type&                                      reference;
+    typedef const value_type&                                const_reference;
+    typedef size_t                                           size_type;
+    typedef ptrdiff_t                                        difference_type;
+
+    typedef value_type*                                      iterator;
+    typedef const value_type*                                const_iterator;
+    typedef orange_stl::reverse_iterator<iterator>           reverse_iterator;
+    typedef orange_stl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+    static_assert(std::is_trivial<CharType>::value,
+                  "the CharType of basic_string must be a trivial type");
+
+    // 末尾值，表示不存在的位置
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+    // 内部缓冲区可容纳的字符数(不含结尾的 0)
+    static constexpr size_type local_capacity =
+        (EStringLocalBytes / sizeof(CharType) > 1 ? EStringLocalBytes / sizeof(CharType) : 2) - 1;
+
+    pointer   ptr_;    // 字符数组的起始位置
+    size_type size_;   // 字符串的长度
+    union
+    {
+        size_type  cap_;                        // 堆空间的容量(不含结尾的 0)
+        value_type buf_[local_capacity + 1];    // 短字符串的内部缓冲区
+    };
+
+public:
+    // 构造、复制、移动、析构函数
+    basic_string() noexcept
+    {
+        init_local();
+    }
+
+    basic_string(size_type n, value_type ch)
+    {
+        init_local();
+        fill_init(n, ch);
+    }
+
+    basic_string(const basic_string& other, size_type pos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > other.size_, "basic_string<Char, Traits> index out of range");
+        init_local();
+        init_from(other.ptr_ + pos, other.size_ - pos);
+    }
+    basic_string(const basic_string& other, size_type pos, size_type count)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > other.size_, "basic_string<Char, Traits> index out of range");
+        init_local();
+        init_from(other.ptr_ + pos, orange_stl::min(count, other.size_ - pos));
+    }
+
+    basic_string(const_pointer str)
+    {
+        init_local();
+        init_from(str, char_traits::length(str));
+    }
+    basic_string(const_pointer str, size_type count)
+    {
+        init_local();
+        init_from(str, count);
+    }
+
+    template <class Iter, typename std::enable_if<
+        orange_stl::is_input_iterator<Iter>::value, int>::type = 0>
+    basic_string(Iter first, Iter last)
+    {
+        init_local();
+        copy_init(first, last, iterator_category(first));
+    }
+
+    basic_string(std::initializer_list<value_type> ilist)
+    {
+        init_local();
+        init_from(ilist.begin(), ilist.size());
+    }
+
+    basic_string(const basic_string& rhs)
+    {
+        init_local();
+        init_from(rhs.ptr_, rhs.size_);
+    }
+
+    // 移动构造从不配置空间：短字符串复制内部缓冲区，长字符串直接接管堆空间
+    basic_string(basic_string&& rhs) noexcept
+    {
+        init_local();
+        steal(rhs);
+    }
+
+    basic_string& operator=(const basic_string& rhs)
+    {
+        if (this != &rhs)
+            assign(rhs.ptr_, rhs.size_);
+        return *this;
+    }
+    basic_string& operator=(basic_string&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (rhs.is_local())
+            {
+                // 内部缓冲区的字符数不会超过当前容量，无需配置空间
+                char_traits::copy(ptr_, rhs.ptr_, rhs.size_ + 1);
+                size_ = rhs.size_;
+                rhs.set_size(0);
+            }
+            else
+            {
+                destroy_buffer();
+                init_local();
+                steal(rhs);
+            }
+        }
+        return *this;
+    }
+
+    basic_string& operator=(const_pointer str)
+    {
+        return assign(str, char_traits::length(str));
+    }
+    basic_string& operator=(value_type ch)
+    {
+        return assign(size_type(1), ch);
+    }
+    basic_string& operator=(std::initializer_list<value_type> ilist)
+    {
+        return assign(ilist.begin(), ilist.size());
+    }
+
+    ~basic_string()
+    {
+        destroy_buffer();
+    }
+
+public:
+    // 迭代器相关操作
+    iterator               begin()         noexcept { return ptr_; }
+    const_iterator         begin()   const noexcept { return ptr_; }
+    iterator               end()           noexcept { return ptr_ + size_; }
+    const_iterator         end()     const noexcept { return ptr_ + size_; }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return size_ == 0; }
+    size_type size()     const noexcept { return size_; }
+    size_type length()   const noexcept { return size_; }
+    size_type capacity() const noexcept { return is_local() ? local_capacity : cap_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type) / 2 - 1; }
+
+    void reserve(size_type n);
+    void shrink_to_fit();
+
+    // 访问元素相关操作
+    reference operator[](size_type n)
+    {
+        ORANGE_STL_DEBUG(n <= size_);
+        return ptr_[n];
+    }
+    const_reference operator[](size_type n) const
+    {
+        ORANGE_STL_DEBUG(n <= size_);
+        return ptr_[n];
+    }
+
+    reference at(size_type n)
+    {
+        THROW_OUT_OF_RANGE_IF(n >= size_, "basic_string<Char, Traits>::at() subscript out of range");
+        return ptr_[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_OF_RANGE_IF(n >= size_, "basic_string<Char, Traits>::at() subscript out of range");
+        return ptr_[n];
+    }
+
+    reference front()
+    {
+        ORANGE_STL_DEBUG(!empty());
+        return *begin();
+    }
+    const_reference front() const
+    {
+        ORANGE_STL_DEBUG(!empty());
+        return *begin();
+    }
+
+    reference back()
+    {
+        ORANGE_STL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    const_reference back() const
+    {
+        ORANGE_STL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+
+    const_pointer data()  const noexcept { return ptr_; }
+    const_pointer c_str() const noexcept { return ptr_; }
+
+    // 添加删除相关操作
+
+    // assign
+    basic_string& assign(size_type count, value_type ch)
+    {
+        return replace_fill(0, size_, count, ch);
+    }
+    basic_string& assign(const basic_string& str)
+    {
+        return *this = str;
+    }
+    basic_string& assign(basic_string&& str) noexcept
+    {
+        return *this = orange_stl::move(str);
+    }
+    basic_string& assign(const basic_string& str, size_type pos, size_type count = npos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > str.size_, "basic_string<Char, Traits>::assign's pos out of range");
+        return replace_cstr(0, size_, str.ptr_ + pos, orange_stl::min(count, str.size_ - pos));
+    }
+    basic_string& assign(const_pointer str, size_type count)
+    {
+        return replace_cstr(0, size_, str, count);
+    }
+    basic_string& assign(const_pointer str)
+    {
+        return replace_cstr(0, size_, str, char_traits::length(str));
+    }
+    template <class Iter, typename std::enable_if<
+        orange_stl::is_input_iterator<Iter>::value, int>::type = 0>
+    basic_string& assign(Iter first, Iter last)
+    {
+        basic_string tmp(first, last);
+        return *this = orange_stl::move(tmp);
+    }
+    basic_string& assign(std::initializer_list<value_type> ilist)
+    {
+        return replace_cstr(0, size_, ilist.begin(), ilist.size());
+    }
+
+    // insert
+    iterator insert(const_iterator pos, value_type ch)
+    {
+        const size_type n = pos - ptr_;
+        replace_fill(n, 0, 1, ch);
+        return ptr_ + n;
+    }
+    iterator insert(const_iterator pos, size_type count, value_type ch)
+    {
+        const size_type n = pos - ptr_;
+        replace_fill(n, 0, count, ch);
+        return ptr_ + n;
+    }
+    template <class Iter, typename std::enable_if<
+        orange_stl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last)
+    {
+        const size_type n = pos - ptr_;
+        const basic_string tmp(first, last);
+        replace_cstr(n, 0, tmp.ptr_, tmp.size_);
+        return ptr_ + n;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        const size_type n = pos - ptr_;
+        replace_cstr(n, 0, ilist.begin(), ilist.size());
+        return ptr_ + n;
+    }
+
+    basic_string& insert(size_type pos, size_type count, value_type ch)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::insert's pos out of range");
+        return replace_fill(pos, 0, count, ch);
+    }
+    basic_string& insert(size_type pos, const_pointer str)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::insert's pos out of range");
+        return replace_cstr(pos, 0, str, char_traits::length(str));
+    }
+    basic_string& insert(size_type pos, const_pointer str, size_type count)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::insert's pos out of range");
+        return replace_cstr(pos, 0, str, count);
+    }
+    basic_string& insert(size_type pos, const basic_string& str)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::insert's pos out of range");
+        return replace_cstr(pos, 0, str.ptr_, str.size_);
+    }
+    basic_string& insert(size_type pos, const basic_string& str, size_type str_pos, size_type count = npos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_ || str_pos > str.size_,
+                              "basic_string<Char, Traits>::insert's pos out of range");
+        return replace_cstr(pos, 0, str.ptr_ + str_pos, orange_stl::min(count, str.size_ - str_pos));
+    }
+
+    // push_back / pop_back
+    void push_back(value_type ch)
+    {
+        if (size_ < capacity())
+        {
+            ptr_[size_] = ch;
+            set_size(size_ + 1);
+        }
+        else
+        {
+            replace_fill(size_, 0, 1, ch);
+        }
+    }
+    void pop_back()
+    {
+        ORANGE_STL_DEBUG(!empty());
+        set_size(size_ - 1);
+    }
+
+    // append
+    basic_string& append(size_type count, value_type ch)
+    {
+        return replace_fill(size_, 0, count, ch);
+    }
+    basic_string& append(const basic_string& str)
+    {
+        return replace_cstr(size_, 0, str.ptr_, str.size_);
+    }
+    basic_string& append(const basic_string& str, size_type pos, size_type count = npos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > str.size_, "basic_string<Char, Traits>::append's pos out of range");
+        return replace_cstr(size_, 0, str.ptr_ + pos, orange_stl::min(count, str.size_ - pos));
+    }
+    basic_string& append(const_pointer str)
+    {
+        return replace_cstr(size_, 0, str, char_traits::length(str));
+    }
+    basic_string& append(const_pointer str, size_type count)
+    {
+        return replace_cstr(size_, 0, str, count);
+    }
+    template <class Iter, typename std::enable_if<
+        orange_stl::is_input_iterator<Iter>::value, int>::type = 0>
+    basic_string& append(Iter first, Iter last)
+    {
+        const basic_string tmp(first, last);
+        return replace_cstr(size_, 0, tmp.ptr_, tmp.size_);
+    }
+    basic_string& append(std::initializer_list<value_type> ilist)
+    {
+        return replace_cstr(size_, 0, ilist.begin(), ilist.size());
+    }
+
+    // operator+=
+    basic_string& operator+=(const basic_string& str)
+    {
+        return append(str);
+    }
+    basic_string& operator+=(value_type ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+    basic_string& operator+=(const_pointer str)
+    {
+        return append(str);
+    }
+    basic_string& operator+=(std::initializer_list<value_type> ilist)
+    {
+        return append(ilist);
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos)
+    {
+        ORANGE_STL_DEBUG(pos != end());
+        const size_type n = pos - ptr_;
+        replace_cstr(n, 1, nullptr, 0);
+        return ptr_ + n;
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const size_type n = first - ptr_;
+        replace_cstr(n, static_cast<size_type>(last - first), nullptr, 0);
+        return ptr_ + n;
+    }
+    basic_string& erase(size_type pos = 0, size_type count = npos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::erase's pos out of range");
+        return replace_cstr(pos, orange_stl::min(count, size_ - pos), nullptr, 0);
+    }
+
+    void clear() noexcept
+    {
+        set_size(0);
+    }
+
+    // resize
+    void resize(size_type count)
+    {
+        resize(count, value_type());
+    }
+    void resize(size_type count, value_type ch)
+    {
+        if (count < size_)
+            set_size(count);
+        else
+            append(count - size_, ch);
+    }
+
+    // compare
+    int compare(const basic_string& other) const noexcept
+    {
+        return compare_cstr(ptr_, size_, other.ptr_, other.size_);
+    }
+    int compare(size_type pos1, size_type count1, const basic_string& other) const
+    {
+        THROW_OUT_OF_RANGE_IF(pos1 > size_, "basic_string<Char, Traits>::compare's pos out of range");
+        return compare_cstr(ptr_ + pos1, orange_stl::min(count1, size_ - pos1), other.ptr_, other.size_);
+    }
+    int compare(size_type pos1, size_type count1, const basic_string& other,
+                size_type pos2, size_type count2 = npos) const
+    {
+        THROW_OUT_OF_RANGE_IF(pos1 > size_ || pos2 > other.size_,
+                              "basic_string<Char, Traits>::compare's pos out of range");
+        return compare_cstr(ptr_ + pos1, orange_stl::min(count1, size_ - pos1),
+                            other.ptr_ + pos2, orange_stl::min(count2, other.size_ - pos2));
+    }
+    int compare(const_pointer s) const
+    {
+        return compare_cstr(ptr_, size_, s, char_traits::length(s));
+    }
+    int compare(size_type pos1, size_type count1, const_pointer s) const
+    {
+        THROW_OUT_OF_RANGE_IF(pos1 > size_, "basic_string<Char, Traits>::compare's pos out of range");
+        return compare_cstr(ptr_ + pos1, orange_stl::min(count1, size_ - pos1), s, char_traits::length(s));
+    }
+    int compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
+    {
+        THROW_OUT_OF_RANGE_IF(pos1 > size_, "basic_string<Char, Traits>::compare's pos out of range");
+        return compare_cstr(ptr_ + pos1, orange_stl::min(count1, size_ - pos1), s, count2);
+    }
+
+    // substr
+    basic_string substr(size_type pos = 0, size_type count = npos) const
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::substr's pos out of range");
+        return basic_string(ptr_ + pos, orange_stl::min(count, size_ - pos));
+    }
+
+    // replace
+    basic_string& replace(size_type pos, size_type count, const basic_string& str)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
+        return replace_cstr(pos, orange_stl::min(count, size_ - pos), str.ptr_, str.size_);
+    }
+    basic_string& replace(const_iterator first, const_iterator last, const basic_string& str)
+    {
+        return replace_cstr(first - ptr_, last - first, str.ptr_, str.size_);
+    }
+    basic_string& replace(size_type pos, size_type count, const_pointer str)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
+        return replace_cstr(pos, orange_stl::min(count, size_ - pos), str, char_traits::length(str));
+    }
+    basic_string& replace(const_iterator first, const_iterator last, const_pointer str)
+    {
+        return replace_cstr(first - ptr_, last - first, str, char_traits::length(str));
+    }
+    basic_string& replace(size_type pos, size_type count, const_pointer str, size_type count2)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
+        return replace_cstr(pos, orange_stl::min(count, size_ - pos), str, count2);
+    }
+    basic_string& replace(const_iterator first, const_iterator last, const_pointer str, size_type count)
+    {
+        return replace_cstr(first - ptr_, last - first, str, count);
+    }
+    basic_string& replace(size_type pos, size_type count, size_type count2, value_type ch)
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
+        return replace_fill(pos, orange_stl::min(count, size_ - pos), count2, ch);
+    }
+    basic_string& replace(const_iterator first, const_iterator last, size_type count, value_type ch)
+    {
+        return replace_fill(first - ptr_, last - first, count, ch);
+    }
+    basic_string& replace(size_type pos1, size_type count1, const basic_string& str,
+                          size_type pos2, size_type count2 = npos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos1 > size_ || pos2 > str.size_,
+                              "basic_string<Char, Traits>::replace's pos out of range");
+        return replace_cstr(pos1, orange_stl::min(count1, size_ - pos1),
+                            str.ptr_ + pos2, orange_stl::min(count2, str.size_ - pos2));
+    }
+    template <class Iter, typename std::enable_if<
+        orange_stl::is_input_iterator<Iter>::value, int>::type = 0>
+    basic_string& replace(const_iterator first, const_iterator last, Iter first2, Iter last2)
+    {
+        const basic_string tmp(first2, last2);
+        return replace_cstr(first - ptr_, last - first, tmp.ptr_, tmp.size_);
+    }
+
+    // reverse
+    void reverse() noexcept
+    {
+        for (pointer first = ptr_, last = ptr_ + size_; first < last; )
+            orange_stl::iter_swap(first++, --last);
+    }
+
+    // copy
+    size_type copy(pointer dst, size_type count, size_type pos = 0) const
+    {
+        THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::copy's pos out of range");
+        const size_type n = orange_stl::min(count, size_ - pos);
+        char_traits::copy(dst, ptr_ + pos, n);
+        return n;
+    }
+
+    // swap
+    void swap(basic_string& rhs) noexcept;
+
+    // 查找相关操作
+
+    // find
+    size_type find(value_type ch, size_type pos = 0) const noexcept;
+    size_type find(const_pointer str, size_type pos = 0) const noexcept;
+    size_type find(const_pointer str, size_type pos, size_type count) const noexcept;
+    size_type find(const basic_string& str, size_type pos = 0) const noexcept;
+
+    // rfind
+    size_type rfind(value_type ch, size_type pos = npos) const noexcept;
+    size_type rfind(const_pointer str, size_type pos = npos) const noexcept;
+    size_type rfind(const_pointer str, size_type pos, size_type count) const noexcept;
+    size_type rfind(const basic_string& str, size_type pos = npos) const noexcept;
+
+    // find_first_of
+    size_type find_first_of(value_type ch, size_type pos = 0) const noexcept;
+    size_type find_first_of(const_pointer s, size_type pos = 0) const noexcept;
+    size_type find_first_of(const_pointer s, size_type pos, size_type count) const noexcept;
+    size_type find_first_of(const basic_string& str, size_type pos = 0) const noexcept;
+
+    // find_first_not_of
+    size_type find_first_not_of(value_type ch, size_type pos = 0) const noexcept;
+    size_type find_first_not_of(const_pointer s, size_type pos = 0) const noexcept;
+    size_type find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept;
+    size_type find_first_not_of(const basic_string& str, size_type pos = 0) const noexcept;
+
+    // find_last_of
+    size_type find_last_of(value_type ch, size_type pos = npos) const noexcept;
+    size_type find_last_of(const_pointer s, size_type pos = npos) const noexcept;
+    size_type find_last_of(const_pointer s, size_type pos, size_type count) const noexcept;
+    size_type find_last_of(const basic_string& str, size_type pos = npos) const noexcept;
+
+    // find_last_not_of
+    size_type find_last_not_of(value_type ch, size_type pos = npos) const noexcept;
+    size_type find_last_not_of(const_pointer s, size_type pos = npos) const noexcept;
+    size_type find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept;
+    size_type find_last_not_of(const basic_string& str, size_type pos = npos) const noexcept;
+
+    // count
+    size_type count(value_type ch, size_type pos = 0) const noexcept;
+
+public:
+    // 重载 operator>> / operator<<
+    friend std::istream& operator>>(std::istream& is, basic_string& str)
+    {
+        str.clear();
+        std::istream::sentry ok(is);
+        if (!ok)
+            return is;
+        std::streambuf* sb = is.rdbuf();
+        int c = sb->sgetc();
+        while (c != EOF && !std::isspace(c))
+        {
+            str.push_back(static_cast<value_type>(c));
+            c = sb->snextc();
+        }
+        if (c == EOF)
+            is.setstate(std::ios_base::eofbit);
+        if (str.empty())
+            is.setstate(std::ios_base::failbit);
+        return is;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const basic_string& str)
+    {
+        for (size_type i = 0; i < str.size_; ++i)
+            os << str.ptr_[i];
+        return os;
+    }
+
+private:
+    // helper functions
+
+    bool is_local() const noexcept
+    {
+        return ptr_ == buf_;
+    }
+
+    // 置为空的短字符串
+    void init_local() noexcept
+    {
+        ptr_ = buf_;
+        size_ = 0;
+        buf_[0] = value_type();
+    }
+
+    // 设置长度并写入结尾的 0
+    void set_size(size_type n) noexcept
+    {
+        size_ = n;
+        ptr_[n] = value_type();
+    }
+
+    // 接管 rhs 的内容，并把 rhs 置为空字符串，调用前 *this 须为空的短字符串
+    void steal(basic_string& rhs) noexcept
+    {
+        if (rhs.is_local())
+        {
+            char_traits::copy(buf_, rhs.buf_, rhs.size_ + 1);
+            size_ = rhs.size_;
+        }
+        else
+        {
+            ptr_ = rhs.ptr_;
+            size_ = rhs.size_;
+            cap_ = rhs.cap_;
+        }
+        rhs.init_local();
+    }
+
+    // str 是否指向自身的字符数组
+    bool is_inside(const_pointer str) const noexcept
+    {
+        return !orange_stl::less<const_pointer>()(str, ptr_) &&
+            orange_stl::less<const_pointer>()(str, ptr_ + size_);
+    }
+
+    static pointer allocate_buffer(size_type cap)
+    {
+        return data_allocator::allocate(cap + 1);
+    }
+
+    void destroy_buffer() noexcept
+    {
+        if (!is_local())
+            data_allocator::deallocate(ptr_, cap_ + 1);
+    }
+
+    // 改用容量为 cap 的堆空间，调用者负责之后写入内容
+    void set_heap(pointer p, size_type cap) noexcept
+    {
+        destroy_buffer();
+        ptr_ = p;
+        cap_ = cap;
+    }
+
+    size_type recommend_capacity(size_type need) const;
+
+    void      init_from(const_pointer str, size_type count);
+    void      fill_init(size_type n, value_type ch);
+
+    template <class Iter>
+    void      copy_init(Iter first, Iter last, orange_stl::input_iterator_tag);
+    template <class Iter>
+    void      copy_init(Iter first, Iter last, orange_stl::forward_iterator_tag);
+
+    basic_string& replace_cstr(size_type pos, size_type count1, const_pointer str, size_type count2);
+    basic_string& replace_fill(size_type pos, size_type count1, size_type count2, value_type ch);
+
+    static int compare_cstr(const_pointer s1, size_type n1, const_pointer s2, size_type n2) noexcept;
+};
+
+template <class CharType, class CharTraits, class Alloc>
+constexpr typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::npos;
+
+template <class CharType, class CharTraits, class Alloc>
+constexpr typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::local_capacity;
+
+/*****************************************************************************************/
+
+// 预留至少能容纳 n 个字符的空间
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+reserve(size_type n)
+{
+    if (n <= capacity())
+        return;
+    THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in basic_string<Char, Traits>::reserve(n)");
+    const size_type new_cap = recommend_capacity(n);
+    pointer p = allocate_buffer(new_cap);
+    char_traits::copy(p, ptr_, size_ + 1);
+    set_heap(p, new_cap);
+}
+
+// 减少不用的空间，长度不超过内部缓冲区时搬回对象内部
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+shrink_to_fit()
+{
+    if (is_local() || size_ == cap_)
+        return;
+    if (size_ <= local_capacity)
+    {
+        pointer old = ptr_;
+        const size_type old_cap = cap_;
+        char_traits::copy(buf_, old, size_ + 1);
+        ptr_ = buf_;
+        data_allocator::deallocate(old, old_cap + 1);
+        return;
+    }
+    pointer p = allocate_buffer(size_);
+    char_traits::copy(p, ptr_, size_ + 1);
+    set_heap(p, size_);
+}
+
+// 交换两个字符串，不配置空间
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+swap(basic_string& rhs) noexcept
+{
+    if (this == &rhs)
+        return;
+    if (!is_local() && !rhs.is_local())
+    {
+        orange_stl::swap(ptr_, rhs.ptr_);
+        orange_stl::swap(size_, rhs.size_);
+        orange_stl::swap(cap_, rhs.cap_);
+        return;
+    }
+    basic_string tmp(orange_stl::move(rhs));
+    rhs = orange_stl::move(*this);
+    *this = orange_stl::move(tmp);
+}
+
+// 从下标 pos 开始查找字符 ch，用 char_traits::find 扫描
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find(value_type ch, size_type pos) const noexcept
+{
+    if (pos >= size_)
+        return npos;
+    const_pointer p = char_traits::find(ptr_ + pos, size_ - pos, ch);
+    return p == nullptr ? npos : static_cast<size_type>(p - ptr_);
+}
+
+// 从下标 pos 开始查找字符串 str 的前 count 个字符
+// 先用 char_traits::find 跳到首字符可能出现的位置，再用 char_traits::compare 比较其余部分
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find(const_pointer str, size_type pos, size_type count) const noexcept
+{
+    if (count == 0)
+        return pos <= size_ ? pos : npos;
+    if (pos >= size_ || count > size_ - pos)
+        return npos;
+    const value_type first = str[0];
+    const_pointer cur = ptr_ + pos;
+    const_pointer last = ptr_ + size_ - count;   // 最后一个可能的起始位置
+    while (cur <= last)
+    {
+        cur = char_traits::find(cur, static_cast<size_type>(last - cur) + 1, first);
+        if (cur == nullptr)
+            return npos;
+        if (char_traits::compare(cur + 1, str + 1, count - 1) == 0)
+            return static_cast<size_type>(cur - ptr_);
+        ++cur;
+    }
+    return npos;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find(const_pointer str, size_type pos) const noexcept
+{
+    return find(str, pos, char_traits::length(str));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find(const basic_string& str, size_type pos) const noexcept
+{
+    return find(str.ptr_, pos, str.size_);
+}
+
+// 从下标 pos 开始反向查找字符 ch
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+rfind(value_type ch, size_type pos) const noexcept
+{
+    if (size_ == 0)
+        return npos;
+    if (pos >= size_)
+        pos = size_ - 1;
+    for (size_type i = pos + 1; i != 0; --i)
+    {
+        if (ptr_[i - 1] == ch)
+            return i - 1;
+    }
+    return npos;
+}
+
+// 从下标 pos 开始反向查找字符串 str 的前 count 个字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+rfind(const_pointer str, size_type pos, size_type count) const noexcept
+{
+    if (count == 0)
+        return orange_stl::min(pos, size_);
+    if (count > size_)
+        return npos;
+    size_type i = orange_stl::min(pos, size_ - count);
+    for (;;)
+    {
+        if (ptr_[i] == str[0] && char_traits::compare(ptr_ + i, str, count) == 0)
+            return i;
+        if (i == 0)
+            break;
+        --i;
+    }
+    return npos;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+rfind(const_pointer str, size_type pos) const noexcept
+{
+    return rfind(str, pos, char_traits::length(str));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+rfind(const basic_string& str, size_type pos) const noexcept
+{
+    return rfind(str.ptr_, pos, str.size_);
+}
+
+// 从下标 pos 开始查找 ch 出现的第一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_of(value_type ch, size_type pos) const noexcept
+{
+    return find(ch, pos);
+}
+
+// 从下标 pos 开始查找字符串 s 的前 count 个字符中任意一个出现的第一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+    for (size_type i = pos; i < size_; ++i)
+    {
+        if (char_traits::find(s, count, ptr_[i]) != nullptr)
+            return i;
+    }
+    return npos;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_of(const_pointer s, size_type pos) const noexcept
+{
+    return find_first_of(s, pos, char_traits::length(s));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_of(const basic_string& str, size_type pos) const noexcept
+{
+    return find_first_of(str.ptr_, pos, str.size_);
+}
+
+// 从下标 pos 开始查找与 ch 不相等的第一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_not_of(value_type ch, size_type pos) const noexcept
+{
+    for (size_type i = pos; i < size_; ++i)
+    {
+        if (ptr_[i] != ch)
+            return i;
+    }
+    return npos;
+}
+
+// 从下标 pos 开始查找不在字符串 s 前 count 个字符中的第一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+    for (size_type i = pos; i < size_; ++i)
+    {
+        if (char_traits::find(s, count, ptr_[i]) == nullptr)
+            return i;
+    }
+    return npos;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_not_of(const_pointer s, size_type pos) const noexcept
+{
+    return find_first_not_of(s, pos, char_traits::length(s));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_first_not_of(const basic_string& str, size_type pos) const noexcept
+{
+    return find_first_not_of(str.ptr_, pos, str.size_);
+}
+
+// 从下标 pos 开始反向查找 ch 出现的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_of(value_type ch, size_type pos) const noexcept
+{
+    return rfind(ch, pos);
+}
+
+// 从下标 pos 开始反向查找字符串 s 的前 count 个字符中任意一个出现的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+    if (size_ == 0)
+        return npos;
+    for (size_type i = orange_stl::min(pos, size_ - 1) + 1; i != 0; --i)
+    {
+        if (char_traits::find(s, count, ptr_[i - 1]) != nullptr)
+            return i - 1;
+    }
+    return npos;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_of(const_pointer s, size_type pos) const noexcept
+{
+    return find_last_of(s, pos, char_traits::length(s));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_of(const basic_string& str, size_type pos) const noexcept
+{
+    return find_last_of(str.ptr_, pos, str.size_);
+}
+
+// 从下标 pos 开始反向查找与 ch 不相等的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_not_of(value_type ch, size_type pos) const noexcept
+{
+    if (size_ == 0)
+        return npos;
+    for (size_type i = orange_stl::min(pos, size_ - 1) + 1; i != 0; --i)
+    {
+        if (ptr_[i - 1] != ch)
+            return i - 1;
+    }
+    return npos;
+}
+
+// 从下标 pos 开始反向查找不在字符串 s 前 count 个字符中的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+    if (size_ == 0)
+        return npos;
+    for (size_type i = orange_stl::min(pos, size_ - 1) + 1; i != 0; --i)
+    {
+        if (char_traits::find(s, count, ptr_[i - 1]) == nullptr)
+            return i - 1;
+    }
+    return npos;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_not_of(const_pointer s, size_type pos) const noexcept
+{
+    return find_last_not_of(s, pos, char_traits::length(s));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+find_last_not_of(const basic_string& str, size_type pos) const noexcept
+{
+    return find_last_not_of(str.ptr_, pos, str.size_);
+}
+
+// 返回从下标 pos 开始字符 ch 出现的次数
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+count(value_type ch, size_type pos) const noexcept
+{
+    size_type n = 0;
+    for (size_type i = pos; i < size_; ++i)
+    {
+        if (ptr_[i] == ch)
+            ++n;
+    }
+    return n;
+}
+
+/*****************************************************************************************/
+// helper functions
+
+// 计算新容量：至少为 need，且按 1.5 倍增长，保证连续 push_back 的均摊复杂度为 O(1)
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::
+recommend_capacity(size_type need) const
+{
+    const size_type old_cap = capacity();
+    const size_type ms = max_size();
+    THROW_LENGTH_ERROR_IF(need > ms, "basic_string<Char, Traits>'s size too big");
+    if (old_cap > ms - old_cap / 2)
+        return ms;
+    return orange_stl::max(need, old_cap + old_cap / 2);
+}
+
+// 以 [str, str + count) 初始化，调用前 *this 须为空的短字符串
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+init_from(const_pointer str, size_type count)
+{
+    if (count > local_capacity)
+    {
+        THROW_LENGTH_ERROR_IF(count > max_size(), "basic_string<Char, Traits>'s size too big");
+        ptr_ = allocate_buffer(count);
+        cap_ = count;
+    }
+    char_traits::copy(ptr_, str, count);
+    set_size(count);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+fill_init(size_type n, value_type ch)
+{
+    if (n > local_capacity)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "basic_string<Char, Traits>'s size too big");
+        ptr_ = allocate_buffer(n);
+        cap_ = n;
+    }
+    char_traits::fill(ptr_, ch, n);
+    set_size(n);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+template <class Iter>
+void basic_string<CharType, CharTraits, Alloc>::
+copy_init(Iter first, Iter last, orange_stl::input_iterator_tag)
+{
+    try
+    {
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+    catch (...)
+    {
+        destroy_buffer();
+        throw;
+    }
+}
+
+template <class CharType, class CharTraits, class Alloc>
+template <class Iter>
+void basic_string<CharType, CharTraits, Alloc>::
+copy_init(Iter first, Iter last, orange_stl::forward_iterator_tag)
+{
+    const size_type n = orange_stl::distance(first, last);
+    if (n > local_capacity)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "basic_string<Char, Traits>'s size too big");
+        ptr_ = allocate_buffer(n);
+        cap_ = n;
+    }
+    pointer cur = ptr_;
+    for (; first != last; ++first, ++cur)
+        *cur = *first;
+    set_size(n);
+}
+
+// 把 [pos, pos + count1) 替换为 [str, str + count2)，其余修改操作都转发到这里
+// 空间足够时就地移动尾部，否则按增长策略配置新空间并一次复制到位
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
+replace_cstr(size_type pos, size_type count1, const_pointer str, size_type count2)
+{
+    ORANGE_STL_DEBUG(pos <= size_ && count1 <= size_ - pos);
+    THROW_LENGTH_ERROR_IF(size_ - count1 > max_size() - count2, "basic_string<Char, Traits>'s size too big");
+    if (count2 != 0 && is_inside(str))
+    {
+        // str 指向自身，先复制一份，避免移动尾部时被覆盖
+        const basic_string tmp(str, count2);
+        return replace_cstr(pos, count1, tmp.ptr_, tmp.size_);
+    }
+    const size_type new_size = size_ - count1 + count2;
+    const size_type tail = size_ - pos - count1;
+    if (new_size <= capacity())
+    {
+        pointer p = ptr_ + pos;
+        if (tail != 0 && count1 != count2)
+            char_traits::move(p + count2, p + count1, tail);
+        char_traits::copy(p, str, count2);
+    }
+    else
+    {
+        const size_type new_cap = recommend_capacity(new_size);
+        pointer p = allocate_buffer(new_cap);
+        char_traits::copy(p, ptr_, pos);
+        char_traits::copy(p + pos, str, count2);
+        char_traits::copy(p + pos + count2, ptr_ + pos + count1, tail);
+        set_heap(p, new_cap);
+    }
+    set_size(new_size);
+    return *this;
+}
+
+// 把 [pos, pos + count1) 替换为 count2 个 ch
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
+replace_fill(size_type pos, size_type count1, size_type count2, value_type ch)
+{
+    ORANGE_STL_DEBUG(pos <= size_ && count1 <= size_ - pos);
+    THROW_LENGTH_ERROR_IF(size_ - count1 > max_size() - count2, "basic_string<Char, Traits>'s size too big");
+    const size_type new_size = size_ - count1 + count2;
+    const size_type tail = size_ - pos - count1;
+    if (new_size <= capacity())
+    {
+        pointer p = ptr_ + pos;
+        if (tail != 0 && count1 != count2)
+            char_traits::move(p + count2, p + count1, tail);
+        char_traits::fill(p, ch, count2);
+    }
+    else
+    {
+        const size_type new_cap = recommend_capacity(new_size);
+        pointer p = allocate_buffer(new_cap);
+        char_traits::copy(p, ptr_, pos);
+        char_traits::fill(p + pos, ch, count2);
+        char_traits::copy(p + pos + count2, ptr_ + pos + count1, tail);
+        set_heap(p, new_cap);
+    }
+    set_size(new_size);
+    return *this;
+}
+
+// 比较两个字符序列，公共部分交给 char_traits::compare，其余按长度决定
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
+compare_cstr(const_pointer s1, size_type n1, const_pointer s2, size_type n2) noexcept
+{
+    const int r = char_traits::compare(s1, s2, orange_stl::min(n1, n2));
+    if (r != 0)
+        return r < 0 ? -1 : 1;
+    if (n1 < n2)
+        return -1;
+    if (n1 > n2)
+        return 1;
+    return 0;
+}
+
+/*****************************************************************************************/
+// 重载全局操作符
+
+// 重载 operator+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs,
+          const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    basic_string<CharType, CharTraits, Alloc> tmp;
+    tmp.reserve(lhs.size() + rhs.size());
+    tmp.append(lhs).append(rhs);
+    return tmp;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    basic_string<CharType, CharTraits, Alloc> tmp(lhs);
+    tmp.append(rhs);
+    return tmp;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(CharType ch, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    basic_string<CharType, CharTraits, Alloc> tmp(1, ch);
+    tmp.append(rhs);
+    return tmp;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+    basic_string<CharType, CharTraits, Alloc> tmp(lhs);
+    tmp.append(rhs);
+    return tmp;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs, CharType ch)
+{
+    basic_string<CharType, CharTraits, Alloc> tmp(lhs);
+    tmp.push_back(ch);
+    return tmp;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs,
+          const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    lhs.append(rhs);
+    return orange_stl::move(lhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs,
+          basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+    rhs.insert(0, lhs);
+    return orange_stl::move(rhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs,
+          basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+    lhs.append(rhs);
+    return orange_stl::move(lhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const CharType* lhs, basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+    rhs.insert(0, lhs);
+    return orange_stl::move(rhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(CharType ch, basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+    rhs.insert(rhs.begin(), ch);
+    return orange_stl::move(rhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs, const CharType* rhs)
+{
+    lhs.append(rhs);
+    return orange_stl::move(lhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs, CharType ch)
+{
+    lhs.push_back(ch);
+    return orange_stl::move(lhs);
+}
+
+// 重载比较操作符，先比较长度，相等时才比较内容
+template <class CharType, class CharTraits, class Alloc>
+bool operator==(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        CharTraits::compare(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator!=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator==(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) == 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator==(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) == 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator!=(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) != 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator!=(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) != 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<(const basic_string<CharType, CharTraits, Alloc>& lhs,
+               const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return lhs.compare(rhs) < 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return lhs.compare(rhs) <= 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>(const basic_string<CharType, CharTraits, Alloc>& lhs,
+               const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return lhs.compare(rhs) >= 0;
+}
+
+// 与 C 风格字符串的大小比较，使 less<void> 可以用 C 风格字符串查找以 basic_string 为键值的容器
+template <class CharType, class CharTraits, class Alloc>
+bool operator<(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) < 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) > 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) < 0;
+}
+
+// 重载 orange_stl 的 swap
+template <class CharType, class CharTraits, class Alloc>
+void swap(basic_string<CharType, CharTraits, Alloc>& lhs,
+          basic_string<CharType, CharTraits, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_BASIC_STRING_H__
@@ -0,0 +1,1441 @@
+#ifndef __ORANGE_BTREE_H__
+#define __ORANGE_BTREE_H__
+
+// 这个头文件包含 B 树 btree，作为 btree_map、btree_set 等容器的底层机制
+// 每个节点在连续的空间中存放多个元素(节点大小约为 EBTreeNodeBytes 字节，占几条缓存行)，内部节点另有指向子节点的指针
+// 与每个元素一个节点的红黑树相比，树高低得多，一次查找的缓存未命中约为 log_B(n) 次，小元素的内存占用也少得多
+// 插入和删除会在节点内或节点之间移动元素，因此会使迭代器、指针和引用失效(end() 除外的所有迭代器)
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <tuple>
+
+#include "orange_iterator.h"
+#include "orange_memory.h"
+#include "orange_functional.h"
+#include "orange_type_traits.h"
+#include "orange_exceptdef.h"
+#include "orange_algobase.h"
+#include "orange_util.h"
+
+namespace orange_stl
+{
+
+// 节点的目标大小，节点中的元素个数由元素大小决定，至少为 3
+enum { EBTreeNodeBytes = 256 };
+
+// btree value traits
+template <class T, bool>
+struct btree_value_traits_imp
+{
+    typedef T key_type;
+    typedef T mapped_type;
+    typedef T value_type;
+
+    template <class Ty>
+    static const key_type& get_key(const Ty& value)
+    {
+        return value;
+    }
+};
+
+template <class T>
+struct btree_value_traits_imp<T, true>
+{
+    typedef typename std::remove_cv<typename T::first_type>::type key_type;
+    typedef typename T::second_type                               mapped_type;
+    typedef T                                                     value_type;
+
+    template <class Ty>
+    static const key_type& get_key(const Ty& value)
+    {
+        return value.first;
+    }
+};
+
+template <class T>
+struct btree_value_traits
+{
+    static constexpr bool is_map = orange_stl::is_pair<T>::value;
+
+    typedef btree_value_traits_imp<T, is_map>       value_traits_type;
+
+    typedef typename value_traits_type::key_type    key_type;
+    typedef typename value_traits_type::mapped_type mapped_type;
+    typedef typename value_traits_type::value_type  value_type;
+
+    template <class Ty>
+    static const key_type& get_key(const Ty& value)
+    {
+        return value_traits_type::get_key(value);
+    }
+};
+
+template <class T> struct btree_internal_node;
+
+// btree 的叶节点，也是内部节点的基类
+// 元素存放在 slots 中，只有前 count 个槽中有元素
+template <class T>
+struct btree_node
+{
+    typedef btree_node<T>*   node_ptr;
+
+    enum
+    {
+        raw_capacity = (static_cast<size_t>(EBTreeNodeBytes) - 2 * sizeof(void*)) / sizeof(T),
+        capacity     = raw_capacity < 3 ? 3 : raw_capacity
+    };
+
+    node_ptr        parent;     // 父节点，根节点为 nullptr
+    unsigned short  position;   // 在父节点的子节点中的下标
+    unsigned short  count;      // 元素个数
+    bool            leaf;       // 是否为叶节点
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[capacity];
+
+    T&       value(size_t i)       { return *reinterpret_cast<T*>(&slots[i]); }
+    const T& value(size_t i) const { return *reinterpret_cast<const T*>(&slots[i]); }
+
+    // 以下两个操作只对内部节点有意义
+    node_ptr& child(size_t i);
+    void      set_child(size_t i, node_ptr c)
+    {
+        child(i) = c;
+        c->parent = this;
+        c->position = static_cast<unsigned short>(i);
+    }
+};
+
+// btree 的内部节点，第 i 个子树中的元素位于第 i - 1 个元素与第 i 个元素之间
+template <class T>
+struct btree_internal_node : public btree_node<T>
+{
+    btree_node<T>* children[btree_node<T>::capacity + 1];
+};
+
+template <class T>
+typename btree_node<T>::node_ptr& btree_node<T>::child(size_t i)
+{
+    return static_cast<btree_internal_node<T>*>(this)->children[i];
+}
+
+template <class T> struct btree_iterator;
+template <class T> struct btree_const_iterator;
+
+// btree iterator，以 (节点, 下标) 表示一个位置
+// 下标等于叶节点的 count 时表示该叶节点之后的位置，end() 为最右叶节点的 (rightmost, count)
+template <class T>
+struct btree_iterator_base : public orange_stl::iterator<orange_stl::bidirectional_iterator_tag, T>
+{
+    typedef btree_node<T>*  node_ptr;
+
+    node_ptr node;
+    int      position;
+
+    btree_iterator_base() : node(nullptr), position(0)
+    { }
+
+    btree_iterator_base(node_ptr n, int pos) : node(n), position(pos)
+    { }
+
+    /* iterator 前进 */
+    void inc()
+    {
+        if (node->leaf)
+        {
+            if (++position < node->count)
+                return;
+            // 叶节点走完，回到第一个还有后继元素的祖先；整棵树走完时停在 end()
+            node_ptr save = node;
+            int save_pos = position;
+            while (position == node->count && node->parent != nullptr)
+            {
+                position = node->position;
+                node = node->parent;
+            }
+            if (position == node->count)
+            {
+                node = save;
+                position = save_pos;
+            }
+        }
+        else
+        {
+            // 内部节点元素的后继是右侧子树的最小元素
+            node = node->child(position + 1);
+            while (!node->leaf)
+                node = node->child(0);
+            position = 0;
+        }
+    }
+
+    /* iterator 后退 */
+    void dec()
+    {
+        if (node->leaf)
+        {
+            if (--position >= 0)
+                return;
+            node_ptr save = node;
+            while (position < 0 && node->parent != nullptr)
+            {
+                position = node->position - 1;
+                node = node->parent;
+            }
+            if (position < 0)
+            {
+                node = save;
+                position = 0;
+            }
+        }
+        else
+        {
+            // 内部节点元素的前驱是左侧子树的最大元素
+            node = node->child(position);
+            while (!node->leaf)
+                node = node->child(node->count);
+            position = node->count - 1;
+        }
+    }
+
+    bool operator==(const btree_iterator_base& rhs) const
+    { return node == rhs.node && position == rhs.position; }
+    bool operator!=(const btree_iterator_base& rhs) const
+    { return !(*this == rhs); }
+};
+
+template <class T>
+struct btree_iterator : public btree_iterator_base<T>
+{
+    typedef T                            value_type;
+    typedef T*                           pointer;
+    typedef T&                           reference;
+    typedef btree_node<T>*               node_ptr;
+
+    typedef btree_iterator<T>            iterator;
+    typedef btree_const_iterator<T>      const_iterator;
+    typedef iterator                     self;
+
+    using btree_iterator_base<T>::node;
+    using btree_iterator_base<T>::position;
+
+    // 构造函数
+    btree_iterator() {}
+    btree_iterator(node_ptr n, int pos) : btree_iterator_base<T>(n, pos) {}
+    btree_iterator(const iterator& rhs) : btree_iterator_base<T>(rhs.node, rhs.position) {}
+    btree_iterator(const const_iterator& rhs) : btree_iterator_base<T>(rhs.node, rhs.position) {}
+    iterator& operator=(const iterator&) noexcept = default;
+
+    // 重载操作符
+    reference operator*()  const { return node->value(position); }
+    pointer   operator->() const { return &(operator*()); }
+
+    self& operator++()
+    {
+        this->inc();
+        return *this;
+    }
+    self operator++(int)
+    {
+        self tmp(*this);
+        this->inc();
+        return tmp;
+    }
+    self& operator--()
+    {
+        this->dec();
+        return *this;
+    }
+    self operator--(int)
+    {
+        self tmp(*this);
+        this->dec();
+        return tmp;
+    }
+};
+
+template <class T>
+struct btree_const_iterator : public btree_iterator_base<T>
+{
+    typedef T                            value_type;
+    typedef const T*                     pointer;
+    typedef const T&                     reference;
+    typedef btree_node<T>*               node_ptr;
+
+    typedef btree_iterator<T>            iterator;
+    typedef btree_const_iterator<T>      const_iterator;
+    typedef const_iterator               self;
+
+    using btree_iterator_base<T>::node;
+    using btree_iterator_base<T>::position;
+
+    // 构造函数
+    btree_const_iterator() {}
+    btree_const_iterator(node_ptr n, int pos) : btree_iterator_base<T>(n, pos) {}
+    btree_const_iterator(const iterator& rhs) : btree_iterator_base<T>(rhs.node, rhs.position) {}
+    btree_const_iterator(const const_iterator& rhs) : btree_iterator_base<T>(rhs.node, rhs.position) {}
+    const_iterator& operator=(const const_iterator&) noexcept = default;
+
+    // 重载操作符
+    reference operator*()  const { return node->value(position); }
+    pointer   operator->() const { return &(operator*()); }
+
+    self& operator++()
+    {
+        this->inc();
+        return *this;
+    }
+    self operator++(int)
+    {
+        self tmp(*this);
+        this->inc();
+        return tmp;
+    }
+    self& operator--()
+    {
+        this->dec();
+        return *this;
+    }
+    self operator--(int)
+    {
+        self tmp(*this);
+        this->dec();
+        return tmp;
+    }
+};
+
+// 模板类 btree
+// 参数一代表数据类型，参数二代表键值比较类型，参数三代表空间配置器类型
+// 接口与 rb_tree 相同(没有节点句柄相关的操作)，元素只存放在节点的槽中，新元素总是插入叶节点
+template <class T, class Compare, class Alloc = orange_stl::allocator<T>>
+class btree
+{
+public:
+    typedef btree_value_traits<T>                           value_traits;
+
+    typedef typename value_traits::key_type                 key_type;
+    typedef typename value_traits::mapped_type              mapped_type;
+    typedef typename value_traits::value_type               value_type;
+    typedef Compare                                         key_compare;
+
+    typedef btree_node<T>                                   node_type;
+    typedef btree_node<T>*                                  node_ptr;
+    typedef btree_internal_node<T>                          internal_type;
+
+    typedef Alloc                                                     allocator_type;
+    typedef typename Alloc::template rebind<T>::other                 data_allocator;
+    typedef typename Alloc::template rebind<node_type>::other         leaf_allocator;
+    typedef typename Alloc::template rebind<internal_type>::other     internal_allocator;
+
+    typedef typename data_allocator::pointer                pointer;
+    typedef typename data_allocator::const_pointer          const_pointer;
+    typedef typename data_allocator::reference              reference;
+    typedef typename data_allocator::const_reference        const_reference;
+    typedef typename data_allocator::size_type              size_type;
+    typedef typename data_allocator::difference_type        difference_type;
+
+    typedef btree_iterator<T>                               iterator;
+    typedef btree_const_iterator<T>                         const_iterator;
+    typedef orange_stl::reverse_iterator<iterator>          reverse_iterator;
+    typedef orange_stl::reverse_iterator<const_iterator>    const_reverse_iterator;
+
+    allocator_type  get_allocator() const { return allocator_type(); }
+    key_compare     key_comp()      const { return key_comp_; }
+
+private:
+    enum
+    {
+        capacity  = node_type::capacity,     // 每个节点最多的元素个数
+        min_count = node_type::capacity / 2  // 删除后元素少于 min_count 的非根节点与兄弟节点合并或者借入元素
+    };
+
+    node_ptr    root_;
+    node_ptr    leftmost_;      // 最左的叶节点
+    node_ptr    rightmost_;     // 最右的叶节点
+    size_type   size_;
+    key_compare key_comp_;
+
+public:
+    // 构造、复制、析构函数
+    btree() : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0), key_comp_()
+    { }
+
+    btree(const btree& rhs);
+    btree(btree&& rhs) noexcept;
+
+    btree& operator=(const btree& rhs);
+    btree& operator=(btree&& rhs);
+
+    ~btree() { clear(); }
+
+public:
+    /* 迭代器相关的操作 */
+    iterator       begin()        noexcept { return iterator(leftmost_, 0); }
+    const_iterator begin()  const noexcept { return const_iterator(leftmost_, 0); }
+    iterator       end()          noexcept { return iterator(rightmost_, end_position()); }
+    const_iterator end()    const noexcept { return const_iterator(rightmost_, end_position()); }
+
+    reverse_iterator       rbegin()       noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()         noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()   const noexcept { return const_reverse_iterator(begin()); }
+
+    /* 容量相关的操作 */
+    bool      empty()    const noexcept { return size_ == 0; }
+    size_type size()     const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    /* 插入相关的操作 */
+    template <class ...Args>
+    iterator emplace_multi(Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_multi(orange_stl::move(value));
+    }
+
+    template <class ...Args>
+    orange_stl::pair<iterator, bool> emplace_unique(Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_unique(orange_stl::move(value));
+    }
+
+    template <class ...Args>
+    iterator emplace_multi_use_hint(iterator hint, Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_multi(hint, orange_stl::move(value));
+    }
+
+    template <class ...Args>
+    iterator emplace_unique_use_hint(iterator hint, Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_unique(hint, orange_stl::move(value));
+    }
+
+    /* insert */
+    iterator insert_multi(const value_type& value)
+    {
+        return insert_multi_value(value);
+    }
+    iterator insert_multi(value_type&& value)
+    {
+        return insert_multi_value(orange_stl::move(value));
+    }
+
+    iterator insert_multi(iterator hint, const value_type& value)
+    {
+        return insert_multi_hint(hint, value);
+    }
+    iterator insert_multi(iterator hint, value_type&& value)
+    {
+        return insert_multi_hint(hint, orange_stl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert_multi(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+            insert_multi(end(), *first);
+    }
+
+    orange_stl::pair<iterator, bool> insert_unique(const value_type& value)
+    {
+        return insert_unique_value(value);
+    }
+    orange_stl::pair<iterator, bool> insert_unique(value_type&& value)
+    {
+        return insert_unique_value(orange_stl::move(value));
+    }
+
+    iterator insert_unique(iterator hint, const value_type& value)
+    {
+        return insert_unique_hint(hint, value);
+    }
+    iterator insert_unique(iterator hint, value_type&& value)
+    {
+        return insert_unique_hint(hint, orange_stl::move(value));
+    }
+
+    // 输入有序时每个元素都以 end() 为提示追加到最右叶节点，整体为线性时间
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+            insert_unique(end(), *first);
+    }
+
+    /* 一次查找完成的插入，供 btree_map 使用，value_type 须为 pair<const key, mapped> */
+    template <class K, class ...Args>
+    orange_stl::pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args)
+    {
+        auto res = find_insert_unique_pos(key);
+        if (!res.second)
+            return orange_stl::make_pair(res.first, false);
+        return orange_stl::make_pair(insert_at(res.first.node, res.first.position,
+                                               orange_stl::piecewise_construct,
+                                               std::forward_as_tuple(orange_stl::forward<K>(key)),
+                                               std::forward_as_tuple(orange_stl::forward<Args>(args)...)), true);
+    }
+
+    template <class K, class V>
+    orange_stl::pair<iterator, bool> insert_or_assign_unique(K&& key, V&& obj)
+    {
+        auto res = find_insert_unique_pos(key);
+        if (!res.second)
+        {
+            res.first->second = orange_stl::forward<V>(obj);
+            return orange_stl::make_pair(res.first, false);
+        }
+        return orange_stl::make_pair(insert_at(res.first.node, res.first.position,
+                                               orange_stl::piecewise_construct,
+                                               std::forward_as_tuple(orange_stl::forward<K>(key)),
+                                               std::forward_as_tuple(orange_stl::forward<V>(obj))), true);
+    }
+
+    template <class K, class Factory>
+    orange_stl::pair<iterator, bool> get_or_insert_with_unique(K&& key, Factory&& factory)
+    {
+        auto res = find_insert_unique_pos(key);
+        if (!res.second)
+            return orange_stl::make_pair(res.first, false);
+        return orange_stl::make_pair(insert_at(res.first.node, res.first.position,
+                                               orange_stl::piecewise_construct,
+                                               std::forward_as_tuple(orange_stl::forward<K>(key)),
+                                               std::forward_as_tuple(factory())), true);
+    }
+
+    /* erase，返回被删除元素的下一个位置 */
+    iterator erase(iterator position);
+    iterator erase(iterator first, iterator last);
+
+    size_type erase_multi(const key_type& key);
+    size_type erase_unique(const key_type& key);
+
+    void clear();
+
+    /* 功能性操作 */
+    /* 带有 K 模板参数的重载用于异构查找，只在 Compare 声明了 is_transparent 时参与重载决议 */
+    iterator       find(const key_type& key)       { return find_key<iterator>(key); }
+    const_iterator find(const key_type& key) const { return find_key<const_iterator>(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator       find(const K& key)              { return find_key<iterator>(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator find(const K& key) const        { return find_key<const_iterator>(key); }
+
+    size_type count_multi(const key_type& key) const { return count_multi_key(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    size_type count_multi(const K& key) const { return count_multi_key(key); }
+
+    size_type count_unique(const key_type& key) const { return find(key) != end() ? 1 : 0; }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    size_type count_unique(const K& key) const { return find(key) != end() ? 1 : 0; }
+
+    iterator       lower_bound(const key_type& key)       { return lower_bound_key<iterator>(key); }
+    const_iterator lower_bound(const key_type& key) const { return lower_bound_key<const_iterator>(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator       lower_bound(const K& key)              { return lower_bound_key<iterator>(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator lower_bound(const K& key) const        { return lower_bound_key<const_iterator>(key); }
+
+    iterator       upper_bound(const key_type& key)       { return upper_bound_key<iterator>(key); }
+    const_iterator upper_bound(const key_type& key) const { return upper_bound_key<const_iterator>(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator       upper_bound(const K& key)              { return upper_bound_key<iterator>(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator upper_bound(const K& key) const        { return upper_bound_key<const_iterator>(key); }
+
+    orange_stl::pair<iterator, iterator> equal_range_multi(const key_type& key)
+    {
+        return orange_stl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    orange_stl::pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+    {
+        return orange_stl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<iterator, iterator> equal_range_multi(const K& key)
+    {
+        return orange_stl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<const_iterator, const_iterator> equal_range_multi(const K& key) const
+    {
+        return orange_stl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    orange_stl::pair<iterator, iterator> equal_range_unique(const key_type& key)
+    {
+        return equal_range_unique_key<iterator>(key);
+    }
+    orange_stl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+    {
+        return equal_range_unique_key<const_iterator>(key);
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<iterator, iterator> equal_range_unique(const K& key)
+    {
+        return equal_range_unique_key<iterator>(key);
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+    {
+        return equal_range_unique_key<const_iterator>(key);
+    }
+
+    void swap(btree& rhs) noexcept;
+
+private:
+    int end_position() const noexcept
+    {
+        return rightmost_ == nullptr ? 0 : rightmost_->count;
+    }
+
+    const key_type& key_of(node_ptr n, size_t i) const
+    {
+        return value_traits::get_key(n->value(i));
+    }
+
+    /* 节点内的二分查找 */
+    template <class K>
+    size_t lower_bound_in_node(node_ptr n, const K& key) const
+    {
+        size_t lo = 0, hi = n->count;
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) >> 1;
+            if (key_comp_(key_of(n, mid), key))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    template <class K>
+    size_t upper_bound_in_node(node_ptr n, const K& key) const
+    {
+        size_t lo = 0, hi = n->count;
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) >> 1;
+            if (key_comp_(key, key_of(n, mid)))
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        return lo;
+    }
+
+    /* 查找相关操作，K 为 key_type 或者透明比较函数接受的其他类型 */
+    template <class Iter, class K>
+    Iter find_key(const K& key) const;
+    template <class Iter, class K>
+    Iter lower_bound_key(const K& key) const;
+    template <class Iter, class K>
+    Iter upper_bound_key(const K& key) const;
+    template <class K>
+    size_type count_multi_key(const K& key) const;
+    template <class Iter, class K>
+    orange_stl::pair<Iter, Iter> equal_range_unique_key(const K& key) const
+    {
+        Iter it = find_key<Iter>(key);
+        Iter next = it;
+        return it == Iter(end()) ? orange_stl::make_pair(it, it) : orange_stl::make_pair(it, ++next);
+    }
+
+    /* 叶节点中的位置 (n, count) 表示该叶节点之后的元素，把它换成实际指向元素的迭代器 */
+    iterator internal_last(iterator it) const;
+
+    /* 键值不允许重复时新元素应在的叶节点位置，键值已存在时返回 (已有元素, false) */
+    template <class K>
+    orange_stl::pair<iterator, bool> find_insert_unique_pos(const K& key);
+    template <class K>
+    iterator find_insert_multi_pos(const K& key);
+
+    /* 把一个合法的插入位置换成叶节点中的位置：内部节点元素之前的位置等于其前驱之后的位置 */
+    iterator leaf_position(iterator pos);
+
+    template <class V>
+    orange_stl::pair<iterator, bool> insert_unique_value(V&& value);
+    template <class V>
+    iterator insert_multi_value(V&& value);
+    template <class V>
+    iterator insert_unique_hint(iterator hint, V&& value);
+    template <class V>
+    iterator insert_multi_hint(iterator hint, V&& value);
+
+    /* 节点相关操作 */
+    node_ptr create_leaf();
+    node_ptr create_internal();
+    void     destroy_node(node_ptr n) noexcept;
+    void     destroy_subtree(node_ptr n) noexcept;
+    void     move_value(node_ptr dst, size_t i, node_ptr src, size_t j);
+    void     reset_edges();
+
+    template <class ...Args>
+    iterator insert_at(node_ptr n, size_t i, Args&& ...args);
+    void     split(node_ptr& n, size_t& i);
+
+    iterator rebalance_after_erase(iterator it);
+    void     merge_nodes(node_ptr left, iterator& it);
+    void     rotate_from_right(node_ptr n, iterator& it);
+    void     rotate_from_left(node_ptr n, iterator& it);
+
+    void copy_from(const btree& rhs);
+};
+
+/*****************************************************************************************/
+
+/* 复制构造函数，按顺序追加元素，新树的节点几乎是满的 */
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>::btree(const btree& rhs)
+    : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0), key_comp_(rhs.key_comp_)
+{
+    copy_from(rhs);
+}
+
+/* 移动构造函数 */
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>::btree(btree&& rhs) noexcept
+    : root_(rhs.root_), leftmost_(rhs.leftmost_), rightmost_(rhs.rightmost_),
+      size_(rhs.size_), key_comp_(rhs.key_comp_)
+{
+    rhs.root_ = rhs.leftmost_ = rhs.rightmost_ = nullptr;
+    rhs.size_ = 0;
+}
+
+/* 复制赋值操作符 */
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>& btree<T, Compare, Alloc>::operator=(const btree& rhs)
+{
+    if (this != &rhs)
+    {
+        clear();
+        key_comp_ = rhs.key_comp_;
+        copy_from(rhs);
+    }
+    return *this;
+}
+
+/* 移动赋值操作符 */
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>& btree<T, Compare, Alloc>::operator=(btree&& rhs)
+{
+    if (this != &rhs)
+    {
+        clear();
+        root_ = rhs.root_;
+        leftmost_ = rhs.leftmost_;
+        rightmost_ = rhs.rightmost_;
+        size_ = rhs.size_;
+        key_comp_ = rhs.key_comp_;
+        rhs.root_ = rhs.leftmost_ = rhs.rightmost_ = nullptr;
+        rhs.size_ = 0;
+    }
+    return *this;
+}
+
+/* 删除 position 处的元素，返回其后继 */
+/* 内部节点的元素先用前驱(左子树中最大的元素，位于叶节点)替换，这样总是从叶节点中删除 */
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::erase(iterator position)
+{
+    node_ptr n = position.node;
+    size_t i = static_cast<size_t>(position.position);
+    const bool internal = !n->leaf;
+    data_allocator::destroy(&n->value(i));
+    if (internal)
+    {
+        node_ptr l = n->child(i);
+        while (!l->leaf)
+            l = l->child(l->count);
+        move_value(n, i, l, l->count - 1);
+        n = l;
+        i = l->count - 1;
+    }
+    for (size_t k = i + 1; k < n->count; ++k)
+        move_value(n, k - 1, n, k);
+    --n->count;
+    --size_;
+
+    iterator res = internal_last(rebalance_after_erase(iterator(n, static_cast<int>(i))));
+    // 被删除的是内部节点的元素时，res 指向顶替它的前驱
+    if (internal)
+        ++res;
+    return res;
+}
+
+/* 删除 [first, last) 内的元素，删除会使 last 失效，因此先数出个数 */
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::erase(iterator first, iterator last)
+{
+    if (first == begin() && last == end())
+    {
+        clear();
+        return end();
+    }
+    for (size_type n = orange_stl::distance(first, last); n > 0; --n)
+        first = erase(first);
+    return first;
+}
+
+/* 删除键值等于 key 的元素，返回删除的个数 */
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::erase_multi(const key_type& key)
+{
+    iterator first = lower_bound(key);
+    const size_type n = orange_stl::distance(first, upper_bound(key));
+    for (size_type k = n; k > 0; --k)
+        first = erase(first);
+    return n;
+}
+
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::erase_unique(const key_type& key)
+{
+    iterator it = find(key);
+    if (it == end())
+        return 0;
+    erase(it);
+    return 1;
+}
+
+/* 清空 btree */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::clear()
+{
+    if (root_ != nullptr)
+    {
+        destroy_subtree(root_);
+        root_ = leftmost_ = rightmost_ = nullptr;
+        size_ = 0;
+    }
+}
+
+/* 交换 btree */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::swap(btree& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        orange_stl::swap(root_, rhs.root_);
+        orange_stl::swap(leftmost_, rhs.leftmost_);
+        orange_stl::swap(rightmost_, rhs.rightmost_);
+        orange_stl::swap(size_, rhs.size_);
+        orange_stl::swap(key_comp_, rhs.key_comp_);
+    }
+}
+
+/*****************************************************************************************/
+// helper function
+
+/* 查找，内部节点中遇到相等的元素时直接返回 */
+template <class T, class Compare, class Alloc>
+template <class Iter, class K>
+Iter btree<T, Compare, Alloc>::find_key(const K& key) const
+{
+    node_ptr n = root_;
+    while (n != nullptr)
+    {
+        const size_t i = lower_bound_in_node(n, key);
+        if (i < n->count && !key_comp_(key, key_of(n, i)))
+            return Iter(n, static_cast<int>(i));
+        n = n->leaf ? nullptr : n->child(i);
+    }
+    return Iter(end());
+}
+
+/* lower_bound 与 upper_bound 一直下降到叶节点，键值允许重复时也能找到第一个(最后一个之后的)位置 */
+template <class T, class Compare, class Alloc>
+template <class Iter, class K>
+Iter btree<T, Compare, Alloc>::lower_bound_key(const K& key) const
+{
+    node_ptr n = root_;
+    if (n == nullptr)
+        return Iter(end());
+    size_t i = lower_bound_in_node(n, key);
+    while (!n->leaf)
+    {
+        n = n->child(i);
+        i = lower_bound_in_node(n, key);
+    }
+    return Iter(internal_last(iterator(n, static_cast<int>(i))));
+}
+
+template <class T, class Compare, class Alloc>
+template <class Iter, class K>
+Iter btree<T, Compare, Alloc>::upper_bound_key(const K& key) const
+{
+    node_ptr n = root_;
+    if (n == nullptr)
+        return Iter(end());
+    size_t i = upper_bound_in_node(n, key);
+    while (!n->leaf)
+    {
+        n = n->child(i);
+        i = upper_bound_in_node(n, key);
+    }
+    return Iter(internal_last(iterator(n, static_cast<int>(i))));
+}
+
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::count_multi_key(const K& key) const
+{
+    return static_cast<size_type>(orange_stl::distance(lower_bound_key<const_iterator>(key),
+                                                       upper_bound_key<const_iterator>(key)));
+}
+
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::internal_last(iterator it) const
+{
+    while (it.node != nullptr && it.position == it.node->count && it.node->parent != nullptr)
+    {
+        it.position = it.node->position;
+        it.node = it.node->parent;
+    }
+    if (it.node == nullptr || it.position == it.node->count)
+        return iterator(rightmost_, end_position());
+    return it;
+}
+
+template <class T, class Compare, class Alloc>
+template <class K>
+orange_stl::pair<typename btree<T, Compare, Alloc>::iterator, bool>
+btree<T, Compare, Alloc>::find_insert_unique_pos(const K& key)
+{
+    node_ptr n = root_;
+    if (n == nullptr)
+        return orange_stl::make_pair(iterator(nullptr, 0), true);
+    for (;;)
+    {
+        const size_t i = lower_bound_in_node(n, key);
+        if (i < n->count && !key_comp_(key, key_of(n, i)))
+            return orange_stl::make_pair(iterator(n, static_cast<int>(i)), false);
+        if (n->leaf)
+            return orange_stl::make_pair(iterator(n, static_cast<int>(i)), true);
+        n = n->child(i);
+    }
+}
+
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::find_insert_multi_pos(const K& key)
+{
+    node_ptr n = root_;
+    if (n == nullptr)
+        return iterator(nullptr, 0);
+    size_t i = upper_bound_in_node(n, key);
+    while (!n->leaf)
+    {
+        n = n->child(i);
+        i = upper_bound_in_node(n, key);
+    }
+    return iterator(n, static_cast<int>(i));
+}
+
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::leaf_position(iterator pos)
+{
+    if (pos.node == nullptr || pos.node->leaf)
+        return pos;
+    --pos;
+    ++pos.position;
+    return pos;
+}
+
+template <class T, class Compare, class Alloc>
+template <class V>
+orange_stl::pair<typename btree<T, Compare, Alloc>::iterator, bool>
+btree<T, Compare, Alloc>::insert_unique_value(V&& value)
+{
+    auto res = find_insert_unique_pos(value_traits::get_key(value));
+    if (!res.second)
+        return res;
+    return orange_stl::make_pair(insert_at(res.first.node, res.first.position, orange_stl::forward<V>(value)), true);
+}
+
+template <class T, class Compare, class Alloc>
+template <class V>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::insert_multi_value(V&& value)
+{
+    iterator pos = find_insert_multi_pos(value_traits::get_key(value));
+    return insert_at(pos.node, pos.position, orange_stl::forward<V>(value));
+}
+
+/* 提示位置与键值相符时直接在该处插入，否则退化为普通插入 */
+template <class T, class Compare, class Alloc>
+template <class V>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::insert_unique_hint(iterator hint, V&& value)
+{
+    const key_type& key = value_traits::get_key(value);
+    iterator prev = hint;
+    if ((hint == begin() || key_comp_(value_traits::get_key(*--prev), key)) &&
+        (hint == end() || key_comp_(key, value_traits::get_key(*hint))))
+    {
+        hint = leaf_position(hint);
+        return insert_at(hint.node, hint.position, orange_stl::forward<V>(value));
+    }
+    return insert_unique_value(orange_stl::forward<V>(value)).first;
+}
+
+template <class T, class Compare, class Alloc>
+template <class V>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::insert_multi_hint(iterator hint, V&& value)
+{
+    const key_type& key = value_traits::get_key(value);
+    iterator prev = hint;
+    if ((hint == begin() || !key_comp_(key, value_traits::get_key(*--prev))) &&
+        (hint == end() || !key_comp_(value_traits::get_key(*hint), key)))
+    {
+        hint = leaf_position(hint);
+        return insert_at(hint.node, hint.position, orange_stl::forward<V>(value));
+    }
+    return insert_multi_value(orange_stl::forward<V>(value));
+}
+
+/* 创建节点，元素槽保持未初始化 */
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::node_ptr
+btree<T, Compare, Alloc>::create_leaf()
+{
+    node_ptr n = leaf_allocator::allocate(1);
+    n->parent = nullptr;
+    n->position = 0;
+    n->count = 0;
+    n->leaf = true;
+    return n;
+}
+
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::node_ptr
+btree<T, Compare, Alloc>::create_internal()
+{
+    node_ptr n = internal_allocator::allocate(1);
+    n->parent = nullptr;
+    n->position = 0;
+    n->count = 0;
+    n->leaf = false;
+    return n;
+}
+
+/* 释放节点，不析构其中的元素 */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::destroy_node(node_ptr n) noexcept
+{
+    if (n->leaf)
+        leaf_allocator::deallocate(n);
+    else
+        internal_allocator::deallocate(static_cast<internal_type*>(n));
+}
+
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::destroy_subtree(node_ptr n) noexcept
+{
+    if (!n->leaf)
+    {
+        for (size_t i = 0; i <= n->count; ++i)
+            destroy_subtree(n->child(i));
+    }
+    data_allocator::destroy(&n->value(0), &n->value(0) + n->count);
+    destroy_node(n);
+}
+
+/* 把 src 第 j 个槽的元素移到 dst 第 i 个槽(未初始化)，src 的槽随后变为未初始化 */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::move_value(node_ptr dst, size_t i, node_ptr src, size_t j)
+{
+    data_allocator::construct(&dst->value(i), orange_stl::move(src->value(j)));
+    data_allocator::destroy(&src->value(j));
+}
+
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::reset_edges()
+{
+    node_ptr n = root_;
+    while (!n->leaf)
+        n = n->child(0);
+    leftmost_ = n;
+    n = root_;
+    while (!n->leaf)
+        n = n->child(n->count);
+    rightmost_ = n;
+}
+
+/* 在叶节点 n 的第 i 个位置构造新元素，n 已满时先分裂 */
+template <class T, class Compare, class Alloc>
+template <class ...Args>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::insert_at(node_ptr n, size_t i, Args&& ...args)
+{
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "btree<T, Comp>'s size too big");
+    if (root_ == nullptr)
+    {
+        root_ = leftmost_ = rightmost_ = create_leaf();
+        n = root_;
+        i = 0;
+    }
+    else if (n->count == capacity)
+    {
+        split(n, i);
+    }
+    for (size_t k = n->count; k > i; --k)
+        move_value(n, k, n, k - 1);
+    try
+    {
+        data_allocator::construct(&n->value(i), orange_stl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        for (size_t k = i; k < n->count; ++k)
+            move_value(n, k, n, k + 1);
+        if (size_ == 0)
+        {
+            destroy_node(root_);
+            root_ = leftmost_ = rightmost_ = nullptr;
+        }
+        throw;
+    }
+    ++n->count;
+    ++size_;
+    return iterator(n, static_cast<int>(i));
+}
+
+/* 分裂已满的节点 n，中间的元素上移到父节点，父节点已满时先分裂父节点 */
+/* i 为即将插入的位置，分裂后更新为新元素所在的节点与位置 */
+/* 在节点的两端插入时偏向一侧分裂，顺序插入时节点几乎是满的；两侧至少各留一个元素 */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::split(node_ptr& n, size_t& i)
+{
+    node_ptr parent = n->parent;
+    if (parent == nullptr)
+    {
+        parent = create_internal();
+        parent->set_child(0, n);
+        root_ = parent;
+    }
+    else if (parent->count == capacity)
+    {
+        size_t pi = n->position;
+        split(parent, pi);
+        parent = n->parent;
+    }
+
+    const size_t mid = i == static_cast<size_t>(capacity) ? capacity - 2 : (i == 0 ? 1 : capacity / 2);
+    node_ptr right = n->leaf ? create_leaf() : create_internal();
+    for (size_t k = mid + 1; k < capacity; ++k)
+        move_value(right, k - mid - 1, n, k);
+    right->count = static_cast<unsigned short>(capacity - mid - 1);
+    if (!n->leaf)
+    {
+        for (size_t k = mid + 1; k <= capacity; ++k)
+            right->set_child(k - mid - 1, n->child(k));
+    }
+
+    // 中间的元素成为父节点的第 p 个元素，right 成为第 p + 1 个子节点
+    const size_t p = n->position;
+    for (size_t k = parent->count; k > p; --k)
+        move_value(parent, k, parent, k - 1);
+    move_value(parent, p, n, mid);
+    for (size_t k = parent->count + 1; k > p + 1; --k)
+        parent->set_child(k, parent->child(k - 1));
+    parent->set_child(p + 1, right);
+    ++parent->count;
+    n->count = static_cast<unsigned short>(mid);
+
+    if (rightmost_ == n)
+        rightmost_ = right;
+    if (i > mid)
+    {
+        n = right;
+        i -= mid + 1;
+    }
+}
+
+/* 从叶节点删除元素后自下而上修复元素过少的节点，it 为删除的位置，返回它在调整之后对应的位置 */
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::rebalance_after_erase(iterator it)
+{
+    node_ptr n = it.node;
+    bool merged = false;
+    for (;;)
+    {
+        if (n == root_)
+        {
+            if (n->count == 0)
+            {
+                if (n->leaf)
+                {
+                    destroy_node(n);
+                    root_ = leftmost_ = rightmost_ = nullptr;
+                    return end();
+                }
+                // 根节点的两个子节点刚刚合并，树高减一；指向旧根的位置只能是末尾
+                root_ = n->child(0);
+                root_->parent = nullptr;
+                root_->position = 0;
+                destroy_node(n);
+                reset_edges();
+                return it.node == n ? end() : it;
+            }
+            break;
+        }
+        if (n->count >= min_count)
+            break;
+        node_ptr parent = n->parent;
+        const size_t p = n->position;
+        if (p > 0 && parent->child(p - 1)->count + n->count + 1 <= capacity)
+        {
+            merge_nodes(parent->child(p - 1), it);
+        }
+        else if (p < parent->count && n->count + parent->child(p + 1)->count + 1 <= capacity)
+        {
+            merge_nodes(n, it);
+        }
+        else
+        {
+            if (p < parent->count)
+                rotate_from_right(n, it);
+            else
+                rotate_from_left(n, it);
+            break;
+        }
+        merged = true;
+        n = parent;
+    }
+    if (merged)
+        reset_edges();
+    return it;
+}
+
+/* 把 left 右侧的兄弟节点连同父节点中的分隔元素并入 left，并释放右侧的节点 */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::merge_nodes(node_ptr left, iterator& it)
+{
+    node_ptr parent = left->parent;
+    const size_t s = left->position;
+    node_ptr right = parent->child(s + 1);
+    const size_t lc = left->count;
+
+    move_value(left, lc, parent, s);
+    for (size_t k = 0; k < right->count; ++k)
+        move_value(left, lc + 1 + k, right, k);
+    if (!left->leaf)
+    {
+        for (size_t k = 0; k <= right->count; ++k)
+            left->set_child(lc + 1 + k, right->child(k));
+    }
+    left->count = static_cast<unsigned short>(lc + 1 + right->count);
+
+    for (size_t k = s + 1; k < parent->count; ++k)
+        move_value(parent, k - 1, parent, k);
+    for (size_t k = s + 2; k <= parent->count; ++k)
+        parent->set_child(k - 1, parent->child(k));
+    --parent->count;
+
+    if (it.node == right)
+    {
+        it.node = left;
+        it.position += static_cast<int>(lc + 1);
+    }
+    else if (it.node == parent && it.position >= static_cast<int>(s))
+    {
+        if (it.position == static_cast<int>(s))
+        {
+            it.node = left;
+            it.position = static_cast<int>(lc);
+        }
+        else
+        {
+            --it.position;
+        }
+    }
+    right->count = 0;
+    destroy_node(right);
+}
+
+/* 从右侧的兄弟节点经父节点借入元素，使两者的元素个数接近 */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::rotate_from_right(node_ptr n, iterator& it)
+{
+    node_ptr parent = n->parent;
+    const size_t s = n->position;
+    node_ptr right = parent->child(s + 1);
+    const size_t nc = n->count;
+    const size_t rc = right->count;
+    size_t to_move = (rc - nc) / 2;
+    if (to_move == 0)
+        to_move = 1;
+
+    move_value(n, nc, parent, s);
+    for (size_t k = 0; k + 1 < to_move; ++k)
+        move_value(n, nc + 1 + k, right, k);
+    move_value(parent, s, right, to_move - 1);
+    for (size_t k = to_move; k < rc; ++k)
+        move_value(right, k - to_move, right, k);
+    if (!n->leaf)
+    {
+        for (size_t k = 0; k < to_move; ++k)
+            n->set_child(nc + 1 + k, right->child(k));
+        for (size_t k = to_move; k <= rc; ++k)
+            right->set_child(k - to_move, right->child(k));
+    }
+    n->count = static_cast<unsigned short>(nc + to_move);
+    right->count = static_cast<unsigned short>(rc - to_move);
+
+    if (it.node == right)
+    {
+        const int q = it.position;
+        const int m = static_cast<int>(to_move);
+        if (q >= m)
+        {
+            it.position = q - m;
+        }
+        else if (q == m - 1)
+        {
+            it.node = parent;
+            it.position = static_cast<int>(s);
+        }
+        else
+        {
+            it.node = n;
+            it.position = static_cast<int>(nc) + 1 + q;
+        }
+    }
+    else if (it.node == parent && it.position == static_cast<int>(s))
+    {
+        it.node = n;
+        it.position = static_cast<int>(nc);
+    }
+}
+
+/* 从左侧的兄弟节点经父节点借入元素，使两者的元素个数接近 */
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::rotate_from_left(node_ptr n, iterator& it)
+{
+    node_ptr parent = n->parent;
+    const size_t s = n->position - 1;
+    node_ptr left = parent->child(s);
+    const size_t nc = n->count;
+    const size_t lc = left->count;
+    size_t to_move = (lc - nc) / 2;
+    if (to_move == 0)
+        to_move = 1;
+    const size_t keep = lc - to_move;
+
+    for (size_t k = nc; k > 0; --k)
+        move_value(n, k - 1 + to_move, n, k - 1);
+    move_value(n, to_move - 1, parent, s);
+    for (size_t k = keep + 1; k < lc; ++k)
+        move_value(n, k - keep - 1, left, k);
+    move_value(parent, s, left, keep);
+    if (!n->leaf)
+    {
+        for (size_t k = nc + 1; k > 0; --k)
+            n->set_child(k - 1 + to_move, n->child(k - 1));
+        for (size_t k = keep + 1; k <= lc; ++k)
+            n->set_child(k - keep - 1, left->child(k));
+    }
+    n->count = static_cast<unsigned short>(nc + to_move);
+    left->count = static_cast<unsigned short>(keep);
+
+    if (it.node == n)
+    {
+        it.position += static_cast<int>(to_move);
+    }
+    else if (it.node == left && it.position >= static_cast<int>(keep))
+    {
+        if (it.position == static_cast<int>(keep))
+        {
+            it.node = parent;
+            it.position = static_cast<int>(s);
+        }
+        else
+        {
+            it.node = n;
+            it.position -= static_cast<int>(keep) + 1;
+        }
+    }
+    else if (it.node == parent && it.position == static_cast<int>(s))
+    {
+        it.node = n;
+        it.position = static_cast<int>(to_move) - 1;
+    }
+}
+
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::copy_from(const btree& rhs)
+{
+    try
+    {
+        for (const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+            insert_at(rightmost_, end_position(), *it);
+    }
+    catch (...)
+    {
+        clear();
+        throw;
+    }
+}
+
+// 重载比较操作符
+template <class T, class Compare, class Alloc>
+bool operator==(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() && orange_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Compare, class Alloc>
+bool operator<(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+    return orange_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Compare, class Alloc>
+bool operator!=(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, class Compare, class Alloc>
+bool operator>(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, class Compare, class Alloc>
+bool operator<=(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, class Compare, class Alloc>
+bool operator>=(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 orange_stl 的 swap
+template <class T, class Compare, class Alloc>
+void swap(btree<T, Compare, Alloc>& lhs, btree<T, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_BTREE_H__
@@ -0,0 +1,810 @@
+#ifndef __ORANGE_BTREE_MAP_H__
+#define __ORANGE_BTREE_MAP_H__
+
+// 这个头文件包含两个模板类 btree_map 和 btree_multimap
+// 接口与 map/multimap 相同(没有节点句柄相关的操作)，不同的是使用 btree 作为底层实现机制：
+// 一个节点存放多个元素，查找时的缓存未命中少得多，小元素的内存占用也更少
+// 插入和删除会移动元素，使迭代器、指针和引用失效，因此 erase 返回被删除元素的下一个位置
+
+#include "orange_btree.h"
+
+namespace orange_stl
+{
+
+// 模板类btree_map，键值不允许重复
+// 参数一表示键值类型，参数二表示实值类型，参数三表示键值的比较方式，默认less，参数四表示空间配置器类型
+template <class Key, class T, class Compare=orange_stl::less<Key>,
+          class Alloc=orange_stl::allocator<orange_stl::pair<const Key, T>>>
+class btree_map
+{
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef orange_stl::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+
+    /* 定义一个fun用来进行元素的比较 */
+    class value_compare : public binary_function<value_type, value_type, bool>
+    {
+        friend class btree_map<Key, T, Compare, Alloc>;
+    private:
+        Compare comp;
+        value_compare(Compare c):comp(c){}
+    public:
+        bool operator()(const value_type& lhs, const value_type& rhs) noexcept
+        {
+            return comp(lhs.first, rhs.first);  //比较键值的大小
+        }
+    };
+private:
+    typedef orange_stl::btree<value_type, key_compare, Alloc> base_type;
+    base_type tree_;
+
+public:
+    typedef typename base_type::pointer                pointer;
+    typedef typename base_type::const_pointer          const_pointer;
+    typedef typename base_type::reference              reference;
+    typedef typename base_type::const_reference        const_reference;
+    typedef typename base_type::iterator               iterator;
+    typedef typename base_type::const_iterator         const_iterator;
+    typedef typename base_type::reverse_iterator       reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type              size_type;
+    typedef typename base_type::difference_type        difference_type;
+    typedef typename base_type::allocator_type         allocator_type;
+
+public:
+    /* 构造，复制和移动函数 */
+    btree_map()=default;
+    
+    template <class InputIterator>
+    btree_map(InputIterator first, InputIterator last):tree_()
+    {
+        tree_.insert_unique(first, last);
+    }
+
+    btree_map(const btree_map& rhs) : tree_(rhs.tree_)
+    { }
+
+    btree_map(btree_map&& rhs) noexcept : tree_(orange_stl::move(rhs.tree_))
+    { }
+
+    btree_map& operator=(const btree_map& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    btree_map& operator=(btree_map&& rhs)
+    {
+        tree_=orange_stl::move(rhs.tree_);
+        return *this;
+    }
+    btree_map& operator=(std::initializer_list<value_type> ilist)
+    {
+        tree_.clear();
+        tree_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    /* 相关接口 */
+    key_compare key_comp() const
+    {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const
+    {
+        return value_compare(tree_.key_comp());
+    }
+    allocator_type get_allocator() const
+    {
+        return tree_.get_allocator();
+    }
+
+    /* 迭代器相关 */
+    iterator begin() noexcept
+    {
+        return tree_.begin();
+    }
+    const_iterator begin() const noexcept
+    { 
+        return tree_.begin(); 
+    }
+    iterator end() noexcept
+    { 
+        return tree_.end(); 
+    }
+    const_iterator end() const noexcept
+    { 
+        return tree_.end(); 
+    }
+    reverse_iterator rbegin() noexcept
+    { 
+        return reverse_iterator(end()); 
+    }
+    const_reverse_iterator rbegin()  const noexcept
+    { 
+        return const_reverse_iterator(end()); 
+    }
+    reverse_iterator rend() noexcept
+    { 
+        return reverse_iterator(begin()); 
+    }
+    const_reverse_iterator rend() const noexcept
+    { 
+        return const_reverse_iterator(begin()); 
+    }
+    const_iterator cbegin() const noexcept
+    { 
+        return begin(); 
+    }
+    const_iterator cend() const noexcept
+    { 
+        return end(); 
+    }
+    const_reverse_iterator crbegin() const noexcept
+    { 
+        return rbegin(); 
+    }
+    const_reverse_iterator crend() const noexcept
+    { 
+        return rend(); 
+    }
+
+    /* 容量相关 */
+    bool empty() const noexcept
+    {
+        return tree_.empty();
+    }
+    size_type size() const noexcept
+    {
+        return tree_.size();
+    }
+    size_type max_size() const noexcept
+    {
+        return tree_.max_size();
+    }
+
+    // 访问元素
+    // 若键值不存在，抛出异常
+    mapped_type& at(const key_type& key)
+    {
+        iterator it = lower_bound(key);
+        // 大于等于key的第一个元素
+        THROW_OUT_OF_RANGE_IF(it==end() || key_comp()(it->first, key),
+                                "btree_map<key, T> no such element exists");
+        return it->second;
+    }
+
+    const mapped_type& at(const key_type& key) const
+    {
+        const_iterator it = lower_bound(key);
+        THROW_OUT_OF_RANGE_IF(it==end() || key_comp()(it->first, key),
+                                "btree_map<key, T> no such element exists");
+        return it->second;
+    }
+
+    mapped_type& operator[](const key_type& key)
+    {
+        return tree_.try_emplace_unique(key).first->second;
+    }
+    mapped_type& operator[](key_type&& key)
+    {
+        return tree_.try_emplace_unique(orange_stl::move(key)).first->second;
+    }
+
+    /* 键值不存在时插入，否则返回已有的元素，只查找一次 */
+    /* 插入失败时不会移动 key 与 args */
+    template <class ...Args>
+    pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+    {
+        return tree_.try_emplace_unique(key, orange_stl::forward<Args>(args)...);
+    }
+    template <class ...Args>
+    pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+    {
+        return tree_.try_emplace_unique(orange_stl::move(key), orange_stl::forward<Args>(args)...);
+    }
+
+    /* 键值不存在时插入，否则赋值 */
+    template <class M>
+    pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+        return tree_.insert_or_assign_unique(key, orange_stl::forward<M>(obj));
+    }
+    template <class M>
+    pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+    {
+        return tree_.insert_or_assign_unique(orange_stl::move(key), orange_stl::forward<M>(obj));
+    }
+
+    /* 返回 key 对应的值，键值不存在时先插入 factory() 的结果 */
+    template <class Factory>
+    mapped_type& get_or_insert_with(const key_type& key, Factory&& factory)
+    {
+        return tree_.get_or_insert_with_unique(key, orange_stl::forward<Factory>(factory)).first->second;
+    }
+    template <class Factory>
+    mapped_type& get_or_insert_with(key_type&& key, Factory&& factory)
+    {
+        return tree_.get_or_insert_with_unique(orange_stl::move(key),
+                                               orange_stl::forward<Factory>(factory)).first->second;
+    }
+
+    /* 插入删除 */
+    template <class ...Args>
+    pair<iterator, bool> emplace(Args&& ...args)
+    {
+        return tree_.emplace_unique(orange_stl::forward<Args>(args)...);
+    }
+
+    template <class ...Args>
+    iterator emplace_hint(iterator hint, Args&& ...args)
+    {
+        return tree_.emplace_unique_use_hint(hint, orange_stl::forward<Args>(args)...);
+    }
+
+    pair<iterator, bool> insert(const value_type& value)
+    {
+        return tree_.insert_unique(value);
+    }
+    pair<iterator, bool> insert(value_type&& value)
+    {
+        return tree_.insert_unique(orange_stl::move(value));
+    }
+
+    iterator insert(iterator hint, const value_type& value)
+    {
+        return tree_.insert_unique(hint, value);
+    }
+    iterator insert(iterator hint, value_type&& value)
+    {
+        return tree_.insert_unique(hint, orange_stl::move(value));
+    }
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        tree_.insert_unique(first, last);
+    }
+
+    iterator erase(iterator position)
+    {
+        return tree_.erase(position);
+    }
+    size_type erase(const key_type& key)
+    {
+        return tree_.erase_unique(key);
+    }
+    iterator erase(iterator first, iterator last)
+    {
+        return tree_.erase(first, last);
+    }
+
+    void clear()
+    {
+        tree_.clear();
+    }
+
+    /* map的相关操作 */
+    iterator find(const key_type& key)
+    {
+        return tree_.find(key);
+    }
+    const_iterator find(const key_type& key) const
+    {
+        return tree_.find(key);
+    }
+
+    size_type count(const key_type& key) const
+    {
+        return tree_.count_unique(key);
+    }
+
+    iterator lower_bound(const key_type& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    const_iterator lower_bound(const key_type& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+    iterator upper_bound(const key_type& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    const_iterator upper_bound(const key_type& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key)
+    {
+        return tree_.equal_range_unique(key);
+    }
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+        return tree_.equal_range_unique(key);
+    }
+
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_unique(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_unique(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return tree_.equal_range_unique(key);
+    }
+
+    void swap(btree_map& rhs) noexcept
+    {
+        tree_.swap(rhs.tree_);
+    }
+public:
+    friend bool operator==(const btree_map& lhs, const btree_map& rhs)
+    {
+        return lhs.tree_==rhs.tree_;
+    }
+    friend bool operator<(const btree_map& lhs, const btree_map& rhs)
+    {
+        return lhs.tree_<rhs.tree_;
+    }
+};
+
+// 重载比较操作符
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs)
+{
+  return lhs == rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs)
+{
+  return lhs < rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare, class Alloc>
+void swap(btree_map<Key, T, Compare, Alloc>& lhs, btree_map<Key, T, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+
+/* 模板类btree_multimap，键值允许重复 */
+/* 参数一表示键值类型，参数二表示实值类型，参数三代表比较方式，默认less */
+template <class Key, class T, class Compare = orange_stl::less<Key>,
+          class Alloc = orange_stl::allocator<orange_stl::pair<const Key, T>>>
+class btree_multimap
+{
+public:
+    typedef Key key_type;
+    typedef T   mapped_type;
+    typedef orange_stl::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+    /* 定义一个fun用来进行元素的比较 */
+    class value_compare : public binary_function<value_type, value_type, bool>
+    {
+        friend class btree_multimap<Key, T, Compare, Alloc>;
+    private:
+        Compare comp;
+        value_compare(Compare c):comp(c){}
+    public:
+        bool operator()(const value_type& lhs, const value_type& rhs) noexcept
+        {
+            return comp(lhs.first, rhs.first);  //比较键值的大小
+        }
+    };
+private:
+    typedef orange_stl::btree<value_type, key_compare, Alloc> base_type;
+    base_type tree_;
+
+public:
+    typedef typename base_type::pointer                pointer;
+    typedef typename base_type::const_pointer          const_pointer;
+    typedef typename base_type::reference              reference;
+    typedef typename base_type::const_reference        const_reference;
+    typedef typename base_type::iterator               iterator;
+    typedef typename base_type::const_iterator         const_iterator;
+    typedef typename base_type::reverse_iterator       reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type              size_type;
+    typedef typename base_type::difference_type        difference_type;
+    typedef typename base_type::allocator_type         allocator_type;
+
+public:
+    /* 构造复制和移动函数 */
+    btree_multimap() = default;
+
+    template <class InputIterator>
+    btree_multimap(InputIterator first, InputIterator last) : tree_() 
+    { 
+        tree_.insert_multi(first, last); 
+    }
+    btree_multimap(std::initializer_list<value_type> ilist) : tree_() 
+    { 
+        tree_.insert_multi(ilist.begin(), ilist.end()); 
+    }
+
+    btree_multimap(const btree_multimap& rhs):tree_(rhs.tree_)
+    { }
+    btree_multimap(btree_multimap&& rhs) noexcept : tree_(orange_stl::move(rhs.tree_))
+    { }
+
+    btree_multimap& operator=(const btree_multimap& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+
+    btree_multimap& operator=(btree_multimap&& rhs)
+    {
+        tree_ = orange_stl::move(rhs.tree_);
+        return *this;
+    }
+
+    btree_multimap& operator=(std::initializer_list<value_type> ilist)
+    {
+        tree_.clear();
+        tree_.insert_multi(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    /* 相关接口 */
+    key_compare key_comp() const
+    {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const
+    {
+        return value_compare(tree_.key_comp());
+    }
+    allocator_type get_allocator() const
+    {
+        return tree_.get_allocator();
+    }
+
+    /* 迭代器相关 */
+    iterator begin() noexcept
+    { 
+        return tree_.begin(); 
+    }
+    const_iterator begin() const noexcept
+    { 
+        return tree_.begin(); 
+    }
+    iterator end() noexcept
+    { 
+        return tree_.end(); 
+    }
+    const_iterator end() const noexcept
+    { 
+        return tree_.end(); 
+    }
+
+    reverse_iterator rbegin() noexcept
+    { 
+        return reverse_iterator(end()); 
+    }
+    const_reverse_iterator rbegin()  const noexcept
+    { 
+        return const_reverse_iterator(end()); 
+    }
+    reverse_iterator rend() noexcept
+    { 
+        return reverse_iterator(begin()); 
+    }
+    const_reverse_iterator rend()    const noexcept
+    { 
+        return const_reverse_iterator(begin()); 
+    }
+
+    const_iterator cbegin() const noexcept
+    { 
+        return begin(); 
+    }
+    const_iterator cend() const noexcept
+    { 
+        return end(); 
+    }
+    const_reverse_iterator crbegin() const noexcept
+    { 
+        return rbegin(); 
+    }
+    const_reverse_iterator crend()   const noexcept
+    { 
+        return rend(); 
+    }
+
+    /* 容量相关 */
+    bool empty() const noexcept
+    {
+        return tree_.empty();
+    }
+    size_type size() const noexcept
+    {
+        return tree_.size();
+    }
+    size_type max_size() const noexcept
+    {
+        return tree_.max_size();
+    }
+
+    /* 插入删除操作 */
+    template <class ...Args>
+    iterator emplace(Args&& ...args)
+    {
+        return tree_.emplace_multi(orange_stl::forward<Args>(args)...);
+    }
+
+    template <class ...Args>
+    iterator emplace_hint(iterator hint, Args&& ...args)
+    {
+        return tree_.emplace_multi_use_hint(hint, orange_stl::forward<Args>(args)...);
+    }
+
+    iterator insert(const value_type& value)
+    {
+        return tree_.insert_multi(value);
+    }
+    iterator insert(value_type&& value)
+    {
+        return tree_.insert_multi(orange_stl::move(value));
+    }
+
+    iterator insert(iterator hint, const value_type& value)
+    {
+        return tree_.insert_multi(hint, value);
+    }
+    iterator insert(iterator hint, value_type&& value)
+    {
+        return tree_.insert_multi(hint, orange_stl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        tree_.insert_multi(first, last);
+    }
+
+    iterator erase(iterator position)             
+    { 
+        return tree_.erase(position); 
+    }
+    size_type erase(const key_type& key)           
+    { 
+        return tree_.erase_multi(key); 
+    }
+    iterator erase(iterator first, iterator last) 
+    { 
+        return tree_.erase(first, last); 
+    }
+
+    void clear() 
+    { 
+        tree_.clear(); 
+    }
+
+    // btree_multimap 相关操作
+
+    iterator find(const key_type& key)              
+    { 
+        return tree_.find(key); 
+    }
+    const_iterator find(const key_type& key) const 
+    { 
+        return tree_.find(key); 
+    }
+
+    size_type count(const key_type& key) const 
+    { 
+        return tree_.count_multi(key); 
+    }
+
+    iterator lower_bound(const key_type& key)       
+    { 
+        return tree_.lower_bound(key); 
+    }
+    const_iterator lower_bound(const key_type& key) const 
+    { 
+        return tree_.lower_bound(key); 
+    }
+
+    iterator upper_bound(const key_type& key)
+    { 
+        return tree_.upper_bound(key); 
+    }
+    const_iterator upper_bound(const key_type& key) const 
+    { 
+        return tree_.upper_bound(key); 
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key)
+    { 
+        return tree_.equal_range_multi(key); 
+    }
+
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
+    { 
+        return tree_.equal_range_multi(key); 
+    }
+
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_multi(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_multi(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return tree_.equal_range_multi(key);
+    }
+
+    void swap(btree_multimap& rhs) noexcept
+    { 
+        tree_.swap(rhs.tree_); 
+    }
+
+public:
+    friend bool operator==(const btree_multimap& lhs, const btree_multimap& rhs) 
+    { 
+        return lhs.tree_ == rhs.tree_; 
+    }
+    friend bool operator< (const btree_multimap& lhs, const btree_multimap& rhs) 
+    { 
+        return lhs.tree_ <  rhs.tree_; 
+    }
+};
+
+// 重载比较操作符
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const btree_multimap<Key, T, Compare, Alloc>& lhs, const btree_multimap<Key, T, Compare, Alloc>& rhs)
+{
+    return lhs == rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const btree_multimap<Key, T, Compare, Alloc>& lhs, const btree_multimap<Key, T, Compare, Alloc>& rhs)
+{
+    return lhs < rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const btree_multimap<Key, T, Compare, Alloc>& lhs, const btree_multimap<Key, T, Compare, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const btree_multimap<Key, T, Compare, Alloc>& lhs, const btree_multimap<Key, T, Compare, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const btree_multimap<Key, T, Compare, Alloc>& lhs, const btree_multimap<Key, T, Compare, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const btree_multimap<Key, T, Compare, Alloc>& lhs, const btree_multimap<Key, T, Compare, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare, class Alloc>
+void swap(btree_multimap<Key, T, Compare, Alloc>& lhs, btree_multimap<Key, T, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // end namespace orange_stl
+
+#endif
\ No newline at end of file
@@ -0,0 +1,403 @@
+#ifndef __ORANGE_CONCURRENT_UNORDERED_MAP_H__
+#define __ORANGE_CONCURRENT_UNORDERED_MAP_H__
+
+// 这个头文件包含读写自旋锁 rw_spinlock 与分片的并发哈希表 concurrent_unordered_map
+// concurrent_unordered_map 按哈希值把键值空间分到 2 的幂个分片，每个分片是一个 hashtable 加一把读写锁，
+// 不同分片上的操作互不阻塞，同一分片上的读操作可以并发进行
+// 由于元素可能随时被其他线程删除，接口不返回迭代器或引用：查找把结果复制出来，或者在持有锁时调用回调
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ORANGE_SPIN_PAUSE() _mm_pause()
+#else
+#define ORANGE_SPIN_PAUSE() ((void)0)
+#endif
+
+#include "orange_hashtable.h"
+#include "orange_vector.h"
+
+namespace orange_stl
+{
+
+// 自旋多少次之后让出时间片，分片的上限，缓存行的大小
+enum { ESpinLockSpinCount = 64, EConcurrentMapMaxShards = 1 << 10, ECacheLineSize = 64 };
+
+// 类：rw_spinlock
+// 以一个原子整数实现的读写锁：最低位表示写者持有，次低位表示有写者在等待，其余各位为读者个数
+// 写者等待期间不再放行新的读者，避免读多写少时写者饿死
+// 临界区很短(一次哈希表操作)时比 std::mutex 开销小，满足 Lockable 要求，可以配合 std::lock_guard 使用
+class rw_spinlock
+{
+private:
+    enum : uint32_t { EWriter = 1, EWriterWaiting = 2, EReader = 4 };
+
+    std::atomic<uint32_t> state_;
+
+public:
+    rw_spinlock() noexcept : state_(0) {}
+
+    rw_spinlock(const rw_spinlock&) = delete;
+    rw_spinlock& operator=(const rw_spinlock&) = delete;
+
+    void lock() noexcept
+    {
+        for (size_t spin = 0; ; ++spin)
+        {
+            uint32_t s = state_.load(std::memory_order_relaxed);
+            // 没有读者和写者时获取，同时清除等待标记(其他等待的写者会重新设置)
+            if ((s & ~static_cast<uint32_t>(EWriterWaiting)) == 0 &&
+                state_.compare_exchange_weak(s, EWriter, std::memory_order_acquire))
+                return;
+            if ((s & EWriterWaiting) == 0)
+                state_.fetch_or(EWriterWaiting, std::memory_order_relaxed);
+            backoff(spin);
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        uint32_t s = state_.load(std::memory_order_relaxed);
+        return (s & ~static_cast<uint32_t>(EWriterWaiting)) == 0 &&
+               state_.compare_exchange_strong(s, EWriter, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept
+    {
+        state_.fetch_and(~static_cast<uint32_t>(EWriter), std::memory_order_release);
+    }
+
+    void lock_shared() noexcept
+    {
+        for (size_t spin = 0; ; ++spin)
+        {
+            uint32_t s = state_.load(std::memory_order_relaxed);
+            if ((s & (EWriter | EWriterWaiting)) == 0 &&
+                state_.compare_exchange_weak(s, s + EReader, std::memory_order_acquire))
+                return;
+            backoff(spin);
+        }
+    }
+
+    void unlock_shared() noexcept
+    {
+        state_.fetch_sub(EReader, std::memory_order_release);
+    }
+
+private:
+    static void backoff(size_t spin) noexcept
+    {
+        if (spin < static_cast<size_t>(ESpinLockSpinCount))
+            ORANGE_SPIN_PAUSE();
+        else
+            std::this_thread::yield();
+    }
+};
+
+// 类：shared_lock_guard
+// 构造时以共享方式加锁，析构时解锁，相当于 C++14 的 std::shared_lock 的最简形式
+template <class Mutex>
+class shared_lock_guard
+{
+private:
+    Mutex& mutex_;
+
+public:
+    explicit shared_lock_guard(Mutex& m) : mutex_(m) { mutex_.lock_shared(); }
+    ~shared_lock_guard() { mutex_.unlock_shared(); }
+
+    shared_lock_guard(const shared_lock_guard&) = delete;
+    shared_lock_guard& operator=(const shared_lock_guard&) = delete;
+};
+
+// 模板类 concurrent_unordered_map，键值不允许重复
+// 模板参数与 unordered_map 相同
+// 分片由哈希值打散后的低位决定，分片内部的 hashtable 仍使用原始的哈希值，两者互不相关
+// 所有操作都是线程安全的；size、empty 与 for_each 逐个分片加锁，只保证每个分片内部的一致性
+template <class Key, class T, class Hash = orange_stl::hash<Key>, class KeyEqual = orange_stl::equal_to<Key>,
+          class Alloc = orange_stl::allocator<orange_stl::pair<const Key, T>>,
+          class BucketPolicy = orange_stl::prime_bucket_policy>
+class concurrent_unordered_map
+{
+private:
+    typedef hashtable<orange_stl::pair<const Key, T>, Hash, KeyEqual, Alloc, BucketPolicy> base_type;
+
+    // 按缓存行对齐，大小也是缓存行的整数倍，一个分片的锁被频繁改写时不会波及相邻的分片
+    struct alignas(ECacheLineSize) shard
+    {
+        mutable rw_spinlock lock;
+        base_type           ht;
+
+        shard(size_t bucket_count, const Hash& hash, const KeyEqual& equal)
+            :ht(bucket_count, hash, equal)
+        {
+        }
+
+        // C++17 之前 new 不保证超过 alignof(max_align_t) 的对齐，
+        // 多配置一条缓存行，对齐后把原始地址存放在对象之前
+        static void* operator new(size_t bytes)
+        {
+            void* raw = ::operator new(bytes + ECacheLineSize);
+            const uintptr_t p = (reinterpret_cast<uintptr_t>(raw) + ECacheLineSize) &
+                                ~static_cast<uintptr_t>(ECacheLineSize - 1);
+            reinterpret_cast<void**>(p)[-1] = raw;
+            return reinterpret_cast<void*>(p);
+        }
+
+        static void operator delete(void* p) noexcept
+        {
+            if (p != nullptr)
+                ::operator delete(static_cast<void**>(p)[-1]);
+        }
+    };
+
+public:
+    typedef typename base_type::allocator_type       allocator_type;
+    typedef typename base_type::key_type             key_type;
+    typedef typename base_type::mapped_type          mapped_type;
+    typedef typename base_type::value_type           value_type;
+    typedef typename base_type::hasher               hasher;
+    typedef typename base_type::key_equal            key_equal;
+    typedef typename base_type::size_type            size_type;
+
+private:
+    // 每个分片单独配置并按缓存行对齐，分片之间不会共享缓存行
+    orange_stl::vector<shard*> shards_;
+    size_type                  mask_;     // 分片数减一
+    hasher                     hash_;
+
+public:
+    // shard_count 会向上取整为 2 的幂，bucket_count 为所有分片的桶数之和
+    explicit concurrent_unordered_map(size_type shard_count = default_shard_count(),
+                                      size_type bucket_count = 100,
+                                      const Hash& hash = Hash(),
+                                      const KeyEqual& equal = KeyEqual())
+        :mask_(0), hash_(hash)
+    {
+        size_type n = 1;
+        while (n < shard_count && n < static_cast<size_type>(EConcurrentMapMaxShards))
+            n <<= 1;
+        mask_ = n - 1;
+        shards_.reserve(n);
+        try
+        {
+            for (size_type i = 0; i < n; ++i)
+                shards_.push_back(new shard(bucket_count / n + 1, hash, equal));
+        }
+        catch (...)
+        {
+            destroy_shards();
+            throw;
+        }
+    }
+
+    concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+    concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+
+    ~concurrent_unordered_map()
+    {
+        destroy_shards();
+    }
+
+    // 缺省的分片数：硬件线程数的 4 倍，使同时访问的线程落在同一分片上的概率较低
+    static size_type default_shard_count()
+    {
+        const size_type n = std::thread::hardware_concurrency();
+        return n == 0 ? 16 : n * 4;
+    }
+
+    size_type shard_count() const noexcept { return mask_ + 1; }
+
+    allocator_type get_allocator() const { return allocator_type(); }
+    hasher         hash_function() const { return hash_; }
+    key_equal      key_eq()        const { return shards_[0]->ht.key_eq(); }
+
+public:
+    // 容量相关操作，结果只是调用期间某一时刻的近似值
+    size_type size() const
+    {
+        size_type n = 0;
+        for (size_type i = 0; i <= mask_; ++i)
+        {
+            shared_lock_guard<rw_spinlock> guard(shards_[i]->lock);
+            n += shards_[i]->ht.size();
+        }
+        return n;
+    }
+
+    bool empty() const
+    {
+        for (size_type i = 0; i <= mask_; ++i)
+        {
+            shared_lock_guard<rw_spinlock> guard(shards_[i]->lock);
+            if (!shards_[i]->ht.empty())
+                return false;
+        }
+        return true;
+    }
+
+    // 查找相关操作，持有分片的读锁
+
+    // 找到时把 mapped 复制到 value 并返回 true
+    bool find(const key_type& key, mapped_type& value) const
+    {
+        const shard& s = shard_of(key);
+        shared_lock_guard<rw_spinlock> guard(s.lock);
+        auto it = s.ht.find(key);
+        if (it == s.ht.end())
+            return false;
+        value = it->second;
+        return true;
+    }
+
+    bool contains(const key_type& key) const
+    {
+        const shard& s = shard_of(key);
+        shared_lock_guard<rw_spinlock> guard(s.lock);
+        return s.ht.find(key) != s.ht.end();
+    }
+
+    size_type count(const key_type& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    // 找到时以 const value_type& 调用 fn 并返回 true，fn 执行期间持有读锁，不能再访问本容器
+    template <class Fn>
+    bool visit(const key_type& key, Fn fn) const
+    {
+        const shard& s = shard_of(key);
+        shared_lock_guard<rw_spinlock> guard(s.lock);
+        auto it = s.ht.find(key);
+        if (it == s.ht.end())
+            return false;
+        fn(*it);
+        return true;
+    }
+
+    // 修改相关操作，持有分片的写锁
+
+    // 键值不存在时插入，返回是否插入
+    bool insert(const value_type& value)
+    {
+        shard& s = shard_of(value.first);
+        std::lock_guard<rw_spinlock> guard(s.lock);
+        return s.ht.insert_unique(value).second;
+    }
+
+    bool insert(value_type&& value)
+    {
+        shard& s = shard_of(value.first);
+        std::lock_guard<rw_spinlock> guard(s.lock);
+        return s.ht.insert_unique(orange_stl::move(value)).second;
+    }
+
+    // 键值不存在时以 key 和 args 原位构造，返回是否插入
+    template <class ...Args>
+    bool try_emplace(const key_type& key, Args&& ...args)
+    {
+        shard& s = shard_of(key);
+        std::lock_guard<rw_spinlock> guard(s.lock);
+        return s.ht.try_emplace_unique(key, orange_stl::forward<Args>(args)...).second;
+    }
+
+    // 键值不存在时插入，否则覆盖 mapped，返回是否插入
+    template <class M>
+    bool upsert(const key_type& key, M&& obj)
+    {
+        shard& s = shard_of(key);
+        std::lock_guard<rw_spinlock> guard(s.lock);
+        return s.ht.insert_or_assign_unique(key, orange_stl::forward<M>(obj)).second;
+    }
+
+    // 键值存在时以 mapped_type& 调用 fn，否则以 key 和 args 构造新元素，返回是否插入
+    // 适合计数器一类“读取-修改-写回”须在同一临界区完成的场景
+    template <class Fn, class ...Args>
+    bool upsert_with(const key_type& key, Fn fn, Args&& ...args)
+    {
+        shard& s = shard_of(key);
+        std::lock_guard<rw_spinlock> guard(s.lock);
+        auto res = s.ht.try_emplace_unique(key, orange_stl::forward<Args>(args)...);
+        if (!res.second)
+            fn(res.first->second);
+        return res.second;
+    }
+
+    // 键值存在时以 mapped_type& 调用 fn 并返回 true
+    template <class Fn>
+    bool update(const key_type& key, Fn fn)
+    {
+        shard& s = shard_of(key);
+        std::lock_guard<rw_spinlock> guard(s.lock);
+        auto it = s.ht.find(key);
+        if (it == s.ht.end())
+            return false;
+        fn(it->second);
+        return true;
+    }
+
+    size_type erase(const key_type& key)
+    {
+        shard& s = shard_of(key);
+        std::lock_guard<rw_spinlock> guard(s.lock);
+        return s.ht.erase_unique(key);
+    }
+
+    void clear()
+    {
+        for (size_type i = 0; i <= mask_; ++i)
+        {
+            std::lock_guard<rw_spinlock> guard(shards_[i]->lock);
+            shards_[i]->ht.clear();
+        }
+    }
+
+    // 预留能容纳 count 个元素的空间，按分片平均分配
+    void reserve(size_type count)
+    {
+        for (size_type i = 0; i <= mask_; ++i)
+        {
+            std::lock_guard<rw_spinlock> guard(shards_[i]->lock);
+            shards_[i]->ht.reserve(count / (mask_ + 1) + 1);
+        }
+    }
+
+    // 对每个元素以 const value_type& 调用 fn
+    // 逐个分片持有读锁遍历：同一分片内看到的是某一时刻的完整快照，不同分片的快照时刻可能不同
+    // fn 执行期间不能再访问本容器
+    template <class Fn>
+    void for_each(Fn fn) const
+    {
+        for (size_type i = 0; i <= mask_; ++i)
+        {
+            const shard& s = *shards_[i];
+            shared_lock_guard<rw_spinlock> guard(s.lock);
+            for (auto it = s.ht.begin(); it != s.ht.end(); ++it)
+                fn(*it);
+        }
+    }
+
+private:
+    size_type shard_index(const key_type& key) const
+    {
+        return orange_stl::hash_mix(static_cast<uint64_t>(hash_(key))) & mask_;
+    }
+
+    shard&       shard_of(const key_type& key)       { return *shards_[shard_index(key)]; }
+    const shard& shard_of(const key_type& key) const { return *shards_[shard_index(key)]; }
+
+    void destroy_shards() noexcept
+    {
+        for (size_type i = 0; i < shards_.size(); ++i)
+            delete shards_[i];
+        shards_.clear();
+    }
+};
+
+} // namespace orange_stl
+#endif // !__ORANGE_CONCURRENT_UNORDERED_MAP_H__
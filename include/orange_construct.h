@@ -3,6 +3,7 @@
 
 #include "orange_type_traits.h"
 #include "orange_iterator.h"
+#include "orange_util.h"
 
 namespace orange_stl
 {
@@ -41,6 +42,9 @@ void destroy_one(Ty* pointer, std::false_type)
     }
 }
 
+template <class Ty>
+void destroy(Ty* pointer);
+
 // 第三个参数是判别有无默认的构造函数
 template <class ForwardIter>
 void destroy_cat(ForwardIter , ForwardIter , std::true_type) {}
@@ -81,13 +81,18 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
     
     self& operator=(const iterator& rhs)
     {
-        if(this != &rhs)
-        {
-            cur=rhs.cur;
-            first=rhs.first;
-            last=rhs.last;
-            node=rhs.node;
-        }
+        cur=rhs.cur;
+        first=rhs.first;
+        last=rhs.last;
+        node=rhs.node;
+        return *this;
+    }
+    self& operator=(const const_iterator& rhs)
+    {
+        cur=rhs.cur;
+        first=rhs.first;
+        last=rhs.last;
+        node=rhs.node;
         return *this;
     }
 
@@ -192,22 +197,23 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
 };
 
 /* 模板类 deque */
-template <class T>
+// 模板参数 T 代表数据类型，Alloc 代表空间配置器类型，缺省使用 orange_stl::allocator
+template <class T, class Alloc = orange_stl::allocator<T>>
 class deque
 {
 public:
     // deque 的型别定义
-    typedef orange_stl::allocator<T>                 allocator_type;
-    typedef orange_stl::allocator<T>                 data_allocator;
-    typedef orange_stl::allocator<T*>                map_allocator;
-
-    typedef typename allocator_type::value_type      value_type;
-    typedef typename allocator_type::pointer         pointer;
-    typedef typename allocator_type::const_pointer   const_pointer;
-    typedef typename allocator_type::reference       reference;
-    typedef typename allocator_type::const_reference const_reference;
-    typedef typename allocator_type::size_type       size_type;
-    typedef typename allocator_type::difference_type difference_type;
+    typedef Alloc                                             allocator_type;
+    typedef typename Alloc::template rebind<T>::other         data_allocator;
+    typedef typename Alloc::template rebind<T*>::other        map_allocator;
+
+    typedef typename data_allocator::value_type      value_type;
+    typedef typename data_allocator::pointer         pointer;
+    typedef typename data_allocator::const_pointer   const_pointer;
+    typedef typename data_allocator::reference       reference;
+    typedef typename data_allocator::const_reference const_reference;
+    typedef typename data_allocator::size_type       size_type;
+    typedef typename data_allocator::difference_type difference_type;
     typedef pointer*                                 map_pointer;
     typedef const_pointer*                           const_map_pointer;
 
@@ -506,10 +512,10 @@ private:
 };
 
 /* 复制/赋值 = 运算符 */
-template <class T>
-deque<T>& deque<T>::operator=(const deque& rhs)
+template <class T, class Alloc>
+deque<T, Alloc>& deque<T, Alloc>::operator=(const deque& rhs)
 {
-    if(this!=&ths)
+    if(this!=&rhs)
     {
         const auto len=size();
         if(len >= rhs.size())
@@ -518,30 +524,26 @@ deque<T>& deque<T>::operator=(const deque& rhs)
         }
         else
         {
-            iterator mid=rhs.begin()+static_cast<difference_type>(len);
-            orange_stl::copy(rhs,begin_, mid, begin_);
+            iterator mid=rhs.begin_+static_cast<difference_type>(len);
+            orange_stl::copy(rhs.begin_, mid, begin_);
             insert(end_, mid, rhs.end_);
         }
     }
     return *this;
 }
 
-template <class T>
-deque<T>& deque<T>::operator=(deque&& rhs)
+template <class T, class Alloc>
+deque<T, Alloc>& deque<T, Alloc>::operator=(deque&& rhs)
 {
-    clear();
-    begin_=orange_stl::move(rhs.begin_);
-    end_=orange_stl::move(rhs.end_);
-    map_=rhs.map_;
-    map_size_=rhs.map_size_;
-    rhs.map_=nullptr;
-    rhs.map_size_=0;
+    // 原有的缓冲区和 map 随 tmp 一起释放
+    deque tmp(orange_stl::move(rhs));
+    swap(tmp);
     return *this;
 }
 
 /* 重置容器大小 */
-template <class T>
-void deque<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc>
+void deque<T, Alloc>::resize(size_type new_size, const value_type& value)
 {
     const auto len=size();
     if(new_size<len)
@@ -555,8 +557,8 @@ void deque<T>::resize(size_type new_size, const value_type& value)
 }
 
 /* 减小容器容量 */
-template <class T>
-void deque<T>::shrink_to_fit() noexcept
+template <class T, class Alloc>
+void deque<T, Alloc>::shrink_to_fit() noexcept
 {
     /* 最少留下头部缓冲区 */
     for(auto cur=map_; cur<begin_.node; ++cur)
@@ -572,9 +574,9 @@ void deque<T>::shrink_to_fit() noexcept
 }
 
 /* emplace_front */
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-void deque<T>::emplace_front(Args&& ...args)
+void deque<T, Alloc>::emplace_front(Args&& ...args)
 {
     if(begin_.cur!=begin_.first)
     {
@@ -598,9 +600,9 @@ void deque<T>::emplace_front(Args&& ...args)
 }
 
 /* emplace_back */
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-void deque<T>::emplace_back(Args&& ...args)
+void deque<T, Alloc>::emplace_back(Args&& ...args)
 {
     if(end_.cur!=end_.last-1)
     {
@@ -616,26 +618,26 @@ void deque<T>::emplace_back(Args&& ...args)
 }
 
 /* emplace */
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args)
+typename deque<T, Alloc>::iterator deque<T, Alloc>::emplace(iterator pos, Args&& ...args)
 {
     if (pos.cur == begin_.cur)
     {
-        emplace_front(mystl::forward<Args>(args)...);
+        emplace_front(orange_stl::forward<Args>(args)...);
         return begin_;
     }
     else if (pos.cur == end_.cur)
     {
-        emplace_back(mystl::forward<Args>(args)...);
+        emplace_back(orange_stl::forward<Args>(args)...);
         return end_;
     }
-    return insert_aux(pos, mystl::forward<Args>(args)...);
+    return insert_aux(pos, orange_stl::forward<Args>(args)...);
 }
 
 /* 在头部插入元素 */
-template <class T>
-void deque<T>::push_front(const value_type& value)
+template <class T, class Alloc>
+void deque<T, Alloc>::push_front(const value_type& value)
 {
     if(begin_.cur!=begin_.first)
     {
@@ -659,8 +661,8 @@ void deque<T>::push_front(const value_type& value)
 }
 
 /* 在尾部插入元素 */
-template <class T>
-void deque<T>::push_back(const value_type& value)
+template <class T, class Alloc>
+void deque<T, Alloc>::push_back(const value_type& value)
 {
     if(end_.cur!=end_.last-1)
     {
@@ -676,8 +678,8 @@ void deque<T>::push_back(const value_type& value)
 }
 
 /* 弹出头部元素 */
-template <class T>
-void deque<T>::pop_front()
+template <class T, class Alloc>
+void deque<T, Alloc>::pop_front()
 {
     ORANGE_STL_DEBUG(!empty());
     if (begin_.cur != begin_.last - 1)
@@ -694,8 +696,8 @@ void deque<T>::pop_front()
 }
 
 /* 弹出尾部元素 */
-template <class T>
-void deque<T>::pop_back()
+template <class T, class Alloc>
+void deque<T, Alloc>::pop_back()
 {
     ORANGE_STL_DEBUG(!empty());
     if (end_.cur != end_.first)
@@ -712,9 +714,9 @@ void deque<T>::pop_back()
 }
 
 /* 在position处插入元素 */
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, const value_type& value)
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::insert(iterator position, const value_type& value)
 {
     if (position.cur == begin_.cur)
     {
@@ -734,31 +736,31 @@ deque<T>::insert(iterator position, const value_type& value)
     }
 }
 
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, value_type&& value)
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::insert(iterator position, value_type&& value)
 {
     if (position.cur == begin_.cur)
     {
-        emplace_front(mystl::move(value));
+        emplace_front(orange_stl::move(value));
         return begin_;
     }
     else if (position.cur == end_.cur)
     {
-        emplace_back(mystl::move(value));
+        emplace_back(orange_stl::move(value));
         auto tmp = end_;
         --tmp;
         return tmp;
     }
     else
     {
-        return insert_aux(position, mystl::move(value));
+        return insert_aux(position, orange_stl::move(value));
     }
 }
 
 // 在 position 位置插入 n 个元素
-template <class T>
-void deque<T>::insert(iterator position, size_type n, const value_type& value)
+template <class T, class Alloc>
+void deque<T, Alloc>::insert(iterator position, size_type n, const value_type& value)
 {
     if (position.cur == begin_.cur)
     {
@@ -781,9 +783,9 @@ void deque<T>::insert(iterator position, size_type n, const value_type& value)
 }
 
 // 删除 position 处的元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator position)
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::erase(iterator position)
 {
     auto next = position;
     ++next;
@@ -802,9 +804,9 @@ deque<T>::erase(iterator position)
 }
 
 // 删除[first, last)上的元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator first, iterator last)
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::erase(iterator first, iterator last)
 {
     if (first == begin_ && last == end_)
     {
@@ -834,8 +836,8 @@ deque<T>::erase(iterator first, iterator last)
 }
 
 // 清空 deque
-template <class T>
-void deque<T>::clear()
+template <class T, class Alloc>
+void deque<T, Alloc>::clear()
 {
     // clear 会保留头部的缓冲区
     for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur)
@@ -852,13 +854,13 @@ void deque<T>::clear()
     {
         orange_stl::destroy(begin_.cur, end_.cur);
     }
-    shrink_to_fit();
     end_ = begin_;
+    shrink_to_fit();
 }
 
 /* 交换两个deque */
-template <class T>
-void deque<T>::swap(deque& rhs) noexcept
+template <class T, class Alloc>
+void deque<T, Alloc>::swap(deque& rhs) noexcept
 {
     if(this!=&rhs)
     {
@@ -871,9 +873,9 @@ void deque<T>::swap(deque& rhs) noexcept
 
 
 /* 辅助函数 */
-template <class T>
-typename deque<T>::map_pointer
-deque<T>::create_map(size_type size)
+template <class T, class Alloc>
+typename deque<T, Alloc>::map_pointer
+deque<T, Alloc>::create_map(size_type size)
 {
     map_pointer mp=nullptr;
     mp=map_allocator::allocate(size);
@@ -883,8 +885,8 @@ deque<T>::create_map(size_type size)
 }
 
 /* create_buffer 函数 */
-template <class T>
-void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
+template <class T, class Alloc>
+void deque<T, Alloc>::create_buffer(map_pointer nstart, map_pointer nfinish)
 {
     map_pointer cur;
     try
@@ -907,8 +909,8 @@ void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
 }
 
 // destroy_buffer 函数
-template <class T>
-void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
+template <class T, class Alloc>
+void deque<T, Alloc>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
 {
     for (map_pointer n = nstart; n <= nfinish; ++n)
     {
@@ -918,8 +920,8 @@ void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
 }
 
 // map_init 函数
-template <class T>
-void deque<T>::map_init(size_type nElem)
+template <class T, class Alloc>
+void deque<T, Alloc>::map_init(size_type nElem)
 {
     const size_type nNode = nElem / buffer_size + 1;  // 需要分配的缓冲区个数
     map_size_ = orange_stl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nNode + 2);
@@ -955,8 +957,8 @@ void deque<T>::map_init(size_type nElem)
 }
 
 // fill_init 函数
-template <class T>
-void deque<T>::fill_init(size_type n, const value_type& value)
+template <class T, class Alloc>
+void deque<T, Alloc>::fill_init(size_type n, const value_type& value)
 {
     map_init(n);
     if (n != 0)
@@ -970,9 +972,9 @@ void deque<T>::fill_init(size_type n, const value_type& value)
 }
 
 // copy_init 函数
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void deque<T>::copy_init(IIter first, IIter last, input_iterator_tag)
+void deque<T, Alloc>::copy_init(IIter first, IIter last, input_iterator_tag)
 {
     const size_type n = orange_stl::distance(first, last);
     map_init(n);
@@ -980,9 +982,9 @@ void deque<T>::copy_init(IIter first, IIter last, input_iterator_tag)
         emplace_back(*first);
 }
 
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::copy_init(FIter first, FIter last, forward_iterator_tag)
+void deque<T, Alloc>::copy_init(FIter first, FIter last, forward_iterator_tag)
 {
     const size_type n = orange_stl::distance(first, last);
     map_init(n);
@@ -997,8 +999,8 @@ void deque<T>::copy_init(FIter first, FIter last, forward_iterator_tag)
 }
 
 // fill_assign 函数
-template <class T>
-void deque<T>::fill_assign(size_type n, const value_type& value)
+template <class T, class Alloc>
+void deque<T, Alloc>::fill_assign(size_type n, const value_type& value)
 {
     if (n > size())
     {
@@ -1013,9 +1015,9 @@ void deque<T>::fill_assign(size_type n, const value_type& value)
 }
 
 // copy_assign 函数
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void deque<T>::copy_assign(IIter first, IIter last, input_iterator_tag)
+void deque<T, Alloc>::copy_assign(IIter first, IIter last, input_iterator_tag)
 {
     auto first1 = begin();
     auto last1 = end();
@@ -1033,9 +1035,9 @@ void deque<T>::copy_assign(IIter first, IIter last, input_iterator_tag)
     }
 }
 
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::copy_assign(FIter first, FIter last, forward_iterator_tag)
+void deque<T, Alloc>::copy_assign(FIter first, FIter last, forward_iterator_tag)
 {  
     const size_type len1 = size();
     const size_type len2 = orange_stl::distance(first, last);
@@ -1053,10 +1055,10 @@ void deque<T>::copy_assign(FIter first, FIter last, forward_iterator_tag)
 }
 
 // insert_aux 函数
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-typename deque<T>::iterator
-deque<T>::insert_aux(iterator position, Args&& ...args)
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::insert_aux(iterator position, Args&& ...args)
 {
     const size_type elems_before = position - begin_;
     value_type value_copy = value_type(orange_stl::forward<Args>(args)...);
@@ -1089,8 +1091,8 @@ deque<T>::insert_aux(iterator position, Args&& ...args)
 }
 
 // fill_insert 函数
-template <class T>
-void deque<T>::fill_insert(iterator position, size_type n, const value_type& value)
+template <class T, class Alloc>
+void deque<T, Alloc>::fill_insert(iterator position, size_type n, const value_type& value)
 {
     const size_type elems_before = position - begin_;
     const size_type len = size();
@@ -1162,9 +1164,9 @@ void deque<T>::fill_insert(iterator position, size_type n, const value_type& val
 }
 
 // copy_insert
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::copy_insert(iterator position, FIter first, FIter last, size_type n)
+void deque<T, Alloc>::copy_insert(iterator position, FIter first, FIter last, size_type n)
 {
     const size_type elems_before = position - begin_;
     auto len = size();
@@ -1238,9 +1240,9 @@ void deque<T>::copy_insert(iterator position, FIter first, FIter last, size_type
 }
 
 // insert_dispatch 函数
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void deque<T>::insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
+void deque<T, Alloc>::insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
 {
     if (last <= first)  return;
     const size_type n = orange_stl::distance(first, last);
@@ -1261,9 +1263,9 @@ void deque<T>::insert_dispatch(iterator position, IIter first, IIter last, input
     }
 }
 
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag)
+void deque<T, Alloc>::insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag)
 {
     if (last <= first)  return;
     const size_type n = orange_stl::distance(first, last);
@@ -1306,8 +1308,8 @@ void deque<T>::insert_dispatch(iterator position, FIter first, FIter last, forwa
 }
 
 // require_capacity 函数
-template <class T>
-void deque<T>::require_capacity(size_type n, bool front)
+template <class T, class Alloc>
+void deque<T, Alloc>::require_capacity(size_type n, bool front)
 {
     if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n))
     {
@@ -1333,8 +1335,8 @@ void deque<T>::require_capacity(size_type n, bool front)
 
 
 // reallocate_map_at_front 函数
-template <class T>
-void deque<T>::reallocate_map_at_front(size_type need_buffer)
+template <class T, class Alloc>
+void deque<T, Alloc>::reallocate_map_at_front(size_type need_buffer)
 {
     const size_type new_map_size = orange_stl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
     map_pointer new_map = create_map(new_map_size);
@@ -1358,8 +1360,8 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer)
 }
 
 // reallocate_map_at_back 函数
-template <class T>
-void deque<T>::reallocate_map_at_back(size_type need_buffer)
+template <class T, class Alloc>
+void deque<T, Alloc>::reallocate_map_at_back(size_type need_buffer)
 {
     const size_type new_map_size = orange_stl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
     map_pointer new_map = create_map(new_map_size);
@@ -1385,47 +1387,47 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer)
 }
 
 // 重载比较操作符
-template <class T>
-bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc>
+bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
 {
     return lhs.size() == rhs.size() && 
         orange_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc>
+bool operator<(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
 {
     return orange_stl::lexicographical_compare(
         lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T>
-bool operator!=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc>
+bool operator!=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
 {
     return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc>
+bool operator>(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
 {
     return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc>
+bool operator<=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
 {
     return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc>
+bool operator>=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
 {
     return !(lhs < rhs);
 }
 
 // 重载 orange_stl 的 swap
-template <class T>
-void swap(deque<T>& lhs, deque<T>& rhs)
+template <class T, class Alloc>
+void swap(deque<T, Alloc>& lhs, deque<T, Alloc>& rhs)
 {
     lhs.swap(rhs);
 }
@@ -0,0 +1,221 @@
+#ifndef __ORANGE_EPOCH_H__
+#define __ORANGE_EPOCH_H__
+
+// 这个头文件包含基于纪元的内存回收(epoch-based reclamation)：epoch_domain、epoch_guard 与 epoch_node
+// 无锁容器把摘下的节点交给 retire，回收推迟到所有可能还在访问它的线程都离开临界区之后：
+// 1. 读者进入临界区时宣告当前的全局纪元，离开时撤销宣告
+// 2. 节点在全局纪元为 e 时被 retire，全局纪元推进到 e + 2 之后才真正释放
+// 3. 所有活跃线程都已宣告当前纪元 e 时，全局纪元才能从 e 推进到 e + 1
+// 被 retire 的对象须继承 epoch_node，回收链表直接串接在对象内部，retire 不需要为待回收的对象另外配置内存
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+namespace orange_stl
+{
+
+// 每个线程 retire 多少个对象之后尝试推进一次全局纪元
+enum { EEpochAdvanceThreshold = 64 };
+
+// 可回收对象的基类，deleter 负责析构并释放整个对象
+struct epoch_node
+{
+    epoch_node* retire_next;
+    void      (*deleter)(epoch_node*);
+};
+
+// 类：epoch_domain
+// 进程范围内唯一，通过 instance 取得；每个线程第一次使用时领取一条记录，线程结束时归还(未回收的对象随记录留给下一个使用者)
+class epoch_domain
+{
+private:
+    // 每个线程一条记录，记录只增不减，直到进程结束才释放
+    struct record
+    {
+        std::atomic<uint64_t> active;           // 0 表示不在临界区，否则为 (宣告的纪元 << 1) | 1
+        std::atomic<bool>     in_use;           // 是否被某个线程占用
+        record*               next;             // 记录链表，发布后不再改变
+        size_t                depth;            // 临界区的嵌套深度，只由拥有者访问
+        size_t                retired;          // 上次推进纪元之后 retire 的个数
+        epoch_node*           limbo[3];         // 按纪元模 3 分组的待回收对象
+        uint64_t              limbo_epoch[3];   // 每组对象 retire 时的纪元
+
+        record() : active(0), in_use(true), next(nullptr), depth(0), retired(0)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                limbo[i] = nullptr;
+                limbo_epoch[i] = 0;
+            }
+        }
+    };
+
+    // 线程结束时归还记录
+    struct record_holder
+    {
+        record* rec;
+        record_holder() : rec(nullptr) {}
+        ~record_holder()
+        {
+            if (rec != nullptr)
+                rec->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    std::atomic<uint64_t> global_;
+    std::atomic<record*>  head_;
+
+    epoch_domain() : global_(1), head_(nullptr) {}
+
+public:
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    // 进程结束时不再有读者，释放所有记录以及其中尚未回收的对象
+    ~epoch_domain()
+    {
+        record* rec = head_.load(std::memory_order_acquire);
+        while (rec != nullptr)
+        {
+            record* next = rec->next;
+            for (int i = 0; i < 3; ++i)
+                free_list(rec->limbo[i]);
+            delete rec;
+            rec = next;
+        }
+    }
+
+    static epoch_domain& instance()
+    {
+        static epoch_domain domain;
+        return domain;
+    }
+
+    // 进入与离开临界区，可以嵌套
+    void enter()
+    {
+        record* rec = local_record();
+        if (rec->depth++ == 0)
+        {
+            // 宣告一个稍旧的纪元也是安全的，只会推迟回收
+            const uint64_t e = global_.load(std::memory_order_relaxed);
+            rec->active.store((e << 1) | 1, std::memory_order_seq_cst);
+        }
+    }
+
+    void leave() noexcept
+    {
+        record* rec = local_record();
+        if (--rec->depth == 0)
+            rec->active.store(0, std::memory_order_release);
+    }
+
+    // 延迟回收 p，调用前 p 必须已经从共享结构中摘下，且 p->deleter 已经设置
+    void retire(epoch_node* p)
+    {
+        record* rec = local_record();
+        uint64_t e = global_.load(std::memory_order_acquire);
+        collect(rec, e);
+        const size_t slot = static_cast<size_t>(e % 3);
+        p->retire_next = rec->limbo[slot];
+        rec->limbo[slot] = p;
+        rec->limbo_epoch[slot] = e;
+        if (++rec->retired >= static_cast<size_t>(EEpochAdvanceThreshold))
+        {
+            rec->retired = 0;
+            if (try_advance(e))
+                collect(rec, e + 1);
+        }
+    }
+
+    // 尝试推进全局纪元，并回收本线程已经安全的对象，供测试或空闲时调用
+    void synchronize()
+    {
+        record* rec = local_record();
+        uint64_t e = global_.load(std::memory_order_acquire);
+        if (try_advance(e))
+            ++e;
+        collect(rec, e);
+    }
+
+    uint64_t epoch() const noexcept { return global_.load(std::memory_order_relaxed); }
+
+private:
+    record* local_record()
+    {
+        static thread_local record_holder holder;
+        if (holder.rec == nullptr)
+            holder.rec = acquire_record();
+        return holder.rec;
+    }
+
+    // 优先复用已归还的记录，没有时新建一条并插到链表头部
+    record* acquire_record()
+    {
+        for (record* rec = head_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+        {
+            bool expected = false;
+            if (!rec->in_use.load(std::memory_order_relaxed) &&
+                rec->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return rec;
+        }
+        record* rec = new record;
+        record* head = head_.load(std::memory_order_relaxed);
+        do
+        {
+            rec->next = head;
+        } while (!head_.compare_exchange_weak(head, rec, std::memory_order_release, std::memory_order_relaxed));
+        return rec;
+    }
+
+    // 所有活跃线程都宣告了纪元 e 时，把全局纪元从 e 推进到 e + 1
+    bool try_advance(uint64_t e) noexcept
+    {
+        for (record* rec = head_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+        {
+            const uint64_t a = rec->active.load(std::memory_order_seq_cst);
+            if ((a & 1) != 0 && (a >> 1) != e)
+                return false;
+        }
+        return global_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel);
+    }
+
+    // 释放 retire 时的纪元不晚于 e - 2 的对象
+    static void collect(record* rec, uint64_t e) noexcept
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            if (rec->limbo[i] != nullptr && rec->limbo_epoch[i] + 2 <= e)
+            {
+                free_list(rec->limbo[i]);
+                rec->limbo[i] = nullptr;
+            }
+        }
+    }
+
+    static void free_list(epoch_node* p) noexcept
+    {
+        while (p != nullptr)
+        {
+            epoch_node* next = p->retire_next;
+            p->deleter(p);
+            p = next;
+        }
+    }
+};
+
+// 类：epoch_guard
+// 构造时进入临界区，析构时离开；临界区内读到的共享节点在离开之前不会被释放
+class epoch_guard
+{
+public:
+    epoch_guard() { epoch_domain::instance().enter(); }
+    ~epoch_guard() { epoch_domain::instance().leave(); }
+
+    epoch_guard(const epoch_guard&) = delete;
+    epoch_guard& operator=(const epoch_guard&) = delete;
+};
+
+} // namespace orange_stl
+#endif // !__ORANGE_EPOCH_H__
@@ -0,0 +1,338 @@
+#ifndef __ORANGE_FLAT_HASH_MAP_H__
+#define __ORANGE_FLAT_HASH_MAP_H__
+
+// 这个头文件包含模板类 flat_hash_map
+// 接口与 unordered_map 相同(没有 bucket 接口)，可以直接替换，不同的是使用 flat_hashtable 作为底层实现机制：
+// 元素直接存放在槽数组中，查找时不需要沿着链表追指针
+// 扩容会移动元素，插入可能使迭代器、指针和引用失效
+
+#include "orange_flat_hashtable.h"
+
+namespace orange_stl
+{
+
+// 模板类 flat_hash_map，键值不允许重复
+// 参数一表示键值类型，参数二表示实值类型，参数三表示哈希函数，默认orange_stl::hash
+// 参数四表示键值的比较方式，默认orange_stl::equal_to，参数五表示空间配置器类型
+
+template <class Key, class T, class Hash=orange_stl::hash<Key>, class KeyEqual=orange_stl::equal_to<Key>,
+          class Alloc=orange_stl::allocator<orange_stl::pair<const Key, T>>>
+class flat_hash_map
+{
+private:
+    // 使用 flat_hashtable 作为底层机制
+    typedef flat_hashtable<orange_stl::pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
+    base_type ht_;
+
+public:
+    // 使用 flat_hashtable 的型别
+    typedef typename base_type::allocator_type       allocator_type;
+    typedef typename base_type::key_type             key_type;
+    typedef typename base_type::mapped_type          mapped_type;
+    typedef typename base_type::value_type           value_type;
+    typedef typename base_type::hasher               hasher;
+    typedef typename base_type::key_equal            key_equal;
+
+    typedef typename base_type::size_type            size_type;
+    typedef typename base_type::difference_type      difference_type;
+    typedef typename base_type::pointer              pointer;
+    typedef typename base_type::const_pointer        const_pointer;
+    typedef typename base_type::reference            reference;
+    typedef typename base_type::const_reference      const_reference;
+
+    typedef typename base_type::iterator             iterator;
+    typedef typename base_type::const_iterator       const_iterator;
+
+    allocator_type get_allocator() const
+    {
+        return ht_.get_allocator();
+    }
+
+public:
+    // 构造复制和移动函数
+    flat_hash_map() : ht_(0, Hash(), KeyEqual())
+    { }
+
+    explicit flat_hash_map(size_type bucket_count,
+                           const Hash& hash = Hash(),
+                           const KeyEqual& equal = KeyEqual()) : ht_(bucket_count, hash, equal)
+    { }
+
+    template <class InputIterator>
+    flat_hash_map(InputIterator first, InputIterator last,
+                  const size_type bucket_count=0,
+                  const Hash& hash = Hash(),
+                  const KeyEqual& equal = KeyEqual())
+        : ht_(orange_stl::max(bucket_count, static_cast<size_type>(orange_stl::distance(first, last))), hash, equal)
+    {
+        ht_.insert_unique(first, last);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> ilist,
+                  const size_type bucket_count=0,
+                  const Hash& hash = Hash(),
+                  const KeyEqual& equal = KeyEqual())
+        : ht_(orange_stl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+    {
+        ht_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_hash_map(const flat_hash_map& rhs) : ht_(rhs.ht_)
+    { }
+
+    flat_hash_map(flat_hash_map&& rhs) noexcept : ht_(orange_stl::move(rhs.ht_))
+    { }
+
+    flat_hash_map& operator=(const flat_hash_map& rhs)
+    {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+
+    flat_hash_map& operator=(flat_hash_map&& rhs)
+    {
+        ht_ = orange_stl::move(rhs.ht_);
+        return *this;
+    }
+
+    flat_hash_map& operator=(std::initializer_list<value_type> ilist)
+    {
+        ht_.clear();
+        ht_.reserve(ilist.size());
+        ht_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~flat_hash_map() = default;
+
+    // 迭代器
+    iterator begin() noexcept
+    {
+        return ht_.begin();
+    }
+    const_iterator begin() const noexcept
+    {
+        return ht_.begin();
+    }
+    iterator end() noexcept
+    {
+        return ht_.end();
+    }
+    const_iterator end() const noexcept
+    {
+        return ht_.end();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return ht_.cbegin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return ht_.cend();
+    }
+
+    bool empty() const noexcept
+    {
+        return ht_.empty();
+    }
+    size_type size() const noexcept
+    {
+        return ht_.size();
+    }
+    size_type max_size() const noexcept
+    {
+        return ht_.max_size();
+    }
+
+    // emplace
+    template <class ...Args>
+    pair<iterator, bool> emplace(Args&& ...args)
+    {
+        return ht_.emplace_unique(orange_stl::forward<Args>(args)...);
+    }
+
+    template <class ...Args>
+    iterator emplace_hint(const_iterator /*hint*/, Args&& ...args)
+    {
+        return ht_.emplace_unique(orange_stl::forward<Args>(args)...).first;
+    }
+
+    // insert
+    pair<iterator, bool> insert(const value_type& value)
+    {
+        return ht_.insert_unique(value);
+    }
+    pair<iterator, bool> insert(value_type&& value)
+    {
+        return ht_.insert_unique(orange_stl::move(value));
+    }
+
+    iterator insert(const_iterator /*hint*/, const value_type& value)
+    {
+        return ht_.insert_unique(value).first;
+    }
+    iterator insert(const_iterator /*hint*/, value_type&& value)
+    {
+        return ht_.insert_unique(orange_stl::move(value)).first;
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        ht_.insert_unique(first, last);
+    }
+
+    void erase(iterator it)
+    {
+        ht_.erase(it);
+    }
+    void erase(iterator first, iterator last)
+    {
+        ht_.erase(first, last);
+    }
+    size_type erase(const key_type& key)
+    {
+        return ht_.erase_unique(key);
+    }
+
+    void clear()
+    {
+        ht_.clear();
+    }
+
+    void swap(flat_hash_map& other) noexcept
+    {
+        ht_.swap(other.ht_);
+    }
+
+    // 查找
+    mapped_type& at(const key_type& key)
+    {
+        iterator it=ht_.find(key);
+        THROW_OUT_OF_RANGE_IF(it==ht_.end(), "flat_hash_map<Key, T> no such element exists");
+        return it->second;
+    }
+
+    const mapped_type& at(const key_type& key) const
+    {
+        const_iterator it=ht_.find(key);
+        THROW_OUT_OF_RANGE_IF(it==ht_.end(), "flat_hash_map<Key, T> no such element exists");
+        return it->second;
+    }
+
+    mapped_type& operator[](const key_type& key)
+    {
+        return ht_.try_emplace_unique(key, key, T{}).first->second;
+    }
+    mapped_type& operator[](key_type&& key)
+    {
+        return ht_.try_emplace_unique(key, orange_stl::move(key), T{}).first->second;
+    }
+
+    size_type count(const key_type& key) const
+    {
+        return ht_.count(key);
+    }
+
+    iterator find(const key_type& key)
+    {
+        return ht_.find(key);
+    }
+    const_iterator find(const key_type& key) const
+    {
+        return ht_.find(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key)
+    {
+        return ht_.equal_range_unique(key);
+    }
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+        return ht_.equal_range_unique(key);
+    }
+
+    // 异构查找，只在 hasher 与 key_equal 都声明了 is_transparent 时参与重载决议
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    size_type count(const K& key) const
+    {
+        return ht_.count(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    iterator find(const K& key)
+    {
+        return ht_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return ht_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return ht_.equal_range_unique(key);
+    }
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return ht_.equal_range_unique(key);
+    }
+
+    size_type bucket_count() const noexcept
+    {
+        return ht_.bucket_count();
+    }
+
+    // hash policy
+    float load_factor() const noexcept
+    {
+        return ht_.load_factor();
+    }
+    float max_load_factor() const noexcept
+    {
+        return ht_.max_load_factor();
+    }
+
+    void rehash(size_type count)
+    {
+        ht_.rehash(count);
+    }
+    void reserve(size_type count)
+    {
+        ht_.reserve(count);
+    }
+
+    hasher hash_fcn() const
+    {
+        return ht_.hash_fcn();
+    }
+    key_equal key_eq() const
+    {
+        return ht_.key_eq();
+    }
+
+public:
+    friend bool operator==(const flat_hash_map& lhs, const flat_hash_map& rhs)
+    {
+        return lhs.ht_.equal_to_unique(rhs.ht_);
+    }
+    friend bool operator!=(const flat_hash_map& lhs, const flat_hash_map& rhs)
+    {
+        return !lhs.ht_.equal_to_unique(rhs.ht_);
+    }
+};
+
+// 重载orange_stl的swap
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+          flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_FLAT_HASH_MAP_H__
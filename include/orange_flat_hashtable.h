@@ -0,0 +1,1017 @@
+#ifndef __ORANGE_FLAT_HASHTABLE_H__
+#define __ORANGE_FLAT_HASHTABLE_H__
+
+/* 模板类 flat_hashtable，开放定址的哈希表
+   元素直接存放在槽数组中，另有一个控制字节数组记录每个槽的状态与哈希值的低 7 位，
+   查找时一次比较一组控制字节，只有控制字节匹配的槽才需要比较键值 */
+#include <initializer_list>
+#include <cstdint>
+#include <cstring>
+#include "orange_algo.h"
+#include "orange_functional.h"
+#include "orange_memory.h"
+#include "orange_hashtable.h"
+#include "orange_util.h"
+#include "orange_exceptdef.h"
+
+// 组匹配在编译期按指令集选择：SSE2 一次比较 16 个控制字节，其余平台使用 8 字节的可移植版本
+// AVX2 一次比较 32 个控制字节，但组越宽最小容量越大、探测时越过的槽越多，实测查找并不比 SSE2 快，
+// 因此需要同时定义 ORANGE_FLAT_GROUP_AVX2 才会启用
+#if defined(__AVX2__) && defined(ORANGE_FLAT_GROUP_AVX2)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ORANGE_FLAT_GROUP_SSE2 1
+#endif
+
+namespace orange_stl
+{
+
+/* 控制字节，每个槽对应一个
+   空槽      1000 0000
+   已删除    1111 1110
+   哨兵      1111 1111   位于所有槽之后，迭代器以它作为终点
+   已占用    0xxx xxxx   低 7 位为哈希值的低 7 位(H2) */
+typedef signed char flat_ctrl_t;
+
+enum flat_ctrl_value : signed char
+{
+    ECtrlEmpty = -128,
+    ECtrlDeleted = -2,
+    ECtrlSentinel = -1
+};
+
+inline bool flat_is_full(flat_ctrl_t c) noexcept { return c >= 0; }
+inline bool flat_is_empty_or_deleted(flat_ctrl_t c) noexcept { return c < ECtrlSentinel; }
+
+// 计算尾随 0 的个数，x 不能为 0
+inline size_t flat_ctz(uint32_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctz(x));
+#else
+    size_t n = 0;
+    for (; (x & 1) == 0; x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+inline size_t flat_ctz(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(x));
+#else
+    size_t n = 0;
+    for (; (x & 1) == 0; x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+/* 组匹配的结果：每个匹配的控制字节对应 mask 中的一位(或一个字节的最高位)，Shift 把位号换算成组内下标 */
+template <class UInt, int Shift>
+class flat_bitmask
+{
+private:
+    UInt mask_;
+
+public:
+    explicit flat_bitmask(UInt mask) noexcept : mask_(mask) {}
+
+    explicit operator bool() const noexcept { return mask_ != 0; }
+
+    // 最低一个匹配的组内下标
+    size_t lowest() const noexcept { return flat_ctz(mask_) >> Shift; }
+
+    // 去掉最低一个匹配
+    void clear_lowest() noexcept { mask_ &= mask_ - 1; }
+};
+
+/* 组：一次检查 width 个连续的控制字节
+   可移植版本把 8 个控制字节装进一个 64 位整数，以位运算同时比较(SWAR) */
+class flat_group_portable
+{
+public:
+    enum { width = 8 };
+    typedef flat_bitmask<uint64_t, 3> bitmask;
+
+private:
+    static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+    static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+    uint64_t ctrl_;
+
+public:
+    explicit flat_group_portable(const flat_ctrl_t* pos) noexcept
+    {
+        std::memcpy(&ctrl_, pos, sizeof(ctrl_));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        ctrl_ = __builtin_bswap64(ctrl_);
+#endif
+    }
+
+    // 控制字节等于 h2 的槽，可能有误报(紧跟在真正匹配之后的字节)，调用者总会再比较键值
+    bitmask match(flat_ctrl_t h2) const noexcept
+    {
+        const uint64_t x = ctrl_ ^ (lsbs * static_cast<unsigned char>(h2));
+        return bitmask((x - lsbs) & ~x & msbs);
+    }
+
+    // 空槽：最高位为 1 且次低位为 0
+    bitmask match_empty() const noexcept
+    {
+        return bitmask((ctrl_ & ~(ctrl_ << 6)) & msbs);
+    }
+
+    // 空槽或已删除：最高位为 1 且最低位为 0
+    bitmask match_empty_or_deleted() const noexcept
+    {
+        return bitmask((ctrl_ & ~(ctrl_ << 7)) & msbs);
+    }
+};
+
+#if defined(__AVX2__) && defined(ORANGE_FLAT_GROUP_AVX2)
+
+/* AVX2 版本：一次比较 32 个控制字节，匹配结果由 movemask 直接得到，每个控制字节对应一位 */
+class flat_group_avx2
+{
+public:
+    enum { width = 32 };
+    typedef flat_bitmask<uint32_t, 0> bitmask;
+
+private:
+    __m256i ctrl_;
+
+public:
+    explicit flat_group_avx2(const flat_ctrl_t* pos) noexcept
+        :ctrl_(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos)))
+    {
+    }
+
+    bitmask match(flat_ctrl_t h2) const noexcept
+    {
+        return bitmask(static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl_))));
+    }
+
+    bitmask match_empty() const noexcept
+    {
+        return bitmask(static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(ECtrlEmpty), ctrl_))));
+    }
+
+    // 空槽与已删除都小于哨兵(有符号比较)
+    bitmask match_empty_or_deleted() const noexcept
+    {
+        return bitmask(static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(ECtrlSentinel), ctrl_))));
+    }
+};
+
+typedef flat_group_avx2 flat_group;
+
+#elif defined(ORANGE_FLAT_GROUP_SSE2)
+
+/* SSE2 版本：一次比较 16 个控制字节 */
+class flat_group_sse2
+{
+public:
+    enum { width = 16 };
+    typedef flat_bitmask<uint32_t, 0> bitmask;
+
+private:
+    __m128i ctrl_;
+
+public:
+    explicit flat_group_sse2(const flat_ctrl_t* pos) noexcept
+        :ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+    {
+    }
+
+    bitmask match(flat_ctrl_t h2) const noexcept
+    {
+        return bitmask(static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))));
+    }
+
+    bitmask match_empty() const noexcept
+    {
+        return bitmask(static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ECtrlEmpty), ctrl_))));
+    }
+
+    // 空槽与已删除都小于哨兵(有符号比较)
+    bitmask match_empty_or_deleted() const noexcept
+    {
+        return bitmask(static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ECtrlSentinel), ctrl_))));
+    }
+};
+
+typedef flat_group_sse2 flat_group;
+
+#else
+
+typedef flat_group_portable flat_group;
+
+#endif
+
+/* 探测序列：以组为单位做二次探测，第 i 步前进 i * width 个槽
+   槽的个数为 2^k - 1，配合掩码运算可以保证遍历所有组 */
+class flat_probe_seq
+{
+private:
+    size_t mask_;
+    size_t offset_;
+    size_t index_;
+
+public:
+    flat_probe_seq(size_t hash, size_t mask) noexcept
+        :mask_(mask), offset_(hash & mask), index_(0)
+    {
+    }
+
+    size_t offset() const noexcept { return offset_; }
+    size_t offset(size_t i) const noexcept { return (offset_ + i) & mask_; }
+
+    void next() noexcept
+    {
+        index_ += flat_group::width;
+        offset_ = (offset_ + index_) & mask_;
+    }
+};
+
+// 把用户的哈希值再打散一次，使 orange_stl::hash 这种恒等哈希在高低位上都足够均匀
+inline size_t flat_hash_mix(size_t h) noexcept
+{
+    uint64_t x = static_cast<uint64_t>(h);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+}
+
+/* flat_hashtable 的迭代器，指向一个槽，同时保存对应的控制字节位置 */
+template <class T, class Ref, class Ptr>
+struct flat_ht_iterator : public orange_stl::iterator<orange_stl::forward_iterator_tag, T>
+{
+    typedef flat_ht_iterator<T, T&, T*>               iterator;
+    typedef flat_ht_iterator<T, const T&, const T*>   const_iterator;
+    typedef flat_ht_iterator                          self;
+
+    typedef T                                         value_type;
+    typedef Ptr                                       pointer;
+    typedef Ref                                       reference;
+    typedef size_t                                    size_type;
+    typedef ptrdiff_t                                 difference_type;
+
+    const flat_ctrl_t* ctrl;   /* 当前槽的控制字节 */
+    T*                 slot;   /* 当前槽 */
+
+    flat_ht_iterator() noexcept : ctrl(nullptr), slot(nullptr) {}
+    flat_ht_iterator(const flat_ctrl_t* c, T* s) noexcept : ctrl(c), slot(s) {}
+    flat_ht_iterator(const iterator& rhs) noexcept : ctrl(rhs.ctrl), slot(rhs.slot) {}
+    flat_ht_iterator& operator=(const flat_ht_iterator&) noexcept = default;
+
+    reference operator*()  const { return *slot; }
+    pointer   operator->() const { return slot; }
+
+    self& operator++()
+    {
+        ++ctrl;
+        ++slot;
+        skip_empty_or_deleted();
+        return *this;
+    }
+    self operator++(int)
+    {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    // 跳过空槽与已删除的槽，哨兵保证循环会停止
+    void skip_empty_or_deleted()
+    {
+        while (flat_is_empty_or_deleted(*ctrl))
+        {
+            ++ctrl;
+            ++slot;
+        }
+    }
+
+    bool operator==(const self& rhs) const { return ctrl == rhs.ctrl; }
+    bool operator!=(const self& rhs) const { return ctrl != rhs.ctrl; }
+};
+
+// 模板类 flat_hashtable
+// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数，参数四代表空间配置器类型
+// 元素在扩容时会被移动，因此插入可能使迭代器、指针和引用失效
+template <class T, class Hash, class KeyEqual, class Alloc = orange_stl::allocator<T>>
+class flat_hashtable
+{
+public:
+    /* flat_hashtable 的型别定义 */
+    typedef ht_value_traits<T>                          value_traits;
+    typedef typename value_traits::key_type             key_type;
+    typedef typename value_traits::mapped_type          mapped_type;
+    typedef typename value_traits::value_type           value_type;
+    typedef Hash                                        hasher;
+    typedef KeyEqual                                    key_equal;
+
+    typedef Alloc                                               allocator_type;
+    typedef typename Alloc::template rebind<T>::other           data_allocator;
+    typedef typename Alloc::template rebind<flat_ctrl_t>::other ctrl_allocator;
+
+    typedef typename data_allocator::pointer            pointer;
+    typedef typename data_allocator::const_pointer      const_pointer;
+    typedef typename data_allocator::reference          reference;
+    typedef typename data_allocator::const_reference    const_reference;
+    typedef typename data_allocator::size_type          size_type;
+    typedef typename data_allocator::difference_type    difference_type;
+
+    typedef flat_ht_iterator<T, T&, T*>                 iterator;
+    typedef flat_ht_iterator<T, const T&, const T*>     const_iterator;
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type();
+    }
+
+private:
+    /* 用以下六个参数来表现 flat_hashtable */
+    flat_ctrl_t* ctrl_;         /* 控制字节，共 capacity_ + width 个：槽、哨兵、开头 width-1 个字节的副本 */
+    T*           slots_;        /* 槽数组，共 capacity_ 个 */
+    size_type    capacity_;     /* 槽的个数，为 0 或 2^k - 1 */
+    size_type    size_;         /* 元素个数 */
+    size_type    growth_left_;  /* 不扩容还能放入空槽的元素个数 */
+    hasher       hash_;
+    key_equal    equal_;
+
+public:
+    /* 构造、复制、移动、析构函数 */
+    explicit flat_hashtable(size_type bucket_count,
+                            const Hash& hash = Hash(),
+                            const KeyEqual& equal = KeyEqual())
+        :ctrl_(empty_ctrl()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+         hash_(hash), equal_(equal)
+    {
+        if (bucket_count > 0)
+            initialize_slots(growth_to_capacity(bucket_count));
+    }
+
+    flat_hashtable(const flat_hashtable& rhs)
+        :ctrl_(empty_ctrl()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+         hash_(rhs.hash_), equal_(rhs.equal_)
+    {
+        copy_init(rhs);
+    }
+
+    flat_hashtable(flat_hashtable&& rhs) noexcept
+        :ctrl_(rhs.ctrl_), slots_(rhs.slots_), capacity_(rhs.capacity_), size_(rhs.size_),
+         growth_left_(rhs.growth_left_), hash_(rhs.hash_), equal_(rhs.equal_)
+    {
+        rhs.reset_empty();
+    }
+
+    flat_hashtable& operator=(const flat_hashtable& rhs);
+    flat_hashtable& operator=(flat_hashtable&& rhs) noexcept;
+
+    ~flat_hashtable()
+    {
+        destroy_slots();
+    }
+
+    /* 迭代器相关操作 */
+    iterator begin() noexcept
+    {
+        iterator it(ctrl_, slots_);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    const_iterator begin() const noexcept
+    {
+        const_iterator it(ctrl_, slots_);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    iterator end() noexcept
+    {
+        return iterator(ctrl_ + capacity_, slots_ + capacity_);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(ctrl_ + capacity_, slots_ + capacity_);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    /* 容量相关操作 */
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+    /* 修改容器相关操作 */
+
+    // emplace / insert
+    template <class ...Args>
+    pair<iterator, bool> emplace_unique(Args&& ...args);
+
+    // 键值不存在时才以 args 在槽中构造元素，键值已存在时 args 不会被使用
+    template <class ...Args>
+    pair<iterator, bool> try_emplace_unique(const key_type& key, Args&& ...args);
+
+    pair<iterator, bool> insert_unique(const value_type& value)
+    {
+        return try_emplace_unique(value_traits::get_key(value), value);
+    }
+    pair<iterator, bool> insert_unique(value_type&& value)
+    {
+        const key_type& key = value_traits::get_key(value);
+        return try_emplace_unique(key, orange_stl::move(value));
+    }
+
+    template <class InputIter>
+    void insert_unique(InputIter first, InputIter last)
+    {
+        for (; first != last; ++first)
+            insert_unique(*first);
+    }
+
+    // erase / clear
+    void erase(const_iterator position);
+    void erase(const_iterator first, const_iterator last);
+
+    size_type erase_unique(const key_type& key);
+
+    void clear();
+
+    void swap(flat_hashtable& rhs) noexcept;
+
+    /* 查找相关操作 */
+    /* 带有 K 模板参数的重载用于异构查找，只在 Hash 与 KeyEqual 都声明了 is_transparent 时参与重载决议 */
+    iterator       find(const key_type& key)       { return find_key(key); }
+    const_iterator find(const key_type& key) const { return find_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    iterator       find(const K& key)              { return find_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    const_iterator find(const K& key) const        { return find_key(key); }
+
+    size_type count(const key_type& key) const
+    {
+        return find_index(key, hash_of(key)) == capacity_ ? 0 : 1;
+    }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    size_type count(const K& key) const
+    {
+        return find_index(key, hash_of(key)) == capacity_ ? 0 : 1;
+    }
+
+    pair<iterator, iterator> equal_range_unique(const key_type& key)
+    { return equal_range_key(key); }
+    pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+    { return equal_range_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    pair<iterator, iterator> equal_range_unique(const K& key)
+    { return equal_range_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+    { return equal_range_key(key); }
+
+    /* 容量与哈希策略 */
+    size_type bucket_count() const noexcept { return capacity_; }
+
+    float load_factor() const noexcept
+    {
+        return capacity_ != 0 ? static_cast<float>(size_) / capacity_ : 0.0f;
+    }
+
+    // 最大负载系数固定为 7/8
+    float max_load_factor() const noexcept { return 0.875f; }
+
+    void rehash(size_type count);
+    void reserve(size_type count);
+
+    hasher    hash_fcn() const { return hash_; }
+    key_equal key_eq()   const { return equal_; }
+
+    bool equal_to_unique(const flat_hashtable& other) const;
+
+private:
+    /* 辅助函数 */
+
+    // 空表共享的控制字节：一个哨兵之后全是空槽，不会被写入
+    static flat_ctrl_t* empty_ctrl() noexcept
+    {
+        alignas(32) static const flat_ctrl_t ctrl[32] = {
+            ECtrlSentinel, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty,
+            ECtrlEmpty,    ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty,
+            ECtrlEmpty,    ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty,
+            ECtrlEmpty,    ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty
+        };
+        return const_cast<flat_ctrl_t*>(ctrl);
+    }
+
+    // 哈希值的高位用于选择起始组，低 7 位存入控制字节
+    static size_t      h1(size_t hash) noexcept { return hash >> 7; }
+    static flat_ctrl_t h2(size_t hash) noexcept { return static_cast<flat_ctrl_t>(hash & 0x7f); }
+
+    template <class K>
+    size_t hash_of(const K& key) const
+    {
+        return flat_hash_mix(hash_(key));
+    }
+
+    iterator iterator_at(size_type n) noexcept
+    {
+        return iterator(ctrl_ + n, slots_ + n);
+    }
+    const_iterator const_iterator_at(size_type n) const noexcept
+    {
+        return const_iterator(ctrl_ + n, slots_ + n);
+    }
+
+    // 容量为 capacity 时，不扩容最多能放入的元素个数，始终保留至少一个空槽使查找能够终止
+    static size_type capacity_to_growth(size_type capacity) noexcept
+    {
+        const size_type growth = capacity - capacity / 8;
+        return growth == capacity ? capacity - 1 : growth;
+    }
+
+    // 能放入 n 个元素的最小容量
+    static size_type growth_to_capacity(size_type n) noexcept
+    {
+        size_type capacity = flat_group::width - 1;
+        while (capacity_to_growth(capacity) < n)
+            capacity = capacity * 2 + 1;
+        return capacity;
+    }
+
+    // 写入第 n 个槽的控制字节，同时更新位于末尾的副本
+    void set_ctrl(size_type n, flat_ctrl_t c) noexcept
+    {
+        const size_type cloned = flat_group::width - 1;
+        ctrl_[n] = c;
+        ctrl_[((n - cloned) & capacity_) + (cloned & capacity_)] = c;
+    }
+
+    void      initialize_slots(size_type capacity);
+    void      destroy_slots() noexcept;
+    void      reset_empty() noexcept;
+    void      copy_init(const flat_hashtable& rhs);
+    void      resize(size_type new_capacity);
+    void      rehash_and_grow_if_necessary();
+
+    // K 为 key_type 或者透明的哈希函数与比较函数接受的其他类型
+    template <class K>
+    size_type find_index(const K& key, size_t hash) const;
+    template <class K>
+    iterator find_key(const K& key)
+    {
+        const size_type n = find_index(key, hash_of(key));
+        return n == capacity_ ? end() : iterator_at(n);
+    }
+    template <class K>
+    const_iterator find_key(const K& key) const
+    {
+        const size_type n = find_index(key, hash_of(key));
+        return n == capacity_ ? end() : const_iterator_at(n);
+    }
+    template <class K>
+    pair<iterator, iterator> equal_range_key(const K& key);
+    template <class K>
+    pair<const_iterator, const_iterator> equal_range_key(const K& key) const;
+    size_type find_first_non_full(size_t hash) const noexcept;
+    size_type prepare_insert(size_t hash);
+    void      erase_at(size_type n) noexcept;
+};
+
+/* ***************************************************************************** */
+
+// 复制赋值运算符
+template <class T, class Hash, class KeyEqual, class Alloc>
+flat_hashtable<T, Hash, KeyEqual, Alloc>&
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+operator=(const flat_hashtable& rhs)
+{
+    if (this != &rhs)
+    {
+        flat_hashtable tmp(rhs);
+        swap(tmp);
+    }
+    return *this;
+}
+
+// 移动赋值运算符
+template <class T, class Hash, class KeyEqual, class Alloc>
+flat_hashtable<T, Hash, KeyEqual, Alloc>&
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+operator=(flat_hashtable&& rhs) noexcept
+{
+    flat_hashtable tmp(orange_stl::move(rhs));
+    swap(tmp);
+    return *this;
+}
+
+// 就地构造元素，若键值已存在则不插入
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+emplace_unique(Args&& ...args)
+{
+    // 需要先构造出元素才能得到键值
+    value_type tmp(orange_stl::forward<Args>(args)...);
+    return insert_unique(orange_stl::move(tmp));
+}
+
+// 键值不存在时在新的槽中以 args 构造元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+try_emplace_unique(const key_type& key, Args&& ...args)
+{
+    const size_t hash = hash_of(key);
+    size_type n = find_index(key, hash);
+    if (n != capacity_)
+        return orange_stl::make_pair(iterator_at(n), false);
+
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "flat_hashtable<T, Hash, KeyEqual>'s size too big");
+    n = prepare_insert(hash);
+    try
+    {
+        data_allocator::construct(slots_ + n, orange_stl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        erase_at(n);
+        throw;
+    }
+    return orange_stl::make_pair(iterator_at(n), true);
+}
+
+// 删除迭代器所指的元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+erase(const_iterator position)
+{
+    const size_type n = static_cast<size_type>(position.ctrl - ctrl_);
+    data_allocator::destroy(slots_ + n);
+    erase_at(n);
+}
+
+// 删除[first, last)内的元素，删除不会移动其他元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+erase(const_iterator first, const_iterator last)
+{
+    while (first != last)
+    {
+        const_iterator next = first;
+        ++next;
+        erase(first);
+        first = next;
+    }
+}
+
+// 删除键值为 key 的元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+erase_unique(const key_type& key)
+{
+    const size_type n = find_index(key, hash_of(key));
+    if (n == capacity_)
+        return 0;
+    data_allocator::destroy(slots_ + n);
+    erase_at(n);
+    return 1;
+}
+
+// 清空元素，保留槽数组
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+clear()
+{
+    if (capacity_ == 0)
+        return;
+    for (size_type i = 0; i < capacity_; ++i)
+    {
+        if (flat_is_full(ctrl_[i]))
+            data_allocator::destroy(slots_ + i);
+    }
+    std::memset(ctrl_, ECtrlEmpty, capacity_ + flat_group::width);
+    ctrl_[capacity_] = ECtrlSentinel;
+    size_ = 0;
+    growth_left_ = capacity_to_growth(capacity_);
+}
+
+// 交换 flat_hashtable
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+swap(flat_hashtable& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        orange_stl::swap(ctrl_, rhs.ctrl_);
+        orange_stl::swap(slots_, rhs.slots_);
+        orange_stl::swap(capacity_, rhs.capacity_);
+        orange_stl::swap(size_, rhs.size_);
+        orange_stl::swap(growth_left_, rhs.growth_left_);
+        orange_stl::swap(hash_, rhs.hash_);
+        orange_stl::swap(equal_, rhs.equal_);
+    }
+}
+
+// 查找与键值 key 相等的区间
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class K>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator,
+     typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+equal_range_key(const K& key)
+{
+    iterator it = find_key(key);
+    if (it == end())
+        return orange_stl::make_pair(it, it);
+    iterator next = it;
+    return orange_stl::make_pair(it, ++next);
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class K>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::const_iterator,
+     typename flat_hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+equal_range_key(const K& key) const
+{
+    const_iterator it = find_key(key);
+    if (it == end())
+        return orange_stl::make_pair(it, it);
+    const_iterator next = it;
+    return orange_stl::make_pair(it, ++next);
+}
+
+// 重新调整槽的个数，使其至少能容纳 count 个槽与现有的全部元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+rehash(size_type count)
+{
+    if (count == 0 && size_ == 0)
+    {
+        destroy_slots();
+        reset_empty();
+        return;
+    }
+    size_type new_capacity = flat_group::width - 1;
+    while (new_capacity < count)
+        new_capacity = new_capacity * 2 + 1;
+    new_capacity = orange_stl::max(new_capacity, growth_to_capacity(size_));
+    if (new_capacity != capacity_)
+        resize(new_capacity);
+}
+
+// 预留空间，使插入 count 个元素之前不会扩容
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+reserve(size_type count)
+{
+    if (count > size_ + growth_left_)
+        resize(growth_to_capacity(count));
+}
+
+// 判断两个 flat_hashtable 是否相等
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool flat_hashtable<T, Hash, KeyEqual, Alloc>::
+equal_to_unique(const flat_hashtable& other) const
+{
+    if (size_ != other.size_)
+        return false;
+    for (const_iterator it = begin(), last = end(); it != last; ++it)
+    {
+        const_iterator res = other.find(value_traits::get_key(*it));
+        if (res == other.end() || !(*res == *it))
+            return false;
+    }
+    return true;
+}
+
+/* ***************************************************************************** */
+// helper function
+
+// 配置 capacity 个槽与对应的控制字节，所有槽置为空
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+initialize_slots(size_type capacity)
+{
+    THROW_LENGTH_ERROR_IF(capacity > max_size() / 2, "flat_hashtable<T, Hash, KeyEqual>'s size too big");
+    flat_ctrl_t* ctrl = ctrl_allocator::allocate(capacity + flat_group::width);
+    T* slots = nullptr;
+    try
+    {
+        slots = data_allocator::allocate(capacity);
+    }
+    catch (...)
+    {
+        ctrl_allocator::deallocate(ctrl, capacity + flat_group::width);
+        throw;
+    }
+    std::memset(ctrl, ECtrlEmpty, capacity + flat_group::width);
+    ctrl[capacity] = ECtrlSentinel;
+    ctrl_ = ctrl;
+    slots_ = slots;
+    capacity_ = capacity;
+    growth_left_ = capacity_to_growth(capacity) - size_;
+}
+
+// 析构所有元素并释放槽数组
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+destroy_slots() noexcept
+{
+    if (capacity_ == 0)
+        return;
+    for (size_type i = 0; i < capacity_; ++i)
+    {
+        if (flat_is_full(ctrl_[i]))
+            data_allocator::destroy(slots_ + i);
+    }
+    data_allocator::deallocate(slots_, capacity_);
+    ctrl_allocator::deallocate(ctrl_, capacity_ + flat_group::width);
+}
+
+// 恢复为不持有任何内存的空表
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+reset_empty() noexcept
+{
+    ctrl_ = empty_ctrl();
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growth_left_ = 0;
+}
+
+// 复制另一个 flat_hashtable：哈希函数相同，因此元素可以放在相同的槽中
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+copy_init(const flat_hashtable& rhs)
+{
+    if (rhs.size_ == 0)
+        return;
+    initialize_slots(rhs.capacity_);
+    size_type i = 0;
+    try
+    {
+        for (; i < capacity_; ++i)
+        {
+            if (flat_is_full(rhs.ctrl_[i]))
+                data_allocator::construct(slots_ + i, rhs.slots_[i]);
+        }
+    }
+    catch (...)
+    {
+        for (size_type j = 0; j < i; ++j)
+        {
+            if (flat_is_full(rhs.ctrl_[j]))
+                data_allocator::destroy(slots_ + j);
+        }
+        data_allocator::deallocate(slots_, capacity_);
+        ctrl_allocator::deallocate(ctrl_, capacity_ + flat_group::width);
+        reset_empty();
+        throw;
+    }
+    std::memcpy(ctrl_, rhs.ctrl_, capacity_ + flat_group::width);
+    size_ = rhs.size_;
+    growth_left_ = rhs.growth_left_;
+}
+
+// 换用 new_capacity 个槽，把元素逐个移动到新的槽中，同时清除所有已删除标记
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+resize(size_type new_capacity)
+{
+    flat_ctrl_t* old_ctrl = ctrl_;
+    T*           old_slots = slots_;
+    const size_type old_capacity = capacity_;
+
+    initialize_slots(new_capacity);
+    for (size_type i = 0; i < old_capacity; ++i)
+    {
+        if (flat_is_full(old_ctrl[i]))
+        {
+            const size_t hash = hash_of(value_traits::get_key(old_slots[i]));
+            const size_type n = find_first_non_full(hash);
+            set_ctrl(n, h2(hash));
+            data_allocator::construct(slots_ + n, orange_stl::move(old_slots[i]));
+            data_allocator::destroy(old_slots + i);
+        }
+    }
+    if (old_capacity != 0)
+    {
+        data_allocator::deallocate(old_slots, old_capacity);
+        ctrl_allocator::deallocate(old_ctrl, old_capacity + flat_group::width);
+    }
+}
+
+// 没有可用的空槽时调用：已删除的槽较多就原地重排，否则容量翻倍
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+rehash_and_grow_if_necessary()
+{
+    if (capacity_ == 0)
+        resize(flat_group::width - 1);
+    else if (size_ <= capacity_to_growth(capacity_) / 2)
+        resize(capacity_);
+    else
+        resize(capacity_ * 2 + 1);
+}
+
+// 查找键值为 key 的槽，找不到时返回 capacity_
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class K>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+find_index(const K& key, size_t hash) const
+{
+    flat_probe_seq seq(h1(hash), capacity_);
+    while (true)
+    {
+        flat_group group(ctrl_ + seq.offset());
+        for (auto match = group.match(h2(hash)); match; match.clear_lowest())
+        {
+            const size_type n = seq.offset(match.lowest());
+            if (equal_(value_traits::get_key(slots_[n]), key))
+                return n;
+        }
+        // 组内有空槽说明插入时不会越过这一组，查找到此为止
+        if (group.match_empty())
+            return capacity_;
+        seq.next();
+    }
+}
+
+// 沿着 hash 的探测序列找到第一个空槽或已删除的槽
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+find_first_non_full(size_t hash) const noexcept
+{
+    flat_probe_seq seq(h1(hash), capacity_);
+    while (true)
+    {
+        auto match = flat_group(ctrl_ + seq.offset()).match_empty_or_deleted();
+        if (match)
+            return seq.offset(match.lowest());
+        seq.next();
+    }
+}
+
+// 为哈希值为 hash 的新元素准备一个槽，必要时扩容，返回槽的下标，调用者负责在槽中构造元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+prepare_insert(size_t hash)
+{
+    size_type n = find_first_non_full(hash);
+    if (growth_left_ == 0 && ctrl_[n] != ECtrlDeleted)
+    {
+        rehash_and_grow_if_necessary();
+        n = find_first_non_full(hash);
+    }
+    ++size_;
+    if (ctrl_[n] == ECtrlEmpty)
+        --growth_left_;
+    set_ctrl(n, h2(hash));
+    return n;
+}
+
+// 把第 n 个槽标记为已删除，元素已由调用者析构
+// 已删除的槽仍然让探测序列继续向后查找，它可以被之后的插入复用，也会在下一次重排时清除
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+erase_at(size_type n) noexcept
+{
+    --size_;
+    set_ctrl(n, ECtrlDeleted);
+}
+
+// 重载 orange_stl 的 swap
+template <class T, class Hash, class KeyEqual, class Alloc>
+void swap(flat_hashtable<T, Hash, KeyEqual, Alloc>& lhs,
+          flat_hashtable<T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_FLAT_HASHTABLE_H__
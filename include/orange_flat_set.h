@@ -0,0 +1,727 @@
+#ifndef __ORANGE_FLAT_SET_H__
+#define __ORANGE_FLAT_SET_H__
+
+// flat_set      : 集合，键值即实值，集合内元素会自动排序，键值不允许重复
+// flat_multiset : 集合，键值即实值，集合内元素会自动排序，键值允许重复
+// 接口与 set/multiset 相同(没有节点句柄相关的操作)，不同的是使用 flat_tree 作为底层实现机制：
+// 元素有序地存放在连续的 vector 中，查找为二分查找，遍历是顺序访存，内存占用只有元素本身
+// 单个元素的插入和删除为 O(n)，适合构造后以查找为主的场合；区间插入只排序、归并一次
+// 插入和删除会使迭代器、指针和引用失效，与 vector 相同
+
+#include "orange_flat_tree.h"
+
+namespace orange_stl
+{
+
+// 模板类flat_set，键值不允许重复
+// 参一：键值类型   参二：键值的比较方式，默认使用orange_stl::less   参三：空间配置器类型
+template <class Key, class Compare = orange_stl::less<Key>, class Alloc = orange_stl::allocator<Key>>
+class flat_set
+{
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+
+private:
+    /* 使用flat_tree作为底层 */
+    typedef orange_stl::flat_tree<orange_stl::flat_set_storage<Key, Alloc>, key_compare> base_type;
+    base_type tree_;
+
+public:
+    typedef typename base_type::const_pointer          pointer;
+    typedef typename base_type::const_pointer          const_pointer;
+    typedef typename base_type::const_reference        reference;
+    typedef typename base_type::const_reference        const_reference;
+    typedef typename base_type::const_iterator         iterator;
+    typedef typename base_type::const_iterator         const_iterator;
+    typedef typename base_type::const_reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type              size_type;
+    typedef typename base_type::difference_type        difference_type;
+    typedef typename base_type::allocator_type         allocator_type;
+
+public:
+    // 构造、复制和移动函数
+    flat_set() = default;
+    template <class InputIterator>
+    flat_set(InputIterator first, InputIterator last) : tree_()
+    {
+        tree_.insert_unique(first, last);
+    }    
+    
+    flat_set(std::initializer_list<value_type> ilist) : tree_()
+    {
+        tree_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_set(const flat_set& rhs) : tree_(rhs.tree_)
+    { }
+
+    flat_set(flat_set&& rhs) noexcept : tree_(orange_stl::move(rhs.tree_))
+    { }
+
+    flat_set& operator=(const flat_set& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    flat_set& operator=(flat_set&& rhs)
+    {
+        tree_ = orange_stl::move(rhs.tree_);
+        return *this;
+    }
+    flat_set& operator=(std::initializer_list<value_type> ilist)
+    {
+        tree_.clear();
+        tree_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    key_compare key_comp() const
+    {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const
+    {
+        return tree_.key_comp();
+    }
+    allocator_type get_allocator() const
+    {
+        return tree_.get_allocator();
+    }
+
+    /* 迭代器相关操作 */
+    iterator begin() noexcept
+    {
+        return tree_.begin();
+    }
+    const_iterator begin() const noexcept
+    {
+        return tree_.begin();
+    }
+    iterator end() noexcept
+    {
+        return tree_.end();
+    }
+    const_iterator end() const noexcept
+    {
+        return tree_.end();
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
+    /* 容量相关 */
+    bool empty() const noexcept 
+    {
+        return tree_.empty();
+    }
+    size_type size() const noexcept
+    {
+        return tree_.size();
+    }
+    size_type max_size() const noexcept
+    {
+        return tree_.max_size();
+    }
+    size_type capacity() const noexcept
+    {
+        return tree_.capacity();
+    }
+    void reserve(size_type n)
+    {
+        tree_.reserve(n);
+    }
+    void shrink_to_fit()
+    {
+        tree_.shrink_to_fit();
+    }
+
+    /* 插入删除操作 */
+    template <class ...Args>
+    pair<iterator, bool> emplace(Args&& ...args)
+    {
+        return tree_.emplace_unique(orange_stl::forward<Args>(args)...);
+    }
+
+    template <class ...Args>
+    iterator emplace_hint(iterator hint, Args&& ...args)
+    {
+        return tree_.emplace_unique_use_hint(hint, orange_stl::forward<Args>(args)...);
+    }
+
+    pair<iterator, bool> insert(const value_type& value)
+    {
+        return tree_.insert_unique(value);
+    }
+
+    pair<iterator, bool> insert(value_type&& value)
+    {
+        return tree_.insert_unique(orange_stl::move(value));
+    }
+
+    iterator insert(iterator hint, const value_type& value)
+    {
+        return tree_.insert_unique(hint, value);
+    }
+
+    iterator insert(iterator hint, value_type&& value)
+    {
+        return tree_.insert_unique(hint, orange_stl::move(value));
+    }
+    
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        tree_.insert_unique(first, last);
+    }
+
+    iterator erase(iterator position)
+    {
+        return tree_.erase(position);
+    }
+    size_type erase(const key_type& key)
+    {
+        return tree_.erase_unique(key);
+    }
+    iterator erase(iterator first, iterator last)
+    {
+        return tree_.erase(first, last);
+    }
+    void clear()
+    {
+        tree_.clear();
+    }
+
+    /* set相关的操作 */
+    iterator find(const key_type& key)
+    {
+        return tree_.find(key);
+    }
+    const_iterator find(const key_type& key) const  
+    {
+        return tree_.find(key);
+    }
+
+    /* 此处可以看出count没有find快 */
+    size_type count(const key_type& key) const
+    {
+        return tree_.count_unique(key);
+    }
+
+    /* 键值不小于key的第一个位置 */
+    iterator lower_bound(const key_type& key)
+    {
+        return tree_.lower_bound(key);
+    }
+
+    const_iterator lower_bound(const key_type& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    /* 键值不小于key的最后一个位置 */
+    iterator upper_bound(const key_type& key)
+    {
+        return tree_.upper_bound(key);
+    }
+
+    const_iterator upper_bound(const key_type& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key)
+    {
+        return tree_.equal_range_unique(key);
+    }
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+        return tree_.equal_range_unique(key);
+    }
+
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_unique(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_unique(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return tree_.equal_range_unique(key);
+    }
+
+    void swap(flat_set& rhs) noexcept
+    {
+        tree_.swap(rhs.tree_);
+    }
+
+public:
+    friend bool operator==(const flat_set& lhs, const flat_set& rhs)
+    {
+        return lhs.tree_==rhs.tree_;
+    }
+    friend bool operator<(const flat_set& lhs, const flat_set& rhs)
+    {
+        return lhs.tree_<rhs.tree_;
+    }
+};
+
+// 重载比较操作符
+template <class Key, class Compare, class Alloc>
+bool operator==(const flat_set<Key, Compare, Alloc>& lhs, const flat_set<Key, Compare, Alloc>& rhs)
+{
+  return lhs == rhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator<(const flat_set<Key, Compare, Alloc>& lhs, const flat_set<Key, Compare, Alloc>& rhs)
+{
+  return lhs < rhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator!=(const flat_set<Key, Compare, Alloc>& lhs, const flat_set<Key, Compare, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>(const flat_set<Key, Compare, Alloc>& lhs, const flat_set<Key, Compare, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator<=(const flat_set<Key, Compare, Alloc>& lhs, const flat_set<Key, Compare, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>=(const flat_set<Key, Compare, Alloc>& lhs, const flat_set<Key, Compare, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+/* 重载orange_stl 的swap */
+template <class Key, class Compare, class Alloc>
+void sawp(flat_set<Key, Compare, Alloc>& lhs, flat_set<Key, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+/* 模板类flat_multiset 键值允许重复 */
+template <class Key, class Compare = orange_stl::less<Key>, class Alloc = orange_stl::allocator<Key>>
+class flat_multiset
+{
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+private:
+    /* 使用flat_tree作为底层 */
+    typedef orange_stl::flat_tree<orange_stl::flat_set_storage<Key, Alloc>, key_compare> base_type;
+    base_type tree_;
+
+public:
+    typedef typename base_type::const_pointer          pointer;
+    typedef typename base_type::const_pointer          const_pointer;
+    typedef typename base_type::const_reference        reference;
+    typedef typename base_type::const_reference        const_reference;
+    typedef typename base_type::const_iterator         iterator;
+    typedef typename base_type::const_iterator         const_iterator;
+    typedef typename base_type::const_reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type              size_type;
+    typedef typename base_type::difference_type        difference_type;
+    typedef typename base_type::allocator_type         allocator_type;
+
+public:
+    /* 复制，构造和移动函数 */
+    flat_multiset() = default;
+
+    template <class InputIterator>
+    flat_multiset(InputIterator first, InputIterator last):tree_()
+    {
+        tree_.insert_multi(first, last);
+    }
+    flat_multiset(std::initializer_list<value_type> ilist):tree_()
+    {
+        tree_.insert_multi(ilist.begin(), ilist.end());
+    }
+    flat_multiset(const flat_multiset& rhs):tree_(rhs.tree_)
+    { }
+    flat_multiset(flat_multiset&& rhs) noexcept :tree_(orange_stl::move(rhs.tree_))
+    { }
+
+    flat_multiset& operator=(const flat_multiset& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    flat_multiset& operator=(flat_multiset&& rhs)
+    {
+        tree_ = orange_stl::move(rhs.tree_);
+        return *this;
+    }
+    flat_multiset& operator=(std::initializer_list<value_type> ilist)    
+    {
+        tree_.clear();
+        tree_.insert_multi(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    /* 相关接口 */
+    key_compare key_comp() const
+    {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const
+    {
+        return tree_.key_comp();
+    }
+    allocator_type get_allocator() const
+    {
+        return tree_.get_allocator();
+    }
+
+    // 迭代器相关
+
+    iterator               begin()         noexcept
+    { return tree_.begin(); }
+    const_iterator         begin()   const noexcept
+    { return tree_.begin(); }
+    iterator               end()           noexcept
+    { return tree_.end(); }
+    const_iterator         end()     const noexcept
+    { return tree_.end(); }
+
+    reverse_iterator       rbegin()        noexcept
+    { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept
+    { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept
+    { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept
+    { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept
+    { return begin(); }
+    const_iterator         cend()    const noexcept
+    { return end(); }
+    const_reverse_iterator crbegin() const noexcept
+    { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept
+    { return rend(); }
+
+    // 容量相关
+    bool        empty()    const noexcept 
+    { 
+        return tree_.empty(); 
+    }
+    size_type   size()     const noexcept 
+    { 
+        return tree_.size(); 
+    }
+    size_type   max_size() const noexcept 
+    { 
+        return tree_.max_size(); 
+    }
+    size_type   capacity() const noexcept
+    {
+        return tree_.capacity();
+    }
+    void        reserve(size_type n)
+    {
+        tree_.reserve(n);
+    }
+    void        shrink_to_fit()
+    {
+        tree_.shrink_to_fit();
+    }
+
+    /* 插入删除操作 */
+    template <class ...Args>
+    iterator emplace(Args&& ...args)
+    {
+        return tree_.emplace_multi(orange_stl::forward<Args>(args)...);
+    }
+    template <class ...Args>
+    iterator emplace_hint(iterator hint, Args&& ...args)
+    {
+        return tree_.emplace_multi_use_hint(hint, orange_stl::forward<Args>(args)...);
+    }
+    iterator insert(const value_type& value)
+    {
+        return tree_.insert_multi(value);
+    }
+    iterator insert(value_type&& value)
+    {
+        return tree_.insert_multi(orange_stl::move(value));
+    }
+
+    iterator insert(iterator hint, const value_type& value)
+    {
+        return tree_.insert_multi(hint, value);
+    }
+    iterator insert(iterator hint, value_type&& value)
+    {
+        return tree_.insert_multi(hint, orange_stl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        tree_.insert_multi(first, last);
+    }
+
+    iterator erase(iterator position)
+    {
+        return tree_.erase(position);
+    }
+    size_type erase(const key_type& key)
+    {
+        return tree_.erase_multi(key);
+    }
+    iterator erase(iterator first, iterator last)
+    {
+        return tree_.erase(first, last);
+    }
+    void clear()
+    {
+        tree_.clear();
+    }
+
+    iterator       find(const key_type& key)              
+    { 
+        return tree_.find(key); 
+    }
+    const_iterator find(const key_type& key)        const 
+    { 
+        return tree_.find(key); 
+    }
+
+    size_type      count(const key_type& key)       const 
+    { 
+        return tree_.count_multi(key); 
+    }
+
+    iterator       lower_bound(const key_type& key)       
+    { 
+        return tree_.lower_bound(key); 
+    }
+    const_iterator lower_bound(const key_type& key) const 
+    { 
+        return tree_.lower_bound(key); 
+    }
+
+    iterator       upper_bound(const key_type& key)      
+    { 
+        return tree_.upper_bound(key); 
+    }
+    const_iterator upper_bound(const key_type& key) const
+    { 
+        return tree_.upper_bound(key); 
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key)
+    {
+        return tree_.equal_range_multi(key);
+    }
+
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+        return tree_.equal_range_multi(key);
+    }
+
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_multi(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_multi(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return tree_.equal_range_multi(key);
+    }
+
+    void swap(flat_multiset& rhs) noexcept
+    {
+        tree_.swap(rhs.tree_);
+    }
+
+public:
+    friend bool operator==(const flat_multiset& lhs, const flat_multiset& rhs)
+    {
+        return lhs.tree_==rhs.tree_;
+    }
+    friend bool operator<(const flat_multiset& lhs, const flat_multiset& rhs)
+    {
+        return lhs.tree_<rhs.tree_;
+    }
+
+    
+};
+
+// 重载比较操作符
+template <class Key, class Compare, class Alloc>
+bool operator==(const flat_multiset<Key, Compare, Alloc>& lhs, const flat_multiset<Key, Compare, Alloc>& rhs)
+{
+    return lhs == rhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator<(const flat_multiset<Key, Compare, Alloc>& lhs, const flat_multiset<Key, Compare, Alloc>& rhs)
+{
+    return lhs < rhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator!=(const flat_multiset<Key, Compare, Alloc>& lhs, const flat_multiset<Key, Compare, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>(const flat_multiset<Key, Compare, Alloc>& lhs, const flat_multiset<Key, Compare, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator<=(const flat_multiset<Key, Compare, Alloc>& lhs, const flat_multiset<Key, Compare, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>=(const flat_multiset<Key, Compare, Alloc>& lhs, const flat_multiset<Key, Compare, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class Compare, class Alloc>
+void swap(flat_multiset<Key, Compare, Alloc>& lhs, flat_multiset<Key, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // end orange_stl
+
+#endif // !__ORANGE_FLAT_SET_H__
\ No newline at end of file
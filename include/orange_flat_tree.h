@@ -0,0 +1,864 @@
+#ifndef __ORANGE_FLAT_TREE_H__
+#define __ORANGE_FLAT_TREE_H__
+
+// 这个头文件包含有序向量 flat_tree，作为 flat_map、flat_set 等容器的底层机制
+// 元素按键值有序地存放在 orange_stl::vector 中，查找为连续空间上的二分查找，没有任何节点指针
+// 单个元素的插入和删除需要移动其后的所有元素，为 O(n)；区间插入先把新元素排序，再与原有元素线性归并一次
+// 插入和删除会使迭代器、指针和引用失效，与 vector 相同
+// 键值和实值的存放方式由 storage 决定：
+// 1. flat_set_storage：只有键值的一个 vector
+// 2. flat_interleaved_storage：pair<Key, T> 的一个 vector，键值和实值交错存放
+// 3. flat_split_storage：键值与实值各一个 vector，查找只扫描紧凑的键值数组，迭代器解引用得到 pair<const Key&, T&>
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <tuple>
+
+#include "orange_vector.h"
+#include "orange_iterator.h"
+#include "orange_memory.h"
+#include "orange_functional.h"
+#include "orange_type_traits.h"
+#include "orange_algo.h"
+#include "orange_util.h"
+
+namespace orange_stl
+{
+
+// flat_set_storage：只存放键值，元素不可修改，iterator 与 const_iterator 相同
+template <class Key, class Alloc>
+class flat_set_storage
+{
+public:
+    typedef Key                                                 key_type;
+    typedef Key                                                 value_type;
+    typedef Alloc                                               allocator_type;
+    typedef typename Alloc::template rebind<Key>::other         key_allocator;
+    typedef orange_stl::vector<Key, key_allocator>              key_container;
+    typedef typename key_container::const_iterator              iterator;
+    typedef typename key_container::const_iterator              const_iterator;
+    typedef size_t                                              size_type;
+
+private:
+    key_container keys_;
+
+public:
+    static const key_type& get_key(const value_type& value) { return value; }
+
+    iterator       begin()        noexcept { return keys_.cbegin(); }
+    const_iterator begin()  const noexcept { return keys_.cbegin(); }
+    const_iterator cbegin() const noexcept { return keys_.cbegin(); }
+    iterator       end()          noexcept { return keys_.cend(); }
+    const_iterator end()    const noexcept { return keys_.cend(); }
+
+    size_type size()     const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+    void      reserve(size_type n)      { keys_.reserve(n); }
+    void      shrink_to_fit()           { keys_.shrink_to_fit(); }
+    void      clear()                   { keys_.clear(); }
+    void      swap(flat_set_storage& rhs) noexcept { keys_.swap(rhs.keys_); }
+
+    const key_type& key(size_type i) const { return keys_[i]; }
+
+    template <class K, class Compare>
+    size_type lower_bound(const K& key, Compare comp) const
+    {
+        return orange_stl::lower_bound(keys_.begin(), keys_.end(), key, comp) - keys_.begin();
+    }
+    template <class K, class Compare>
+    size_type upper_bound(const K& key, Compare comp) const
+    {
+        return orange_stl::upper_bound(keys_.begin(), keys_.end(), key, comp) - keys_.begin();
+    }
+
+    template <class V>
+    void insert_value(size_type i, V&& value)
+    {
+        keys_.emplace(keys_.begin() + i, orange_stl::forward<V>(value));
+    }
+    void erase(size_type first, size_type last)
+    {
+        keys_.erase(keys_.begin() + first, keys_.begin() + last);
+    }
+
+    /* 归并时向末尾追加 */
+    void push_back_value(value_type&& value) { keys_.push_back(orange_stl::move(value)); }
+    void push_back_from(flat_set_storage& src, size_type i) { keys_.push_back(orange_stl::move(src.keys_[i])); }
+};
+
+// flat_interleaved_storage：pair<Key, T> 交错存放，一次缓存未命中即可同时取得键值和实值
+// vector 中的元素需要可以赋值，因此 value_type 为 pair<Key, T>，修改键值会破坏有序性，使用者不应这样做
+template <class Key, class T, class Alloc>
+class flat_interleaved_storage
+{
+public:
+    typedef Key                                                 key_type;
+    typedef T                                                   mapped_type;
+    typedef orange_stl::pair<Key, T>                            value_type;
+    typedef Alloc                                               allocator_type;
+    typedef typename Alloc::template rebind<value_type>::other  value_allocator;
+    typedef orange_stl::vector<value_type, value_allocator>     value_container;
+    typedef typename value_container::iterator                  iterator;
+    typedef typename value_container::const_iterator            const_iterator;
+    typedef size_t                                              size_type;
+
+private:
+    // 以键值比较 value_type 与查找所用的 K
+    template <class Compare>
+    struct key_compare_adapter
+    {
+        Compare comp;
+        explicit key_compare_adapter(Compare c) : comp(c) {}
+
+        template <class K>
+        bool operator()(const value_type& lhs, const K& rhs) { return comp(lhs.first, rhs); }
+        template <class K>
+        bool operator()(const K& lhs, const value_type& rhs) { return comp(lhs, rhs.first); }
+    };
+
+    value_container data_;
+
+public:
+    static const key_type& get_key(const value_type& value) { return value.first; }
+
+    iterator       begin()        noexcept { return data_.begin(); }
+    const_iterator begin()  const noexcept { return data_.begin(); }
+    const_iterator cbegin() const noexcept { return data_.begin(); }
+    iterator       end()          noexcept { return data_.end(); }
+    const_iterator end()    const noexcept { return data_.end(); }
+
+    size_type size()     const noexcept { return data_.size(); }
+    size_type max_size() const noexcept { return data_.max_size(); }
+    size_type capacity() const noexcept { return data_.capacity(); }
+    void      reserve(size_type n)      { data_.reserve(n); }
+    void      shrink_to_fit()           { data_.shrink_to_fit(); }
+    void      clear()                   { data_.clear(); }
+    void      swap(flat_interleaved_storage& rhs) noexcept { data_.swap(rhs.data_); }
+
+    const key_type& key(size_type i)    const { return data_[i].first; }
+    mapped_type&    mapped(size_type i)       { return data_[i].second; }
+
+    template <class K, class Compare>
+    size_type lower_bound(const K& key, Compare comp) const
+    {
+        return orange_stl::lower_bound(data_.begin(), data_.end(), key,
+                                       key_compare_adapter<Compare>(comp)) - data_.begin();
+    }
+    template <class K, class Compare>
+    size_type upper_bound(const K& key, Compare comp) const
+    {
+        return orange_stl::upper_bound(data_.begin(), data_.end(), key,
+                                       key_compare_adapter<Compare>(comp)) - data_.begin();
+    }
+
+    template <class V>
+    void insert_value(size_type i, V&& value)
+    {
+        data_.emplace(data_.begin() + i, orange_stl::forward<V>(value));
+    }
+    template <class K, class ...Args>
+    void emplace_key(size_type i, K&& key, Args&& ...args)
+    {
+        data_.emplace(data_.begin() + i, orange_stl::piecewise_construct,
+                      std::forward_as_tuple(orange_stl::forward<K>(key)),
+                      std::forward_as_tuple(orange_stl::forward<Args>(args)...));
+    }
+    void erase(size_type first, size_type last)
+    {
+        data_.erase(data_.begin() + first, data_.begin() + last);
+    }
+
+    void push_back_value(value_type&& value) { data_.push_back(orange_stl::move(value)); }
+    void push_back_from(flat_interleaved_storage& src, size_type i) { data_.push_back(orange_stl::move(src.data_[i])); }
+};
+
+// flat_split_storage 的迭代器，同时指向键值数组和实值数组中的同一个位置
+// 元素并不以 pair 的形式存在，解引用返回临时的 pair<const Key&, T&>，operator-> 返回持有它的代理对象
+template <class Key, class T, bool IsConst>
+struct flat_split_iterator
+{
+    typedef typename std::conditional<IsConst, const T, T>::type    mapped_value;
+
+    typedef orange_stl::random_access_iterator_tag          iterator_category;
+    typedef orange_stl::pair<Key, T>                        value_type;
+    typedef orange_stl::pair<const Key&, mapped_value&>     reference;
+    typedef ptrdiff_t                                       difference_type;
+
+    struct pointer
+    {
+        reference ref;
+        reference* operator->() { return &ref; }
+    };
+
+    const Key*    key_;
+    mapped_value* mapped_;
+
+    flat_split_iterator() noexcept : key_(nullptr), mapped_(nullptr) {}
+    flat_split_iterator(const Key* k, mapped_value* m) noexcept : key_(k), mapped_(m) {}
+
+    // iterator 可以转换为 const_iterator
+    template <bool C, typename std::enable_if<IsConst && !C, int>::type = 0>
+    flat_split_iterator(const flat_split_iterator<Key, T, C>& rhs) noexcept
+        : key_(rhs.key_), mapped_(rhs.mapped_) {}
+
+    reference operator*()  const { return reference(*key_, *mapped_); }
+    pointer   operator->() const { return pointer{ reference(*key_, *mapped_) }; }
+    reference operator[](difference_type n) const { return reference(key_[n], mapped_[n]); }
+
+    flat_split_iterator& operator++() { ++key_; ++mapped_; return *this; }
+    flat_split_iterator& operator--() { --key_; --mapped_; return *this; }
+    flat_split_iterator  operator++(int) { flat_split_iterator tmp = *this; ++*this; return tmp; }
+    flat_split_iterator  operator--(int) { flat_split_iterator tmp = *this; --*this; return tmp; }
+
+    flat_split_iterator& operator+=(difference_type n) { key_ += n; mapped_ += n; return *this; }
+    flat_split_iterator& operator-=(difference_type n) { key_ -= n; mapped_ -= n; return *this; }
+    flat_split_iterator  operator+(difference_type n) const { return flat_split_iterator(key_ + n, mapped_ + n); }
+    flat_split_iterator  operator-(difference_type n) const { return flat_split_iterator(key_ - n, mapped_ - n); }
+};
+
+template <class Key, class T, bool C>
+flat_split_iterator<Key, T, C> operator+(ptrdiff_t n, const flat_split_iterator<Key, T, C>& it)
+{
+    return it + n;
+}
+
+// 位置只由键值指针决定，iterator 与 const_iterator 之间可以相互比较
+template <class Key, class T, bool C1, bool C2>
+ptrdiff_t operator-(const flat_split_iterator<Key, T, C1>& lhs, const flat_split_iterator<Key, T, C2>& rhs)
+{
+    return lhs.key_ - rhs.key_;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator==(const flat_split_iterator<Key, T, C1>& lhs, const flat_split_iterator<Key, T, C2>& rhs)
+{
+    return lhs.key_ == rhs.key_;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator!=(const flat_split_iterator<Key, T, C1>& lhs, const flat_split_iterator<Key, T, C2>& rhs)
+{
+    return lhs.key_ != rhs.key_;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator<(const flat_split_iterator<Key, T, C1>& lhs, const flat_split_iterator<Key, T, C2>& rhs)
+{
+    return lhs.key_ < rhs.key_;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator>(const flat_split_iterator<Key, T, C1>& lhs, const flat_split_iterator<Key, T, C2>& rhs)
+{
+    return rhs.key_ < lhs.key_;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator<=(const flat_split_iterator<Key, T, C1>& lhs, const flat_split_iterator<Key, T, C2>& rhs)
+{
+    return !(rhs.key_ < lhs.key_);
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator>=(const flat_split_iterator<Key, T, C1>& lhs, const flat_split_iterator<Key, T, C2>& rhs)
+{
+    return !(lhs.key_ < rhs.key_);
+}
+
+// flat_split_storage：键值与实值分别存放在两个 vector 中，同一下标对应同一个元素
+// 查找只访问键值数组，实值较大时每条缓存行能容纳的键值多得多
+template <class Key, class T, class Alloc>
+class flat_split_storage
+{
+public:
+    typedef Key                                                 key_type;
+    typedef T                                                   mapped_type;
+    typedef orange_stl::pair<Key, T>                            value_type;
+    typedef Alloc                                               allocator_type;
+    typedef typename Alloc::template rebind<Key>::other         key_allocator;
+    typedef typename Alloc::template rebind<T>::other           mapped_allocator;
+    typedef orange_stl::vector<Key, key_allocator>              key_container;
+    typedef orange_stl::vector<T, mapped_allocator>             mapped_container;
+    typedef flat_split_iterator<Key, T, false>                  iterator;
+    typedef flat_split_iterator<Key, T, true>                   const_iterator;
+    typedef size_t                                              size_type;
+
+private:
+    key_container    keys_;
+    mapped_container values_;
+
+public:
+    static const key_type& get_key(const value_type& value) { return value.first; }
+
+    iterator       begin()        noexcept { return iterator(keys_.data(), values_.data()); }
+    const_iterator begin()  const noexcept { return const_iterator(keys_.data(), values_.data()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator       end()          noexcept { return begin() + keys_.size(); }
+    const_iterator end()    const noexcept { return begin() + keys_.size(); }
+
+    size_type size()     const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+    void      reserve(size_type n)      { keys_.reserve(n); values_.reserve(n); }
+    void      shrink_to_fit()           { keys_.shrink_to_fit(); values_.shrink_to_fit(); }
+    void      clear()                   { keys_.clear(); values_.clear(); }
+    void      swap(flat_split_storage& rhs) noexcept
+    {
+        keys_.swap(rhs.keys_);
+        values_.swap(rhs.values_);
+    }
+
+    const key_type& key(size_type i)    const { return keys_[i]; }
+    mapped_type&    mapped(size_type i)       { return values_[i]; }
+
+    template <class K, class Compare>
+    size_type lower_bound(const K& key, Compare comp) const
+    {
+        return orange_stl::lower_bound(keys_.begin(), keys_.end(), key, comp) - keys_.begin();
+    }
+    template <class K, class Compare>
+    size_type upper_bound(const K& key, Compare comp) const
+    {
+        return orange_stl::upper_bound(keys_.begin(), keys_.end(), key, comp) - keys_.begin();
+    }
+
+    template <class V>
+    void insert_value(size_type i, V&& value)
+    {
+        emplace_key(i, orange_stl::forward<V>(value).first, orange_stl::forward<V>(value).second);
+    }
+    // 先放入键值，实值构造失败时撤销，两个数组始终等长
+    template <class K, class ...Args>
+    void emplace_key(size_type i, K&& key, Args&& ...args)
+    {
+        keys_.emplace(keys_.begin() + i, orange_stl::forward<K>(key));
+        try
+        {
+            values_.emplace(values_.begin() + i, orange_stl::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            keys_.erase(keys_.begin() + i);
+            throw;
+        }
+    }
+    void erase(size_type first, size_type last)
+    {
+        keys_.erase(keys_.begin() + first, keys_.begin() + last);
+        values_.erase(values_.begin() + first, values_.begin() + last);
+    }
+
+    // 归并的结果失败时整体丢弃，这里不需要维持两个数组等长
+    void push_back_value(value_type&& value)
+    {
+        keys_.push_back(orange_stl::move(value.first));
+        values_.push_back(orange_stl::move(value.second));
+    }
+    void push_back_from(flat_split_storage& src, size_type i)
+    {
+        keys_.push_back(orange_stl::move(src.keys_[i]));
+        values_.push_back(orange_stl::move(src.values_[i]));
+    }
+};
+
+// flat_map 存放方式的选择，作为模板参数传给 flat_map 与 flat_multimap
+// flat_interleaved：键值与实值交错存放(缺省)，适合遍历时同时访问二者
+// flat_split：键值与实值分开存放，适合查找远多于遍历、实值较大的情形
+struct flat_interleaved
+{
+    template <class Key, class T, class Alloc>
+    struct storage
+    {
+        typedef flat_interleaved_storage<Key, T, Alloc> type;
+    };
+};
+
+struct flat_split
+{
+    template <class Key, class T, class Alloc>
+    struct storage
+    {
+        typedef flat_split_storage<Key, T, Alloc> type;
+    };
+};
+
+// 模板类 flat_tree
+// 参数一代表元素的存放方式，参数二代表键值比较类型
+template <class Storage, class Compare>
+class flat_tree
+{
+public:
+    // flat_tree 的嵌套型别定义
+    typedef Storage                                             storage_type;
+    typedef Compare                                             key_compare;
+    typedef typename Storage::key_type                          key_type;
+    typedef typename Storage::value_type                        value_type;
+    typedef typename Storage::allocator_type                    allocator_type;
+
+    typedef typename Storage::iterator                          iterator;
+    typedef typename Storage::const_iterator                    const_iterator;
+    typedef orange_stl::reverse_iterator<iterator>              reverse_iterator;
+    typedef orange_stl::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+    typedef typename iterator_traits<iterator>::pointer         pointer;
+    typedef typename iterator_traits<const_iterator>::pointer   const_pointer;
+    typedef typename iterator_traits<iterator>::reference       reference;
+    typedef typename iterator_traits<const_iterator>::reference const_reference;
+    typedef size_t                                              size_type;
+    typedef ptrdiff_t                                           difference_type;
+
+    allocator_type  get_allocator() const { return allocator_type(); }
+    key_compare     key_comp()      const { return key_comp_; }
+
+private:
+    storage_type s_;
+    key_compare  key_comp_;
+
+public:
+    // 构造、复制、移动函数都使用缺省版本
+    flat_tree() : s_(), key_comp_() {}
+
+public:
+    /* 迭代器相关的操作 */
+    iterator       begin()        noexcept { return s_.begin(); }
+    const_iterator begin()  const noexcept { return s_.begin(); }
+    iterator       end()          noexcept { return s_.end(); }
+    const_iterator end()    const noexcept { return s_.end(); }
+
+    reverse_iterator       rbegin()       noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()         noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()   const noexcept { return const_reverse_iterator(begin()); }
+
+    /* 容量相关的操作 */
+    bool      empty()    const noexcept { return s_.size() == 0; }
+    size_type size()     const noexcept { return s_.size(); }
+    size_type max_size() const noexcept { return s_.max_size(); }
+    size_type capacity() const noexcept { return s_.capacity(); }
+    void      reserve(size_type n)      { s_.reserve(n); }
+    void      shrink_to_fit()           { s_.shrink_to_fit(); }
+
+    /* 插入相关的操作 */
+    template <class ...Args>
+    iterator emplace_multi(Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_multi_value(orange_stl::move(value));
+    }
+
+    template <class ...Args>
+    orange_stl::pair<iterator, bool> emplace_unique(Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_unique_value(orange_stl::move(value));
+    }
+
+    template <class ...Args>
+    iterator emplace_multi_use_hint(const_iterator hint, Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_multi_hint(hint, orange_stl::move(value));
+    }
+
+    template <class ...Args>
+    iterator emplace_unique_use_hint(const_iterator hint, Args&& ...args)
+    {
+        value_type value(orange_stl::forward<Args>(args)...);
+        return insert_unique_hint(hint, orange_stl::move(value));
+    }
+
+    /* insert */
+    iterator insert_multi(const value_type& value)
+    {
+        return insert_multi_value(value);
+    }
+    iterator insert_multi(value_type&& value)
+    {
+        return insert_multi_value(orange_stl::move(value));
+    }
+
+    iterator insert_multi(const_iterator hint, const value_type& value)
+    {
+        return insert_multi_hint(hint, value);
+    }
+    iterator insert_multi(const_iterator hint, value_type&& value)
+    {
+        return insert_multi_hint(hint, orange_stl::move(value));
+    }
+
+    // 区间插入只排序、归并一次，而不是逐个插入
+    template <class InputIterator>
+    void insert_multi(InputIterator first, InputIterator last)
+    {
+        insert_range(first, last, false);
+    }
+
+    orange_stl::pair<iterator, bool> insert_unique(const value_type& value)
+    {
+        return insert_unique_value(value);
+    }
+    orange_stl::pair<iterator, bool> insert_unique(value_type&& value)
+    {
+        return insert_unique_value(orange_stl::move(value));
+    }
+
+    iterator insert_unique(const_iterator hint, const value_type& value)
+    {
+        return insert_unique_hint(hint, value);
+    }
+    iterator insert_unique(const_iterator hint, value_type&& value)
+    {
+        return insert_unique_hint(hint, orange_stl::move(value));
+    }
+
+    // 键值重复时保留容器中原有的元素，区间中重复的键值保留最先出现的一个
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last)
+    {
+        insert_range(first, last, true);
+    }
+
+    /* 一次查找完成的插入，供 flat_map 使用 */
+    template <class K, class ...Args>
+    orange_stl::pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args)
+    {
+        const size_type i = lower_index(key);
+        if (i != size() && !key_comp_(key, s_.key(i)))
+            return orange_stl::make_pair(begin() + i, false);
+        s_.emplace_key(i, orange_stl::forward<K>(key), orange_stl::forward<Args>(args)...);
+        return orange_stl::make_pair(begin() + i, true);
+    }
+
+    template <class K, class V>
+    orange_stl::pair<iterator, bool> insert_or_assign_unique(K&& key, V&& obj)
+    {
+        const size_type i = lower_index(key);
+        if (i != size() && !key_comp_(key, s_.key(i)))
+        {
+            s_.mapped(i) = orange_stl::forward<V>(obj);
+            return orange_stl::make_pair(begin() + i, false);
+        }
+        s_.emplace_key(i, orange_stl::forward<K>(key), orange_stl::forward<V>(obj));
+        return orange_stl::make_pair(begin() + i, true);
+    }
+
+    template <class K, class Factory>
+    orange_stl::pair<iterator, bool> get_or_insert_with_unique(K&& key, Factory&& factory)
+    {
+        const size_type i = lower_index(key);
+        if (i != size() && !key_comp_(key, s_.key(i)))
+            return orange_stl::make_pair(begin() + i, false);
+        s_.emplace_key(i, orange_stl::forward<K>(key), factory());
+        return orange_stl::make_pair(begin() + i, true);
+    }
+
+    /* erase，返回被删除元素的下一个位置 */
+    iterator erase(const_iterator position)
+    {
+        const size_type i = index_of(position);
+        s_.erase(i, i + 1);
+        return begin() + i;
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const size_type i = index_of(first);
+        s_.erase(i, index_of(last));
+        return begin() + i;
+    }
+
+    size_type erase_multi(const key_type& key)
+    {
+        const size_type lo = lower_index(key);
+        const size_type hi = upper_index(key);
+        s_.erase(lo, hi);
+        return hi - lo;
+    }
+    size_type erase_unique(const key_type& key)
+    {
+        const size_type i = find_index(key);
+        if (i == size())
+            return 0;
+        s_.erase(i, i + 1);
+        return 1;
+    }
+
+    void clear() { s_.clear(); }
+
+    /* 功能性操作 */
+    /* 带有 K 模板参数的重载用于异构查找，只在 Compare 声明了 is_transparent 时参与重载决议 */
+    iterator       find(const key_type& key)       { return begin() + find_index(key); }
+    const_iterator find(const key_type& key) const { return begin() + find_index(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator       find(const K& key)              { return begin() + find_index(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator find(const K& key) const        { return begin() + find_index(key); }
+
+    size_type count_multi(const key_type& key) const { return upper_index(key) - lower_index(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    size_type count_multi(const K& key) const { return upper_index(key) - lower_index(key); }
+
+    size_type count_unique(const key_type& key) const { return find_index(key) != size() ? 1 : 0; }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    size_type count_unique(const K& key) const { return find_index(key) != size() ? 1 : 0; }
+
+    iterator       lower_bound(const key_type& key)       { return begin() + lower_index(key); }
+    const_iterator lower_bound(const key_type& key) const { return begin() + lower_index(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator       lower_bound(const K& key)              { return begin() + lower_index(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator lower_bound(const K& key) const        { return begin() + lower_index(key); }
+
+    iterator       upper_bound(const key_type& key)       { return begin() + upper_index(key); }
+    const_iterator upper_bound(const key_type& key) const { return begin() + upper_index(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator       upper_bound(const K& key)              { return begin() + upper_index(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator upper_bound(const K& key) const        { return begin() + upper_index(key); }
+
+    orange_stl::pair<iterator, iterator> equal_range_multi(const key_type& key)
+    {
+        return orange_stl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    orange_stl::pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+    {
+        return orange_stl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<iterator, iterator> equal_range_multi(const K& key)
+    {
+        return orange_stl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<const_iterator, const_iterator> equal_range_multi(const K& key) const
+    {
+        return orange_stl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    orange_stl::pair<iterator, iterator> equal_range_unique(const key_type& key)
+    {
+        const size_type i = find_index(key);
+        return orange_stl::pair<iterator, iterator>(begin() + i, begin() + (i == size() ? i : i + 1));
+    }
+    orange_stl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+    {
+        const size_type i = find_index(key);
+        return orange_stl::pair<const_iterator, const_iterator>(begin() + i, begin() + (i == size() ? i : i + 1));
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<iterator, iterator> equal_range_unique(const K& key)
+    {
+        const size_type i = find_index(key);
+        return orange_stl::pair<iterator, iterator>(begin() + i, begin() + (i == size() ? i : i + 1));
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+    {
+        const size_type i = find_index(key);
+        return orange_stl::pair<const_iterator, const_iterator>(begin() + i, begin() + (i == size() ? i : i + 1));
+    }
+
+    void swap(flat_tree& rhs) noexcept
+    {
+        s_.swap(rhs.s_);
+        orange_stl::swap(key_comp_, rhs.key_comp_);
+    }
+
+private:
+    size_type index_of(const_iterator it) const
+    {
+        return static_cast<size_type>(it - s_.cbegin());
+    }
+
+    template <class K>
+    size_type lower_index(const K& key) const { return s_.lower_bound(key, key_comp_); }
+    template <class K>
+    size_type upper_index(const K& key) const { return s_.upper_bound(key, key_comp_); }
+
+    // 找不到时返回 size()
+    template <class K>
+    size_type find_index(const K& key) const
+    {
+        const size_type i = lower_index(key);
+        return (i == size() || key_comp_(key, s_.key(i))) ? size() : i;
+    }
+
+    template <class V>
+    orange_stl::pair<iterator, bool> insert_unique_value(V&& value);
+    template <class V>
+    iterator insert_multi_value(V&& value);
+    template <class V>
+    iterator insert_unique_hint(const_iterator hint, V&& value);
+    template <class V>
+    iterator insert_multi_hint(const_iterator hint, V&& value);
+
+    template <class InputIterator>
+    void insert_range(InputIterator first, InputIterator last, bool unique);
+};
+
+/*****************************************************************************************/
+
+/* 键值不允许重复的插入，键值已存在时返回 (已有元素, false) */
+template <class Storage, class Compare>
+template <class V>
+orange_stl::pair<typename flat_tree<Storage, Compare>::iterator, bool>
+flat_tree<Storage, Compare>::insert_unique_value(V&& value)
+{
+    const size_type i = lower_index(Storage::get_key(value));
+    if (i != size() && !key_comp_(Storage::get_key(value), s_.key(i)))
+        return orange_stl::make_pair(begin() + i, false);
+    s_.insert_value(i, orange_stl::forward<V>(value));
+    return orange_stl::make_pair(begin() + i, true);
+}
+
+/* 键值允许重复的插入，新元素放在相等元素的最后 */
+template <class Storage, class Compare>
+template <class V>
+typename flat_tree<Storage, Compare>::iterator
+flat_tree<Storage, Compare>::insert_multi_value(V&& value)
+{
+    const size_type i = upper_index(Storage::get_key(value));
+    s_.insert_value(i, orange_stl::forward<V>(value));
+    return begin() + i;
+}
+
+/* 提示位置恰好使序列保持有序时省去二分查找 */
+template <class Storage, class Compare>
+template <class V>
+typename flat_tree<Storage, Compare>::iterator
+flat_tree<Storage, Compare>::insert_unique_hint(const_iterator hint, V&& value)
+{
+    const size_type i = index_of(hint);
+    const key_type& key = Storage::get_key(value);
+    if ((i == 0 || key_comp_(s_.key(i - 1), key)) && (i == size() || key_comp_(key, s_.key(i))))
+    {
+        s_.insert_value(i, orange_stl::forward<V>(value));
+        return begin() + i;
+    }
+    return insert_unique_value(orange_stl::forward<V>(value)).first;
+}
+
+template <class Storage, class Compare>
+template <class V>
+typename flat_tree<Storage, Compare>::iterator
+flat_tree<Storage, Compare>::insert_multi_hint(const_iterator hint, V&& value)
+{
+    size_type i = index_of(hint);
+    const key_type& key = Storage::get_key(value);
+    // 提示位置不合法时，放在离它最近的合法位置
+    if (i != size() && key_comp_(s_.key(i), key))
+        i = lower_index(key);
+    else if (i != 0 && key_comp_(key, s_.key(i - 1)))
+        i = upper_index(key);
+    s_.insert_value(i, orange_stl::forward<V>(value));
+    return begin() + i;
+}
+
+/* 区间插入：
+ * 1. 把新元素收集到临时的 vector 中，按 (键值, 出现顺序) 对下标排序，相当于稳定排序
+ * 2. 把原有元素与排好序的新元素线性归并到新的存储中，相等时原有元素在前
+ * 3. unique 时丢弃与上一个输出元素键值相等的新元素
+ * 总的时间为 O(m log m + n + m)，逐个插入则为 O(m * (n + m))
+ */
+template <class Storage, class Compare>
+template <class InputIterator>
+void flat_tree<Storage, Compare>::insert_range(InputIterator first, InputIterator last, bool unique)
+{
+    orange_stl::vector<value_type> batch;
+    for (; first != last; ++first)
+        batch.emplace_back(*first);
+    const size_type m = batch.size();
+    if (m == 0)
+        return;
+    if (m == 1)
+    {
+        if (unique)
+            insert_unique_value(orange_stl::move(batch[0]));
+        else
+            insert_multi_value(orange_stl::move(batch[0]));
+        return;
+    }
+
+    orange_stl::vector<size_type> order(m);
+    for (size_type j = 0; j < m; ++j)
+        order[j] = j;
+    key_compare comp = key_comp_;
+    orange_stl::sort(order.begin(), order.end(), [&](size_type a, size_type b)
+    {
+        const key_type& ka = Storage::get_key(batch[a]);
+        const key_type& kb = Storage::get_key(batch[b]);
+        if (comp(ka, kb))
+            return true;
+        if (comp(kb, ka))
+            return false;
+        return a < b;
+    });
+
+    const size_type n = size();
+    storage_type out;
+    out.reserve(n + m);
+    size_type i = 0, j = 0;
+    while (i < n || j < m)
+    {
+        if (j == m || (i < n && !key_comp_(Storage::get_key(batch[order[j]]), s_.key(i))))
+        {
+            out.push_back_from(s_, i++);
+        }
+        else
+        {
+            value_type& value = batch[order[j++]];
+            if (unique && out.size() != 0 && !key_comp_(out.key(out.size() - 1), Storage::get_key(value)))
+                continue;
+            out.push_back_value(orange_stl::move(value));
+        }
+    }
+    s_.swap(out);
+}
+
+// 重载比较操作符
+template <class Storage, class Compare>
+bool operator==(const flat_tree<Storage, Compare>& lhs, const flat_tree<Storage, Compare>& rhs)
+{
+    return lhs.size() == rhs.size() && orange_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Storage, class Compare>
+bool operator<(const flat_tree<Storage, Compare>& lhs, const flat_tree<Storage, Compare>& rhs)
+{
+    return orange_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class Storage, class Compare>
+bool operator!=(const flat_tree<Storage, Compare>& lhs, const flat_tree<Storage, Compare>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Storage, class Compare>
+bool operator>(const flat_tree<Storage, Compare>& lhs, const flat_tree<Storage, Compare>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class Storage, class Compare>
+bool operator<=(const flat_tree<Storage, Compare>& lhs, const flat_tree<Storage, Compare>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class Storage, class Compare>
+bool operator>=(const flat_tree<Storage, Compare>& lhs, const flat_tree<Storage, Compare>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 orange_stl 的 swap
+template <class Storage, class Compare>
+void swap(flat_tree<Storage, Compare>& lhs, flat_tree<Storage, Compare>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_FLAT_TREE_H__
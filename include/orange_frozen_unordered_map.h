@@ -0,0 +1,461 @@
+#ifndef __ORANGE_FROZEN_UNORDERED_MAP_H__
+#define __ORANGE_FROZEN_UNORDERED_MAP_H__
+
+// 这个头文件包含模板类 frozen_unordered_map：构造之后键值集合不再改变的哈希表
+// 构造时为全部键值求一个最小完美哈希(PTHash 的做法：先把键值分到若干小桶，再从大到小为每个桶找一个 pilot，
+// 使桶内所有键值都落在互不相同的空槽上)，元素按槽的顺序紧密存放在一个数组中，没有空槽也没有链表
+// 查找只需要一次哈希、读一个 pilot、定位一个槽、做一次比较，不需要沿链表追指针，也没有取模运算
+// 只能通过构造与赋值整体替换内容，实值可以通过迭代器或 at 修改
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "orange_hashtable.h"
+#include "orange_vector.h"
+#include "orange_algo.h"
+#include "orange_uninitialized.h"
+
+namespace orange_stl
+{
+
+// 平均每个 pilot 桶含 EFrozenBucketSize 个键值
+// 一次构造最多换 EFrozenMaxAttempts 个种子，每个桶的 pilot 至少尝试 EFrozenMinPilotLimit 个
+enum { EFrozenBucketSize = 4, EFrozenMaxAttempts = 64, EFrozenMinPilotLimit = 1 << 16 };
+
+// 把 x 均匀地映射到 [0, n)，取 x * n 的高 64 位，不需要除法
+inline size_t frozen_reduce(size_t x, size_t n) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    return static_cast<size_t>((static_cast<__uint128_t>(x) * n) >> 64);
+#else
+    return x % n;
+#endif
+}
+
+// 键值的哈希值与种子混合，哈希值不同的键值混合后仍然不同
+inline size_t frozen_key_mix(size_t code, size_t seed) noexcept
+{
+    return ht_hash_mix(code ^ seed);
+}
+
+// 由 pilot 与混合后的哈希值得到槽的位置
+inline size_t frozen_slot(size_t mixed, uint32_t pilot, size_t n) noexcept
+{
+    return frozen_reduce(ht_hash_mix(mixed ^ (static_cast<size_t>(pilot) * 0x9e3779b97f4a7c15ULL)), n);
+}
+
+// 为 n 个互不相同的哈希值求 pilot，成功时 pilots 为每个桶的 pilot，slots 为每个哈希值所在的槽
+inline bool frozen_place(const size_t* codes, size_t n, size_t nb, size_t seed,
+                         uint32_t* pilots, size_t* slots)
+{
+    vector<size_t> mixed(n);
+    vector<size_t> start(nb + 1, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mixed[i] = frozen_key_mix(codes[i], seed);
+        ++start[frozen_reduce(mixed[i], nb) + 1];
+    }
+    for (size_t b = 0; b < nb; ++b)
+        start[b + 1] += start[b];
+
+    // 按桶计数排序，members[start[b], start[b + 1]) 为桶 b 中的键值
+    vector<size_t> members(n);
+    vector<size_t> cursor(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < n; ++i)
+        members[cursor[frozen_reduce(mixed[i], nb)]++] = i;
+
+    // 大桶先放，此时空槽多，容易找到合适的 pilot
+    vector<size_t> order(nb);
+    for (size_t b = 0; b < nb; ++b)
+        order[b] = b;
+    orange_stl::sort(order.begin(), order.end(), [&start](size_t x, size_t y)
+    {
+        return start[x + 1] - start[x] > start[y + 1] - start[y];
+    });
+
+    uint64_t limit = orange_stl::max(static_cast<uint64_t>(EFrozenMinPilotLimit), static_cast<uint64_t>(n) * 64);
+    limit = orange_stl::min(limit, static_cast<uint64_t>(UINT32_MAX));
+    vector<unsigned char> taken(n, 0);
+    for (size_t k = 0; k < nb; ++k)
+    {
+        const size_t b = order[k];
+        const size_t first = start[b], last = start[b + 1];
+        pilots[b] = 0;
+        if (first == last)
+            continue;
+        uint64_t p = 0;
+        for (; p < limit; ++p)
+        {
+            size_t m = first;
+            for (; m < last; ++m)
+            {
+                const size_t s = frozen_slot(mixed[members[m]], static_cast<uint32_t>(p), n);
+                if (taken[s])
+                    break;
+                taken[s] = 1;
+                slots[members[m]] = s;
+            }
+            if (m == last)
+                break;
+            for (size_t u = first; u < m; ++u)
+                taken[slots[members[u]]] = 0;
+        }
+        if (p == limit)
+            return false;
+        pilots[b] = static_cast<uint32_t>(p);
+    }
+    return true;
+}
+
+// 模板类 frozen_unordered_map，键值不允许重复
+// 参数一表示键值类型，参数二表示实值类型，参数三表示哈希函数，参数四表示键值的比较方式，参数五表示空间配置器类型
+// 输入中键值重复时保留先出现的元素；不相等的键值哈希值相同时无法区分，构造抛出 runtime_error
+// 迭代顺序为槽的顺序，与输入顺序无关
+template <class Key, class T, class Hash = orange_stl::hash<Key>, class KeyEqual = orange_stl::equal_to<Key>,
+          class Alloc = orange_stl::allocator<orange_stl::pair<const Key, T>>>
+class frozen_unordered_map
+{
+public:
+    typedef Key                                             key_type;
+    typedef T                                               mapped_type;
+    typedef orange_stl::pair<const Key, T>                  value_type;
+    typedef Hash                                            hasher;
+    typedef KeyEqual                                        key_equal;
+
+    typedef Alloc                                                  allocator_type;
+    typedef typename Alloc::template rebind<value_type>::other     data_allocator;
+    typedef typename Alloc::template rebind<uint32_t>::other       pilot_allocator;
+
+    typedef size_t                                          size_type;
+    typedef ptrdiff_t                                       difference_type;
+    typedef value_type*                                     pointer;
+    typedef const value_type*                               const_pointer;
+    typedef value_type&                                     reference;
+    typedef const value_type&                               const_reference;
+
+    typedef value_type*                                     iterator;
+    typedef const value_type*                               const_iterator;
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+private:
+    value_type* slots_;          // size_ 个元素，按槽的顺序存放
+    uint32_t*   pilots_;         // 每个 pilot 桶的 pilot
+    size_type   size_;
+    size_type   bucket_count_;   // pilot 桶的个数
+    size_t      seed_;
+    hasher      hash_;
+    key_equal   equal_;
+
+public:
+    // 构造、复制、移动、析构函数
+    frozen_unordered_map(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : slots_(nullptr), pilots_(nullptr), size_(0), bucket_count_(0), seed_(0), hash_(hash), equal_(equal)
+    {
+    }
+
+    template <class InputIterator>
+    frozen_unordered_map(InputIterator first, InputIterator last,
+                         const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : slots_(nullptr), pilots_(nullptr), size_(0), bucket_count_(0), seed_(0), hash_(hash), equal_(equal)
+    {
+        build(first, last);
+    }
+
+    frozen_unordered_map(std::initializer_list<value_type> ilist,
+                         const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : slots_(nullptr), pilots_(nullptr), size_(0), bucket_count_(0), seed_(0), hash_(hash), equal_(equal)
+    {
+        build(ilist.begin(), ilist.end());
+    }
+
+    frozen_unordered_map(const frozen_unordered_map& rhs)
+        : slots_(nullptr), pilots_(nullptr), size_(0), bucket_count_(0),
+          seed_(rhs.seed_), hash_(rhs.hash_), equal_(rhs.equal_)
+    {
+        copy_init(rhs);
+    }
+
+    frozen_unordered_map(frozen_unordered_map&& rhs) noexcept
+        : slots_(rhs.slots_), pilots_(rhs.pilots_), size_(rhs.size_), bucket_count_(rhs.bucket_count_),
+          seed_(rhs.seed_), hash_(rhs.hash_), equal_(rhs.equal_)
+    {
+        rhs.slots_ = nullptr;
+        rhs.pilots_ = nullptr;
+        rhs.size_ = 0;
+        rhs.bucket_count_ = 0;
+    }
+
+    frozen_unordered_map& operator=(const frozen_unordered_map& rhs)
+    {
+        if (this != &rhs)
+        {
+            frozen_unordered_map tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    frozen_unordered_map& operator=(frozen_unordered_map&& rhs) noexcept
+    {
+        frozen_unordered_map tmp(orange_stl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    frozen_unordered_map& operator=(std::initializer_list<value_type> ilist)
+    {
+        frozen_unordered_map tmp(ilist, hash_, equal_);
+        swap(tmp);
+        return *this;
+    }
+
+    ~frozen_unordered_map() { release(); }
+
+public:
+    // 迭代器相关操作
+    iterator       begin()        noexcept { return slots_; }
+    const_iterator begin()  const noexcept { return slots_; }
+    iterator       end()          noexcept { return slots_ + size_; }
+    const_iterator end()    const noexcept { return slots_ + size_; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+    // 容量相关操作
+    bool      empty()        const noexcept { return size_ == 0; }
+    size_type size()         const noexcept { return size_; }
+    size_type bucket_count() const noexcept { return bucket_count_; }
+
+    void swap(frozen_unordered_map& rhs) noexcept
+    {
+        orange_stl::swap(slots_, rhs.slots_);
+        orange_stl::swap(pilots_, rhs.pilots_);
+        orange_stl::swap(size_, rhs.size_);
+        orange_stl::swap(bucket_count_, rhs.bucket_count_);
+        orange_stl::swap(seed_, rhs.seed_);
+        orange_stl::swap(hash_, rhs.hash_);
+        orange_stl::swap(equal_, rhs.equal_);
+    }
+
+    // 查找相关操作
+    mapped_type& at(const key_type& key)
+    {
+        const size_type n = find_index(key);
+        THROW_OUT_OF_RANGE_IF(n == size_, "frozen_unordered_map<Key, T> no such element exists");
+        return slots_[n].second;
+    }
+
+    const mapped_type& at(const key_type& key) const
+    {
+        const size_type n = find_index(key);
+        THROW_OUT_OF_RANGE_IF(n == size_, "frozen_unordered_map<Key, T> no such element exists");
+        return slots_[n].second;
+    }
+
+    iterator       find(const key_type& key)       { return slots_ + find_index(key); }
+    const_iterator find(const key_type& key) const { return slots_ + find_index(key); }
+
+    size_type count(const key_type& key) const { return find_index(key) != size_ ? 1 : 0; }
+
+    pair<iterator, iterator> equal_range(const key_type& key)
+    {
+        iterator it = find(key);
+        return it == end() ? make_pair(it, it) : make_pair(it, it + 1);
+    }
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+        const_iterator it = find(key);
+        return it == end() ? make_pair(it, it) : make_pair(it, it + 1);
+    }
+
+    // 异构查找，只在 hasher 与 key_equal 都声明了 is_transparent 时参与重载决议
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    iterator       find(const K& key)       { return slots_ + find_index(key); }
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    const_iterator find(const K& key) const { return slots_ + find_index(key); }
+
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    size_type count(const K& key) const { return find_index(key) != size_ ? 1 : 0; }
+
+    // 哈希函数与比较函数
+    hasher    hash_fcn() const { return hash_; }
+    key_equal key_eq()   const { return equal_; }
+
+private:
+    template <class K>
+    size_type find_index(const K& key) const
+    {
+        if (size_ == 0)
+            return 0;
+        const size_t mixed = frozen_key_mix(hash_(key), seed_);
+        const size_type n = frozen_slot(mixed, pilots_[frozen_reduce(mixed, bucket_count_)], size_);
+        return equal_(slots_[n].first, key) ? n : size_;
+    }
+
+    template <class InputIterator>
+    void build(InputIterator first, InputIterator last);
+
+    void copy_init(const frozen_unordered_map& rhs);
+    void release() noexcept;
+};
+
+/*****************************************************************************************/
+
+// 先把输入收集起来并去掉重复的键值，再求完美哈希，最后把元素移动到各自的槽中
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class InputIterator>
+void frozen_unordered_map<Key, T, Hash, KeyEqual, Alloc>::
+build(InputIterator first, InputIterator last)
+{
+    vector<value_type> items;
+    for (; first != last; ++first)
+        items.emplace_back(*first);
+    const size_type total = items.size();
+    if (total == 0)
+        return;
+
+    vector<size_t> codes(total);
+    vector<size_type> order(total);
+    for (size_type i = 0; i < total; ++i)
+    {
+        codes[i] = hash_(items[i].first);
+        order[i] = i;
+    }
+    orange_stl::sort(order.begin(), order.end(), [&codes](size_type x, size_type y)
+    {
+        return codes[x] < codes[y] || (codes[x] == codes[y] && x < y);
+    });
+
+    // 哈希值相同的一段中只保留最先出现的元素，这一段的键值必须全部相等
+    vector<size_type> keep;
+    keep.reserve(total);
+    for (size_type i = 0; i < total;)
+    {
+        size_type j = i + 1;
+        for (; j < total && codes[order[j]] == codes[order[i]]; ++j)
+        {
+            THROW_RUNTIME_ERROR_IF(!equal_(items[order[i]].first, items[order[j]].first),
+                                   "frozen_unordered_map<Key, T> distinct keys share a hash code");
+        }
+        keep.push_back(order[i]);
+        i = j;
+    }
+
+    const size_type n = keep.size();
+    const size_type nb = n / EFrozenBucketSize + 1;
+    vector<size_t> kept_codes(n);
+    for (size_type i = 0; i < n; ++i)
+        kept_codes[i] = codes[keep[i]];
+
+    vector<uint32_t> pilots(nb);
+    vector<size_t> slot_of(n);
+    size_t seed = 0;
+    for (size_t attempt = 0; ; ++attempt)
+    {
+        THROW_RUNTIME_ERROR_IF(attempt == static_cast<size_t>(EFrozenMaxAttempts),
+                               "frozen_unordered_map<Key, T> failed to build a perfect hash");
+        seed = attempt == 0 ? 0 : ht_hash_mix(attempt);
+        if (frozen_place(kept_codes.data(), n, nb, seed, pilots.data(), slot_of.data()))
+            break;
+    }
+
+    // 槽 s 中放的是 keep[at_slot[s]]，按槽的顺序构造
+    vector<size_type> at_slot(n);
+    for (size_type i = 0; i < n; ++i)
+        at_slot[slot_of[i]] = i;
+
+    value_type* slots = data_allocator::allocate(n);
+    size_type s = 0;
+    try
+    {
+        for (; s < n; ++s)
+            data_allocator::construct(slots + s, orange_stl::move(items[keep[at_slot[s]]]));
+    }
+    catch (...)
+    {
+        data_allocator::destroy(slots, slots + s);
+        data_allocator::deallocate(slots, n);
+        throw;
+    }
+    uint32_t* p = nullptr;
+    try
+    {
+        p = pilot_allocator::allocate(nb);
+    }
+    catch (...)
+    {
+        data_allocator::destroy(slots, slots + n);
+        data_allocator::deallocate(slots, n);
+        throw;
+    }
+    orange_stl::uninitialized_copy(pilots.begin(), pilots.end(), p);
+
+    slots_ = slots;
+    pilots_ = p;
+    size_ = n;
+    bucket_count_ = nb;
+    seed_ = seed;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void frozen_unordered_map<Key, T, Hash, KeyEqual, Alloc>::
+copy_init(const frozen_unordered_map& rhs)
+{
+    if (rhs.size_ == 0)
+        return;
+    value_type* slots = data_allocator::allocate(rhs.size_);
+    try
+    {
+        orange_stl::uninitialized_copy(rhs.slots_, rhs.slots_ + rhs.size_, slots);
+    }
+    catch (...)
+    {
+        data_allocator::deallocate(slots, rhs.size_);
+        throw;
+    }
+    uint32_t* p = nullptr;
+    try
+    {
+        p = pilot_allocator::allocate(rhs.bucket_count_);
+    }
+    catch (...)
+    {
+        data_allocator::destroy(slots, slots + rhs.size_);
+        data_allocator::deallocate(slots, rhs.size_);
+        throw;
+    }
+    orange_stl::uninitialized_copy(rhs.pilots_, rhs.pilots_ + rhs.bucket_count_, p);
+
+    slots_ = slots;
+    pilots_ = p;
+    size_ = rhs.size_;
+    bucket_count_ = rhs.bucket_count_;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void frozen_unordered_map<Key, T, Hash, KeyEqual, Alloc>::
+release() noexcept
+{
+    if (slots_ != nullptr)
+    {
+        data_allocator::destroy(slots_, slots_ + size_);
+        data_allocator::deallocate(slots_, size_);
+        pilot_allocator::deallocate(pilots_, bucket_count_);
+    }
+    slots_ = nullptr;
+    pilots_ = nullptr;
+    size_ = 0;
+    bucket_count_ = 0;
+}
+
+// 重载 orange_stl 的 swap
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(frozen_unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+          frozen_unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_FROZEN_UNORDERED_MAP_H__
@@ -4,6 +4,11 @@
 // 这个头文件包含了 orange_stl 的函数对象与哈希函数
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cfloat>
+
+#include "orange_type_traits.h"
 
 namespace orange_stl
 {
@@ -82,6 +87,16 @@ struct equal_to :public binary_function<T, T, bool>
   bool operator()(const T& x, const T& y) const { return x == y; }
 };
 
+// 透明的等于，可以比较任意两个支持 == 的对象，供异构查找使用
+template <>
+struct equal_to<void>
+{
+  typedef int is_transparent;
+
+  template <class T, class U>
+  bool operator()(const T& x, const U& y) const { return x == y; }
+};
+
 // 函数对象：不等于
 template <class T>
 struct not_equal_to :public binary_function<T, T, bool>
@@ -103,6 +118,16 @@ struct less :public binary_function<T, T, bool>
   bool operator()(const T& x, const T& y) const { return x < y; }
 };
 
+// 透明的小于，可以比较任意两个支持 < 的对象，供异构查找使用
+template <>
+struct less<void>
+{
+  typedef int is_transparent;
+
+  template <class T, class U>
+  bool operator()(const T& x, const U& y) const { return x < y; }
+};
+
 // 函数对象：大于等于
 template <class T>
 struct greater_equal :public binary_function<T, T, bool>
@@ -179,6 +204,135 @@ struct projectsecond :public binary_function<Arg1, Arg2, Arg1>
   Arg2 operator()(const Arg1&, const Arg2& y) const { return y; }
 };
 
+/*****************************************************************************************/
+// 字节序列的哈希：wyhash 的做法，每步读入 16 字节(长输入时三路并行，每轮 48 字节)，
+// 以 64x64->128 位乘法把高低两半异或作为混合函数
+
+namespace hash_detail
+{
+
+const uint64_t secret0 = 0xa0761d6478bd642full;
+const uint64_t secret1 = 0xe7037ed1a0b428dbull;
+const uint64_t secret2 = 0x8ebc6af09c88c6e3ull;
+const uint64_t secret3 = 0x589965cc75374cc3ull;
+
+// 128 位乘积的低 64 位与高 64 位
+inline void mum(uint64_t& a, uint64_t& b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  a = static_cast<uint64_t>(r);
+  b = static_cast<uint64_t>(r >> 64);
+#else
+  const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+  const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  const uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  const uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  a = lo;
+  b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) noexcept
+{
+  mum(a, b);
+  return a ^ b;
+}
+
+// 以小端序读入 8/4 字节，不要求对齐
+inline uint64_t read8(const unsigned char* p) noexcept
+{
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+inline uint64_t read4(const unsigned char* p) noexcept
+{
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
+// 1 到 3 个字节
+inline uint64_t read3(const unsigned char* p, size_t k) noexcept
+{
+  return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+} // namespace hash_detail
+
+// 计算 [data, data + len) 这 len 个字节的哈希值，seed 可用于得到不同的哈希函数
+inline size_t hash_bytes(const void* data, size_t len, uint64_t seed = 0) noexcept
+{
+  using namespace hash_detail;
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  seed ^= mix(seed ^ secret0, secret1);
+  uint64_t a, b;
+  if (len <= 16)
+  {
+    if (len >= 4)
+    {
+      // 首尾各取两个 4 字节(可能重叠)，覆盖全部输入
+      a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+      b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+    }
+    else if (len > 0)
+    {
+      a = read3(p, len);
+      b = 0;
+    }
+    else
+    {
+      a = b = 0;
+    }
+  }
+  else
+  {
+    size_t i = len;
+    if (i > 48)
+    {
+      uint64_t see1 = seed, see2 = seed;
+      do
+      {
+        seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+        see1 = mix(read8(p + 16) ^ secret2, read8(p + 24) ^ see1);
+        see2 = mix(read8(p + 32) ^ secret3, read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16)
+    {
+      seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    // 最后 16 个字节(可能与已处理的部分重叠)
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+  a ^= secret1;
+  b ^= seed;
+  mum(a, b);
+  return static_cast<size_t>(mix(a ^ secret0 ^ len, b ^ secret1));
+}
+
+// 把一个 64 位整数打散，用于指针等低位规律明显的值
+inline size_t hash_mix(uint64_t x) noexcept
+{
+  return static_cast<size_t>(hash_detail::mix(x ^ hash_detail::secret0, hash_detail::secret1));
+}
+
 /*****************************************************************************************/
 // 哈希函数对象
 
@@ -186,12 +340,12 @@ struct projectsecond :public binary_function<Arg1, Arg2, Arg1>
 template <class Key>
 struct hash {};
 
-// 针对指针的偏特化版本
+// 针对指针的偏特化版本，指针的低位通常是 0，因此先打散
 template <class T>
 struct hash<T*>
 {
   size_t operator()(T* p) const noexcept
-  { return reinterpret_cast<size_t>(p); }
+  { return hash_mix(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p))); }
 };
 
 // 对于整型类型，只是返回原值
@@ -234,52 +388,81 @@ orange_stl_TRIVIAL_HASH_FCN(unsigned long long)
 
 #undef orange_stl_TRIVIAL_HASH_FCN
 
-// 对于浮点数，逐位哈希
+// 逐字节哈希，保留原来的接口，现在转发到 hash_bytes
 inline size_t bitwise_hash(const unsigned char* first, size_t count)
 {
-#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) &&__SIZEOF_POINTER__ == 8)
-  const size_t fnv_offset = 14695981039346656037ull;
-  const size_t fnv_prime = 1099511628211ull;
-#else
-  const size_t fnv_offset = 2166136261u;
-  const size_t fnv_prime = 16777619u;
-#endif
-  size_t result = fnv_offset;
-  for (size_t i = 0; i < count; ++i)
-  {
-    result ^= (size_t)first[i];
-    result *= fnv_prime;
-  }
-  return result;
+  return hash_bytes(first, count);
 }
 
+// 对于浮点数，对其二进制表示做哈希，+0.0 与 -0.0 相等，因此都映射为 0
 template <>
 struct hash<float>
 {
-  size_t operator()(const float& val)
+  size_t operator()(const float& val) const noexcept
   { 
-    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(float));
+    return val == 0.0f ? 0 : hash_bytes(&val, sizeof(float));
   }
 };
 
 template <>
 struct hash<double>
 {
-  size_t operator()(const double& val)
+  size_t operator()(const double& val) const noexcept
   {
-    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(double));
+    return val == 0.0 ? 0 : hash_bytes(&val, sizeof(double));
   }
 };
 
+// x87 的 80 位 long double 之后是填充字节，内容不确定，只对有效的 10 个字节做哈希
 template <>
 struct hash<long double>
 {
-  size_t operator()(const long double& val)
+  size_t operator()(const long double& val) const noexcept
   {
-    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(long double));
+#if LDBL_MANT_DIG == 64
+    return val == 0.0L ? 0 : hash_bytes(&val, 10);
+#else
+    return val == 0.0L ? 0 : hash_bytes(&val, sizeof(long double));
+#endif
+  }
+};
+
+// 字符串的哈希，basic_string 定义于 orange_basic_string.h
+template <class CharType>
+struct char_traits;
+
+template <class CharType, class CharTraits, class Alloc>
+class basic_string;
+
+// 声明为透明的，配合 equal_to<void> 可以直接用 C 风格字符串查找，而不必构造临时的 basic_string
+template <class CharType, class CharTraits, class Alloc>
+struct hash<basic_string<CharType, CharTraits, Alloc>>
+{
+  typedef int is_transparent;
+
+  size_t operator()(const basic_string<CharType, CharTraits, Alloc>& str) const noexcept
+  {
+    return hash_bytes(str.data(), str.size() * sizeof(CharType));
+  }
+
+  size_t operator()(const CharType* str) const noexcept
+  {
+    return hash_bytes(str, CharTraits::length(str) * sizeof(CharType));
   }
 };
 
+// is_fast_hash
+// 哈希函数是否足够便宜，hashtable 据此决定是否在节点中缓存哈希值
+// 算术类型、指针与枚举的 orange_stl::hash 视为便宜，其余(包括未知的哈希函数)视为昂贵
+// 自定义的廉价哈希函数可以特化为 m_true_type，以省去节点中的哈希值
+template <class Hash>
+struct is_fast_hash : m_false_type {};
+
+template <class Key>
+struct is_fast_hash<hash<Key>>
+  : m_bool_constant<std::is_arithmetic<Key>::value || std::is_pointer<Key>::value ||
+                    std::is_enum<Key>::value> {};
+
 } // namespace orange_stl
 #endif // !__ORANGE_FUNCTIONAL_H__
 
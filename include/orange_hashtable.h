@@ -1,11 +1,18 @@
 #ifndef __ORANGE_HASHTABLE_H__
 #define __ORANGE_HASHTABLE_H__
 
-/* 模板类hashtable，哈希表，使用开链法处理冲突 */
+/* 模板类hashtable，哈希表，使用开链法处理冲突
+   所有节点串成一条单链表，同一个桶的节点在链表中相邻，桶中保存的是该桶第一个节点的前一个节点，
+   因此遍历整张表只需沿着链表前进，不需要重新计算哈希值，也不需要扫描空桶
+   可选的渐进式 rehash：扩容时新旧两个桶数组并存，之后的插入、查找、删除每次只迁移少量旧桶
+   哈希函数不是 is_fast_hash 时，节点中缓存哈希值：rehash 不再调用哈希函数，查找时先比较哈希值再调用 key_equal */
 #include <initializer_list>
+#include <cstdint>
+#include <tuple>
 #include "orange_algo.h"
 #include "orange_functional.h"
 #include "orange_memory.h"
+#include "orange_node_handle.h"
 #include "orange_vector.h"
 #include "orange_util.h"
 #include "orange_exceptdef.h"
@@ -14,23 +21,39 @@ namespace orange_stl
 {
 
 /* hashtable 结点的定义 */
-template <class T>
-struct hashtable_node
+// 链表的基本结点，只含 next，hashtable 以它作为第一个节点之前的哨兵
+struct ht_node_base
 {
-    hashtable_node* next;   /* 指向下一个节点 */
-    T value;    /* 存储实值 */
+    ht_node_base* next;   /* 指向下一个节点 */
+};
 
-    hashtable_node() = default;
-    hashtable_node(const T& n):next(nullptr), value(n){}
+// 缓存的哈希值，CacheHash 为 false 时是空基类，不占空间
+template <bool CacheHash>
+struct ht_hash_code_base
+{
+};
 
-    hashtable_node(const hashtable_node& node):next(node.next),value(node.value)
-    { }
-    hashtable_node(hashtable_node&& node):next(node.next), value(orange_stl::move(node.value))
+template <>
+struct ht_hash_code_base<true>
+{
+    size_t hash_code;   /* 缓存的哈希值 */
+};
+
+template <class T, bool CacheHash = false>
+struct hashtable_node : public ht_node_base, public ht_hash_code_base<CacheHash>
+{
+    T value;    /* 存储实值 */
+
+    hashtable_node* next_node() const noexcept
     {
-        node.next=nullptr;
+        return static_cast<hashtable_node*>(next);
     }
 };
 
+// 哈希函数昂贵(不是 is_fast_hash)时，hashtable 在节点中缓存哈希值
+template <class Hash>
+struct ht_cache_hash : orange_stl::m_bool_constant<!orange_stl::is_fast_hash<Hash>::value> {};
+
 // value traits
 template <class T, bool>
 struct ht_value_traits_imp
@@ -97,31 +120,32 @@ struct ht_value_traits
 };
 
 /* 前置声明 */
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc, class BucketPolicy>
 class hashtable;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc, class BucketPolicy>
 struct ht_iterator;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc, class BucketPolicy>
 struct ht_const_iterator;
 
-template <class T>
+template <class T, class HashFun, class KeyEqual, class Alloc, class BucketPolicy>
 struct ht_local_iterator;
 
-template <class T>
+template <class T, class HashFun, class KeyEqual, class Alloc, class BucketPolicy>
 struct ht_const_local_iterator;
 
 /* ht_iterator */
-template <class T, class Hash, class KeyEqual>
-class ht_iterator_base 
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+class ht_iterator_base
     : public orange_stl::iterator<orange_stl::forward_iterator_tag, T>
 {
-    typedef orange_stl::hashtable<T, Hash, KeyEqual>         hashtable;
-    typedef ht_iterator_base<T, Hash, KeyEqual>              base;
-    typedef orange_stl::ht_iterator<T, Hash, KeyEqual>       iterator;
-    typedef orange_stl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-    typedef hashtable_node<T>*                               node_ptr;
+public:
+    typedef orange_stl::hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>         hashtable;
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc, BucketPolicy>              base;
+    typedef orange_stl::ht_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>       iterator;
+    typedef orange_stl::ht_const_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy> const_iterator;
+    typedef hashtable_node<T, ht_cache_hash<Hash>::value>*   node_ptr;
     typedef hashtable*                                       contain_ptr;
     typedef const node_ptr                                   const_node_ptr;
     typedef const contain_ptr                                const_contain_ptr;
@@ -144,10 +168,10 @@ class ht_iterator_base
     }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual, Alloc, BucketPolicy>
 {
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc, BucketPolicy> base;
     typedef typename base::hashtable            hashtable;
     typedef typename base::iterator             iterator;
     typedef typename base::const_iterator       const_iterator;
@@ -211,15 +235,8 @@ struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual>
     iterator& operator++()  /* 前置++ */
     {
         ORANGE_STL_DEBUG(node!=nullptr);
-        const node_ptr old=node;
-        node=node->next;
-        if(node==nullptr)
-        {
-            /* 如果下一个位置为空，调到下一个bucket的起始处 */
-            auto index = ht->hash(value_traits::get_key(old->value));
-            while(!node && ++index < ht->bucket_size_)
-                node = ht->buckets_[index];
-        }
+        /* 所有节点在同一条链表上，直接走到下一个节点 */
+        node = node->next_node();
         return *this;
     }
 
@@ -231,10 +248,10 @@ struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual>
     }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual, Alloc, BucketPolicy>
 {
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc, BucketPolicy> base;
     typedef typename base::hashtable            hashtable;
     typedef typename base::iterator             iterator;
     typedef typename base::const_iterator       const_iterator;
@@ -268,11 +285,8 @@ struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual>
     }
     const_iterator& operator=(const iterator& rhs)
     {
-        if (this != &rhs)
-        {
-            node = rhs.node;
-            ht = rhs.ht;
-        }
+        node = rhs.node;
+        ht = rhs.ht;
         return *this;
     }
     const_iterator& operator=(const const_iterator& rhs)
@@ -286,28 +300,20 @@ struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual>
     }
 
     // 重载操作符
-    reference operator*()  const 
+    reference operator*()  const
     {
-        return node->value; 
+        return node->value;
     }
-    pointer   operator->() const 
-    { 
-        return &(operator*()); 
+    pointer   operator->() const
+    {
+        return &(operator*());
     }
 
     const_iterator& operator++()
     {
         ORANGE_STL_DEBUG(node != nullptr);
-        const node_ptr old = node;
-        node = node->next;
-        if (node == nullptr)
-        { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-            auto index = ht->hash(value_traits::get_key(old->value));
-            while (!node && ++index < ht->bucket_size_)
-            {
-                node = ht->buckets_[index];
-            }
-        }
+        // 所有节点在同一条链表上，直接走到下一个节点
+        node = node->next_node();
         return *this;
     }
     const_iterator operator++(int)
@@ -319,8 +325,9 @@ struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual>
 };
 
 /* local iterator */
-template <class T>
-struct ht_local_iterator 
+// 桶内的节点在链表中相邻，走到下一个节点后若它属于别的桶，说明本桶已经走完
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+struct ht_local_iterator
     : public orange_stl::iterator<orange_stl::forward_iterator_tag, T>
 {
     typedef T                          value_type;
@@ -328,20 +335,25 @@ struct ht_local_iterator
     typedef value_type&                reference;
     typedef size_t                     size_type;
     typedef ptrdiff_t                  difference_type;
-    typedef hashtable_node<T>*         node_ptr;
+    typedef hashtable_node<T, ht_cache_hash<Hash>::value>*       node_ptr;
+
+    typedef orange_stl::hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>               hashtable;
+    typedef ht_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>                   self;
+    typedef ht_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>                   local_iterator;
+    typedef ht_const_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>             const_local_iterator;
 
-    typedef ht_local_iterator<T>       self;
-    typedef ht_local_iterator<T>       local_iterator;
-    typedef ht_const_local_iterator<T> const_local_iterator;
-    node_ptr node;
+    node_ptr         node;
+    const hashtable* ht;
+    size_type        bucket;
 
-    ht_local_iterator(node_ptr n) : node(n)
+    ht_local_iterator(node_ptr n, const hashtable* t, size_type b) : node(n), ht(t), bucket(b)
     { }
 
-    ht_local_iterator(const local_iterator& rhs) : node(rhs.node)
+    ht_local_iterator(const local_iterator& rhs) : node(rhs.node), ht(rhs.ht), bucket(rhs.bucket)
     { }
 
-    ht_local_iterator(const const_local_iterator& rhs) : node(rhs.node)
+    ht_local_iterator(const const_local_iterator& rhs)
+        : node(const_cast<node_ptr>(rhs.node)), ht(rhs.ht), bucket(rhs.bucket)
     { }
 
     reference operator*() const
@@ -356,7 +368,9 @@ struct ht_local_iterator
     self& operator++()
     {
         ORANGE_STL_DEBUG(node!=nullptr);
-        node = node->next;
+        node = node->next_node();
+        if (node != nullptr && ht->bucket_index(node) != bucket)
+            node = nullptr;
         return *this;
     }
 
@@ -377,8 +391,8 @@ struct ht_local_iterator
     }
 };
 
-template <class T>
-struct ht_const_local_iterator 
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+struct ht_const_local_iterator
     :public orange_stl::iterator<orange_stl::forward_iterator_tag, T>
 {
     typedef T                          value_type;
@@ -386,34 +400,39 @@ struct ht_const_local_iterator
     typedef const value_type&          reference;
     typedef size_t                     size_type;
     typedef ptrdiff_t                  difference_type;
-    typedef const hashtable_node<T>*   node_ptr;
+    typedef const hashtable_node<T, ht_cache_hash<Hash>::value>* node_ptr;
 
-    typedef ht_const_local_iterator<T> self;
-    typedef ht_local_iterator<T>       local_iterator;
-    typedef ht_const_local_iterator<T> const_local_iterator;
+    typedef orange_stl::hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>               hashtable;
+    typedef ht_const_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>             self;
+    typedef ht_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>                   local_iterator;
+    typedef ht_const_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>             const_local_iterator;
 
-    node_ptr node;
+    node_ptr         node;
+    const hashtable* ht;
+    size_type        bucket;
 
-    ht_const_local_iterator(node_ptr n):node(n)
+    ht_const_local_iterator(node_ptr n, const hashtable* t, size_type b) : node(n), ht(t), bucket(b)
     { }
-    ht_const_local_iterator(const local_iterator& rhs):node(rhs.node)
+    ht_const_local_iterator(const local_iterator& rhs) : node(rhs.node), ht(rhs.ht), bucket(rhs.bucket)
     { }
-    ht_const_local_iterator(const const_local_iterator& rhs):node(rhs.node)
+    ht_const_local_iterator(const const_local_iterator& rhs) : node(rhs.node), ht(rhs.ht), bucket(rhs.bucket)
     { }
 
-    reference operator*()  const 
-    { 
-        return node->value; 
+    reference operator*()  const
+    {
+        return node->value;
     }
-    pointer operator->() const 
-    { 
-        return &(operator*()); 
+    pointer operator->() const
+    {
+        return &(operator*());
     }
 
     self& operator++()
     {
         ORANGE_STL_DEBUG(node != nullptr);
-        node = node->next;
+        node = node->next_node();
+        if (node != nullptr && ht->bucket_index(node) != bucket)
+            node = nullptr;
         return *this;
     }
 
@@ -495,13 +514,79 @@ inline size_t ht_next_prime(size_t n)
     return pos == last ? *(last - 1) : *pos;
 }
 
+// 把哈希值的每一位都扩散到全部位上(64 位 finalizer)，使恒等哈希的整数在低位上也足够均匀
+inline size_t ht_hash_mix(size_t h) noexcept
+{
+    uint64_t x = static_cast<uint64_t>(h);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+}
+
+// 桶的策略：决定桶的个数以及哈希值到桶的映射
+//   next_size(n)        不小于 n 的桶个数
+//   max_size()          桶个数的上限
+//   index(hash, count)  哈希值为 hash 的元素所在的桶，count 为 next_size 得到的桶个数
+
+// 质数个桶，以取模定位桶，对哈希值的质量不敏感，但每次定位都需要一次整数除法
+struct prime_bucket_policy
+{
+    static size_t next_size(size_t n) noexcept
+    { return ht_next_prime(n); }
+
+    static size_t max_size() noexcept
+    { return ht_prime_list[PRIME_NUM - 1]; }
+
+    static size_t index(size_t hash, size_t count) noexcept
+    { return hash % count; }
+};
+
+// 2 的幂个桶，先以 ht_hash_mix 打散哈希值再取低位，定位桶不需要除法
+struct power2_bucket_policy
+{
+    static size_t next_size(size_t n) noexcept
+    {
+        size_t count = 8;
+        while (count < n && count < max_size())
+            count <<= 1;
+        return count;
+    }
+
+    static size_t max_size() noexcept
+    { return (static_cast<size_t>(-1) >> 1) + 1; }
+
+    static size_t index(size_t hash, size_t count) noexcept
+    { return ht_hash_mix(hash) & (count - 1); }
+};
+
+// 渐进式 rehash 时，每次插入、查找、删除最多迁移的非空旧桶个数
+// find_batch 每组处理的键值个数，同一组的预取请求可以同时在途
+enum { EHashtableRehashSteps = 4, EHashtableBatchSize = 32 };
+
+// 软件预取，提前把 p 所在的缓存行读入缓存，不支持的编译器上什么也不做
+inline void ht_prefetch(const void* p) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
 // 模板类 hashtable
-// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
-template <class T, class Hash, class KeyEqual>
+// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数，参数四代表空间配置器类型
+// 参数五代表桶的策略，缺省使用 prime_bucket_policy
+template <class T, class Hash, class KeyEqual, class Alloc = orange_stl::allocator<T>,
+          class BucketPolicy = orange_stl::prime_bucket_policy>
 class hashtable
 {
-    friend struct orange_stl::ht_iterator<T, Hash, KeyEqual>;
-    friend struct orange_stl::ht_const_iterator<T, Hash, KeyEqual>;
+    friend struct orange_stl::ht_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>;
+    friend struct orange_stl::ht_const_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>;
+    friend struct orange_stl::ht_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>;
+    friend struct orange_stl::ht_const_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>;
 
 public:
     /* hashtable 的型别定义 */
@@ -512,47 +597,65 @@ public:
     typedef Hash                                        hasher;
     typedef KeyEqual                                    key_equal;
 
-    typedef hashtable_node<T>                           node_type;
+    typedef hashtable_node<T, ht_cache_hash<Hash>::value> node_type;
     typedef node_type*                                  node_ptr;
-    typedef orange_stl::vector<node_ptr>                bucket_type;
+    typedef ht_node_base*                               base_ptr;
+
+    typedef Alloc                                               allocator_type;
+    typedef typename Alloc::template rebind<T>::other           data_allocator;
+    typedef typename Alloc::template rebind<node_type>::other   node_allocator;
+    typedef typename Alloc::template rebind<base_ptr>::other    bucket_allocator;
+    typedef orange_stl::vector<base_ptr, bucket_allocator>      bucket_type;
 
-    typedef orange_stl::allocator<T>                    allocator_type;
-    typedef orange_stl::allocator<T>                    data_allocator;
-    typedef orange_stl::allocator<node_type>            node_allocator;
+    typedef typename data_allocator::pointer            pointer;
+    typedef typename data_allocator::const_pointer      const_pointer;
+    typedef typename data_allocator::reference          reference;
+    typedef typename data_allocator::const_reference    const_reference;
+    typedef typename data_allocator::size_type          size_type;
+    typedef typename data_allocator::difference_type    difference_type;
 
-    typedef typename allocator_type::pointer            pointer;
-    typedef typename allocator_type::const_pointer      const_pointer;
-    typedef typename allocator_type::reference          reference;
-    typedef typename allocator_type::const_reference    const_reference;
-    typedef typename allocator_type::size_type          size_type;
-    typedef typename allocator_type::difference_type    difference_type;
+    typedef orange_stl::ht_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>             iterator;
+    typedef orange_stl::ht_const_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>       const_iterator;
+    typedef orange_stl::ht_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy>       local_iterator;
+    typedef orange_stl::ht_const_local_iterator<T, Hash, KeyEqual, Alloc, BucketPolicy> const_local_iterator;
 
-    typedef orange_stl::ht_iterator<T, Hash, KeyEqual>       iterator;
-    typedef orange_stl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-    typedef orange_stl::ht_local_iterator<T>                 local_iterator;
-    typedef orange_stl::ht_const_local_iterator<T>           const_local_iterator;
+    typedef orange_stl::node_handle<T, node_type, Alloc>                node_handle_type;
+    typedef orange_stl::node_insert_return<iterator, node_handle_type>  insert_return_type;
 
-    allocator_type get_allocator() const 
-    { 
-        return allocator_type(); 
+    allocator_type get_allocator() const
+    {
+        return allocator_type();
     }
 
 private:
-    // 用以下六个参数来表现 hashtable
-    bucket_type buckets_;
-    size_type   bucket_size_;
-    size_type   size_;
-    float       mlf_;
-    hasher      hash_;
-    key_equal   equal_;
+    // 用以下七个参数来表现 hashtable
+    // buckets_[n] 指向第 n 个桶第一个节点的前一个节点，桶为空时为 nullptr
+    // before_begin_ 是整条链表的头哨兵，第一个节点所在的桶指向它
+    bucket_type  buckets_;
+    ht_node_base before_begin_;
+    size_type    bucket_size_;
+    size_type    size_;
+    float        mlf_;
+    hasher       hash_;
+    key_equal    equal_;
+
+    // 渐进式 rehash 的状态
+    // 迁移期间旧桶数组中下标不小于 rehash_index_ 的桶尚未迁移，键值落在这些桶的节点仍挂在旧桶上
+    // 两个数组的桶共用同一条链表，旧桶 k 的编号记为 bucket_size_ + k
+    bucket_type  old_buckets_;
+    size_type    old_bucket_size_;   // 不在迁移时为 0
+    size_type    rehash_index_;
+    bool         incremental_;
 
 private:
-    bool is_equal(const key_type& key1, const key_type& key2)
+    template <class K>
+    bool is_equal(const key_type& key1, const K& key2)
     {
         return equal_(key1, key2);
     }
 
-    bool is_equal(const key_type& key1, const key_type& key2) const
+    template <class K>
+    bool is_equal(const key_type& key1, const K& key2) const
     {
         return equal_(key1, key2);
     }
@@ -562,24 +665,108 @@ private:
         return const_iterator(node, const_cast<hashtable*>(this));
     }
 
-    iterator M_begin() noexcept
+    node_ptr begin_node() const noexcept
     {
-        for (size_type n = 0; n < bucket_size_; ++n)
-        {
-            if (buckets_[n])  // 找到第一个有节点的位置就返回
-                return iterator(buckets_[n], this);
-        }
-        return iterator(nullptr, this);
+        return static_cast<node_ptr>(before_begin_.next);
     }
 
-    const_iterator M_begin() const noexcept
+    bool is_rehashing() const noexcept
     {
-        for (size_type n = 0; n < bucket_size_; ++n)
+        return old_bucket_size_ != 0;
+    }
+
+    // 哈希值为 code 的键值所在的桶的编号，迁移期间尚未迁移的键值返回旧桶的编号
+    size_type bucket_index_code(size_t code) const
+    {
+        if (is_rehashing())
         {
-            if (buckets_[n])  // 找到第一个有节点的位置就返回
-                return M_cit(buckets_[n]);
+            const size_type k = BucketPolicy::index(code, old_bucket_size_);
+            if (k >= rehash_index_)
+                return bucket_size_ + k;
         }
-        return M_cit(nullptr);
+        return BucketPolicy::index(code, bucket_size_);
+    }
+
+    size_type bucket_index(const key_type& key) const
+    {
+        return bucket_index_code(hash_(key));
+    }
+
+    size_type bucket_index(const node_type* np) const
+    {
+        return bucket_index_code(node_hash(np));
+    }
+
+    size_type bucket_index(const node_type* np, size_type n) const
+    {
+        return BucketPolicy::index(node_hash(np), n);
+    }
+
+    // 节点的哈希值，缓存时直接读取
+    size_t node_hash(const node_type* np) const
+    {
+        return node_hash(np, ht_cache_hash<Hash>());
+    }
+    size_t node_hash(const node_type* np, m_true_type) const noexcept
+    {
+        return np->hash_code;
+    }
+    size_t node_hash(const node_type* np, m_false_type) const
+    {
+        return hash_(value_traits::get_key(np->value));
+    }
+
+    void store_hash(node_type* np, size_t code) const noexcept
+    {
+        store_hash(np, code, ht_cache_hash<Hash>());
+    }
+    void store_hash(node_type* np, size_t code, m_true_type) const noexcept
+    {
+        np->hash_code = code;
+    }
+    void store_hash(node_type*, size_t, m_false_type) const noexcept
+    {
+    }
+
+    // 节点的键值是否等于 key，缓存哈希值时先比较哈希值
+    template <class K>
+    bool node_equal(const node_type* np, const K& key, size_t code) const
+    {
+        return node_equal(np, key, code, ht_cache_hash<Hash>());
+    }
+    template <class K>
+    bool node_equal(const node_type* np, const K& key, size_t code, m_true_type) const
+    {
+        return np->hash_code == code && is_equal(value_traits::get_key(np->value), key);
+    }
+    template <class K>
+    bool node_equal(const node_type* np, const K& key, size_t, m_false_type) const
+    {
+        return is_equal(value_traits::get_key(np->value), key);
+    }
+
+    // 按编号取得桶
+    base_ptr& bucket_ref(size_type n) noexcept
+    {
+        return n < bucket_size_ ? buckets_[n] : old_buckets_[n - bucket_size_];
+    }
+
+    base_ptr bucket_ref(size_type n) const noexcept
+    {
+        return n < bucket_size_ ? buckets_[n] : old_buckets_[n - bucket_size_];
+    }
+
+    // 桶在桶数组中的地址，供预取使用
+    const base_ptr* bucket_addr(size_type n) const noexcept
+    {
+        return n < bucket_size_ ? buckets_.data() + n : old_buckets_.data() + (n - bucket_size_);
+    }
+
+    // 迁移期间推进一步
+    void rehash_step_if_need()
+    {
+        if (is_rehashing())
+            rehash_step(EHashtableRehashSteps);
     }
 
 public:
@@ -587,7 +774,8 @@ public:
     explicit hashtable(size_type bucket_count,
                         const Hash& hash = Hash(),
                         const KeyEqual& equal = KeyEqual())
-        :size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
+        :size_(0), mlf_(1.0f), hash_(hash), equal_(equal),
+        old_bucket_size_(0), rehash_index_(0), incremental_(false)
     {
         init(bucket_count);
     }
@@ -598,47 +786,61 @@ public:
                 size_type bucket_count,
                 const Hash& hash = Hash(),
                 const KeyEqual& equal = KeyEqual())
-        :size_(orange_stl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal)
+        :size_(0), mlf_(1.0f), hash_(hash), equal_(equal),
+        old_bucket_size_(0), rehash_index_(0), incremental_(false)
     {
         init(orange_stl::max(bucket_count, static_cast<size_type>(orange_stl::distance(first, last))));
     }
 
-    hashtable(const hashtable& rhs) : hash_(rhs.hash_), equal_(rhs.equal_)
+    hashtable(const hashtable& rhs)
+        : hash_(rhs.hash_), equal_(rhs.equal_),
+        old_bucket_size_(0), rehash_index_(0), incremental_(rhs.incremental_)
     {
         copy_init(rhs);
     }
 
     hashtable(hashtable&& rhs) noexcept
-        : bucket_size_(rhs.bucket_size_), 
+        : bucket_size_(rhs.bucket_size_),
         size_(rhs.size_),
         mlf_(rhs.mlf_),
         hash_(rhs.hash_),
-        equal_(rhs.equal_)
+        equal_(rhs.equal_),
+        old_bucket_size_(rhs.old_bucket_size_),
+        rehash_index_(rhs.rehash_index_),
+        incremental_(rhs.incremental_)
     {
         buckets_ = orange_stl::move(rhs.buckets_);
+        old_buckets_ = orange_stl::move(rhs.old_buckets_);
+        before_begin_.next = rhs.before_begin_.next;
+        // 第一个节点所在的桶原先指向 rhs 的哨兵
+        if (before_begin_.next != nullptr)
+            bucket_ref(bucket_index(begin_node())) = &before_begin_;
+        rhs.before_begin_.next = nullptr;
         rhs.bucket_size_ = 0;
         rhs.size_ = 0;
         rhs.mlf_ = 0.0f;
+        rhs.old_bucket_size_ = 0;
+        rhs.rehash_index_ = 0;
     }
 
     hashtable& operator=(const hashtable& rhs);
     hashtable& operator=(hashtable&& rhs) noexcept;
 
-    ~hashtable() 
-    { 
-        clear(); 
+    ~hashtable()
+    {
+        clear();
     }
 
     // 迭代器相关操作
     iterator       begin()        noexcept
-    { return M_begin(); }
+    { return iterator(begin_node(), this); }
     const_iterator begin()  const noexcept
-    { return M_begin(); }
+    { return M_cit(begin_node()); }
     iterator       end()          noexcept
     { return iterator(nullptr, this); }
     const_iterator end()    const noexcept
     { return M_cit(nullptr); }
-    
+
     const_iterator cbegin() const noexcept
     { return begin(); }
     const_iterator cend()   const noexcept
@@ -657,16 +859,16 @@ public:
 
     template <class ...Args>
     iterator emplace_multi_use_hint(const_iterator /*hint*/, Args&& ...args)
-    { 
-        return emplace_multi(orange_stl::forward<Args>(args)...); 
+    {
+        return emplace_multi(orange_stl::forward<Args>(args)...);
     }
 
     template <class ...Args>
     iterator emplace_unique_use_hint(const_iterator /*hint*/, Args&& ...args)
-    { 
-        return emplace_unique(orange_stl::forward<Args>(args)...).first; 
+    {
+        return emplace_unique(orange_stl::forward<Args>(args)...).first;
     }
-    
+
     iterator             insert_multi_noresize(const value_type& value);
     pair<iterator, bool> insert_unique_noresize(const value_type& value);
 
@@ -676,8 +878,8 @@ public:
         return insert_multi_noresize(value);
     }
     iterator insert_multi(value_type&& value)
-    { 
-        return emplace_multi(orange_stl::move(value)); 
+    {
+        return emplace_multi(orange_stl::move(value));
     }
 
     pair<iterator, bool> insert_unique(const value_type& value)
@@ -686,8 +888,8 @@ public:
         return insert_unique_noresize(value);
     }
     pair<iterator, bool> insert_unique(value_type&& value)
-    { 
-        return emplace_unique(orange_stl::move(value)); 
+    {
+        return emplace_unique(orange_stl::move(value));
     }
 
     iterator insert_multi_use_hint(const_iterator /*hint*/, const value_type& value)
@@ -698,7 +900,7 @@ public:
     iterator insert_unique_use_hint(const_iterator /*hint*/, const value_type& value)
     { return insert_unique(value).first; }
     iterator insert_unique_use_hint(const_iterator /*hint*/, value_type&& value)
-    { return emplace_unique(orange_stl::move(value)); }
+    { return emplace_unique(orange_stl::move(value)).first; }
 
     template <class InputIter>
     void insert_multi(InputIter first, InputIter last)
@@ -708,6 +910,19 @@ public:
     void insert_unique(InputIter first, InputIter last)
     { copy_insert_unique(first, last, iterator_category(first)); }
 
+    // 只计算一次哈希、查找一次的插入，供 unordered_map 使用，value_type 须为 pair<const key, mapped>
+    // 键值不存在时以 key 和 args 原位构造新节点，否则什么也不做
+    template <class K, class ...Args>
+    pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args);
+
+    // 键值不存在时插入，否则把 obj 赋给已有元素的 second
+    template <class K, class V>
+    pair<iterator, bool> insert_or_assign_unique(K&& key, V&& obj);
+
+    // 键值不存在时以 factory() 的结果构造 second，factory 只在插入时调用
+    template <class K, class Factory>
+    pair<iterator, bool> get_or_insert_with_unique(K&& key, Factory&& factory);
+
     void      erase(const_iterator position);
     void      erase(const_iterator first, const_iterator last);
 
@@ -718,23 +933,94 @@ public:
 
     void      swap(hashtable& rhs) noexcept;
 
-    // 查找相关操作
+    // 节点句柄相关的操作，节点在容器之间转移时不重新配置，也不复制或移动元素
+    // extract 把节点从表中摘下交给句柄，键值允许重复时摘下找到的第一个节点，找不到时返回空句柄
+    node_handle_type   extract(const_iterator position);
+    node_handle_type   extract(const key_type& key);
 
-    size_type                            count(const key_type& key) const;
+    // 插入句柄持有的节点，键值已存在或扩容失败时节点仍归句柄所有
+    insert_return_type insert_unique(node_handle_type&& nh);
+    iterator           insert_multi(node_handle_type&& nh);
 
-    iterator                             find(const key_type& key);
-    const_iterator                       find(const key_type& key) const;
+    // 把 source 中的节点转移到本表，键值不允许重复时已存在的键值留在 source 中
+    // 哈希值由本表的哈希函数重新计算
+    void      merge_unique(hashtable& source);
+    void      merge_multi(hashtable& source);
 
-    pair<iterator, iterator>             equal_range_multi(const key_type& key);
-    pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const;
+    // 查找相关操作
 
-    pair<iterator, iterator>             equal_range_unique(const key_type& key);
-    pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const;
+    // 带有 K 模板参数的重载用于异构查找，只在 Hash 与 KeyEqual 都声明了 is_transparent 时参与重载决议
+    // 此时 hash_(key) 与 equal_(node_key, key) 须对 K 有定义，且与 key_type 的结果一致
+
+    size_type count(const key_type& key) const { return count_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    size_type count(const K& key) const { return count_key(key); }
+
+    iterator       find(const key_type& key)       { return find_key(key); }
+    const_iterator find(const key_type& key) const { return find_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    iterator       find(const K& key)              { return find_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    const_iterator find(const K& key) const        { return find_key(key); }
+
+    pair<iterator, iterator> equal_range_multi(const key_type& key)
+    { return equal_range_multi_key(key); }
+    pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+    { return equal_range_multi_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    pair<iterator, iterator> equal_range_multi(const K& key)
+    { return equal_range_multi_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    pair<const_iterator, const_iterator> equal_range_multi(const K& key) const
+    { return equal_range_multi_key(key); }
+
+    pair<iterator, iterator> equal_range_unique(const key_type& key)
+    { return equal_range_unique_key(key); }
+    pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+    { return equal_range_unique_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    pair<iterator, iterator> equal_range_unique(const K& key)
+    { return equal_range_unique_key(key); }
+    template <class K, typename enable_if_transparent<K, Hash, KeyEqual>::type = 0>
+    pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+    { return equal_range_unique_key(key); }
+
+    // 批量查找：依次查找 [first, last) 中的每个键值，把结果(找不到时为 end())写入 out，返回写入后的 out
+    // 每 EHashtableBatchSize 个键值为一组，先算出整组的哈希值并预取各自的桶，再逐级预取桶中的节点，
+    // 最后逐个比较，一组键值的缓存未命中因此可以重叠，而不是一个接一个地等待
+    // 适合远大于缓存的表；表能放进缓存时预取没有收益，逐个调用 find 反而更快
+    // *first 须为 key_type，或者在 Hash 与 KeyEqual 都声明了 is_transparent 时为它们接受的类型
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out);
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const;
+
+    // bucket interface
+
+    local_iterator       begin(size_type n)        noexcept
+    {
+        ORANGE_STL_DEBUG(n < bucket_size_);
+        return local_iterator(bucket_begin(n), this, n);
+    }
+    const_local_iterator begin(size_type n)  const noexcept
+    {
+        ORANGE_STL_DEBUG(n < bucket_size_);
+        return const_local_iterator(bucket_begin(n), this, n);
+    }
+    const_local_iterator cbegin(size_type n) const noexcept
+    { return begin(n); }
+
+    local_iterator       end(size_type n)          noexcept
+    { return local_iterator(nullptr, this, n); }
+    const_local_iterator end(size_type n)    const noexcept
+    { return const_local_iterator(nullptr, this, n); }
+    const_local_iterator cend(size_type n)   const noexcept
+    { return end(n); }
 
     size_type bucket_count()                 const noexcept
     { return bucket_size_; }
     size_type max_bucket_count()             const noexcept
-    { return ht_prime_list[PRIME_NUM - 1]; }
+    { return BucketPolicy::max_size(); }
 
     size_type bucket_size(size_type n)       const noexcept;
     size_type bucket(const key_type& key)    const
@@ -744,8 +1030,8 @@ public:
     { return bucket_size_ != 0 ? (float)size_ / bucket_size_ : 0.0f; }
 
     float max_load_factor() const noexcept
-    { 
-        return mlf_; 
+    {
+        return mlf_;
     }
 
     void max_load_factor(float ml)
@@ -756,14 +1042,40 @@ public:
 
     void rehash(size_type count);
 
+    // 渐进式 rehash
+    // 开启后，自动扩容只分配新的桶数组，元素留在旧桶上，之后每次插入、非 const 的 find 与按键值删除迁移少量旧桶，
+    // 单次操作的耗时不再随元素个数增长
+    // 迁移期间迭代器与引用仍然有效，但上述操作可能改变遍历顺序；桶接口(bucket、bucket_size、begin(n) 等)只反映新的桶数组
+    // 显式调用 rehash / reserve 或关闭该模式时，会一次完成剩余的迁移
+    bool incremental_rehash() const noexcept
+    { return incremental_; }
+
+    void incremental_rehash(bool on)
+    {
+        incremental_ = on;
+        if (!on && is_rehashing())
+            rehash_step(old_bucket_size_);
+    }
+
+    // 是否处于迁移中
+    bool rehashing() const noexcept
+    { return is_rehashing(); }
+
+    // 最多迁移 count 个非空旧桶，迁移完成后返回 false，可在空闲时调用以尽快结束迁移
+    bool rehash_step(size_type count);
+
     void reserve(size_type count)
-    { 
-        rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f)); 
+    {
+        rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f));
     }
 
     hasher    hash_fcn() const { return hash_; }
     key_equal key_eq()   const { return equal_; }
 
+    // comparision
+    bool equal_to_multi(const hashtable& other) const;
+    bool equal_to_unique(const hashtable& other) const;
+
 private:
     // hashtable 成员函数
 
@@ -794,22 +1106,48 @@ private:
 
     // insert node
     pair<iterator, bool> insert_node_unique(node_ptr np);
+    iterator             insert_unique_node(size_t code, node_ptr np);
     iterator             insert_node_multi(node_ptr np);
 
-    // bucket operator
-    void replace_bucket(size_type bucket_count);
-    void erase_bucket(size_type n, node_ptr first, node_ptr last);
-    void erase_bucket(size_type n, node_ptr last);
+    // find，K 为 key_type 或者透明的哈希函数与比较函数接受的其他类型
+    template <class K>
+    base_ptr  find_before_node(size_type n, const K& key, size_t code) const;
+    template <class K>
+    node_ptr  find_node(size_type n, const K& key, size_t code) const;
+
+    template <class K>
+    size_type                            count_key(const K& key) const;
+    template <class K>
+    iterator                             find_key(const K& key);
+    template <class K>
+    const_iterator                       find_key(const K& key) const;
+    template <class K>
+    pair<iterator, iterator>             equal_range_multi_key(const K& key);
+    template <class K>
+    pair<const_iterator, const_iterator> equal_range_multi_key(const K& key) const;
+    template <class K>
+    pair<iterator, iterator>             equal_range_unique_key(const K& key);
+    template <class K>
+    pair<const_iterator, const_iterator> equal_range_unique_key(const K& key) const;
+    template <class ForwardIter>
+    size_type find_group(ForwardIter& first, ForwardIter last, node_ptr* result) const;
+    node_ptr  bucket_begin(size_type n) const;
 
-    // comparision
-    bool equal_to_multi(const hashtable& other);
-    bool equal_to_unique(const hashtable& other);
+    // bucket operator
+    void      replace_bucket(size_type bucket_count);
+    void      start_rehash(size_type bucket_count);
+    void      migrate_bucket(size_type k);
+    void      insert_bucket_begin(size_type n, node_ptr np);
+    void      remove_bucket_begin(size_type n, node_ptr next, size_type next_n);
+    base_ptr  get_previous_node(size_type n, node_ptr np) const;
+    node_ptr  unlink_node(size_type n, base_ptr prev, node_ptr np);
+    node_ptr  erase_node(size_type n, base_ptr prev, node_ptr np);
 };
 
 // 复制赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>&
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>&
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 operator=(const hashtable& rhs)
 {
     if (this != &rhs)
@@ -821,9 +1159,9 @@ operator=(const hashtable& rhs)
 }
 
 // 移动赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>&
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>&
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 operator=(hashtable&& rhs) noexcept
 {
     hashtable tmp(orange_stl::move(rhs));
@@ -833,16 +1171,16 @@ operator=(hashtable&& rhs) noexcept
 
 // 就地构造元素，键值允许重复
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
 template <class ...Args>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::emplace_multi(Args&& ...args)
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::emplace_multi(Args&& ...args)
 {
     auto np = create_node(orange_stl::forward<Args>(args)...);
     try
     {
-        if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-        rehash(size_ + 1);
+        rehash_step_if_need();
+        rehash_if_need(1);
     }
     catch (...)
     {
@@ -853,218 +1191,374 @@ hashtable<T, Hash, KeyEqual>::emplace_multi(Args&& ...args)
 }
 
 
-// 就地构造元素，键值允许重复
+// 就地构造元素，键值不允许重复
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
 template <class ...Args>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool> 
-hashtable<T, Hash, KeyEqual>::emplace_unique(Args&& ...args)
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::emplace_unique(Args&& ...args)
 {
     auto np = create_node(orange_stl::forward<Args>(args)...);
+    size_t code = 0;
+    node_ptr cur = nullptr;
     try
     {
-        if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-        rehash(size_ + 1);
+        code = hash_(value_traits::get_key(np->value));
+        rehash_step_if_need();
+        cur = find_node(bucket_index_code(code), value_traits::get_key(np->value), code);
     }
     catch (...)
     {
         destroy_node(np);
         throw;
     }
-    return insert_node_unique(np);
+    // 键值已存在时不需要扩容
+    if (cur != nullptr)
+    {
+        destroy_node(np);
+        return orange_stl::make_pair(iterator(cur, this), false);
+    }
+    return orange_stl::make_pair(insert_unique_node(code, np), true);
 }
 
-// 在不需要重建表格的情况下插入新节点，键值不允许重复
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::insert_unique_noresize(const value_type& value)
+// 键值不存在时原位构造新节点，否则返回已有的元素
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K, class ...Args>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::try_emplace_unique(K&& key, Args&& ...args)
+{
+    rehash_step_if_need();
+    const size_t code = hash_(key);
+    node_ptr cur = find_node(bucket_index_code(code), key, code);
+    if (cur != nullptr)
+        return orange_stl::make_pair(iterator(cur, this), false);
+    auto np = create_node(orange_stl::piecewise_construct,
+                          std::forward_as_tuple(orange_stl::forward<K>(key)),
+                          std::forward_as_tuple(orange_stl::forward<Args>(args)...));
+    return orange_stl::make_pair(insert_unique_node(code, np), true);
+}
+
+// 键值不存在时插入，否则赋值
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K, class V>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_or_assign_unique(K&& key, V&& obj)
+{
+    rehash_step_if_need();
+    const size_t code = hash_(key);
+    node_ptr cur = find_node(bucket_index_code(code), key, code);
+    if (cur != nullptr)
+    {
+        cur->value.second = orange_stl::forward<V>(obj);
+        return orange_stl::make_pair(iterator(cur, this), false);
+    }
+    auto np = create_node(orange_stl::piecewise_construct,
+                          std::forward_as_tuple(orange_stl::forward<K>(key)),
+                          std::forward_as_tuple(orange_stl::forward<V>(obj)));
+    return orange_stl::make_pair(insert_unique_node(code, np), true);
+}
+
+// 键值不存在时以 factory() 构造新节点，否则返回已有的元素
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K, class Factory>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::get_or_insert_with_unique(K&& key, Factory&& factory)
+{
+    rehash_step_if_need();
+    const size_t code = hash_(key);
+    node_ptr cur = find_node(bucket_index_code(code), key, code);
+    if (cur != nullptr)
+        return orange_stl::make_pair(iterator(cur, this), false);
+    auto np = create_node(orange_stl::piecewise_construct,
+                          std::forward_as_tuple(orange_stl::forward<K>(key)),
+                          std::forward_as_tuple(factory()));
+    return orange_stl::make_pair(insert_unique_node(code, np), true);
+}
+
+// 把已确认键值不存在、哈希值为 code 的新节点放入表中，必要时先扩容
+// 扩容失败时销毁节点，强异常安全保证
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_unique_node(size_t code, node_ptr np)
 {
-    const auto n = hash(value_traits::get_key(value));
-    auto first = buckets_[n];
-    for (auto cur = first; cur; cur = cur->next)
+    store_hash(np, code);
+    try
     {
-        if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
-            return orange_stl::make_pair(iterator(cur, this), false);
+        rehash_if_need(1);
     }
-    // 让新节点成为链表的第一个节点
-    auto tmp = create_node(value);  
-    tmp->next = first;
-    buckets_[n] = tmp;
+    catch (...)
+    {
+        destroy_node(np);
+        throw;
+    }
+    insert_bucket_begin(bucket_index_code(code), np);
+    ++size_;
+    return iterator(np, this);
+}
+
+// 在不需要重建表格的情况下插入新节点，键值不允许重复
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_unique_noresize(const value_type& value)
+{
+    rehash_step_if_need();
+    const size_t code = hash_(value_traits::get_key(value));
+    const auto n = bucket_index_code(code);
+    auto cur = find_node(n, value_traits::get_key(value), code);
+    if (cur != nullptr)
+        return orange_stl::make_pair(iterator(cur, this), false);
+    // 让新节点成为桶的第一个节点
+    auto tmp = create_node(value);
+    store_hash(tmp, code);
+    insert_bucket_begin(n, tmp);
     ++size_;
     return orange_stl::make_pair(iterator(tmp, this), true);
 }
 
 // 在不需要重建表格的情况下插入新节点，键值允许重复
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::insert_multi_noresize(const value_type& value)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_multi_noresize(const value_type& value)
 {
-    const auto n = hash(value_traits::get_key(value));
-    auto first = buckets_[n];
-    auto tmp = create_node(value);
-    for (auto cur = first; cur; cur = cur->next)
+    auto np = create_node(value);
+    try
     {
-        if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
-        { // 如果链表中存在相同键值的节点就马上插入，然后返回
-            tmp->next = cur->next;
-            cur->next = tmp;
-            ++size_;
-            return iterator(tmp, this);
-        }
+        rehash_step_if_need();
     }
-    // 否则插入在链表头部
-    tmp->next = first;
-    buckets_[n] = tmp;
-    ++size_;
-    return iterator(tmp, this);
+    catch (...)
+    {
+        destroy_node(np);
+        throw;
+    }
+    return insert_node_multi(np);
 }
 
 // 删除迭代器所指的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::erase(const_iterator position)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::erase(const_iterator position)
 {
     auto p = position.node;
     if (p)
     {
-        const auto n = hash(value_traits::get_key(p->value));
-        auto cur = buckets_[n];
-        if (cur == p)
-        { // p 位于链表头部
-            buckets_[n] = cur->next;
-            destroy_node(cur);
-            --size_;
-        }
-        else
-        {
-            auto next = cur->next;
-            while (next)
-            {
-                if (next == p)
-                {
-                    cur->next = next->next;
-                    destroy_node(next);
-                    --size_;
-                    break;
-                }
-                else
-                {
-                    cur = next;
-                    next = cur->next;
-                }
-            }
-        }
+        const auto n = bucket_index(p);
+        erase_node(n, get_previous_node(n, p), p);
     }
 }
 
 // 删除[first, last)内的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::erase(const_iterator first, const_iterator last)
+// 区间内的节点在链表上是连续的，逐个删除并维护途经各桶的前驱指针
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::erase(const_iterator first, const_iterator last)
 {
-    if (first.node == last.node)
+    node_ptr cur = first.node;
+    node_ptr last_node = last.node;
+    if (cur == last_node)
         return;
-    auto first_bucket = first.node 
-        ? hash(value_traits::get_key(first.node->value)) 
-        : bucket_size_;
-    auto last_bucket = last.node 
-        ? hash(value_traits::get_key(last.node->value))
-        : bucket_size_;
-    if (first_bucket == last_bucket)
-    { // 如果在 bucket 在同一个位置
-        erase_bucket(first_bucket, first.node, last.node);
-    }
-    else
+    size_type n = bucket_index(cur);
+    base_ptr prev = get_previous_node(n, cur);
+    bool is_bucket_begin = prev == bucket_ref(n);
+    size_type next_n = n;
+    for (;;)
     {
-        erase_bucket(first_bucket, first.node, nullptr);
-        for (auto n = first_bucket + 1; n < last_bucket; ++n)
+        do
         {
-            if(buckets_[n] != nullptr)
-                erase_bucket(n, nullptr);
-        }
-        if (last_bucket != bucket_size_)
-        {
-            erase_bucket(last_bucket, last.node);
-        }
-    }
+            auto tmp = cur;
+            cur = cur->next_node();
+            destroy_node(tmp);
+            --size_;
+            if (cur == nullptr)
+                break;
+            next_n = bucket_index(cur);
+        } while (cur != last_node && next_n == n);
+
+        if (is_bucket_begin)
+            remove_bucket_begin(n, cur, next_n);
+        if (cur == last_node)
+            break;
+        // 进入下一个桶，该桶从第一个节点开始删除
+        is_bucket_begin = true;
+        n = next_n;
+    }
+    if (cur != nullptr && (next_n != n || is_bucket_begin))
+        bucket_ref(next_n) = prev;
+    prev->next = cur;
 }
 
 // 删除键值为 key 的节点
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::erase_multi(const key_type& key)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::erase_multi(const key_type& key)
 {
-    auto p = equal_range_multi(key);
-    if (p.first.node != nullptr)
-    {
-        erase(p.first, p.second);
-        return orange_stl::distance(p.first, p.second);
-    }
-    return 0;
+    rehash_step_if_need();
+    const size_t code = hash_(key);
+    const auto n = bucket_index_code(code);
+    auto prev = find_before_node(n, key, code);
+    if (prev == nullptr)
+        return 0;
+    // 键值相等的节点在链表上相邻
+    auto first = static_cast<node_ptr>(prev->next);
+    auto last = first->next_node();
+    size_type result = 1;
+    for (; last && node_equal(last, key, code); last = last->next_node())
+        ++result;
+    erase(M_cit(first), M_cit(last));
+    return result;
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::erase_unique(const key_type& key)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::erase_unique(const key_type& key)
 {
-    const auto n = hash(key);
-    auto first = buckets_[n];
-    if (first)
-    {
-        if (is_equal(value_traits::get_key(first->value), key))
-        {
-            buckets_[n] = first->next;
-            destroy_node(first);
-            --size_;
-            return 1;
-        }
-        else
+    rehash_step_if_need();
+    const size_t code = hash_(key);
+    const auto n = bucket_index_code(code);
+    auto prev = find_before_node(n, key, code);
+    if (prev == nullptr)
+        return 0;
+    erase_node(n, prev, static_cast<node_ptr>(prev->next));
+    return 1;
+}
+
+// 摘下迭代器所指的节点
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::node_handle_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::extract(const_iterator position)
+{
+    auto p = position.node;
+    if (p == nullptr)
+        return node_handle_type();
+    const auto n = bucket_index(p);
+    unlink_node(n, get_previous_node(n, p), p);
+    return node_handle_type(p);
+}
+
+// 摘下键值为 key 的第一个节点
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::node_handle_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::extract(const key_type& key)
+{
+    rehash_step_if_need();
+    const size_t code = hash_(key);
+    const auto n = bucket_index_code(code);
+    auto prev = find_before_node(n, key, code);
+    if (prev == nullptr)
+        return node_handle_type();
+    auto np = static_cast<node_ptr>(prev->next);
+    unlink_node(n, prev, np);
+    return node_handle_type(np);
+}
+
+// 插入句柄持有的节点，键值不允许重复
+// 先完成查找与扩容再取出节点，任何一步抛出异常时节点仍归句柄所有
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_return_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_unique(node_handle_type&& nh)
+{
+    if (nh.empty())
+        return insert_return_type{end(), false, node_handle_type()};
+    rehash_step_if_need();
+    const auto& key = value_traits::get_key(nh.value());
+    const size_t code = hash_(key);
+    auto cur = find_node(bucket_index_code(code), key, code);
+    if (cur != nullptr)
+        return insert_return_type{iterator(cur, this), false, orange_stl::move(nh)};
+    rehash_if_need(1);
+    auto np = nh.release();
+    store_hash(np, code);
+    insert_bucket_begin(bucket_index_code(code), np);
+    ++size_;
+    return insert_return_type{iterator(np, this), true, node_handle_type()};
+}
+
+// 插入句柄持有的节点，键值允许重复，句柄为空时返回 end()
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_multi(node_handle_type&& nh)
+{
+    if (nh.empty())
+        return end();
+    rehash_step_if_need();
+    rehash_if_need(1);
+    return insert_node_multi(nh.release());
+}
+
+// 把 source 中的节点转移过来，键值不允许重复
+// 沿 source 的链表逐个处理，prev 始终是 cur 在 source 链表上的前驱，摘下节点时不需要再查找前驱
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::merge_unique(hashtable& source)
+{
+    if (this == &source)
+        return;
+    base_ptr prev = &source.before_begin_;
+    while (prev->next != nullptr)
+    {
+        auto cur = static_cast<node_ptr>(prev->next);
+        const auto& key = value_traits::get_key(cur->value);
+        rehash_step_if_need();
+        const size_t code = hash_(key);
+        if (find_node(bucket_index_code(code), key, code) != nullptr)
         {
-            auto next = first->next;
-            while (next)
-            {
-                if (is_equal(value_traits::get_key(next->value), key))
-                {
-                    first->next = next->next;
-                    destroy_node(next);
-                    --size_;
-                    return 1;
-                }
-                first = next;
-                next = first->next;
-            }
+            prev = cur;
+            continue;
         }
+        rehash_if_need(1);
+        source.unlink_node(source.bucket_index(cur), prev, cur);
+        store_hash(cur, code);
+        insert_bucket_begin(bucket_index_code(code), cur);
+        ++size_;
+    }
+}
+
+// 把 source 中的节点全部转移过来，键值允许重复
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::merge_multi(hashtable& source)
+{
+    if (this == &source)
+        return;
+    while (source.before_begin_.next != nullptr)
+    {
+        auto cur = source.begin_node();
+        rehash_step_if_need();
+        rehash_if_need(1);
+        source.unlink_node(source.bucket_index(cur), &source.before_begin_, cur);
+        insert_node_multi(cur);
     }
-    return 0;
 }
 
 // 清空 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 clear()
 {
     if (size_ != 0)
     {
-        for (size_type i = 0; i < bucket_size_; ++i)
+        node_ptr cur = begin_node();
+        while (cur != nullptr)
         {
-            node_ptr cur = buckets_[i];
-            while (cur != nullptr)
-            {
-                node_ptr next = cur->next;
-                destroy_node(cur);
-                cur = next;
-            }
-            buckets_[i] = nullptr;
+            node_ptr next = cur->next_node();
+            destroy_node(cur);
+            cur = next;
         }
+        for (size_type i = 0; i < bucket_size_; ++i)
+            buckets_[i] = nullptr;
+        before_begin_.next = nullptr;
         size_ = 0;
     }
+    if (is_rehashing())
+    { // 剩下的旧桶都已为空，直接结束迁移
+        bucket_type().swap(old_buckets_);
+        old_bucket_size_ = 0;
+        rehash_index_ = 0;
+    }
 }
 
 // 在某个 bucket 节点的个数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::bucket_size(size_type n) const noexcept
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::bucket_size(size_type n) const noexcept
 {
     size_type result = 0;
-    for (auto cur = buckets_[n]; cur; cur = cur->next)
+    for (auto cur = bucket_begin(n); cur && bucket_index(cur) == n; cur = cur->next_node())
     {
         ++result;
     }
@@ -1072,10 +1566,10 @@ hashtable<T, Hash, KeyEqual>::bucket_size(size_type n) const noexcept
 }
 
 // 重新对元素进行一遍哈希，插入到新的位置
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::rehash(size_type count)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::rehash(size_type count)
 {
-    auto n = ht_next_prime(count);
+    auto n = next_size(count);
     if (n > bucket_size_)
     {
         replace_bucket(n);
@@ -1087,166 +1581,259 @@ void hashtable<T, Hash, KeyEqual>::rehash(size_type count)
         {
             replace_bucket(n);
         }
+        else if (is_rehashing())
+        { // 一次完成剩余的迁移
+            rehash_step(old_bucket_size_);
+        }
     }
 }
 
+// rehash_step 函数
+// 从 rehash_index_ 开始迁移至多 count 个非空旧桶，途经的空桶最多 count * 10 个
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+bool hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::rehash_step(size_type count)
+{
+    if (!is_rehashing())
+        return false;
+    size_type empty_visits = count * 10;
+    while (count > 0 && rehash_index_ < old_bucket_size_)
+    {
+        if (old_buckets_[rehash_index_] == nullptr)
+        {
+            ++rehash_index_;
+            if (--empty_visits == 0)
+                break;
+            continue;
+        }
+        migrate_bucket(rehash_index_);
+        --count;
+    }
+    if (rehash_index_ == old_bucket_size_)
+    { // 迁移完成，释放旧桶数组
+        bucket_type().swap(old_buckets_);
+        old_bucket_size_ = 0;
+        rehash_index_ = 0;
+        return false;
+    }
+    return true;
+}
+
 // 查找键值为 key 的节点，返回其迭代器
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::find(const key_type& key)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::find_key(const K& key)
 {
-    const auto n = hash(key);
-    node_ptr first = buckets_[n];
-    for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-    return iterator(first, this);
+    rehash_step_if_need();
+    const size_t code = hash_(key);
+    return iterator(find_node(bucket_index_code(code), key, code), this);
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::const_iterator
-hashtable<T, Hash, KeyEqual>::find(const key_type& key) const
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::const_iterator
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::find_key(const K& key) const
 {
-    const auto n = hash(key);
-    node_ptr first = buckets_[n];
-    for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-    return M_cit(first);
+    const size_t code = hash_(key);
+    return M_cit(find_node(bucket_index_code(code), key, code));
 }
 
 // 查找键值为 key 出现的次数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::count(const key_type& key) const
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::count_key(const K& key) const
 {
-    const auto n = hash(key);
+    const size_t code = hash_(key);
+    node_ptr cur = find_node(bucket_index_code(code), key, code);
     size_type result = 0;
-    for (node_ptr cur = buckets_[n]; cur; cur = cur->next)
-    {
-        if (is_equal(value_traits::get_key(cur->value), key))
-            ++result;
-    }
+    for (; cur && node_equal(cur, key, code); cur = cur->next_node())
+        ++result;
     return result;
 }
 
 // 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-  typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::equal_range_multi(const key_type& key)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::equal_range_multi_key(const K& key)
 {
-    const auto n = hash(key);
-    for (node_ptr first = buckets_[n]; first; first = first->next)
-    {
-        if (is_equal(value_traits::get_key(first->value), key))
-        { // 如果出现相等的键值
-            for (node_ptr second = first->next; second; second = second->next)
-            {
-                if (!is_equal(value_traits::get_key(second->value), key))
-                    return orange_stl::make_pair(iterator(first, this), iterator(second, this));
-            }
-            for (auto m = n + 1; m < bucket_size_; ++m)
-            { // 整个链表都相等，查找下一个链表出现的位置
-                if (buckets_[m])
-                    return orange_stl::make_pair(iterator(first, this), iterator(buckets_[m], this));
-            }
-            return orange_stl::make_pair(iterator(first, this), end());
-        }
-    }
-    return orange_stl::make_pair(end(), end());
+    const size_t code = hash_(key);
+    node_ptr first = find_node(bucket_index_code(code), key, code);
+    if (first == nullptr)
+        return orange_stl::make_pair(end(), end());
+    // 键值相等的节点在链表上相邻
+    node_ptr second = first->next_node();
+    for (; second && node_equal(second, key, code); second = second->next_node()) {}
+    return orange_stl::make_pair(iterator(first, this), iterator(second, this));
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::const_iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+equal_range_multi_key(const K& key) const
+{
+    const size_t code = hash_(key);
+    node_ptr first = find_node(bucket_index_code(code), key, code);
+    if (first == nullptr)
+        return orange_stl::make_pair(cend(), cend());
+    node_ptr second = first->next_node();
+    for (; second && node_equal(second, key, code); second = second->next_node()) {}
+    return orange_stl::make_pair(M_cit(first), M_cit(second));
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::equal_range_unique_key(const K& key)
+{
+    const size_t code = hash_(key);
+    node_ptr first = find_node(bucket_index_code(code), key, code);
+    if (first == nullptr)
+        return orange_stl::make_pair(end(), end());
+    return orange_stl::make_pair(iterator(first, this), iterator(first->next_node(), this));
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-  typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::
-equal_range_multi(const key_type& key) const
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::const_iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::equal_range_unique_key(const K& key) const
 {
-    const auto n = hash(key);
-    for (node_ptr first = buckets_[n]; first; first = first->next)
+    const size_t code = hash_(key);
+    node_ptr first = find_node(bucket_index_code(code), key, code);
+    if (first == nullptr)
+        return orange_stl::make_pair(cend(), cend());
+    return orange_stl::make_pair(M_cit(first), M_cit(first->next_node()));
+}
+
+// 批量查找
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class ForwardIter, class OutputIter>
+OutputIter hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+{
+    node_ptr result[EHashtableBatchSize];
+    while (first != last)
     {
-        if (is_equal(value_traits::get_key(first->value), key))
-        {
-            for (node_ptr second = first->next; second; second = second->next)
-            {
-                if (!is_equal(value_traits::get_key(second->value), key))
-                return orange_stl::make_pair(M_cit(first), M_cit(second));
-            }
-            for (auto m = n + 1; m < bucket_size_; ++m)
-            { // 整个链表都相等，查找下一个链表出现的位置
-                if (buckets_[m])
-                return orange_stl::make_pair(M_cit(first), M_cit(buckets_[m]));
-            }
-            return orange_stl::make_pair(M_cit(first), cend());
-        }
+        rehash_step_if_need();
+        const size_type n = find_group(first, last, result);
+        for (size_type i = 0; i < n; ++i, ++out)
+            *out = iterator(result[i], this);
     }
-    return orange_stl::make_pair(cend(), cend());
+    return out;
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-  typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::equal_range_unique(const key_type& key)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class ForwardIter, class OutputIter>
+OutputIter hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
 {
-    const auto n = hash(key);
-    for (node_ptr first = buckets_[n]; first; first = first->next)
+    node_ptr result[EHashtableBatchSize];
+    while (first != last)
     {
-        if (is_equal(value_traits::get_key(first->value), key))
-        {
-            if (first->next)
-                return orange_stl::make_pair(iterator(first, this), iterator(first->next, this));
-            for (auto m = n + 1; m < bucket_size_; ++m)
-            { // 整个链表都相等，查找下一个链表出现的位置
-                if (buckets_[m])
-                    return orange_stl::make_pair(iterator(first, this), iterator(buckets_[m], this));
-            }
-            return orange_stl::make_pair(iterator(first, this), end());
-        }
+        const size_type n = find_group(first, last, result);
+        for (size_type i = 0; i < n; ++i, ++out)
+            *out = M_cit(result[i]);
     }
-    return orange_stl::make_pair(end(), end());
+    return out;
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-  typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::equal_range_unique(const key_type& key) const
+// 查找从 first 开始的一组键值，结果写入 result，first 前进到下一组的开头，返回这一组的键值个数
+// 桶保存的是桶内第一个节点的前驱，因此逐级预取：桶、前驱节点、第一个节点；
+// 第一个节点不匹配时还要读它的后继(判断是否仍在本桶内)，再预取后继，最后才沿链表查找这些键值
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class ForwardIter>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+find_group(ForwardIter& first, ForwardIter last, node_ptr* result) const
 {
-    const auto n = hash(key);
-    for (node_ptr first = buckets_[n]; first; first = first->next)
-    {
-        if (is_equal(value_traits::get_key(first->value), key))
+    size_t    code[EHashtableBatchSize];
+    size_type id[EHashtableBatchSize];
+    bool      pending[EHashtableBatchSize];
+    ForwardIter group = first;
+    size_type n = 0;
+    for (; n < EHashtableBatchSize && first != last; ++n, ++first)
+    {
+        code[n] = hash_(*first);
+        id[n] = bucket_index_code(code[n]);
+        ht_prefetch(bucket_addr(id[n]));
+    }
+    for (size_type i = 0; i < n; ++i)
+    {
+        const base_ptr prev = bucket_ref(id[i]);
+        if (prev != nullptr)
+            ht_prefetch(prev);
+    }
+    for (size_type i = 0; i < n; ++i)
+    {
+        const base_ptr prev = bucket_ref(id[i]);
+        if (prev != nullptr)
+            ht_prefetch(prev->next);
+    }
+    ForwardIter it = group;
+    for (size_type i = 0; i < n; ++i, ++it)
+    {
+        const base_ptr prev = bucket_ref(id[i]);
+        pending[i] = false;
+        result[i] = nullptr;
+        if (prev == nullptr)
+            continue;
+        const node_ptr np = static_cast<node_ptr>(prev->next);
+        if (node_equal(np, *it, code[i]))
         {
-            if (first->next)
-                return orange_stl::make_pair(M_cit(first), M_cit(first->next));
-            for (auto m = n + 1; m < bucket_size_; ++m)
-            { // 整个链表都相等，查找下一个链表出现的位置
-                if (buckets_[m])
-                    return orange_stl::make_pair(M_cit(first), M_cit(buckets_[m]));
-            }
-            return orange_stl::make_pair(M_cit(first), cend());
+            result[i] = np;
+        }
+        else if (np->next != nullptr)
+        {
+            ht_prefetch(np->next);
+            pending[i] = true;
         }
     }
-    return orange_stl::make_pair(cend(), cend());
+    for (size_type i = 0; i < n; ++i, ++group)
+    {
+        if (pending[i])
+            result[i] = find_node(id[i], *group, code[i]);
+    }
+    return n;
 }
 
 // 交换 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 swap(hashtable& rhs) noexcept
 {
     if (this != &rhs)
     {
         buckets_.swap(rhs.buckets_);
+        orange_stl::swap(before_begin_.next, rhs.before_begin_.next);
         orange_stl::swap(bucket_size_, rhs.bucket_size_);
-        myorange_stlstl::swap(size_, rhs.size_);
+        orange_stl::swap(size_, rhs.size_);
         orange_stl::swap(mlf_, rhs.mlf_);
         orange_stl::swap(hash_, rhs.hash_);
         orange_stl::swap(equal_, rhs.equal_);
+        old_buckets_.swap(rhs.old_buckets_);
+        orange_stl::swap(old_bucket_size_, rhs.old_bucket_size_);
+        orange_stl::swap(rehash_index_, rhs.rehash_index_);
+        orange_stl::swap(incremental_, rhs.incremental_);
+        // 第一个节点所在的桶要改为指向各自的哨兵
+        if (before_begin_.next != nullptr)
+            bucket_ref(bucket_index(begin_node())) = &before_begin_;
+        if (rhs.before_begin_.next != nullptr)
+            rhs.bucket_ref(rhs.bucket_index(rhs.begin_node())) = &rhs.before_begin_;
     }
 }
 
 // init 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::init(size_type n)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::init(size_type n)
 {
     const auto bucket_nums = next_size(n);
+    before_begin_.next = nullptr;
     try
     {
         buckets_.reserve(bucket_nums);
@@ -1262,49 +1849,59 @@ void hashtable<T, Hash, KeyEqual>::init(size_type n)
 }
 
 // copy_init 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::copy_init(const hashtable& ht)
+// 按原表的链表顺序复制节点并追加到链表尾部，桶数与哈希函数相同，因此每个桶的节点仍然相邻
+// 原表处于迁移中时，新表只使用新的桶数组，同一个新桶的节点可能不相邻，此时插入为桶的第一个节点
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::copy_init(const hashtable& ht)
 {
     bucket_size_ = 0;
+    size_ = 0;
+    before_begin_.next = nullptr;
     buckets_.reserve(ht.bucket_size_);
     buckets_.assign(ht.bucket_size_, nullptr);
+    bucket_size_ = ht.bucket_size_;
+    mlf_ = ht.mlf_;
     try
     {
-        for (size_type i = 0; i < ht.bucket_size_; ++i)
+        base_ptr prev = &before_begin_;
+        size_type prev_n = bucket_size_;
+        for (node_ptr cur = ht.begin_node(); cur; cur = cur->next_node())
         {
-            node_ptr cur = ht.buckets_[i];
-            if (cur)
-            { // 如果某 bucket 存在链表
-                auto copy = create_node(cur->value);
-                buckets_[i] = copy;
-                for (auto next = cur->next; next; cur = next, next = cur->next)
-                {  //复制链表
-                    copy->next = create_node(next->value);
-                    copy = copy->next;
-                }
-                copy->next = nullptr;
+            auto copy = create_node(cur->value);
+            store_hash(copy, ht.node_hash(cur));
+            const auto n = bucket_index(copy);
+            if (buckets_[n] == nullptr || n == prev_n)
+            {
+                prev->next = copy;
+                if (buckets_[n] == nullptr)
+                    buckets_[n] = prev;
+                prev = copy;
+                prev_n = n;
+            }
+            else
+            {
+                insert_bucket_begin(n, copy);
             }
+            ++size_;
         }
-        bucket_size_ = ht.bucket_size_;
-        mlf_ = ht.mlf_;
-        size_ = ht.size_;
     }
     catch (...)
     {
         clear();
+        throw;
     }
 }
 
 // create_node 函数
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
 template <class ...Args>
-typename hashtable<T, Hash, KeyEqual>::node_ptr
-hashtable<T, Hash, KeyEqual>::create_node(Args&& ...args)
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::node_ptr
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::create_node(Args&& ...args)
 {
     node_ptr tmp = node_allocator::allocate(1);
     try
     {
-        data_allocator::construct(orange_stl::address_of(tmp->value), 
+        data_allocator::construct(orange_stl::address_of(tmp->value),
             orange_stl::forward<Args>(args)...);
         tmp->next = nullptr;
     }
@@ -1317,8 +1914,8 @@ hashtable<T, Hash, KeyEqual>::create_node(Args&& ...args)
 }
 
 // destroy_node 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::destroy_node(node_ptr node)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::destroy_node(node_ptr node)
 {
     data_allocator::destroy(orange_stl::address_of(node->value));
     node_allocator::deallocate(node);
@@ -1326,40 +1923,45 @@ void hashtable<T, Hash, KeyEqual>::destroy_node(node_ptr node)
 }
 
 // next_size 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::next_size(size_type n) const
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::next_size(size_type n) const
 {
-    return ht_next_prime(n);
+    return BucketPolicy::next_size(n);
 }
 
 // hash 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::hash(const key_type& key, size_type n) const
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::hash(const key_type& key, size_type n) const
 {
-    return hash_(key) % n;
+    return BucketPolicy::index(hash_(key), n);
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::hash(const key_type& key) const
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::hash(const key_type& key) const
 {
-    return hash_(key) % bucket_size_;
+    return BucketPolicy::index(hash_(key), bucket_size_);
 }
 
 // rehash_if_need 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::rehash_if_need(size_type n)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::rehash_if_need(size_type n)
 {
     if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
-        rehash(size_ + n);
+    {
+        if (incremental_)
+            start_rehash(next_size(size_ + n));
+        else
+            rehash(size_ + n);
+    }
 }
 
 // copy_insert
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 copy_insert_multi(InputIter first, InputIter last, orange_stl::input_iterator_tag)
 {
     rehash_if_need(orange_stl::distance(first, last));
@@ -1367,9 +1969,9 @@ copy_insert_multi(InputIter first, InputIter last, orange_stl::input_iterator_ta
         insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 copy_insert_multi(ForwardIter first, ForwardIter last, orange_stl::forward_iterator_tag)
 {
     size_type n = orange_stl::distance(first, last);
@@ -1378,9 +1980,9 @@ copy_insert_multi(ForwardIter first, ForwardIter last, orange_stl::forward_itera
         insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 copy_insert_unique(InputIter first, InputIter last, orange_stl::input_iterator_tag)
 {
     rehash_if_need(orange_stl::distance(first, last));
@@ -1388,9 +1990,9 @@ copy_insert_unique(InputIter first, InputIter last, orange_stl::input_iterator_t
         insert_unique_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 copy_insert_unique(ForwardIter first, ForwardIter last, orange_stl::forward_iterator_tag)
 {
     size_type n = orange_stl::distance(first, last);
@@ -1400,146 +2002,266 @@ copy_insert_unique(ForwardIter first, ForwardIter last, orange_stl::forward_iter
 }
 
 // insert_node 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::insert_node_multi(node_ptr np)
+// 存在键值相等的节点时插入到它们之前，保持相等的节点相邻，否则作为桶的第一个节点
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::insert_node_multi(node_ptr np)
 {
-    const auto n = hash(value_traits::get_key(np->value));
-    auto cur = buckets_[n];
-    if (cur == nullptr)
+    const size_t code = hash_(value_traits::get_key(np->value));
+    store_hash(np, code);
+    const auto n = bucket_index_code(code);
+    auto prev = find_before_node(n, value_traits::get_key(np->value), code);
+    if (prev != nullptr)
     {
-        buckets_[n] = np;
-        ++size_;
-        return iterator(np, this);
+        np->next = prev->next;
+        prev->next = np;
     }
-    for (; cur; cur = cur->next)
+    else
     {
-        if (is_equal(value_traits::get_key(cur->value), 
-            value_traits::get_key(np->value)))
-        {
-            np->next = cur->next;
-            cur->next = np;
-            ++size_;
-            return iterator(np, this);
-        }
+        insert_bucket_begin(n, np);
     }
-
-    // 作为队列首部
-    np->next = buckets_[n];
-    buckets_[n] = np;
     ++size_;
     return iterator(np, this);
 }
 
 // insert_node_unique 函数
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::
+// 键值已存在时销毁 np
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
 insert_node_unique(node_ptr np)
 {
-    const auto n = hash(value_traits::get_key(np->value));
-    auto cur = buckets_[n];
-    if (cur == nullptr)
-    {
-        buckets_[n] = np;
-        ++size_;
-        return orange_stl::make_pair(iterator(np, this), true);
-    }
-    for (; cur; cur = cur->next)
+    const size_t code = hash_(value_traits::get_key(np->value));
+    store_hash(np, code);
+    const auto n = bucket_index_code(code);
+    auto cur = find_node(n, value_traits::get_key(np->value), code);
+    if (cur != nullptr)
     {
-        if (is_equal(value_traits::get_key(cur->value), 
-            value_traits::get_key(np->value)))
-        {
-            return orange_stl::make_pair(iterator(cur, this), false);
-        }
+        destroy_node(np);
+        return orange_stl::make_pair(iterator(cur, this), false);
     }
-    np->next = buckets_[n];
-    buckets_[n] = np;
+    insert_bucket_begin(n, np);
     ++size_;
     return orange_stl::make_pair(iterator(np, this), true);
 }
 
+// find_before_node 函数
+// 在第 n 个桶内查找键值为 key 的第一个节点，返回它的前一个节点，找不到时返回 nullptr
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::base_ptr
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+find_before_node(size_type n, const K& key, size_t code) const
+{
+    base_ptr prev = bucket_ref(n);
+    if (prev == nullptr)
+        return nullptr;
+    for (auto cur = static_cast<node_ptr>(prev->next);; cur = cur->next_node())
+    {
+        if (node_equal(cur, key, code))
+            return prev;
+        // 走到链表末尾或者下一个桶
+        if (cur->next == nullptr || bucket_index(cur->next_node()) != n)
+            break;
+        prev = cur;
+    }
+    return nullptr;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::node_ptr
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+find_node(size_type n, const K& key, size_t code) const
+{
+    auto prev = find_before_node(n, key, code);
+    return prev ? static_cast<node_ptr>(prev->next) : nullptr;
+}
+
+// 第 n 个桶的第一个节点
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::node_ptr
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::bucket_begin(size_type n) const
+{
+    return buckets_[n] ? static_cast<node_ptr>(buckets_[n]->next) : nullptr;
+}
+
 // replace_bucket 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::replace_bucket(size_type bucket_count)
+// 沿链表把节点逐个重新挂到新桶上，不复制节点
+// 新出现的桶插在链表头部，原链表中相邻的节点(包括键值相等的节点)依然相邻
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::replace_bucket(size_type bucket_count)
 {
     bucket_type bucket(bucket_count);
-    if (size_ != 0)
-    {
-        for (size_type i = 0; i < bucket_size_; ++i)
+    node_ptr cur = begin_node();
+    before_begin_.next = nullptr;
+    size_type begin_n = 0;  // 当前链表第一个节点所在的桶
+    while (cur != nullptr)
+    {
+        node_ptr next = cur->next_node();
+        const auto n = bucket_index(cur, bucket_count);
+        if (bucket[n] == nullptr)
         {
-            for (auto first = buckets_[i]; first; first = first->next)
-            {
-                auto tmp = create_node(first->value);
-                const auto n = hash(value_traits::get_key(first->value), bucket_count);
-                auto f = bucket[n];
-                bool is_inserted = false;
-                for (auto cur = f; cur; cur = cur->next)
-                {
-                    if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(first->value)))
-                    {
-                        tmp->next = cur->next;
-                        cur->next = tmp;
-                        is_inserted = true;
-                        break;
-                    }
-                }
-                if (!is_inserted)
-                {
-                    tmp->next = f;
-                    bucket[n] = tmp;
-                }
-            }
+            cur->next = before_begin_.next;
+            before_begin_.next = cur;
+            bucket[n] = &before_begin_;
+            if (cur->next != nullptr)
+                bucket[begin_n] = cur;
+            begin_n = n;
+        }
+        else
+        {
+            cur->next = bucket[n]->next;
+            bucket[n]->next = cur;
         }
+        cur = next;
     }
     buckets_.swap(bucket);
     bucket_size_ = buckets_.size();
+    if (is_rehashing())
+    { // 所有节点都已挂到新桶上
+        bucket_type().swap(old_buckets_);
+        old_bucket_size_ = 0;
+        rehash_index_ = 0;
+    }
 }
 
-// erase_bucket 函数
-// 在第 n 个 bucket 内，删除 [first, last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
-erase_bucket(size_type n, node_ptr first, node_ptr last)
+// start_rehash 函数
+// 开始一次渐进式 rehash：当前的桶数组成为旧桶，节点暂不移动
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::start_rehash(size_type bucket_count)
 {
-    auto cur = buckets_[n];
-    if (cur == first)
+    if (is_rehashing())  // 上一次迁移尚未完成
+        rehash_step(old_bucket_size_);
+    if (bucket_count <= bucket_size_)
+        return;
+    bucket_type bucket(bucket_count);
+    old_buckets_.swap(buckets_);
+    buckets_.swap(bucket);
+    old_bucket_size_ = bucket_size_;
+    bucket_size_ = bucket_count;
+    rehash_index_ = 0;
+}
+
+// migrate_bucket 函数
+// 把旧桶 k 的节点从链表中摘下，逐个插入新桶
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::migrate_bucket(size_type k)
+{
+    const size_type id = bucket_size_ + k;
+    base_ptr prev = old_buckets_[k];
+    node_ptr first = static_cast<node_ptr>(prev->next);
+    node_ptr last = first;
+    while (last->next != nullptr && bucket_index(last->next_node()) == id)
+        last = last->next_node();
+    node_ptr next = last->next_node();
+    prev->next = next;
+    if (next != nullptr)
+        bucket_ref(bucket_index(next)) = prev;
+    last->next = nullptr;
+    old_buckets_[k] = nullptr;
+    // 先推进 rehash_index_，这些键值此后都落在新桶上
+    rehash_index_ = k + 1;
+    while (first != nullptr)
+    {
+        next = first->next_node();
+        insert_bucket_begin(bucket_index(first), first);
+        first = next;
+    }
+}
+
+// insert_bucket_begin 函数
+// 把 np 插入为第 n 个桶的第一个节点，空桶的节点插在整条链表的头部
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+insert_bucket_begin(size_type n, node_ptr np)
+{
+    base_ptr& bucket = bucket_ref(n);
+    if (bucket != nullptr)
     {
-        erase_bucket(n, last);
+        np->next = bucket->next;
+        bucket->next = np;
     }
     else
     {
-        node_ptr next = cur->next;
-        for (; next != first; cur = next, next = cur->next) {}
-        while (next != last)
-        {
-            cur->next = next->next;
-            destroy_node(next);
-            next = cur->next;
-            --size_;
-        }
+        np->next = before_begin_.next;
+        before_begin_.next = np;
+        // 原先的第一个节点所在的桶，前驱变为 np
+        if (np->next != nullptr)
+            bucket_ref(bucket_index(np->next_node())) = np;
+        bucket = &before_begin_;
     }
 }
 
-// erase_bucket 函数
-// 在第 n 个 bucket 内，删除 [buckets_[n], last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::erase_bucket(size_type n, node_ptr last)
+// remove_bucket_begin 函数
+// 删除第 n 个桶的第一个节点前调用，next 为被删节点的后继，next_n 为后继所在的桶
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+remove_bucket_begin(size_type n, node_ptr next, size_type next_n)
 {
-    auto cur = buckets_[n];
-    while (cur != last)
+    if (next == nullptr || next_n != n)
+    { // 第 n 个桶将变为空桶
+        base_ptr& bucket = bucket_ref(n);
+        if (next != nullptr)
+            bucket_ref(next_n) = bucket;
+        if (bucket == &before_begin_)
+            before_begin_.next = next;
+        bucket = nullptr;
+    }
+}
+
+// get_previous_node 函数
+// 第 n 个桶中 np 的前一个节点
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::base_ptr
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+get_previous_node(size_type n, node_ptr np) const
+{
+    base_ptr prev = bucket_ref(n);
+    while (prev->next != np)
+        prev = prev->next;
+    return prev;
+}
+
+// unlink_node 函数
+// 把第 n 个桶中 prev 之后的节点 np 从链表上摘下但不销毁，返回 np 的后继
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::node_ptr
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+unlink_node(size_type n, base_ptr prev, node_ptr np)
+{
+    auto next = np->next_node();
+    if (prev == bucket_ref(n))
     {
-        auto next = cur->next;
-        destroy_node(cur);
-        cur = next;
-        --size_;
+        remove_bucket_begin(n, next, next ? bucket_index(next) : 0);
     }
-    buckets_[n] = last;
+    else if (next != nullptr)
+    { // np 是本桶最后一个节点时，下一个桶的前驱变为 prev
+        const auto next_n = bucket_index(next);
+        if (next_n != n)
+            bucket_ref(next_n) = prev;
+    }
+    prev->next = next;
+    np->next = nullptr;
+    --size_;
+    return next;
+}
+
+// erase_node 函数
+// 删除第 n 个桶中 prev 之后的节点 np，返回 np 的后继
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+typename hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::node_ptr
+hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::
+erase_node(size_type n, base_ptr prev, node_ptr np)
+{
+    auto next = unlink_node(n, prev, np);
+    destroy_node(np);
+    return next;
 }
 
 // equal_to 函数
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+bool hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::equal_to_multi(const hashtable& other) const
 {
     if (size_ != other.size_)
         return false;
@@ -1547,16 +2269,16 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
     {
         auto p1 = equal_range_multi(value_traits::get_key(*f));
         auto p2 = other.equal_range_multi(value_traits::get_key(*f));
-        if (orange_stl::distance(p1.first, p1.last) != orange_stl::distance(p2.first, p2.last) ||
-            !orange_stl::is_permutation(p1.first, p2.last, p2.first, p2.last))
+        if (orange_stl::distance(p1.first, p1.second) != orange_stl::distance(p2.first, p2.second) ||
+            !orange_stl::is_permutation(p1.first, p1.second, p2.first, p2.second))
             return false;
-        f = p1.last;
+        f = p1.second;
     }
     return true;
 }
 
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+bool hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>::equal_to_unique(const hashtable& other) const
 {
     if (size_ != other.size_)
         return false;
@@ -1570,9 +2292,9 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
 }
 
 // 重载 orange_stl 的 swap
-template <class T, class Hash, class KeyEqual>
-void swap(hashtable<T, Hash, KeyEqual>& lhs,
-          hashtable<T, Hash, KeyEqual>& rhs) noexcept
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void swap(hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>& lhs,
+          hashtable<T, Hash, KeyEqual, Alloc, BucketPolicy>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
@@ -1581,4 +2303,4 @@ void swap(hashtable<T, Hash, KeyEqual>& lhs,
 
 }/* end of orange_stl */
 
-#endif
\ No newline at end of file
+#endif
@@ -195,16 +195,16 @@ namespace orange_stl
     };
 
     // 模板类: list
-    // 模板参数 T 代表数据类型
-    template <class T>
+    // 模板参数 T 代表数据类型，Alloc 代表空间配置器类型，缺省使用 orange_stl::allocator
+    template <class T, class Alloc = orange_stl::allocator<T>>
     class list
     {
     public:
         // list 的嵌套型别定义
-        typedef orange_stl::allocator<T> allocator_type;
-        typedef orange_stl::allocator<T> data_allocator;
-        typedef orange_stl::allocator<list_node_base<T>> base_allocator;
-        typedef orange_stl::allocator<list_node<T>> node_allocator;
+        typedef Alloc allocator_type;
+        typedef typename Alloc::template rebind<T>::other data_allocator;
+        typedef typename Alloc::template rebind<list_node_base<T>>::other base_allocator;
+        typedef typename Alloc::template rebind<list_node<T>>::other node_allocator;
 
         typedef typename allocator_type::value_type value_type;
         typedef typename allocator_type::pointer pointer;
@@ -222,7 +222,7 @@ namespace orange_stl
         typedef typename node_traits<T>::base_ptr base_ptr;
         typedef typename node_traits<T>::node_ptr node_ptr;
 
-        allocator_type get_allocator() { return node_allocator(); }
+        allocator_type get_allocator() { return allocator_type(); }
 
     private:
         base_ptr node_;  // 指向末尾节点
@@ -622,9 +622,9 @@ namespace orange_stl
     };
 
     // 删除 pos 处的元素
-    template <class T>
-    typename list<T>::iterator
-    list<T>::erase(const_iterator pos)
+    template <class T, class Alloc>
+    typename list<T, Alloc>::iterator
+    list<T, Alloc>::erase(const_iterator pos)
     {
         ORANGE_STL_DEBUG(pos != cend());
         auto n = pos.node_;
@@ -636,9 +636,9 @@ namespace orange_stl
     }
 
     // 删除 [first, last) 内的元素
-    template <class T>
-    typename list<T>::iterator
-    list<T>::erase(const_iterator first, const_iterator last)
+    template <class T, class Alloc>
+    typename list<T, Alloc>::iterator
+    list<T, Alloc>::erase(const_iterator first, const_iterator last)
     {
         if (first != last)
         {
@@ -655,8 +655,8 @@ namespace orange_stl
     }
 
     // 清空 list
-    template <class T>
-    void list<T>::clear()
+    template <class T, class Alloc>
+    void list<T, Alloc>::clear()
     {
         if (size_ != 0)
         {
@@ -671,8 +671,8 @@ namespace orange_stl
     }
 
     // 重置容器大小
-    template <class T>
-    void list<T>::resize(size_type new_size, const value_type &value)
+    template <class T, class Alloc>
+    void list<T, Alloc>::resize(size_type new_size, const value_type &value)
     {
         auto i = begin();
         size_type len = 0;
@@ -692,8 +692,8 @@ namespace orange_stl
     }
 
     // 将 list x 接合于 pos 之前
-    template <class T>
-    void list<T>::splice(const_iterator pos, list &x)
+    template <class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list &x)
     {
         ORANGE_STL_DEBUG(this != &x);
         if (!x.empty())
@@ -712,8 +712,8 @@ namespace orange_stl
     }
 
     // 将 it 所指的节点接合于 pos 之前
-    template <class T>
-    void list<T>::splice(const_iterator pos, list &x, const_iterator it)
+    template <class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list &x, const_iterator it)
     {
         if (pos.node_ != it.node_ && pos.node_ != it.node_->next)
         {
@@ -730,8 +730,8 @@ namespace orange_stl
     }
 
     // 将 list x 的 [first, last) 内的节点接合于 pos 之前
-    template <class T>
-    void list<T>::splice(const_iterator pos, list &x, const_iterator first, const_iterator last)
+    template <class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list &x, const_iterator first, const_iterator last)
     {
         if (first != last && this != &x)
         {
@@ -749,9 +749,9 @@ namespace orange_stl
     }
 
     // 将另一元操作 pred 为 true 的所有元素移除
-    template <class T>
+    template <class T, class Alloc>
     template <class UnaryPredicate>
-    void list<T>::remove_if(UnaryPredicate pred)
+    void list<T, Alloc>::remove_if(UnaryPredicate pred)
     {
         auto f = begin();
         auto l = end();
@@ -766,9 +766,9 @@ namespace orange_stl
     }
 
     // 移除 list 中满足 pred 为 true 重复元素
-    template <class T>
+    template <class T, class Alloc>
     template <class BinaryPredicate>
-    void list<T>::unique(BinaryPredicate pred)
+    void list<T, Alloc>::unique(BinaryPredicate pred)
     {
         auto i = begin();
         auto e = end();
@@ -790,9 +790,9 @@ namespace orange_stl
     }
 
     // 与另一个 list 合并，按照 comp 为 true 的顺序
-    template <class T>
+    template <class T, class Alloc>
     template <class Compare>
-    void list<T>::merge(list &x, Compare comp)
+    void list<T, Alloc>::merge(list &x, Compare comp)
     {
         if (this != &x)
         {
@@ -841,8 +841,8 @@ namespace orange_stl
     }
 
     // 将 list 反转
-    template <class T>
-    void list<T>::reverse()
+    template <class T, class Alloc>
+    void list<T, Alloc>::reverse()
     {
         if (size_ <= 1)
         {
@@ -862,10 +862,10 @@ namespace orange_stl
     // helper function
 
     // 创建结点
-    template <class T>
+    template <class T, class Alloc>
     template <class... Args>
-    typename list<T>::node_ptr
-    list<T>::create_node(Args &&... args)
+    typename list<T, Alloc>::node_ptr
+    list<T, Alloc>::create_node(Args &&... args)
     {
         node_ptr p = node_allocator::allocate(1);
         try
@@ -883,16 +883,16 @@ namespace orange_stl
     }
 
     // 销毁结点
-    template <class T>
-    void list<T>::destroy_node(node_ptr p)
+    template <class T, class Alloc>
+    void list<T, Alloc>::destroy_node(node_ptr p)
     {
         data_allocator::destroy(orange_stl::address_of(p->value));
         node_allocator::deallocate(p);
     }
 
     // 用 n 个元素初始化容器
-    template <class T>
-    void list<T>::fill_init(size_type n, const value_type &value)
+    template <class T, class Alloc>
+    void list<T, Alloc>::fill_init(size_type n, const value_type &value)
     {
         node_ = base_allocator::allocate(1);
         node_->unlink();
@@ -915,9 +915,9 @@ namespace orange_stl
     }
 
     // 以 [first, last) 初始化容器
-    template <class T>
+    template <class T, class Alloc>
     template <class Iter>
-    void list<T>::copy_init(Iter first, Iter last)
+    void list<T, Alloc>::copy_init(Iter first, Iter last)
     {
         node_ = base_allocator::allocate(1);
         node_->unlink();
@@ -941,9 +941,9 @@ namespace orange_stl
     }
 
     // 在 pos 处连接一个节点
-    template <class T>
-    typename list<T>::iterator
-    list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
+    template <class T, class Alloc>
+    typename list<T, Alloc>::iterator
+    list<T, Alloc>::link_iter_node(const_iterator pos, base_ptr link_node)
     {
         if (pos == node_->next)
         {
@@ -961,8 +961,8 @@ namespace orange_stl
     }
 
     // 在 pos 处连接 [first, last] 的结点
-    template <class T>
-    void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
+    template <class T, class Alloc>
+    void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
     {
         pos->prev->next = first;
         first->prev = pos->prev;
@@ -971,8 +971,8 @@ namespace orange_stl
     }
 
     // 在头部连接 [first, last] 结点
-    template <class T>
-    void list<T>::link_nodes_at_front(base_ptr first, base_ptr last)
+    template <class T, class Alloc>
+    void list<T, Alloc>::link_nodes_at_front(base_ptr first, base_ptr last)
     {
         first->prev = node_;
         last->next = node_->next;
@@ -981,8 +981,8 @@ namespace orange_stl
     }
 
     // 在尾部连接 [first, last] 结点
-    template <class T>
-    void list<T>::link_nodes_at_back(base_ptr first, base_ptr last)
+    template <class T, class Alloc>
+    void list<T, Alloc>::link_nodes_at_back(base_ptr first, base_ptr last)
     {
         last->next = node_;
         first->prev = node_->prev;
@@ -991,16 +991,16 @@ namespace orange_stl
     }
 
     // 容器与 [first, last] 结点断开连接
-    template <class T>
-    void list<T>::unlink_nodes(base_ptr first, base_ptr last)
+    template <class T, class Alloc>
+    void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last)
     {
         first->prev->next = last->next;
         last->next->prev = first->prev;
     }
 
     // 用 n 个元素为容器赋值
-    template <class T>
-    void list<T>::fill_assign(size_type n, const value_type &value)
+    template <class T, class Alloc>
+    void list<T, Alloc>::fill_assign(size_type n, const value_type &value)
     {
         auto i = begin();
         auto e = end();
@@ -1019,9 +1019,9 @@ namespace orange_stl
     }
 
     // 复制[f2, l2)为容器赋值
-    template <class T>
+    template <class T, class Alloc>
     template <class Iter>
-    void list<T>::copy_assign(Iter f2, Iter l2)
+    void list<T, Alloc>::copy_assign(Iter f2, Iter l2)
     {
         auto f1 = begin();
         auto l1 = end();
@@ -1040,9 +1040,9 @@ namespace orange_stl
     }
 
     // 在 pos 处插入 n 个元素
-    template <class T>
-    typename list<T>::iterator
-    list<T>::fill_insert(const_iterator pos, size_type n, const value_type &value)
+    template <class T, class Alloc>
+    typename list<T, Alloc>::iterator
+    list<T, Alloc>::fill_insert(const_iterator pos, size_type n, const value_type &value)
     {
         iterator r(pos.node_);
         if (n != 0)
@@ -1082,10 +1082,10 @@ namespace orange_stl
     }
 
     // 在 pos 处插入 [first, last) 的元素
-    template <class T>
+    template <class T, class Alloc>
     template <class Iter>
-    typename list<T>::iterator
-    list<T>::copy_insert(const_iterator pos, size_type n, Iter first)
+    typename list<T, Alloc>::iterator
+    list<T, Alloc>::copy_insert(const_iterator pos, size_type n, Iter first)
     {
         iterator r(pos.node_);
         if (n != 0)
@@ -1124,10 +1124,10 @@ namespace orange_stl
     }
 
     // 对 list 进行归并排序，返回一个迭代器指向区间最小元素的位置
-    template <class T>
+    template <class T, class Alloc>
     template <class Compared>
-    typename list<T>::iterator
-    list<T>::list_sort(iterator f1, iterator l2, size_type n, Compared comp)
+    typename list<T, Alloc>::iterator
+    list<T, Alloc>::list_sort(iterator f1, iterator l2, size_type n, Compared comp)
     {
         if (n < 2)
             return f1;
@@ -1201,8 +1201,8 @@ namespace orange_stl
     }
 
     // 重载比较操作符
-    template <class T>
-    bool operator==(const list<T> &lhs, const list<T> &rhs)
+    template <class T, class Alloc>
+    bool operator==(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs)
     {
         auto f1 = lhs.cbegin();
         auto f2 = rhs.cbegin();
@@ -1213,39 +1213,39 @@ namespace orange_stl
         return f1 == l1 && f2 == l2;
     }
 
-    template <class T>
-    bool operator<(const list<T> &lhs, const list<T> &rhs)
+    template <class T, class Alloc>
+    bool operator<(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs)
     {
         return orange_stl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
     }
 
-    template <class T>
-    bool operator!=(const list<T> &lhs, const list<T> &rhs)
+    template <class T, class Alloc>
+    bool operator!=(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class T>
-    bool operator>(const list<T> &lhs, const list<T> &rhs)
+    template <class T, class Alloc>
+    bool operator>(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs)
     {
         return rhs < lhs;
     }
 
-    template <class T>
-    bool operator<=(const list<T> &lhs, const list<T> &rhs)
+    template <class T, class Alloc>
+    bool operator<=(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class T>
-    bool operator>=(const list<T> &lhs, const list<T> &rhs)
+    template <class T, class Alloc>
+    bool operator>=(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs)
     {
         return !(lhs < rhs);
     }
 
     // 重载 orange_stl 的 swap
-    template <class T>
-    void swap(list<T> &lhs, list<T> &rhs) noexcept
+    template <class T, class Alloc>
+    void swap(list<T, Alloc> &lhs, list<T, Alloc> &rhs) noexcept
     {
         lhs.swap(rhs);
     }
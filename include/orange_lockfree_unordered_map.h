@@ -0,0 +1,613 @@
+#ifndef __ORANGE_LOCKFREE_UNORDERED_MAP_H__
+#define __ORANGE_LOCKFREE_UNORDERED_MAP_H__
+
+// 这个头文件包含无锁哈希表 lockfree_unordered_map，采用分裂有序链表(split-ordered list)：
+// 1. 所有元素串在一条按“哈希值的位反转”排序的无锁链表上(Harris-Michael 链表，next 的最低位为删除标记)
+// 2. 桶只是指向链表中哨兵节点的捷径，桶数翻倍时不移动任何元素，新桶在第一次使用时才插入哨兵
+// 3. 摘下的节点与被替换的值交给 epoch_domain 延迟回收
+// 查找不加锁、不写共享内存，只沿链表读取，适合读远多于写的场景
+// 元素的值存放在单独的值块中，insert_or_assign 以原子交换值块的方式更新，值块被换下或者元素被删除时才回收
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#include "orange_epoch.h"
+#include "orange_hashtable.h"
+
+namespace orange_stl
+{
+
+// 平均每个桶的元素个数超过 ELockFreeMapLoadFactor 时桶数翻倍
+// 桶数组按段配置，第 s 段(s >= 1)含 2^s 个桶，第 0 段含 2 个桶
+enum { ELockFreeMapLoadFactor = 2, ELockFreeMapSegments = 64 };
+
+// 64 位整数的位反转
+inline uint64_t lf_reverse_bits(uint64_t x) noexcept
+{
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((x & 0x0f0f0f0f0f0f0f0fULL) << 4);
+    x = ((x >> 8) & 0x00ff00ff00ff00ffULL) | ((x & 0x00ff00ff00ff00ffULL) << 8);
+    x = ((x >> 16) & 0x0000ffff0000ffffULL) | ((x & 0x0000ffff0000ffffULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+// 最高的非零位的位置，x 不为 0
+inline size_t lf_floor_log2(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(63 - __builtin_clzll(x));
+#else
+    size_t r = 0;
+    while (x >>= 1)
+        ++r;
+    return r;
+#endif
+}
+
+// 模板类 lockfree_unordered_map，键值不允许重复
+// 参数一表示键值类型，参数二表示实值类型，参数三表示哈希函数，参数四表示键值的比较方式，参数五表示空间配置器类型
+// 除析构函数外的所有操作都可以被多个线程同时调用；查找与插入、删除、赋值之间是线性一致的
+// 接口不返回迭代器或引用：查找把结果复制出来，或者在临界区内调用回调
+template <class Key, class T, class Hash = orange_stl::hash<Key>, class KeyEqual = orange_stl::equal_to<Key>,
+          class Alloc = orange_stl::allocator<orange_stl::pair<const Key, T>>>
+class lockfree_unordered_map
+{
+public:
+    typedef Key                                 key_type;
+    typedef T                                   mapped_type;
+    typedef orange_stl::pair<const Key, T>      value_type;
+    typedef Hash                                hasher;
+    typedef KeyEqual                            key_equal;
+    typedef Alloc                               allocator_type;
+    typedef size_t                              size_type;
+
+private:
+    // 值块，被替换或者所属的元素被删除之后延迟回收
+    struct value_block : public epoch_node
+    {
+        value_type value;
+
+        template <class ...Args>
+        explicit value_block(Args&& ...args) : value(orange_stl::forward<Args>(args)...) {}
+    };
+
+    // 链表节点，哨兵节点的 so_key 为偶数且 value 为空
+    // 普通节点的 value 被置空表示已被删除(线性化点)，随后再标记 next 并从链表上摘下
+    struct so_node : public epoch_node
+    {
+        std::atomic<uintptr_t>    next;     // 后继节点，最低位为删除标记
+        uint64_t                  so_key;   // 位反转后的哈希值
+        std::atomic<value_block*> value;
+
+        so_node(uint64_t key, value_block* vb) : next(0), so_key(key), value(vb) {}
+    };
+
+    typedef std::atomic<so_node*>                                     bucket_slot;
+    typedef typename Alloc::template rebind<value_block>::other       value_allocator;
+    typedef typename Alloc::template rebind<so_node>::other           node_allocator;
+    typedef typename Alloc::template rebind<bucket_slot>::other       slot_allocator;
+
+    std::atomic<bucket_slot*> segments_[ELockFreeMapSegments];
+    std::atomic<size_type>    bucket_count_;    // 2 的幂
+    std::atomic<size_type>    size_;
+    hasher                    hash_;
+    key_equal                 equal_;
+
+public:
+    // bucket_count 向上取整为 2 的幂
+    explicit lockfree_unordered_map(size_type bucket_count = 16,
+                                    const Hash& hash = Hash(),
+                                    const KeyEqual& equal = KeyEqual())
+        :bucket_count_(2), size_(0), hash_(hash), equal_(equal)
+    {
+        for (size_type i = 0; i < static_cast<size_type>(ELockFreeMapSegments); ++i)
+            segments_[i].store(nullptr, std::memory_order_relaxed);
+        size_type n = 2;
+        while (n < bucket_count && n < (static_cast<size_type>(1) << (ELockFreeMapSegments - 1)))
+            n <<= 1;
+        bucket_count_.store(n, std::memory_order_relaxed);
+        // 0 号桶的哨兵是整条链表的头
+        so_node* head = create_node(0, nullptr);
+        try
+        {
+            bucket_ref(0).store(head, std::memory_order_release);
+        }
+        catch (...)
+        {
+            destroy_node(head);
+            throw;
+        }
+    }
+
+    lockfree_unordered_map(const lockfree_unordered_map&) = delete;
+    lockfree_unordered_map& operator=(const lockfree_unordered_map&) = delete;
+
+    // 析构时不能有其他线程访问本容器；已经交给 epoch_domain 的节点由它负责回收
+    ~lockfree_unordered_map()
+    {
+        so_node* cur = segments_[0].load(std::memory_order_relaxed)[0].load(std::memory_order_relaxed);
+        while (cur != nullptr)
+        {
+            so_node* next = node_of(cur->next.load(std::memory_order_relaxed));
+            value_block* vb = cur->value.load(std::memory_order_relaxed);
+            if (vb != nullptr)
+                destroy_value(vb);
+            destroy_node(cur);
+            cur = next;
+        }
+        for (size_type s = 0; s < static_cast<size_type>(ELockFreeMapSegments); ++s)
+        {
+            bucket_slot* seg = segments_[s].load(std::memory_order_relaxed);
+            if (seg != nullptr)
+                slot_allocator::deallocate(seg, segment_size(s));
+        }
+    }
+
+    allocator_type get_allocator() const { return allocator_type(); }
+    hasher         hash_function() const { return hash_; }
+    key_equal      key_eq()        const { return equal_; }
+
+public:
+    // 容量相关操作，并发修改时只是近似值
+    size_type size()         const noexcept { return size_.load(std::memory_order_relaxed); }
+    bool      empty()        const noexcept { return size() == 0; }
+    size_type bucket_count() const noexcept { return bucket_count_.load(std::memory_order_relaxed); }
+
+    // 查找相关操作，只读取共享内存
+
+    // 找到时把 mapped 复制到 value 并返回 true
+    bool find(const key_type& key, mapped_type& value) const
+    {
+        epoch_guard guard;
+        const value_block* vb = find_value(key);
+        if (vb == nullptr)
+            return false;
+        value = vb->value.second;
+        return true;
+    }
+
+    bool contains(const key_type& key) const
+    {
+        epoch_guard guard;
+        return find_value(key) != nullptr;
+    }
+
+    size_type count(const key_type& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    mapped_type at(const key_type& key) const
+    {
+        epoch_guard guard;
+        const value_block* vb = find_value(key);
+        THROW_OUT_OF_RANGE_IF(vb == nullptr, "lockfree_unordered_map<Key, T> no such element exists");
+        return vb->value.second;
+    }
+
+    // 找到时以 const value_type& 调用 fn 并返回 true，fn 执行期间处于临界区，回调应当尽量短
+    template <class Fn>
+    bool visit(const key_type& key, Fn fn) const
+    {
+        epoch_guard guard;
+        const value_block* vb = find_value(key);
+        if (vb == nullptr)
+            return false;
+        fn(vb->value);
+        return true;
+    }
+
+    // 修改相关操作，返回是否插入了新元素
+
+    bool insert(const value_type& value) { return emplace(value); }
+    bool insert(value_type&& value)      { return emplace(orange_stl::move(value)); }
+
+    template <class ...Args>
+    bool emplace(Args&& ...args)
+    {
+        value_block* vb = create_value(orange_stl::forward<Args>(args)...);
+        return insert_value(vb, false);
+    }
+
+    template <class ...Args>
+    bool try_emplace(const key_type& key, Args&& ...args)
+    {
+        if (contains(key))
+            return false;
+        return emplace(orange_stl::piecewise_construct,
+                       std::forward_as_tuple(key),
+                       std::forward_as_tuple(orange_stl::forward<Args>(args)...));
+    }
+
+    // 键值存在时原子地替换它的值，否则插入
+    template <class M>
+    bool insert_or_assign(const key_type& key, M&& obj)
+    {
+        value_block* vb = create_value(key, orange_stl::forward<M>(obj));
+        return insert_value(vb, true);
+    }
+
+    size_type erase(const key_type& key);
+
+    // 对每个元素以 const value_type& 调用 fn
+    // 不是快照：遍历期间并发插入或删除的元素可能被看到也可能看不到，但每个未被修改的元素恰好访问一次
+    // 整个遍历处于同一个临界区，期间回收会被推迟
+    template <class Fn>
+    void for_each(Fn fn) const
+    {
+        epoch_guard guard;
+        so_node* cur = node_of(bucket_head(0)->next.load(std::memory_order_acquire));
+        while (cur != nullptr)
+        {
+            const uintptr_t next = cur->next.load(std::memory_order_acquire);
+            if ((cur->so_key & 1) != 0 && !is_marked(next))
+            {
+                const value_block* vb = cur->value.load(std::memory_order_acquire);
+                if (vb != nullptr)
+                    fn(vb->value);
+            }
+            cur = node_of(next);
+        }
+    }
+
+private:
+    // 指针与删除标记
+    static bool      is_marked(uintptr_t p) noexcept { return (p & 1) != 0; }
+    static so_node*  node_of(uintptr_t p)   noexcept { return reinterpret_cast<so_node*>(p & ~static_cast<uintptr_t>(1)); }
+    static uintptr_t word_of(so_node* p)    noexcept { return reinterpret_cast<uintptr_t>(p); }
+
+    // 哈希值先以 ht_hash_mix 打散，低位决定桶，位反转后决定在链表中的次序
+    size_t   mixed_hash(const key_type& key) const { return ht_hash_mix(hash_(key)); }
+    static uint64_t regular_key(size_t code) noexcept { return lf_reverse_bits(code) | 1; }
+    static uint64_t dummy_key(size_type b)   noexcept { return lf_reverse_bits(b); }
+
+    // 桶数组
+    static size_type segment_of(size_type b) noexcept { return b < 2 ? 0 : lf_floor_log2(b); }
+    static size_type segment_size(size_type s) noexcept { return s == 0 ? 2 : static_cast<size_type>(1) << s; }
+    static size_type segment_offset(size_type b, size_type s) noexcept { return s == 0 ? b : b - (static_cast<size_type>(1) << s); }
+
+    // 第 b 个桶的槽位，所在的段尚未配置时配置它
+    bucket_slot& bucket_ref(size_type b);
+    // 第 b 个桶的哨兵，尚未初始化时返回 nullptr
+    so_node*     bucket_head(size_type b) const;
+    // 第 b 个桶的哨兵，尚未初始化时插入它
+    so_node*     bucket_head_init(size_type b);
+    // 只读地定位离 b 最近的已初始化的桶
+    so_node*     bucket_head_readonly(size_type b) const;
+
+    // 节点
+    template <class ...Args>
+    static value_block* create_value(Args&& ...args);
+    static void         destroy_value(value_block* vb) noexcept;
+    static so_node*     create_node(uint64_t so_key, value_block* vb);
+    static void         destroy_node(so_node* np) noexcept;
+    static void         free_value(epoch_node* p) noexcept { destroy_value(static_cast<value_block*>(p)); }
+    static void         free_node(epoch_node* p)  noexcept { destroy_node(static_cast<so_node*>(p)); }
+    static void         retire_value(value_block* vb);
+    static void         retire_node(so_node* np);
+
+    // 链表操作
+    bool node_matches(const so_node* np, uint64_t so_key, const key_type* key) const;
+    bool list_find(so_node* head, uint64_t so_key, const key_type* key,
+                   std::atomic<uintptr_t>*& prev, so_node*& cur);
+    const value_block* find_value(const key_type& key) const;
+    bool insert_value(value_block* vb, bool assign);
+};
+
+/*****************************************************************************************/
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::bucket_slot&
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::bucket_ref(size_type b)
+{
+    const size_type s = segment_of(b);
+    bucket_slot* seg = segments_[s].load(std::memory_order_acquire);
+    if (seg == nullptr)
+    {
+        const size_type n = segment_size(s);
+        bucket_slot* fresh = slot_allocator::allocate(n);
+        for (size_type i = 0; i < n; ++i)
+            ::new (static_cast<void*>(fresh + i)) bucket_slot(nullptr);
+        if (segments_[s].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel))
+            seg = fresh;
+        else
+            slot_allocator::deallocate(fresh, n);   // 其他线程已经配置，seg 为它配置的段
+    }
+    return seg[segment_offset(b, s)];
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::so_node*
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::bucket_head(size_type b) const
+{
+    const size_type s = segment_of(b);
+    bucket_slot* seg = segments_[s].load(std::memory_order_acquire);
+    return seg == nullptr ? nullptr : seg[segment_offset(b, s)].load(std::memory_order_acquire);
+}
+
+// 第 b 个桶的父桶是去掉最高位后的桶，父桶的哨兵在链表上一定位于 b 的哨兵之前
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::so_node*
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::bucket_head_readonly(size_type b) const
+{
+    so_node* head = bucket_head(b);
+    while (head == nullptr)
+    {
+        b &= ~(static_cast<size_type>(1) << lf_floor_log2(b));
+        head = bucket_head(b);
+    }
+    return head;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::so_node*
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::bucket_head_init(size_type b)
+{
+    so_node* head = bucket_head(b);
+    if (head != nullptr)
+        return head;
+    const size_type parent = b & ~(static_cast<size_type>(1) << lf_floor_log2(b));
+    so_node* parent_head = bucket_head_init(parent);
+    bucket_slot& slot = bucket_ref(b);
+    const uint64_t so_key = dummy_key(b);
+    so_node* dummy = create_node(so_key, nullptr);
+    std::atomic<uintptr_t>* prev = nullptr;
+    so_node* cur = nullptr;
+    for (;;)
+    {
+        if (list_find(parent_head, so_key, nullptr, prev, cur))
+        { // 其他线程已经插入了这个哨兵
+            destroy_node(dummy);
+            dummy = cur;
+            break;
+        }
+        dummy->next.store(word_of(cur), std::memory_order_relaxed);
+        uintptr_t expected = word_of(cur);
+        if (prev->compare_exchange_strong(expected, word_of(dummy), std::memory_order_release))
+            break;
+    }
+    slot.store(dummy, std::memory_order_release);
+    return dummy;
+}
+
+/*****************************************************************************************/
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::value_block*
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::create_value(Args&& ...args)
+{
+    value_block* vb = value_allocator::allocate(1);
+    try
+    {
+        value_allocator::construct(vb, orange_stl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        value_allocator::deallocate(vb);
+        throw;
+    }
+    vb->deleter = &free_value;
+    return vb;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::destroy_value(value_block* vb) noexcept
+{
+    value_allocator::destroy(vb);
+    value_allocator::deallocate(vb);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::so_node*
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::create_node(uint64_t so_key, value_block* vb)
+{
+    so_node* np = node_allocator::allocate(1);
+    ::new (static_cast<void*>(np)) so_node(so_key, vb);
+    np->deleter = &free_node;
+    return np;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::destroy_node(so_node* np) noexcept
+{
+    np->~so_node();
+    node_allocator::deallocate(np);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::retire_value(value_block* vb)
+{
+    epoch_domain::instance().retire(vb);
+}
+
+// 节点被摘下时它的值块已经由删除者取走，只回收节点本身
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::retire_node(so_node* np)
+{
+    epoch_domain::instance().retire(np);
+}
+
+/*****************************************************************************************/
+
+// 普通节点的键值是否等于 key，已删除(值块为空)的节点不匹配
+// 哨兵节点(key 为 nullptr)只比较 so_key
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::
+node_matches(const so_node* np, uint64_t so_key, const key_type* key) const
+{
+    if (np->so_key != so_key)
+        return false;
+    if (key == nullptr)
+        return true;
+    const value_block* vb = np->value.load(std::memory_order_acquire);
+    return vb != nullptr && equal_(vb->value.first, *key);
+}
+
+// 从 head 开始查找 so_key 与 key 都匹配的节点，途中摘下已标记删除的节点
+// 找到时返回 true，cur 为该节点；否则 cur 为第一个 so_key 大于目标的节点(或 nullptr)，即插入位置
+// 两种情况下 prev 都指向 cur 的前驱的 next 字段
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::
+list_find(so_node* head, uint64_t so_key, const key_type* key,
+          std::atomic<uintptr_t>*& prev, so_node*& cur)
+{
+retry:
+    prev = &head->next;
+    cur = node_of(prev->load(std::memory_order_acquire));
+    for (;;)
+    {
+        if (cur == nullptr)
+            return false;
+        const uintptr_t next = cur->next.load(std::memory_order_acquire);
+        if (prev->load(std::memory_order_acquire) != word_of(cur))
+            goto retry;     // 前驱已被删除或者其后插入了新节点
+        if (is_marked(next))
+        { // 帮助摘下已标记的节点，成功摘下的线程负责回收
+            uintptr_t expected = word_of(cur);
+            if (!prev->compare_exchange_strong(expected, next & ~static_cast<uintptr_t>(1),
+                                               std::memory_order_acq_rel))
+                goto retry;
+            retire_node(cur);
+            cur = node_of(next);
+            continue;
+        }
+        if (cur->so_key > so_key)
+            return false;
+        if (node_matches(cur, so_key, key))
+            return true;
+        prev = &cur->next;
+        cur = node_of(next);
+    }
+}
+
+// 只读查找：跳过已标记的节点但不摘下它们，不写任何共享内存
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+const typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::value_block*
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::find_value(const key_type& key) const
+{
+    const size_t code = mixed_hash(key);
+    const uint64_t so_key = regular_key(code);
+    so_node* cur = bucket_head_readonly(code & (bucket_count_.load(std::memory_order_acquire) - 1));
+    while (cur != nullptr)
+    {
+        const uintptr_t next = cur->next.load(std::memory_order_acquire);
+        if (cur->so_key > so_key)
+            return nullptr;
+        if (cur->so_key == so_key && !is_marked(next))
+        {
+            const value_block* vb = cur->value.load(std::memory_order_acquire);
+            if (vb != nullptr && equal_(vb->value.first, key))
+                return vb;
+        }
+        cur = node_of(next);
+    }
+    return nullptr;
+}
+
+// 插入值块 vb，键值已存在时：assign 为 true 则原子地替换值块，否则销毁 vb
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::insert_value(value_block* vb, bool assign)
+{
+    so_node* np = nullptr;
+    try
+    {
+        epoch_guard guard;
+        const key_type& key = vb->value.first;
+        const size_t code = mixed_hash(key);
+        const uint64_t so_key = regular_key(code);
+        const size_type count = bucket_count_.load(std::memory_order_acquire);
+        so_node* head = bucket_head_init(code & (count - 1));
+        std::atomic<uintptr_t>* prev = nullptr;
+        so_node* cur = nullptr;
+        for (;;)
+        {
+            if (list_find(head, so_key, &key, prev, cur))
+            {
+                if (!assign)
+                {
+                    if (np != nullptr)
+                        destroy_node(np);
+                    destroy_value(vb);
+                    return false;
+                }
+                // 值块为空说明元素刚被删除，重新查找后按插入处理
+                value_block* old = cur->value.load(std::memory_order_acquire);
+                while (old != nullptr)
+                {
+                    if (cur->value.compare_exchange_weak(old, vb, std::memory_order_acq_rel))
+                    {
+                        if (np != nullptr)
+                            destroy_node(np);
+                        retire_value(old);
+                        return false;
+                    }
+                }
+                continue;
+            }
+            if (np == nullptr)
+                np = create_node(so_key, vb);
+            np->next.store(word_of(cur), std::memory_order_relaxed);
+            uintptr_t expected = word_of(cur);
+            if (prev->compare_exchange_strong(expected, word_of(np), std::memory_order_release))
+                break;
+        }
+        // 平均链长超过上限时桶数翻倍，新桶在使用时才初始化
+        const size_type n = size_.fetch_add(1, std::memory_order_relaxed) + 1;
+        size_type c = count;
+        if (n > c * ELockFreeMapLoadFactor && c < (static_cast<size_type>(1) << (ELockFreeMapSegments - 1)))
+            bucket_count_.compare_exchange_strong(c, c * 2, std::memory_order_acq_rel);
+        return true;
+    }
+    catch (...)
+    { // 节点尚未链入链表
+        if (np != nullptr)
+            destroy_node(np);
+        destroy_value(vb);
+        throw;
+    }
+}
+
+// 删除键值为 key 的元素
+// 先把值块置空(线性化点)，再标记 next 并尝试摘下节点
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::size_type
+lockfree_unordered_map<Key, T, Hash, KeyEqual, Alloc>::erase(const key_type& key)
+{
+    epoch_guard guard;
+    const size_t code = mixed_hash(key);
+    const uint64_t so_key = regular_key(code);
+    so_node* head = bucket_head_init(code & (bucket_count_.load(std::memory_order_acquire) - 1));
+    std::atomic<uintptr_t>* prev = nullptr;
+    so_node* cur = nullptr;
+    value_block* old = nullptr;
+    for (;;)
+    {
+        if (!list_find(head, so_key, &key, prev, cur))
+            return 0;
+        old = cur->value.load(std::memory_order_acquire);
+        while (old != nullptr && !cur->value.compare_exchange_weak(old, nullptr, std::memory_order_acq_rel))
+        {
+        }
+        if (old != nullptr)
+            break;
+    }
+    retire_value(old);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    // 只有置空值块的线程会标记 next，标记之后 next 不再改变
+    uintptr_t next = cur->next.load(std::memory_order_acquire);
+    while (!cur->next.compare_exchange_weak(next, next | 1, std::memory_order_acq_rel))
+    {
+    }
+    uintptr_t expected = word_of(cur);
+    if (prev->compare_exchange_strong(expected, next, std::memory_order_acq_rel))
+        retire_node(cur);
+    else
+        list_find(head, so_key, &key, prev, cur);   // 由查找过程帮助摘下
+    return 1;
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_LOCKFREE_UNORDERED_MAP_H__
@@ -5,9 +5,16 @@
 
 namespace orange_stl
 {
+
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+class multimap;
+
 // 模板类map，键值不允许重复
-// 参数一表示键值类型，参数二表示实值类型，参数三表示键值的比较方式，默认less
-template <class Key, class T, class Compare=orange_stl::less<Key>>
+// 参数一表示键值类型，参数二表示实值类型，参数三表示键值的比较方式，默认less，参数四表示空间配置器类型
+// 参数五表示是否维护子树大小以支持 nth、rank 等顺序统计操作，默认不维护
+template <class Key, class T, class Compare=orange_stl::less<Key>,
+          class Alloc=orange_stl::allocator<orange_stl::pair<const Key, T>>,
+          bool Ranked=false>
 class map
 {
 public:
@@ -19,7 +26,7 @@ public:
     /* 定义一个fun用来进行元素的比较 */
     class value_compare : public binary_function<value_type, value_type, bool>
     {
-        friend class map<Key, T, Compare>;
+        friend class map<Key, T, Compare, Alloc, Ranked>;
     private:
         Compare comp;
         value_compare(Compare c):comp(c){}
@@ -30,9 +37,11 @@ public:
         }
     };
 private:
-    typedef orange_stl::rb_tree<value_type, key_compare> base_type;
+    typedef orange_stl::rb_tree<value_type, key_compare, Alloc, Ranked> base_type;
     base_type tree_;
 
+    friend class multimap<Key, T, Compare, Alloc, Ranked>;
+
 public:
     typedef typename base_type::node_type              node_type;
     typedef typename base_type::pointer                pointer;
@@ -46,6 +55,8 @@ public:
     typedef typename base_type::size_type              size_type;
     typedef typename base_type::difference_type        difference_type;
     typedef typename base_type::allocator_type         allocator_type;
+    typedef typename base_type::node_handle_type       node_handle_type;
+    typedef typename base_type::insert_return_type     insert_return_type;
 
 public:
     /* 构造，复制和移动函数 */
@@ -179,30 +190,62 @@ public:
 
     mapped_type& operator[](const key_type& key)
     {
-        iterator it = lower_bound(key);
-        if(it==end || key_comp()(key, it->first))
-            it = emplace_hint(it, key, T{});
-        return it->second;
+        return tree_.try_emplace_unique(key).first->second;
     }
     mapped_type& operator[](key_type&& key)
     {
-        iterator it = lower_bound(key);
-        if(it==end || key_comp()(key, it->first))
-            it = emplace_hint(it, orange_stl::move(key), T{});
-        return it->second;
+        return tree_.try_emplace_unique(orange_stl::move(key)).first->second;
+    }
+
+    /* 键值不存在时插入，否则返回已有的元素，只查找一次 */
+    /* 插入失败时不会移动 key 与 args */
+    template <class ...Args>
+    pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+    {
+        return tree_.try_emplace_unique(key, orange_stl::forward<Args>(args)...);
+    }
+    template <class ...Args>
+    pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+    {
+        return tree_.try_emplace_unique(orange_stl::move(key), orange_stl::forward<Args>(args)...);
+    }
+
+    /* 键值不存在时插入，否则赋值 */
+    template <class M>
+    pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+        return tree_.insert_or_assign_unique(key, orange_stl::forward<M>(obj));
+    }
+    template <class M>
+    pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+    {
+        return tree_.insert_or_assign_unique(orange_stl::move(key), orange_stl::forward<M>(obj));
+    }
+
+    /* 返回 key 对应的值，键值不存在时先插入 factory() 的结果 */
+    template <class Factory>
+    mapped_type& get_or_insert_with(const key_type& key, Factory&& factory)
+    {
+        return tree_.get_or_insert_with_unique(key, orange_stl::forward<Factory>(factory)).first->second;
+    }
+    template <class Factory>
+    mapped_type& get_or_insert_with(key_type&& key, Factory&& factory)
+    {
+        return tree_.get_or_insert_with_unique(orange_stl::move(key),
+                                               orange_stl::forward<Factory>(factory)).first->second;
     }
 
     /* 插入删除 */
     template <class ...Args>
     pair<iterator, bool> emplace(Args&& ...args)
     {
-        return tree_.emplace_unique(mystl::forward<Args>(args)...);
+        return tree_.emplace_unique(orange_stl::forward<Args>(args)...);
     }
 
     template <class ...Args>
     iterator emplace_hint(iterator hint, Args&& ...args)
     {
-        return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
+        return tree_.emplace_unique_use_hint(hint, orange_stl::forward<Args>(args)...);
     }
 
     pair<iterator, bool> insert(const value_type& value)
@@ -220,7 +263,7 @@ public:
     }
     iterator insert(iterator hint, value_type&& value)
     {
-        return tree_.insert_unique(hint, mystl::move(value));
+        return tree_.insert_unique(hint, orange_stl::move(value));
     }
     template <class InputIterator>
     void insert(InputIterator first, InputIterator last)
@@ -241,6 +284,62 @@ public:
         tree_.erase(first, last);
     }
 
+    /* 节点句柄相关的操作 */
+    node_handle_type extract(iterator position)
+    {
+        return tree_.extract(position);
+    }
+    node_handle_type extract(const key_type& key)
+    {
+        return tree_.extract(key);
+    }
+    insert_return_type insert(node_handle_type&& nh)
+    {
+        return tree_.insert_unique(orange_stl::move(nh));
+    }
+    void merge(map& source)
+    {
+        tree_.merge_unique(source.tree_);
+    }
+    void merge(multimap<Key, T, Compare, Alloc, Ranked>& source)
+    {
+        tree_.merge_unique(source.tree_);
+    }
+
+    /* 基于 join 的整体操作，节点直接在容器之间转移 */
+    // 键值不小于 key 的元素移到返回的容器中，本容器留下小于 key 的元素，O(log n)
+    map split(const key_type& key)
+    {
+        map right;
+        tree_.split(key, right.tree_);
+        return right;
+    }
+    // 把 rhs 接到本容器之后，要求本容器的键值都不大于 rhs 的键值，O(log n)
+    void join(map& rhs)
+    {
+        tree_.join(rhs.tree_);
+    }
+    // 取出键值在 [first, last) 之间的元素
+    map extract_range(const key_type& first, const key_type& last)
+    {
+        map out;
+        tree_.extract_range(first, last, out.tree_);
+        return out;
+    }
+    // 集合运算，rhs 的节点被复用或销毁，运算后 rhs 为空，键值相同时保留本容器的元素
+    void union_with(map& rhs)
+    {
+        tree_.union_unique(rhs.tree_);
+    }
+    void intersection_with(map& rhs)
+    {
+        tree_.intersection_unique(rhs.tree_);
+    }
+    void difference_with(map& rhs)
+    {
+        tree_.difference_unique(rhs.tree_);
+    }
+
     void clear()
     {
         tree_.clear();
@@ -287,6 +386,84 @@ public:
         return tree_.equal_range_unique(key);
     }
 
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_unique(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_unique(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return tree_.equal_range_unique(key);
+    }
+
+    /* 顺序统计，只在 Ranked 为 true 时可用，均为 O(log n) */
+    iterator nth(size_type k)
+    {
+        return tree_.nth(k);
+    }
+    const_iterator nth(size_type k) const
+    {
+        return tree_.nth(k);
+    }
+    size_type rank(const key_type& key) const
+    {
+        return tree_.rank(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type rank(const K& key) const
+    {
+        return tree_.rank(key);
+    }
+    size_type index_of(const_iterator position) const
+    {
+        return tree_.index_of(position);
+    }
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+        return tree_.distance(first, last);
+    }
+
     void swap(map& rhs) noexcept
     {
         tree_.swap(rhs.tree_);
@@ -303,53 +480,55 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator==(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator!=(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<=(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>=(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+void swap(map<Key, T, Compare, Alloc, Ranked>& lhs, map<Key, T, Compare, Alloc, Ranked>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
 
 
 /* 模板类multimap，键值允许重复 */
-/* 参数一表示键值类型，参数二表示实值类型，参数三代表比较方式，默认less */
-template <class Key, class T, class Compare = orange_stl::less<Key>>
+/* 参数一表示键值类型，参数二表示实值类型，参数三代表比较方式，默认less，参数五表示是否支持顺序统计操作 */
+template <class Key, class T, class Compare = orange_stl::less<Key>,
+          class Alloc = orange_stl::allocator<orange_stl::pair<const Key, T>>,
+          bool Ranked = false>
 class multimap
 {
 public:
@@ -360,7 +539,7 @@ public:
     /* 定义一个fun用来进行元素的比较 */
     class value_compare : public binary_function<value_type, value_type, bool>
     {
-        friend class multimap<Key, T, Compare>;
+        friend class multimap<Key, T, Compare, Alloc, Ranked>;
     private:
         Compare comp;
         value_compare(Compare c):comp(c){}
@@ -371,8 +550,10 @@ public:
         }
     };
 private:
-    typedef orange_stl::rb_tree<value_type, key_compare> base_type;
+    typedef orange_stl::rb_tree<value_type, key_compare, Alloc, Ranked> base_type;
     base_type tree_;
+
+    friend class map<Key, T, Compare, Alloc, Ranked>;
 public:
     typedef typename base_type::node_type              node_type;
     typedef typename base_type::pointer                pointer;
@@ -386,6 +567,7 @@ public:
     typedef typename base_type::size_type              size_type;
     typedef typename base_type::difference_type        difference_type;
     typedef typename base_type::allocator_type         allocator_type;
+    typedef typename base_type::node_handle_type       node_handle_type;
 
 public:
     /* 构造复制和移动函数 */
@@ -403,7 +585,7 @@ public:
 
     multimap(const multimap& rhs):tree_(rhs.tree_)
     { }
-    multimap(multimap&& rhs) noexcept : tree_(mystl::move(rhs.tree_))
+    multimap(multimap&& rhs) noexcept : tree_(orange_stl::move(rhs.tree_))
     { }
 
     multimap& operator=(const multimap& rhs)
@@ -555,6 +737,49 @@ public:
         tree_.erase(first, last); 
     }
 
+    // 节点句柄相关的操作
+    node_handle_type extract(iterator position)
+    {
+        return tree_.extract(position);
+    }
+    node_handle_type extract(const key_type& key)
+    {
+        return tree_.extract(key);
+    }
+    iterator insert(node_handle_type&& nh)
+    {
+        return tree_.insert_multi(orange_stl::move(nh));
+    }
+    void merge(multimap& source)
+    {
+        tree_.merge_multi(source.tree_);
+    }
+    void merge(map<Key, T, Compare, Alloc, Ranked>& source)
+    {
+        tree_.merge_multi(source.tree_);
+    }
+
+    /* 基于 join 的整体操作，节点直接在容器之间转移 */
+    // 键值不小于 key 的元素移到返回的容器中，本容器留下小于 key 的元素，O(log n)
+    multimap split(const key_type& key)
+    {
+        multimap right;
+        tree_.split(key, right.tree_);
+        return right;
+    }
+    // 把 rhs 接到本容器之后，要求本容器的键值都不大于 rhs 的键值，O(log n)
+    void join(multimap& rhs)
+    {
+        tree_.join(rhs.tree_);
+    }
+    // 取出键值在 [first, last) 之间的元素
+    multimap extract_range(const key_type& first, const key_type& last)
+    {
+        multimap out;
+        tree_.extract_range(first, last, out.tree_);
+        return out;
+    }
+
     void clear() 
     { 
         tree_.clear(); 
@@ -604,6 +829,84 @@ public:
         return tree_.equal_range_multi(key); 
     }
 
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_multi(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_multi(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return tree_.equal_range_multi(key);
+    }
+
+    /* 顺序统计，只在 Ranked 为 true 时可用，均为 O(log n) */
+    iterator nth(size_type k)
+    {
+        return tree_.nth(k);
+    }
+    const_iterator nth(size_type k) const
+    {
+        return tree_.nth(k);
+    }
+    size_type rank(const key_type& key) const
+    {
+        return tree_.rank(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type rank(const K& key) const
+    {
+        return tree_.rank(key);
+    }
+    size_type index_of(const_iterator position) const
+    {
+        return tree_.index_of(position);
+    }
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+        return tree_.distance(first, last);
+    }
+
     void swap(multimap& rhs) noexcept
     { 
         tree_.swap(rhs.tree_); 
@@ -621,45 +924,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator==(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
     return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
     return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator!=(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
     return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
     return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<=(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
     return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>=(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+void swap(multimap<Key, T, Compare, Alloc, Ranked>& lhs, multimap<Key, T, Compare, Alloc, Ranked>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
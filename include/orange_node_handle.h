@@ -0,0 +1,133 @@
+#ifndef __ORANGE_NODE_HANDLE_H__
+#define __ORANGE_NODE_HANDLE_H__
+
+// 这个头文件包含节点句柄 node_handle 与插入节点句柄的返回类型 node_insert_return
+// 关联式容器与无序关联式容器的 extract 把节点从容器中摘下并交给 node_handle，
+// 之后可以修改它的键值再插入同类型的容器，整个过程不会重新配置节点也不会复制元素
+
+#include <type_traits>
+
+#include "orange_memory.h"
+#include "orange_util.h"
+
+namespace orange_stl
+{
+
+template <class T, class Compare, class Alloc, bool Ranked>
+class rb_tree;
+
+template <class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+class hashtable;
+
+// 模板类 node_handle
+// 参数一代表元素类型，参数二代表容器的节点类型，参数三代表容器的空间配置器类型
+// 持有一个已从容器摘下的节点，只能移动不能复制，析构时销毁并释放仍然持有的节点
+template <class T, class Node, class Alloc>
+class node_handle
+{
+    template <class, class, class, bool> friend class orange_stl::rb_tree;
+    template <class, class, class, class, class> friend class orange_stl::hashtable;
+
+public:
+    typedef T                                                  value_type;
+    typedef Alloc                                              allocator_type;
+
+private:
+    typedef typename Alloc::template rebind<T>::other          data_allocator;
+    typedef typename Alloc::template rebind<Node>::other       node_allocator;
+
+    Node* np_;
+
+public:
+    node_handle() noexcept : np_(nullptr) {}
+
+    node_handle(node_handle&& rhs) noexcept : np_(rhs.np_)
+    {
+        rhs.np_ = nullptr;
+    }
+
+    node_handle& operator=(node_handle&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            reset();
+            np_ = rhs.np_;
+            rhs.np_ = nullptr;
+        }
+        return *this;
+    }
+
+    node_handle(const node_handle&) = delete;
+    node_handle& operator=(const node_handle&) = delete;
+
+    ~node_handle() { reset(); }
+
+public:
+    bool empty() const noexcept { return np_ == nullptr; }
+    explicit operator bool() const noexcept { return np_ != nullptr; }
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+    // 以下操作要求句柄非空
+    value_type& value() const { return np_->value; }
+
+    // key 与 mapped 只对 map 类的容器(元素为 pair<const Key, T>)有意义
+    // 节点不在容器中，因此可以通过 key 修改键值
+    template <class U = T>
+    typename std::remove_const<typename U::first_type>::type& key() const
+    {
+        return const_cast<typename std::remove_const<typename U::first_type>::type&>(np_->value.first);
+    }
+
+    template <class U = T>
+    typename U::second_type& mapped() const
+    {
+        return np_->value.second;
+    }
+
+    void swap(node_handle& rhs) noexcept
+    {
+        orange_stl::swap(np_, rhs.np_);
+    }
+
+private:
+    explicit node_handle(Node* np) noexcept : np_(np) {}
+
+    // 交出节点的所有权，供容器把节点重新链入
+    Node* release() noexcept
+    {
+        Node* np = np_;
+        np_ = nullptr;
+        return np;
+    }
+
+    void reset() noexcept
+    {
+        if (np_ != nullptr)
+        {
+            data_allocator::destroy(orange_stl::address_of(np_->value));
+            node_allocator::deallocate(np_);
+            np_ = nullptr;
+        }
+    }
+};
+
+template <class T, class Node, class Alloc>
+void swap(node_handle<T, Node, Alloc>& lhs, node_handle<T, Node, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// 模板类 node_insert_return
+// 键值不允许重复的容器插入节点句柄的结果：
+// 插入成功时 position 指向新元素、node 为空；键值已存在时 position 指向已有的元素，节点交还给 node
+template <class Iterator, class NodeHandle>
+struct node_insert_return
+{
+    Iterator   position;
+    bool       inserted;
+    NodeHandle node;
+};
+
+} // namespace orange_stl
+#endif // !__ORANGE_NODE_HANDLE_H__
@@ -0,0 +1,211 @@
+#ifndef __ORANGE_PARALLEL_ALGO_H__
+#define __ORANGE_PARALLEL_ALGO_H__
+
+// 这个头文件包含并行算法 parallel_sort，在 thread_pool 上执行
+// 区间长度不超过 cutoff 或线程池没有工作线程时，退化为单线程的 orange_stl::sort
+
+#include <cstddef>
+#include <type_traits>
+
+#include "orange_algo.h"
+#include "orange_memory.h"
+#include "orange_vector.h"
+#include "orange_thread_pool.h"
+
+namespace orange_stl
+{
+
+// 参数的取值依据：
+// EParallelSortCutoff: 缺省的串行阈值，区间长度不超过它时直接使用 orange_stl::sort
+//   一轮 psort 要唤醒线程、分配缓冲区并多读写两遍数据，2^16 个元素串行排序约 2~3 ms，
+//   低于这个规模时固定开销和线程唤醒延迟就占了可观的比例；同时它也是递归排序过大桶的下限
+// EParallelSortMaxSplitters: 分割点个数的上限，桶编号 2m+1 <= 511 可以用 unsigned short 保存
+// EParallelSortOversample: 每个分割点对应的样本数，样本排序后每隔这么多个取一个分割点，
+//   过采样 16 倍时最大桶超过平均大小 2 倍的概率已经很小，样本排序的代价可以忽略
+// 分割点个数取 4*workers-1，每个线程平均分到 4 个桶，单个桶偏大时由其他线程分担剩余的桶；
+// 统计和搬移阶段把区间分成 2*workers 块，块的数量决定了计数表的大小(块数 x 桶数)
+enum { EParallelSortCutoff = 1 << 16, EParallelSortMaxSplitters = 255, EParallelSortOversample = 16 };
+
+/*****************************************************************************************/
+// parallel_sort
+// 将[first, last)内的元素以递增的方式排序，采用样本排序(sample sort)：
+// 1. 抽取样本并排序，从中选出 m 个分割点，把值域分成 2m+1 个桶：
+//    偶数号桶存放落在相邻两个分割点之间的元素，奇数号桶存放与某个分割点相等的元素(无需再排序)
+// 2. 把区间分成若干块，每块并行计算每个元素的桶编号并统计各桶的元素个数，
+//    求前缀和后按记下的桶编号并行把元素搬到临时缓冲区，每个元素只比较一次
+// 3. 每个桶并行搬回原区间，再各自排序，过大的桶递归地并行排序
+// 元素的移动构造可能抛出异常或者临时缓冲区申请失败时，退化为 orange_stl::sort
+/*****************************************************************************************/
+
+// 计算元素所在的桶，m 至少为 1
+// 二分查找的循环次数只与 m 有关，比较结果只用来选择下一个区间的起点，不产生难以预测的分支
+template <class T, class Compared>
+size_t psort_bucket(const T* splitters, size_t m, const T& value, Compared comp)
+{
+    const T* base = splitters;
+    while (m > 1)
+    {
+        const size_t half = m / 2;
+        base = comp(value, base[half - 1]) ? base : base + half;
+        m -= half;
+    }
+    // 此时 base 之前的分割点都不大于 value，base 之后的分割点都大于 value
+    if (!comp(value, *base))
+        return 2 * static_cast<size_t>(base - splitters) + (comp(*base, value) ? 2 : 1);
+    if (base != splitters && !comp(base[-1], value))
+        return 2 * static_cast<size_t>(base - splitters) - 1;   // 与分割点 base-1 相等
+    return 2 * static_cast<size_t>(base - splitters);
+}
+
+template <class RandomIter, class Compared>
+void psort_aux(RandomIter first, RandomIter last, Compared comp, size_t cutoff, thread_pool& pool)
+{
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t workers = pool.size() + 1;
+    if (n <= cutoff || workers == 1 || !std::is_nothrow_move_constructible<value_type>::value)
+    {
+        orange_stl::sort(first, last, comp);
+        return;
+    }
+
+    // 选取分割点：等距抽样，排序后每隔 oversample 个取一个
+    size_t m = workers * 4 - 1;
+    if (m > static_cast<size_t>(EParallelSortMaxSplitters))
+        m = EParallelSortMaxSplitters;
+    const size_t sample_count = (m + 1) * EParallelSortOversample;
+    orange_stl::vector<value_type> sample;
+    sample.reserve(sample_count);
+    const size_t step = n / sample_count;
+    for (size_t i = 0; i < sample_count; ++i)
+        sample.push_back(*(first + (i * step + (i * 7919) % (step == 0 ? 1 : step))));
+    orange_stl::sort(sample.begin(), sample.end(), comp);
+    orange_stl::vector<value_type> splitters;
+    splitters.reserve(m);
+    for (size_t i = 1; i <= m; ++i)
+    {
+        const value_type& s = sample[i * EParallelSortOversample - 1];
+        if (splitters.empty() || comp(splitters.back(), s))
+            splitters.push_back(s);
+    }
+    m = splitters.size();
+    const value_type* sp = splitters.begin();
+    const size_t buckets = 2 * m + 1;
+
+    // 每个元素的桶编号，统计阶段写入，搬移阶段读取
+    orange_stl::vector<unsigned short> ids(n);
+    unsigned short* id = ids.begin();
+
+    pair<value_type*, ptrdiff_t> buf = orange_stl::get_temporary_buffer<value_type>(static_cast<ptrdiff_t>(n));
+    if (buf.first == nullptr || static_cast<size_t>(buf.second) < n)
+    {
+        orange_stl::release_temporary_buffer(buf.first);
+        orange_stl::sort(first, last, comp);
+        return;
+    }
+    value_type* tmp = buf.first;
+
+    // 统计每块中各桶的元素个数
+    const size_t chunks = workers * 2;
+    orange_stl::vector<size_t> offset(chunks * buckets, 0);
+    {
+        task_group group(pool);
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            group.run([=, &offset] {
+                size_t* cnt = offset.begin() + c * buckets;
+                const size_t b = n * c / chunks;
+                const size_t e = n * (c + 1) / chunks;
+                RandomIter it = first + b;
+                for (size_t i = b; i < e; ++i, ++it)
+                {
+                    const size_t k = orange_stl::psort_bucket(sp, m, *it, comp);
+                    id[i] = static_cast<unsigned short>(k);
+                    ++cnt[k];
+                }
+            });
+        }
+        group.wait();
+    }
+
+    // 前缀和：offset[c][k] 变为块 c 中桶 k 的元素在缓冲区中的起始位置
+    orange_stl::vector<size_t> bucket_begin(buckets + 1, 0);
+    size_t sum = 0;
+    for (size_t k = 0; k < buckets; ++k)
+    {
+        bucket_begin[k] = sum;
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            const size_t cnt = offset[c * buckets + k];
+            offset[c * buckets + k] = sum;
+            sum += cnt;
+        }
+    }
+    bucket_begin[buckets] = sum;
+
+    // 把元素搬到缓冲区中对应的位置
+    {
+        task_group group(pool);
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            group.run([=, &offset] {
+                size_t* pos = offset.begin() + c * buckets;
+                const size_t b = n * c / chunks;
+                const size_t e = n * (c + 1) / chunks;
+                RandomIter it = first + b;
+                for (size_t i = b; i < e; ++i, ++it)
+                    ::new (static_cast<void*>(tmp + pos[id[i]]++)) value_type(orange_stl::move(*it));
+            });
+        }
+        group.wait();
+    }
+
+    // 每个桶搬回原区间并排序，与分割点相等的桶已经有序
+    {
+        task_group group(pool);
+        for (size_t k = 0; k < buckets; ++k)
+        {
+            const size_t b = bucket_begin[k];
+            const size_t e = bucket_begin[k + 1];
+            if (b == e)
+                continue;
+            group.run([=, &pool] {
+                RandomIter out = first + b;
+                for (size_t i = b; i < e; ++i, ++out)
+                {
+                    *out = orange_stl::move(tmp[i]);
+                    orange_stl::destroy(tmp + i);
+                }
+                if (k % 2 == 0)
+                {
+                    if (e - b > n / workers)
+                        orange_stl::psort_aux(first + b, first + e, comp, cutoff, pool);
+                    else
+                        orange_stl::sort(first + b, first + e, comp);
+                }
+            });
+        }
+        group.wait();
+    }
+    orange_stl::release_temporary_buffer(tmp);
+}
+
+template <class RandomIter, class Compared>
+void parallel_sort(RandomIter first, RandomIter last, Compared comp,
+                   size_t cutoff = EParallelSortCutoff,
+                   thread_pool& pool = thread_pool::default_pool())
+{
+    if (first != last)
+        orange_stl::psort_aux(first, last, comp, cutoff, pool);
+}
+
+template <class RandomIter>
+void parallel_sort(RandomIter first, RandomIter last)
+{
+    orange_stl::parallel_sort(first, last,
+                              orange_stl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_PARALLEL_ALGO_H__
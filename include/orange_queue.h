@@ -199,7 +199,7 @@ private:
 public:
     priority_queue() = default;
 
-    priority_queue(const Compare& c) : c_(), comp(c)
+    priority_queue(const Compare& c) : c_(), comp_(c)
     { }
 
     explicit priority_queue(size_type n) : c_(n)
@@ -252,7 +252,7 @@ public:
     }
     priority_queue& operator=(priority_queue&& rhs)
     {
-        c_ = mystl::move(rhs.c_);
+        c_ = orange_stl::move(rhs.c_);
         comp_ = rhs.comp_;
         orange_stl::make_heap(c_.begin(), c_.end(), comp_);
         return *this;
@@ -2,9 +2,11 @@
 #define __ORANGE_RB_TREE_H__
 
 #include <initializer_list>
+#include <tuple>
 #include "orange_functional.h"
 #include "orange_iterator.h"
 #include "orange_memory.h"
+#include "orange_node_handle.h"
 #include "orange_type_traits.h"
 #include "orange_exceptdef.h"
 
@@ -156,6 +158,13 @@ struct rb_tree_node : public rb_tree_node_base<T>
     }
 };
 
+/* 顺序统计树(order statistic tree)的节点，额外记录以该节点为根的子树中的节点数 */
+template <class T>
+struct rb_tree_rank_node : public rb_tree_node<T>
+{
+    size_t size;
+};
+
 /* rb_tree traits */
 template <class T>
 struct rb_tree_traits
@@ -261,6 +270,7 @@ struct rb_tree_iterator : public rb_tree_iterator_base<T>
     rb_tree_iterator(node_ptr x) { node = x; }
     rb_tree_iterator(const iterator& rhs) { node = rhs.node; }
     rb_tree_iterator(const const_iterator& rhs) { node = rhs.node; }
+    iterator& operator=(const iterator&) = default;
 
     // 重载操作符
     reference operator*()  const { return node->get_node_ptr()->value; }
@@ -313,6 +323,7 @@ struct rb_tree_const_iterator :public rb_tree_iterator_base<T>
     rb_tree_const_iterator(node_ptr x) { node = x; }
     rb_tree_const_iterator(const iterator& rhs) { node = rhs.node; }
     rb_tree_const_iterator(const const_iterator& rhs) { node = rhs.node; }
+    const_iterator& operator=(const const_iterator&) = default;
 
     // 重载操作符
     reference operator*()  const { return node->get_node_ptr()->value; }
@@ -392,6 +403,54 @@ NodePtr rb_tree_next(NodePtr node) noexcept
     return node->parent;
 }
 
+/* 维护节点附加信息的函数对象，节点的子树发生变化后以该节点调用，调用时其子节点的信息已经正确 */
+// 不维护任何信息
+struct rb_tree_no_augment
+{
+    template <class NodePtr>
+    void operator()(NodePtr) const noexcept {}
+
+    template <class NodePtr>
+    static void copy(NodePtr, NodePtr) noexcept {}
+};
+
+// 维护子树大小，节点必须是 rb_tree_rank_node
+template <class T>
+struct rb_tree_size_augment
+{
+    typedef rb_tree_node_base<T>* base_ptr;
+    typedef rb_tree_rank_node<T>* rank_ptr;
+
+    static size_t size_of(base_ptr x) noexcept
+    {
+        return x == nullptr ? 0 : static_cast<rank_ptr>(x->get_node_ptr())->size;
+    }
+
+    void operator()(base_ptr x) const noexcept
+    {
+        static_cast<rank_ptr>(x->get_node_ptr())->size = size_of(x->left) + size_of(x->right) + 1;
+    }
+
+    // 复制一棵结构相同的树时直接复制
+    static void copy(base_ptr dst, base_ptr src) noexcept
+    {
+        static_cast<rank_ptr>(dst->get_node_ptr())->size = size_of(src);
+    }
+};
+
+// 从 x 沿父节点向上逐个更新，直到 stop 为止(不含 stop)
+template <class NodePtr, class Augment>
+void rb_tree_augment_path(NodePtr x, NodePtr stop, Augment update) noexcept
+{
+    for(; x != stop; x = x->parent)
+        update(x);
+}
+
+template <class NodePtr>
+void rb_tree_augment_path(NodePtr, NodePtr, rb_tree_no_augment) noexcept
+{
+}
+
 /*---------------------------------------*\
 |       p                         p       |
 |      / \                       / \      |
@@ -401,9 +460,9 @@ NodePtr rb_tree_next(NodePtr node) noexcept
 |      / \                   / \          |
 |     b   c                 a   b         |
 \*---------------------------------------*/
-// 左旋，参数一为左旋点，参数二为根节点
-template <class NodePtr>
-void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept
+// 左旋，参数一为左旋点，参数二为根节点，参数三维护附加信息
+template <class NodePtr, class Augment = rb_tree_no_augment>
+void rb_tree_rotate_left(NodePtr x, NodePtr& root, Augment update = Augment()) noexcept
 {
     auto y=x->right;
     x->right=y->left;
@@ -420,6 +479,8 @@ void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept
 
     y->left=x;
     x->parent=y;
+    update(x);
+    update(y);
 }
 
 /*----------------------------------------*\
@@ -431,9 +492,9 @@ void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept
 |    / \                           / \     |
 |   b   c                         c   a    |
 \*----------------------------------------*/
-// 右旋，参数一为右旋点，参数二为根节点
-template <class NodePtr>
-void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept
+// 右旋，参数一为右旋点，参数二为根节点，参数三维护附加信息
+template <class NodePtr, class Augment = rb_tree_no_augment>
+void rb_tree_rotate_right(NodePtr x, NodePtr& root, Augment update = Augment()) noexcept
 {
     auto y=x->left;
     x->left=y->right;
@@ -446,10 +507,12 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept
     else if(rb_tree_is_lchild(x))
         x->parent->left=y;
     else
-        x->parent->right=x;
+        x->parent->right=y;
     
     y->right = x;
     x->parent = y;
+    update(x);
+    update(y);
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * \   
@@ -463,10 +526,12 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept
 *         让父节点成为当前节点，再以当前节点为支点左（右）旋
 * case 5: 父节点为红，叔叔节点为 NIL 或黑色，父节点为左（右）孩子，当前节点为左（右）孩子，
 *         让父节点变为黑色，祖父节点变为红色，以祖父节点为支点右（左）旋
+* 参数三维护附加信息：先更新新增节点到根节点路径上的所有节点，之后每次旋转各自维护
 \** * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
-template <class NodePtr>
-void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
+template <class NodePtr, class Augment = rb_tree_no_augment>
+void rb_tree_insert_rebalance(NodePtr x, NodePtr& root, Augment update = Augment()) noexcept
 {
+    rb_tree_augment_path(x, root->parent, update);
     rb_tree_set_red(x);     /* 新增节点为红色 */
     while(x != root && rb_tree_is_red(x->parent))
     {
@@ -488,12 +553,12 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
                 {
                     /* case4: 当前结点为右子节点 */
                     x=x->parent;
-                    rb_tree_rotate_left(x, root);
+                    rb_tree_rotate_left(x, root, update);
                 }
                 /* 转换为case5: 当前结点变为左子节点 */
                 rb_tree_set_black(x->parent);
                 rb_tree_set_red(x->parent->parent);
-                rb_tree_rotate_right(x->parent->parent, root);
+                rb_tree_rotate_right(x->parent->parent, root, update);
                 break;
             }
         }
@@ -514,12 +579,12 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
                 {
                     /* case4: 当前结点为左子节点 */
                     x=x->parent;
-                    rb_tree_rotate_right(x, root);
+                    rb_tree_rotate_right(x, root, update);
                 }
                  /* 转换为case5: 当前结点变为右子节点 */
                 rb_tree_set_black(x->parent);
                 rb_tree_set_red(x->parent->parent);
-                rb_tree_rotate_left(x->parent->parent, root);
+                rb_tree_rotate_left(x->parent->parent, root, update);
                 break;
             }
         }
@@ -527,9 +592,11 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
     rb_tree_set_black(root);
 }
 
-/*  删除节点后使 rb tree 重新平衡，参数一为要删除的节点，参数二为根节点，参数三为最小节点，参数四为最大节点  */
-template <class NodePtr>
-NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodePtr rightmost)
+/*  删除节点后使 rb tree 重新平衡，参数一为要删除的节点，参数二为根节点，参数三为最小节点，参数四为最大节点
+    参数五维护附加信息：摘除节点之后先更新 xp 到根节点路径上的所有节点，之后每次旋转各自维护  */
+template <class NodePtr, class Augment = rb_tree_no_augment>
+NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr& leftmost, NodePtr& rightmost,
+                               Augment update = Augment())
 {
     /* y是可能的替换节点，指向最终要删除的节点 */
     /* 如果z有双子节点，y就是右子树的最左节点，否则y=z; */
@@ -602,6 +669,10 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
         if(rightmost==z)
             rightmost = x == nullptr ? xp : rb_tree_max(x);
     }
+
+    /* 子树发生变化的节点都在 xp 到根节点的路径上(y 顶替 z 时 y 也在其中) */
+    if(root != nullptr)
+        rb_tree_augment_path(xp, root->parent, update);
     
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
      * 此时，y 指向要删除的节点，x 为替代节点，从 x 节点开始调整。
@@ -627,7 +698,7 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
                     // case 1
                     rb_tree_set_black(brother);
                     rb_tree_set_red(xp);
-                    rb_tree_rotate_left(xp, root);
+                    rb_tree_rotate_left(xp, root, update);
                     brother = xp->right;
                 }
                 // case 1 转为为了 case 2、3、4 中的一种
@@ -645,7 +716,7 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
                         if (brother->left != nullptr)
                             rb_tree_set_black(brother->left);
                         rb_tree_set_red(brother);
-                        rb_tree_rotate_right(brother, root);
+                        rb_tree_rotate_right(brother, root, update);
                         brother = xp->right;
                     }
                     // 转为 case 4
@@ -653,7 +724,7 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
                     rb_tree_set_black(xp);
                     if (brother->right != nullptr)  
                         rb_tree_set_black(brother->right);
-                    rb_tree_rotate_left(xp, root);
+                    rb_tree_rotate_left(xp, root, update);
                     break;
                 }
             }
@@ -664,7 +735,7 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
                 { // case 1
                     rb_tree_set_black(brother);
                     rb_tree_set_red(xp);
-                    rb_tree_rotate_right(xp, root);
+                    rb_tree_rotate_right(xp, root, update);
                     brother = xp->left;
                 }
                 if ((brother->left == nullptr || !rb_tree_is_red(brother->left)) &&
@@ -681,7 +752,7 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
                         if (brother->right != nullptr)
                         rb_tree_set_black(brother->right);
                         rb_tree_set_red(brother);
-                        rb_tree_rotate_left(brother, root);
+                        rb_tree_rotate_left(brother, root, update);
                         brother = xp->left;
                     }
                     // 转为 case 4
@@ -689,7 +760,7 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
                     rb_tree_set_black(xp);
                     if (brother->left != nullptr)  
                         rb_tree_set_black(brother->left);
-                    rb_tree_rotate_right(xp, root);
+                    rb_tree_rotate_right(xp, root, update);
                     break;
                 }
             }
@@ -700,8 +771,161 @@ NodePtr rb_tree_erase_reblance(NodePtr z, NodePtr& root, NodePtr leftmost, NodeP
     return y;
 }
 
-/* 模板类 rb_tree  参数1表示数据类型，参数2表示键值比较类型*/
-template <class T, class Compare>
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+* 基于 join 的整体操作 (split、join、并、交、差)
+* 以下函数操作已经脱离 header 的子树，bh 表示子树的黑高(空树为 0)
+* 链接时只设置子节点的 parent，返回的子树根节点的 parent 由调用者设置
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+// 以 k 为根，l、r 为左右子树链接成一棵子树
+template <class NodePtr, class Augment>
+NodePtr rb_tree_link(NodePtr l, NodePtr k, NodePtr r, rb_tree_color_type color, Augment update) noexcept
+{
+    k->left = l;
+    k->right = r;
+    k->color = color;
+    if(l != nullptr)
+        l->parent = k;
+    if(r != nullptr)
+        r->parent = k;
+    update(k);
+    return k;
+}
+
+// 黑高为 bh 的子树 x 的子节点的黑高
+template <class NodePtr>
+size_t rb_tree_child_bh(NodePtr x, size_t bh) noexcept
+{
+    return rb_tree_is_red(x) ? bh : bh - 1;
+}
+
+// 子树 x 的黑高，沿最左路径计数
+template <class NodePtr>
+size_t rb_tree_black_height(NodePtr x) noexcept
+{
+    size_t bh = 0;
+    for(; x != nullptr; x = x->left)
+    {
+        if(!rb_tree_is_red(x))
+            ++bh;
+    }
+    return bh;
+}
+
+/* 沿 l 的右侧链向下，在黑高等于 rbh 的黑节点处以红节点 k 连接 r，要求 lbh > rbh 且 r 的根为黑
+   回溯时若出现连续的红节点，把下面的红节点染黑并在其祖父处左旋 */
+template <class NodePtr, class Augment>
+NodePtr rb_tree_join_right(NodePtr l, size_t lbh, NodePtr k, NodePtr r, size_t rbh, Augment update) noexcept
+{
+    if(lbh == rbh && (l == nullptr || !rb_tree_is_red(l)))
+        return rb_tree_link(l, k, r, rb_tree_red, update);
+    auto t = rb_tree_join_right(l->right, rb_tree_child_bh(l, lbh), k, r, rbh, update);
+    if(!rb_tree_is_red(l) && rb_tree_is_red(t) && t->right != nullptr && rb_tree_is_red(t->right))
+    {
+        auto tr = t->right;
+        rb_tree_set_black(tr);
+        rb_tree_link(l->left, l, t->left, l->color, update);
+        return rb_tree_link(l, t, tr, t->color, update);
+    }
+    return rb_tree_link(l->left, l, t, l->color, update);
+}
+
+// 与 rb_tree_join_right 对称，要求 rbh > lbh 且 l 的根为黑
+template <class NodePtr, class Augment>
+NodePtr rb_tree_join_left(NodePtr l, size_t lbh, NodePtr k, NodePtr r, size_t rbh, Augment update) noexcept
+{
+    if(lbh == rbh && (r == nullptr || !rb_tree_is_red(r)))
+        return rb_tree_link(l, k, r, rb_tree_red, update);
+    auto t = rb_tree_join_left(l, lbh, k, r->left, rb_tree_child_bh(r, rbh), update);
+    if(!rb_tree_is_red(r) && rb_tree_is_red(t) && t->left != nullptr && rb_tree_is_red(t->left))
+    {
+        auto tl = t->left;
+        rb_tree_set_black(tl);
+        rb_tree_link(t->right, r, r->right, r->color, update);
+        return rb_tree_link(tl, t, r, t->color, update);
+    }
+    return rb_tree_link(t, r, r->right, r->color, update);
+}
+
+/* 以节点 k 连接 l 与 r，要求 l 中的键值都不大于 k，r 中的键值都不小于 k
+   只沿较高一棵树的一侧走 |lbh - rbh| 层，返回根为黑色的新树，bh 为其黑高 */
+template <class NodePtr, class Augment>
+NodePtr rb_tree_join(NodePtr l, size_t lbh, NodePtr k, NodePtr r, size_t rbh, size_t& bh, Augment update) noexcept
+{
+    if(l != nullptr && rb_tree_is_red(l))
+    {
+        rb_tree_set_black(l);
+        ++lbh;
+    }
+    if(r != nullptr && rb_tree_is_red(r))
+    {
+        rb_tree_set_black(r);
+        ++rbh;
+    }
+    NodePtr t;
+    if(lbh > rbh)
+    {
+        t = rb_tree_join_right(l, lbh, k, r, rbh, update);
+        bh = lbh;
+    }
+    else if(lbh < rbh)
+    {
+        t = rb_tree_join_left(l, lbh, k, r, rbh, update);
+        bh = rbh;
+    }
+    else
+    {
+        t = rb_tree_link(l, k, r, rb_tree_black, update);
+        bh = lbh + 1;
+    }
+    if(rb_tree_is_red(t))
+    {
+        rb_tree_set_black(t);
+        ++bh;
+    }
+    return t;
+}
+
+// 从子树 t 中摘下最大的节点并返回，剩余部分为 rest，黑高为 rest_bh
+template <class NodePtr, class Augment>
+NodePtr rb_tree_split_last(NodePtr t, size_t bh, NodePtr& rest, size_t& rest_bh, Augment update) noexcept
+{
+    const size_t cbh = rb_tree_child_bh(t, bh);
+    if(t->right == nullptr)
+    {
+        rest = t->left;
+        rest_bh = cbh;
+        return t;
+    }
+    NodePtr r;
+    size_t rbh;
+    auto last = rb_tree_split_last(t->right, cbh, r, rbh, update);
+    rest = rb_tree_join(t->left, cbh, t, r, rbh, rest_bh, update);
+    return last;
+}
+
+// 不借助中间节点连接 l 与 r：先摘下 l 的最大节点，再以它为中间节点 join
+template <class NodePtr, class Augment>
+NodePtr rb_tree_join2(NodePtr l, size_t lbh, NodePtr r, size_t rbh, size_t& bh, Augment update) noexcept
+{
+    if(l == nullptr)
+    {
+        bh = rbh;
+        return r;
+    }
+    if(r == nullptr)
+    {
+        bh = lbh;
+        return l;
+    }
+    NodePtr rest;
+    size_t rest_bh;
+    auto k = rb_tree_split_last(l, lbh, rest, rest_bh, update);
+    return rb_tree_join(rest, rest_bh, k, r, rbh, bh, update);
+}
+
+/* 模板类 rb_tree  参数1表示数据类型，参数2表示键值比较类型，参数3表示空间配置器类型
+   参数4表示是否维护子树大小，为 true 时节点多占一个 size_t，换来 O(log n) 的 nth、rank、index_of 与 distance */
+template <class T, class Compare, class Alloc = orange_stl::allocator<T>, bool Ranked = false>
 class rb_tree
 {
 public:
@@ -717,24 +941,31 @@ public:
     typedef typename tree_traits::value_type              value_type;
     typedef Compare                                       key_compare;
 
-    typedef orange_stl::allocator<T>                      allocator_type;
-    typedef orange_stl::allocator<T>                      data_allocator;
-    typedef orange_stl::allocator<base_type>              base_allocator;
-    typedef orange_stl::allocator<node_type>              node_allocator;
+    /* 实际配置的节点类型，以及旋转和重新平衡时维护附加信息的方式 */
+    typedef typename std::conditional<Ranked, rb_tree_rank_node<T>, node_type>::type          node_storage_type;
+    typedef typename std::conditional<Ranked, rb_tree_size_augment<T>, rb_tree_no_augment>::type augment_type;
+
+    typedef Alloc                                                         allocator_type;
+    typedef typename Alloc::template rebind<T>::other                     data_allocator;
+    typedef typename Alloc::template rebind<base_type>::other             base_allocator;
+    typedef typename Alloc::template rebind<node_storage_type>::other     node_allocator;
 
-    typedef typename allocator_type::pointer              pointer;
-    typedef typename allocator_type::const_pointer        const_pointer;
-    typedef typename allocator_type::reference            reference;
-    typedef typename allocator_type::const_reference      const_reference;
-    typedef typename allocator_type::size_type            size_type;
-    typedef typename allocator_type::difference_type      difference_type;
+    typedef typename data_allocator::pointer              pointer;
+    typedef typename data_allocator::const_pointer        const_pointer;
+    typedef typename data_allocator::reference            reference;
+    typedef typename data_allocator::const_reference      const_reference;
+    typedef typename data_allocator::size_type            size_type;
+    typedef typename data_allocator::difference_type      difference_type;
 
     typedef rb_tree_iterator<T>                           iterator;
     typedef rb_tree_const_iterator<T>                     const_iterator;
     typedef orange_stl::reverse_iterator<iterator>        reverse_iterator;
     typedef orange_stl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-    allocator_type  get_allocator() const { return node_allocator(); }
+    typedef orange_stl::node_handle<T, node_storage_type, Alloc>          node_handle_type;
+    typedef orange_stl::node_insert_return<iterator, node_handle_type>    insert_return_type;
+
+    allocator_type  get_allocator() const { return allocator_type(); }
     key_compare     key_comp()      const { return key_comp_; }
 
 private:
@@ -831,11 +1062,17 @@ public:
         return emplace_multi_use_hint(hint, orange_stl::move(value));
     }
 
+    // 空树(构造与赋值)且输入有序时线性建树，否则逐个插入
     template <class InputIterator>
     void insert_multi(InputIterator first, InputIterator last)
     {
         size_type n=orange_stl::distance(first, last);
         THROW_LENGTH_ERROR_IF(node_count_>max_size()-n, "rb_tree<T, Comp>'s size too big");
+        if(node_count_==0)
+        {
+            build_from_range(first, last, false);
+            return;
+        }
         for(; n>0; --n, ++first)
             insert_multi(end(), *first);
     }
@@ -860,10 +1097,28 @@ public:
     {
         size_type n=orange_stl::distance(first, last);
         THROW_LENGTH_ERROR_IF(node_count_ > max_size()-n, "rb_tree<T, Comp>'s size too big");
+        if(node_count_==0)
+        {
+            build_from_range(first, last, true);
+            return;
+        }
         for(; n>0; --n,++first)
             insert_unique(end(), *first);
     }
 
+    /* 一次查找完成的插入，供 map 使用，value_type 须为 pair<const key, mapped> */
+    /* 键值不存在时以 key 和 args 原位构造新节点，否则什么也不做 */
+    template <class K, class ...Args>
+    orange_stl::pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args);
+
+    /* 键值不存在时插入，否则把 obj 赋给已有元素的 second */
+    template <class K, class V>
+    orange_stl::pair<iterator, bool> insert_or_assign_unique(K&& key, V&& obj);
+
+    /* 键值不存在时以 factory() 的结果构造 second，factory 只在插入时调用 */
+    template <class K, class Factory>
+    orange_stl::pair<iterator, bool> get_or_insert_with_unique(K&& key, Factory&& factory);
+
     /* erase */
     iterator erase(iterator hint);
 
@@ -873,25 +1128,49 @@ public:
     void erase(iterator first, iterator last);
     void clear();
 
-    /* 功能性操作 */
-    iterator find(const key_type& key);
-    const_iterator find(const key_type& key) const;
+    /* 节点句柄相关的操作，节点在容器之间转移时不重新配置，也不复制或移动元素 */
+    /* extract 把节点从树中摘下交给句柄，键值允许重复时摘下第一个等于 key 的节点，找不到时返回空句柄 */
+    node_handle_type extract(iterator position);
+    node_handle_type extract(const key_type& key);
 
-    size_type count_multi(const key_type& key) const
-    {
-        auto p=equal_range_multi(key);
-        return static_cast<size_type>(orange_stl::distance(p.first, p.second));
-    }
-    size_type count_unique(const key_type& key) const
-    {
-        return find(key)!=end()?1:0;
-    }
+    /* 插入句柄持有的节点，键值已存在时节点交还给返回值的 node */
+    insert_return_type insert_unique(node_handle_type&& nh);
+    iterator           insert_multi(node_handle_type&& nh);
 
-    iterator lower_bound(const key_type& key);
-    const_iterator lower_bound(const key_type& key) const;
+    /* 把 source 中的节点转移到本树，键值不允许重复时已存在的键值留在 source 中 */
+    void merge_unique(rb_tree& source);
+    void merge_multi(rb_tree& source);
 
-    iterator upper_bound(const key_type& key);
-    const_iterator upper_bound(const key_type& key) const;
+    /* 功能性操作 */
+    /* 带有 K 模板参数的重载用于异构查找，只在 Compare 声明了 is_transparent 时参与重载决议 */
+    iterator find(const key_type& key) { return iterator(find_node(key)); }
+    const_iterator find(const key_type& key) const { return const_iterator(find_node(key)); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator find(const K& key) { return iterator(find_node(key)); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator find(const K& key) const { return const_iterator(find_node(key)); }
+
+    size_type count_multi(const key_type& key) const { return count_multi_key(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    size_type count_multi(const K& key) const { return count_multi_key(key); }
+
+    size_type count_unique(const key_type& key) const { return find_node(key) != header_ ? 1 : 0; }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    size_type count_unique(const K& key) const { return find_node(key) != header_ ? 1 : 0; }
+
+    iterator lower_bound(const key_type& key) { return iterator(lower_bound_node(key)); }
+    const_iterator lower_bound(const key_type& key) const { return const_iterator(lower_bound_node(key)); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator lower_bound(const K& key) { return iterator(lower_bound_node(key)); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator lower_bound(const K& key) const { return const_iterator(lower_bound_node(key)); }
+
+    iterator upper_bound(const key_type& key) { return iterator(upper_bound_node(key)); }
+    const_iterator upper_bound(const key_type& key) const { return const_iterator(upper_bound_node(key)); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    iterator upper_bound(const K& key) { return iterator(upper_bound_node(key)); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    const_iterator upper_bound(const K& key) const { return const_iterator(upper_bound_node(key)); }
 
     orange_stl::pair<iterator, iterator> equal_range_multi(const key_type& key)
     {
@@ -901,34 +1180,111 @@ public:
     {
         return orange_stl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
     }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<iterator, iterator> equal_range_multi(const K& key)
+    {
+        return orange_stl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<const_iterator, const_iterator> equal_range_multi(const K& key) const
+    {
+        return orange_stl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
 
     orange_stl::pair<iterator, iterator> equal_range_unique(const key_type& key)
     {
-        iterator it=find(key);
-        auto next=it;
-        return it==end()?orange_stl::make_pair(it, it):orange_stl::make_pair(it, ++next);
+        return equal_range_unique_key<iterator>(key);
     }
     orange_stl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
     {
-        const_iterator it=find(key);
-        auto next=it;
-        return it==end()?orange_stl::make_pair(it, it):orange_stl::make_pair(it, ++next);
+        return equal_range_unique_key<const_iterator>(key);
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<iterator, iterator> equal_range_unique(const K& key)
+    {
+        return equal_range_unique_key<iterator>(key);
+    }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    orange_stl::pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+    {
+        return equal_range_unique_key<const_iterator>(key);
     }
+    /* 顺序统计，只在 Ranked 为 true 时可用，均为 O(log n) */
+    /* nth 返回第 k 个元素(从 0 开始)，k 不小于 size() 时返回 end() */
+    iterator       nth(size_type k)       { return iterator(nth_node(k)); }
+    const_iterator nth(size_type k) const { return const_iterator(nth_node(k)); }
+
+    /* rank 返回键值小于 key 的元素个数，即 lower_bound(key) 的下标 */
+    size_type rank(const key_type& key) const { return rank_key(key); }
+    template <class K, typename enable_if_transparent<K, Compare>::type = 0>
+    size_type rank(const K& key) const { return rank_key(key); }
+
+    /* index_of 返回迭代器的下标，end() 的下标为 size() */
+    size_type index_of(const_iterator position) const;
+
+    /* distance 返回从 first 到 last 的元素个数，first 不能在 last 之后 */
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+        return static_cast<difference_type>(index_of(last) - index_of(first));
+    }
+
+    /* 基于 join 的整体操作，节点直接在树之间转移，不重新配置也不复制元素 */
+    /* split 把键值不小于 key 的元素移到 right 中(right 原有的元素被销毁)，本树留下小于 key 的元素 */
+    void split(const key_type& key, rb_tree& right);
+
+    /* join 把 rhs 的元素全部接到本树之后并清空 rhs，要求本树的键值都不大于 rhs 的键值，O(log n) */
+    void join(rb_tree& rhs);
+
+    /* extract_range 把键值在 [first, last) 之间的元素移到 out 中(out 原有的元素被销毁) */
+    void extract_range(const key_type& first, const key_type& last, rb_tree& out);
+
+    /* 集合运算，键值不允许重复，结果留在本树，rhs 被清空，键值相同时保留本树的元素
+       本树与 rhs 的大小分别为 n、m (m <= n) 时为 O(m log(n/m + 1)) */
+    void union_unique(rb_tree& rhs);
+    void intersection_unique(rb_tree& rhs);
+    void difference_unique(rb_tree& rhs);
+
     void swap(rb_tree& rhs) noexcept;
 
 private:
+    /* 查找相关操作，K 为 key_type 或者透明比较函数接受的其他类型 */
+    template <class K>
+    base_ptr lower_bound_node(const K& key) const;
+    template <class K>
+    base_ptr upper_bound_node(const K& key) const;
+    template <class K>
+    base_ptr find_node(const K& key) const;
+    template <class K>
+    size_type count_multi_key(const K& key) const;
+    template <class Iter, class K>
+    orange_stl::pair<Iter, Iter> equal_range_unique_key(const K& key) const
+    {
+        Iter it(find_node(key));
+        Iter next = it;
+        return it.node == header_ ? orange_stl::make_pair(it, it) : orange_stl::make_pair(it, ++next);
+    }
+
     /* 节点相关操作 */
     template <class ...Args>
     node_ptr create_node(Args&&... args);
     node_ptr clone_node(base_ptr x);
     void destroy_node(node_ptr p);
 
+    /* 节点句柄持有实际配置的节点类型 */
+    static node_storage_type* storage_ptr(node_ptr p) noexcept { return static_cast<node_storage_type*>(p); }
+
+    base_ptr nth_node(size_type k) const;
+    template <class K>
+    size_type rank_key(const K& key) const;
+
     void rb_tree_init();
     void reset();
 
     orange_stl::pair<base_ptr, bool> get_insert_multi_pos(const key_type& key);
     orange_stl::pair<orange_stl::pair<base_ptr, bool>, bool> get_insert_unique_pos(const key_type& key);
 
+    node_ptr extract_node(base_ptr x);
+
     iterator insert_value_at(base_ptr x, const value_type& value, bool add_to_left);
     iterator insert_node_at(base_ptr x, node_ptr node, bool add_to_left);
 
@@ -937,11 +1293,28 @@ private:
 
     base_ptr copy_from(base_ptr x, base_ptr p);
     void erase_since(base_ptr x);
+
+    template <class InputIterator>
+    void build_from_range(InputIterator first, InputIterator last, bool unique);
+    base_ptr link_sorted(base_ptr& chain, size_type n, size_type depth, size_type red_depth);
+    void destroy_chain(base_ptr x);
+
+    /* join 相关操作，子树的黑高由调用者一并传入传出 */
+    template <class K>
+    base_ptr split_node(base_ptr t, size_type bh, const K& key, bool take_equal,
+                        base_ptr& l, size_type& lbh, base_ptr& r, size_type& rbh);
+    base_ptr union_node(base_ptr a, size_type abh, base_ptr b, size_type bbh, size_type& bh, size_type& dup);
+    base_ptr intersection_node(base_ptr a, size_type abh, base_ptr b, size_type bbh, size_type& bh, size_type& kept);
+    base_ptr difference_node(base_ptr a, size_type abh, base_ptr b, size_type bbh, size_type& bh, size_type& removed);
+
+    void install_root(base_ptr t);
+    void count_split(rb_tree& other, size_type total, m_true_type);
+    void count_split(rb_tree& other, size_type total, m_false_type);
 };
 
 /* 复制构造函数 */
-template <class T, class Compare>
-rb_tree<T, Compare>::rb_tree(const rb_tree& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>::rb_tree(const rb_tree& rhs)
 {
     rb_tree_init();
     if(rhs.node_count_!=0)
@@ -955,18 +1328,18 @@ rb_tree<T, Compare>::rb_tree(const rb_tree& rhs)
 }
 
 /* 移动构造函数 */
-template <class T, class Compare>
-rb_tree<T, Compare>::rb_tree(rb_tree&& rhs) noexcept
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>::rb_tree(rb_tree&& rhs) noexcept
     : header_(orange_stl::move(rhs.header_)), 
-    node_count_(rhs.key_comp_), 
+    node_count_(rhs.node_count_), 
     key_comp_(rhs.key_comp_)
 {
     rhs.reset();
 }
 
 /* 复制赋值操作符 */
-template <class T, class Compare>
-rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(const rb_tree& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>& rb_tree<T, Compare, Alloc, Ranked>::operator=(const rb_tree& rhs)
 {
     if(this!=&rhs)
     {
@@ -984,8 +1357,8 @@ rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(const rb_tree& rhs)
 }
 
 /* 移动赋值操作符 */
-template <class T, class Compare>
-rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(rb_tree&& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>& rb_tree<T, Compare, Alloc, Ranked>::operator=(rb_tree&& rhs)
 {
     clear();
     header_ = orange_stl::move(rhs.header_);
@@ -996,10 +1369,10 @@ rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(rb_tree&& rhs)
 }
 
 /* 就地插入元素，键值允许重复 */
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::emplace_multi(Args&& ...args)
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::emplace_multi(Args&& ...args)
 {
     THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
     node_ptr np=create_node(orange_stl::forward<Args>(args)...);
@@ -1008,10 +1381,10 @@ rb_tree<T, Compare>::emplace_multi(Args&& ...args)
 }
 
 /* 就地插入元素， 键值不允许重复 */
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class ...Args>
-orange_stl::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::emplace_unique(Args&& ...args)
+orange_stl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::iterator, bool>
+rb_tree<T, Compare, Alloc, Ranked>::emplace_unique(Args&& ...args)
 {
     THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
     node_ptr np=create_node(orange_stl::forward<Args>(args)...);
@@ -1025,10 +1398,10 @@ rb_tree<T, Compare>::emplace_unique(Args&& ...args)
 }
 
 /* 就地插入元素，键值允许重复， 当hint位置与插入位置接近时，插入操作的时间复杂度可以降低 */
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::emplace_multi_use_hint(iterator hint, Args&& ...args)
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::emplace_multi_use_hint(iterator hint, Args&& ...args)
 {
     THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
     node_ptr np=create_node(orange_stl::forward<Args>(args)...);
@@ -1039,7 +1412,7 @@ rb_tree<T, Compare>::emplace_multi_use_hint(iterator hint, Args&& ...args)
     key_type key = value_traits::get_key(np->value);
     if(hint == begin())
     {
-        if(key_comp_(key, value_traits::get_key(&hint)))
+        if(key_comp_(key, value_traits::get_key(*hint)))
         {
             return insert_node_at(hint.node, np, true);
         }
@@ -1065,10 +1438,10 @@ rb_tree<T, Compare>::emplace_multi_use_hint(iterator hint, Args&& ...args)
 }
 
 /* 就地插入元素，键值允许重复， 当hint位置与插入位置接近时，插入操作的时间复杂度可以降低 */
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::emplace_unique_use_hint(iterator hint, Args&& ...args)
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::emplace_unique_use_hint(iterator hint, Args&& ...args)
 {
     THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
     node_ptr np=create_node(orange_stl::forward<Args>(args)...);
@@ -1106,7 +1479,7 @@ rb_tree<T, Compare>::emplace_unique_use_hint(iterator hint, Args&& ...args)
             auto pos=get_insert_unique_pos(key);
             if(!pos.second)
             {
-                destroy(np);
+                destroy_node(np);
                 return pos.first.first;
             }
             return insert_node_at(pos.first.first, np, pos.first.second);
@@ -1115,10 +1488,66 @@ rb_tree<T, Compare>::emplace_unique_use_hint(iterator hint, Args&& ...args)
     return insert_unique_use_hint(hint, key, np);
 }
 
+/* 键值不存在时原位构造新节点，只做一次查找 */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K, class ...Args>
+orange_stl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::iterator, bool>
+rb_tree<T, Compare, Alloc, Ranked>::try_emplace_unique(K&& key, Args&& ...args)
+{
+    THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
+    auto res=get_insert_unique_pos(key);
+    if(!res.second)
+    {
+        return orange_stl::make_pair(iterator(res.first.first), false);
+    }
+    node_ptr np=create_node(orange_stl::piecewise_construct,
+                            std::forward_as_tuple(orange_stl::forward<K>(key)),
+                            std::forward_as_tuple(orange_stl::forward<Args>(args)...));
+    return orange_stl::make_pair(insert_node_at(res.first.first, np, res.first.second), true);
+}
+
+/* 键值不存在时插入，否则赋值，只做一次查找 */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K, class V>
+orange_stl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::iterator, bool>
+rb_tree<T, Compare, Alloc, Ranked>::insert_or_assign_unique(K&& key, V&& obj)
+{
+    THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
+    auto res=get_insert_unique_pos(key);
+    if(!res.second)
+    {
+        iterator it(res.first.first);
+        it->second=orange_stl::forward<V>(obj);
+        return orange_stl::make_pair(it, false);
+    }
+    node_ptr np=create_node(orange_stl::piecewise_construct,
+                            std::forward_as_tuple(orange_stl::forward<K>(key)),
+                            std::forward_as_tuple(orange_stl::forward<V>(obj)));
+    return orange_stl::make_pair(insert_node_at(res.first.first, np, res.first.second), true);
+}
+
+/* 键值不存在时以 factory() 构造新节点，只做一次查找 */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K, class Factory>
+orange_stl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::iterator, bool>
+rb_tree<T, Compare, Alloc, Ranked>::get_or_insert_with_unique(K&& key, Factory&& factory)
+{
+    THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
+    auto res=get_insert_unique_pos(key);
+    if(!res.second)
+    {
+        return orange_stl::make_pair(iterator(res.first.first), false);
+    }
+    node_ptr np=create_node(orange_stl::piecewise_construct,
+                            std::forward_as_tuple(orange_stl::forward<K>(key)),
+                            std::forward_as_tuple(factory()));
+    return orange_stl::make_pair(insert_node_at(res.first.first, np, res.first.second), true);
+}
+
 /* 插入元素，节点键值允许重复 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_multi(const value_type& value)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_multi(const value_type& value)
 {
     THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
     auto res=get_insert_multi_pos(value_traits::get_key(value));
@@ -1127,38 +1556,38 @@ rb_tree<T, Compare>::insert_multi(const value_type& value)
 
 // 插入新值，节点键值不允许重复，返回一个 pair
 // 若插入成功，pair 的第二参数为 true，否则为 false
-template <class T, class Compare>
-orange_stl::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::insert_unique(const value_type& value)
+template <class T, class Compare, class Alloc, bool Ranked>
+orange_stl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::iterator, bool>
+rb_tree<T, Compare, Alloc, Ranked>::insert_unique(const value_type& value)
 {
     THROW_LENGTH_ERROR_IF(node_count_>max_size()-1, "rb_tree<T, Compare>'s size too big");
     auto res=get_insert_unique_pos(value_traits::get_key(value));
     if(res.second)
     {
-        return orange_stl::make_pair(res.first.first, false);
+        return orange_stl::make_pair(insert_value_at(res.first.first, value, res.first.second), true);
     }
-    return orange_stl::make_pair(res.first.fitst, false);
+    return orange_stl::make_pair(iterator(res.first.first), false);
 }
 
 /* 删除hint位置的节点 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::erase(iterator hint)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::erase(iterator hint)
 {
     auto node = hint.node->get_node_ptr();
     iterator next(node);
     ++next;
 
-    rb_tree_erase_reblance(hint.node, root(), leftmost(), rightmost());
+    rb_tree_erase_reblance(hint.node, root(), leftmost(), rightmost(), augment_type());
     destroy_node(node);
     --node_count_;
     return next;
 }
 
 /* 删除键值等于key的元素，返回删除的个数 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::erase_multi(const key_type& key)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type
+rb_tree<T, Compare, Alloc, Ranked>::erase_multi(const key_type& key)
 {
     auto p=equal_range_multi(key);
     size_type n=orange_stl::distance(p.first, p.second);
@@ -1167,9 +1596,9 @@ rb_tree<T, Compare>::erase_multi(const key_type& key)
 }
 
 /* 删除键值等于key的元素，返回删除的个数 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::erase_unique(const key_type& key)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type
+rb_tree<T, Compare, Alloc, Ranked>::erase_unique(const key_type& key)
 {
     auto it=find(key);
     if(it!=end())
@@ -1181,8 +1610,8 @@ rb_tree<T, Compare>::erase_unique(const key_type& key)
 }
 
 /* 删除[first, last)区间内的元素 */
-template <class T, class Compare>  
-void rb_tree<T, Compare>::erase(iterator first, iterator last)
+template <class T, class Compare, class Alloc, bool Ranked>  
+void rb_tree<T, Compare, Alloc, Ranked>::erase(iterator first, iterator last)
 {
     if(first == begin() && last==end())
     {
@@ -1195,95 +1624,99 @@ void rb_tree<T, Compare>::erase(iterator first, iterator last)
     }
 }
 
-/* 清空rb_tree */
-template <class T, class Compare>
-void rb_tree<T, Compare>::clear()
+/* 摘下position位置的节点 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::node_handle_type
+rb_tree<T, Compare, Alloc, Ranked>::extract(iterator position)
 {
-    if(node_count_!=0)
-    {
-        erase_since(root());
-        leftmost() = header_;
-        root=nullptr;
-        rightmost() = header_;
-        node_count_=0;
-    }
+    return node_handle_type(storage_ptr(extract_node(position.node)));
 }
 
-/* 查找键值为key的节点，返回指向它的迭代器 */
-template <class T, class Compare>   
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::find(const key_type& key)
+/* 摘下第一个键值等于key的节点 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::node_handle_type
+rb_tree<T, Compare, Alloc, Ranked>::extract(const key_type& key)
 {
-    auto y = header_;
-    auto x = root();
-    while(x!=nullptr)
+    auto x = lower_bound_node(key);
+    if(x == header_ || key_comp_(key, value_traits::get_key(x->get_node_ptr()->value)))
+        return node_handle_type();
+    return node_handle_type(storage_ptr(extract_node(x)));
+}
+
+/* 插入句柄持有的节点，键值不允许重复 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::insert_return_type
+rb_tree<T, Compare, Alloc, Ranked>::insert_unique(node_handle_type&& nh)
+{
+    if(nh.empty())
+        return insert_return_type{end(), false, node_handle_type()};
+    auto res = get_insert_unique_pos(value_traits::get_key(nh.value()));
+    if(!res.second)
+        return insert_return_type{iterator(res.first.first), false, orange_stl::move(nh)};
+    auto it = insert_node_at(res.first.first, nh.release(), res.first.second);
+    return insert_return_type{it, true, node_handle_type()};
+}
+
+/* 插入句柄持有的节点，键值允许重复，句柄为空时返回end() */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_multi(node_handle_type&& nh)
+{
+    if(nh.empty())
+        return end();
+    auto res = get_insert_multi_pos(value_traits::get_key(nh.value()));
+    return insert_node_at(res.first, nh.release(), res.second);
+}
+
+/* 把source中的节点转移过来，键值不允许重复
+    先在本树中确定插入位置，键值已存在的节点不动，因此不会改变source中剩余元素的相对次序 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::merge_unique(rb_tree& source)
+{
+    if(this == &source)
+        return;
+    for(auto it = source.begin(); it != source.end(); )
     {
-        if(!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
-        {
-            /* key小于等于x的键值，向左走 */
-            y = x;
-            x=x->left;
-        }
-        else
-        {
-            /* key大于x键值，向右走 */
-            x=x->right;
-        }
+        auto cur = it++;
+        auto res = get_insert_unique_pos(value_traits::get_key(*cur));
+        if(res.second)
+            insert_node_at(res.first.first, source.extract_node(cur.node), res.first.second);
     }
-    iterator j=iterator(y);
-    return (j==end() || key_comp_(key, value_traits::get_key(*j)))?end():j;
 }
 
-template <class T, class Compare>   
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::find(const key_type& key) const
+/* 把source中的节点全部转移过来，键值允许重复，等值的元素排在已有元素之后 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::merge_multi(rb_tree& source)
 {
-    auto y=header_; /* 最后一个不小于key的节点 */
-    auto x=root();
-    while(x!=nullptr)
+    if(this == &source)
+        return;
+    for(auto it = source.begin(); it != source.end(); )
     {
-        if(!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
-        {
-            /* key小于等于x键值， 向左走 */
-            y=x;
-            x=x->left;
-        }
-        else
-        {
-            /* key大于x键值，向右走 */
-            x=x->right;
-        }
+        auto cur = it++;
+        auto res = get_insert_multi_pos(value_traits::get_key(*cur));
+        insert_node_at(res.first, source.extract_node(cur.node), res.second);
     }
-    const_iterator j = const_iterator(y);
-    return (j==end() || key_comp_(key, value_traits::get_key(*j)))?end():j;
 }
 
-/* 键值不小于key的第一个位置 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::lower_bound(const key_type& key)
+/* 清空rb_tree */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::clear()
 {
-    auto y=header_;
-    auto x=root();
-    while(x!=nullptr)
+    if(node_count_!=0)
     {
-        if(!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
-        {
-            /* key <= x */
-            y=x;
-            x=x->left;
-        }
-        else
-        {
-            x=x->right;
-        }
+        erase_since(root());
+        leftmost() = header_;
+        root()=nullptr;
+        rightmost() = header_;
+        node_count_=0;
     }
-    return iterator(y);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::lower_bound(const key_type& key) const
+/* 键值不小于key的第一个节点，不存在时返回header_ */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::lower_bound_node(const K& key) const
 {
     auto y=header_;
     auto x=root();
@@ -1291,22 +1724,24 @@ rb_tree<T, Compare>::lower_bound(const key_type& key) const
     {
         if(!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
         {
-            /* key <= x */
+            /* key <= x，向左走 */
             y=x;
             x=x->left;
         }
         else
         {
+            /* key > x，向右走 */
             x=x->right;
         }
     }
-    return const_iterator(y);
+    return y;
 }
 
-/* 键值不小于key的最后一个位置 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::upper_bound(const key_type& key)
+/* 键值大于key的第一个节点，不存在时返回header_ */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::upper_bound_node(const K& key) const
 {
     auto y=header_;
     auto x=root();
@@ -1323,34 +1758,32 @@ rb_tree<T, Compare>::upper_bound(const key_type& key)
             x=x->right;
         }
     }
-    return iterator(y);
+    return y;
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::upper_bound(const key_type& key) const
+/* 查找键值等于key的第一个节点，不存在时返回header_ */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::find_node(const K& key) const
 {
-    auto y=header_;
-    auto x=root();
-    while(x!=nullptr)
-    {
-        if(!key_comp_(key, value_traits::get_key(x->get_node_ptr()->value)))
-        {
-            /* key <= x */
-            y=x;
-            x=x->left;
-        }
-        else
-        {
-            x=x->right;
-        }
-    }
-    return const_iterator(y);
+    auto y=lower_bound_node(key);
+    return (y==header_ || key_comp_(key, value_traits::get_key(y->get_node_ptr()->value)))?header_:y;
+}
+
+/* 键值等于key的节点个数 */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type
+rb_tree<T, Compare, Alloc, Ranked>::count_multi_key(const K& key) const
+{
+    return static_cast<size_type>(orange_stl::distance(const_iterator(lower_bound_node(key)),
+                                                       const_iterator(upper_bound_node(key))));
 }
 
 /* 交换rb_tree */
-template <class T, class Compare>
-void rb_tree<T, Compare>::swap(rb_tree& rhs) noexcept
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::swap(rb_tree& rhs) noexcept
 {
     if(this != &rhs)
     {
@@ -1363,10 +1796,10 @@ void rb_tree<T, Compare>::swap(rb_tree& rhs) noexcept
 /* 辅助函数 */
 
 /* 创建一个节点 */
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class ...Args>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::create_node (Args&&... args)
+typename rb_tree<T, Compare, Alloc, Ranked>::node_ptr
+rb_tree<T, Compare, Alloc, Ranked>::create_node (Args&&... args)
 {
     auto tmp=node_allocator::allocate(1);
     try
@@ -1375,6 +1808,7 @@ rb_tree<T, Compare>::create_node (Args&&... args)
         tmp->left = nullptr;
         tmp->right = nullptr;
         tmp->parent = nullptr;
+        augment_type()(tmp->get_base_ptr());
     }
     catch(...)
     {
@@ -1385,28 +1819,29 @@ rb_tree<T, Compare>::create_node (Args&&... args)
 }
 
 /* 复制一个结点 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::clone_node(base_ptr x)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::node_ptr
+rb_tree<T, Compare, Alloc, Ranked>::clone_node(base_ptr x)
 {
     node_ptr tmp=create_node(x->get_node_ptr()->value);
     tmp->color=x->color;
     tmp->left=nullptr;
     tmp->right=nullptr;
+    augment_type::copy(tmp->get_base_ptr(), x);
     return tmp;
 }
 
 /* 销毁一个结点 */
-template <class T, class Compare>
-void rb_tree<T, Compare>::destroy_node (node_ptr p)
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::destroy_node (node_ptr p)
 {
     data_allocator::destroy(&p->value);
-    node_allocator::deallocate(p);
+    node_allocator::deallocate(storage_ptr(p));
 }
 
 /* 初始化容器 */
-template <class T, class Compare>
-void rb_tree<T, Compare>::rb_tree_init()
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::rb_tree_init()
 {
     header_ = base_allocator::allocate(1);
     header_->color = rb_tree_red;
@@ -1417,17 +1852,17 @@ void rb_tree<T, Compare>::rb_tree_init()
 }
 
 /* reset函数 */
-template <class T, class Compare>
-void rb_tree<T, Compare>::reset()
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::reset()
 {
-    header = nullptr;
+    header_ = nullptr;
     node_count_ = 0;
 }
 
 /* get_insert_multi_pos函数 */
-template <class T, class Compare>
-orange_stl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-rb_tree<T, Compare>::get_insert_multi_pos (const key_type& key)
+template <class T, class Compare, class Alloc, bool Ranked>
+orange_stl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr, bool>
+rb_tree<T, Compare, Alloc, Ranked>::get_insert_multi_pos (const key_type& key)
 {
     auto x = root();
     auto y = header_;
@@ -1442,12 +1877,12 @@ rb_tree<T, Compare>::get_insert_multi_pos (const key_type& key)
 }
 
 /* get_insert_unique_pos函数 */
-template <class T, class Compare>
-orange_stl::pair<orange_stl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-rb_tree<T, Compare>::get_insert_unique_pos (const key_type& key)
+template <class T, class Compare, class Alloc, bool Ranked>
+orange_stl::pair<orange_stl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr, bool>, bool>
+rb_tree<T, Compare, Alloc, Ranked>::get_insert_unique_pos (const key_type& key)
 {
     // 返回一个 pair，第一个值为一个 pair，包含插入点的父节点和一个 bool 表示是否在左边插入，
-    // 第二个值为一个 bool，表示是否插入成功
+    // 第二个值为一个 bool，表示是否插入成功；插入失败时，第一个值中的节点为键值重复的节点
     auto x = root();
     auto y = header_;
     bool add_to_left = true; /* 树为空的时候，也在左边插入 */
@@ -1476,15 +1911,15 @@ rb_tree<T, Compare>::get_insert_unique_pos (const key_type& key)
         /* 表明新节点没有重复 */
         return orange_stl::make_pair(orange_stl::make_pair(y, add_to_left), true);
     }
-    /* 表示新节点与现有结点值重复 */
-    return orange_stl::make_pair(orange_stl::make_pair(y, add_to_left), false);
+    /* 表示新节点与现有结点值重复，返回重复的节点 */
+    return orange_stl::make_pair(orange_stl::make_pair(j.node, add_to_left), false);
 }
 
 /* insert_value_at 函数 */
 /* x为插入点的父节点，value为要插入的值，add_to_left表示是否在左边插入 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_value_at (base_ptr x, const value_type& value, bool add_to_left)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_value_at (base_ptr x, const value_type& value, bool add_to_left)
 {
     node_ptr node = create_node(value);
     node->parent = x;
@@ -1493,7 +1928,7 @@ rb_tree<T, Compare>::insert_value_at (base_ptr x, const value_type& value, bool
     {
         root() = base_node;
         leftmost() = base_node;
-        rihgtmost() = base_node;
+        rightmost() = base_node;
     }
     else if(add_to_left)
     {
@@ -1507,29 +1942,42 @@ rb_tree<T, Compare>::insert_value_at (base_ptr x, const value_type& value, bool
         if(rightmost()==x)
             rightmost()=base_node;
     }
-    rb_tree_insert_rebalance(base_node, root());
+    rb_tree_insert_rebalance(base_node, root(), augment_type());
     ++node_count_;
     return iterator(node);
 }
 
+/* 把节点x从树中摘下但不销毁，摘下后的节点与create_node的结果一样不含任何链接 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::node_ptr
+rb_tree<T, Compare, Alloc, Ranked>::extract_node(base_ptr x)
+{
+    rb_tree_erase_reblance(x, root(), leftmost(), rightmost(), augment_type());
+    --node_count_;
+    x->left = nullptr;
+    x->right = nullptr;
+    x->parent = nullptr;
+    return x->get_node_ptr();
+}
+
 /* 在x结点处插入新的结点
     x为插入点的父节点，node为要插入的结点，add_to_left表示是否在左边插入 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
 {
     node->parent=x;
     auto base_node = node->get_base_ptr();
     if(x==header_)
-    [
+    {
         root()=base_node;
         leftmost()=base_node;
         rightmost()=base_node;
-    ]
+    }
     else if(add_to_left)
     {
         x->left = base_node;
-        if(left_most()==x)
+        if(leftmost()==x)
             leftmost()=base_node;
     }
     else
@@ -1538,15 +1986,15 @@ rb_tree<T, Compare>::insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
         if(rightmost()==x)
             rightmost()=base_node;
     }
-    rb_tree_insert_rebalance(base_node, root());
+    rb_tree_insert_rebalance(base_node, root(), augment_type());
     ++node_count_;
     return iterator(node);
 }
 
 /* 插入元素，键值允许重复，使用hint */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
 {
     /* 在hint附近寻找可插入的位置 */
     auto np=hint.node;
@@ -1571,9 +2019,9 @@ rb_tree<T, Compare>::insert_multi_use_hint(iterator hint, key_type key, node_ptr
 }
 
 /* 插入元素，键值不允许重复，使用hint */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
 {
     /* 在hint附近寻找可以插入的位置 */
     auto np = hint.node;
@@ -1604,9 +2052,9 @@ rb_tree<T, Compare>::insert_unique_use_hint(iterator hint, key_type key, node_pt
 
 /* copy_from 函数 */
 /* 递归的复制一棵树，节点冲x开始，p为x的父节点 */
-template <class T, class Compare>
-typename rb_tree<T, Compare>::base_ptr
-rb_tree<T, Compare>::copy_from (base_ptr x, base_ptr p)
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::copy_from (base_ptr x, base_ptr p)
 {
     auto top = clone_node(x);
     top->parent = p;
@@ -1637,8 +2085,8 @@ rb_tree<T, Compare>::copy_from (base_ptr x, base_ptr p)
 
 /* erase_since 函数 */
 /* 从x节点开始删除该节点及其子树 */
-template <class T, class Compare>
-void rb_tree<T, Compare>::erase_since (base_ptr x)
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::erase_since (base_ptr x)
 {
     while(x!=nullptr)
     {
@@ -1649,46 +2097,528 @@ void rb_tree<T, Compare>::erase_since (base_ptr x)
     }
 }
 
+/* 向空树插入区间 [first, last)
+ * 1. 按输入顺序为每个元素配置节点，用 right 指针串成链表，同时检查键值是否有序，unique 时相邻的重复元素直接丢弃
+ * 2. 有序时把链表按中序直接链接成一棵完全平衡的树，不需要任何比较和旋转，整体为 O(n)
+ * 3. 无序时退回逐个插入已经配置好的节点
+ */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class InputIterator>
+void rb_tree<T, Compare, Alloc, Ranked>::build_from_range(InputIterator first, InputIterator last, bool unique)
+{
+    base_ptr head = nullptr;
+    base_ptr tail = nullptr;
+    size_type n = 0;
+    bool sorted = true;
+    try
+    {
+        for(; first != last; ++first)
+        {
+            base_ptr x = create_node(*first)->get_base_ptr();
+            if(tail == nullptr)
+            {
+                head = tail = x;
+                ++n;
+                continue;
+            }
+            tail->right = x;  /* 先挂到链表上，比较抛出异常时也能被释放 */
+            if(sorted)
+            {
+                const key_type& prev = value_traits::get_key(tail->get_node_ptr()->value);
+                const key_type& key = value_traits::get_key(x->get_node_ptr()->value);
+                if(key_comp_(key, prev))
+                {
+                    sorted = false;
+                }
+                else if(unique && !key_comp_(prev, key))
+                {
+                    tail->right = nullptr;
+                    destroy_node(x->get_node_ptr());
+                    continue;
+                }
+            }
+            tail = x;
+            ++n;
+        }
+    }
+    catch(...)
+    {
+        destroy_chain(head);
+        throw;
+    }
+    if(head == nullptr)
+        return;
+
+    if(sorted)
+    {
+        // 深度为 floor(log2 n) 的最底层可能不满，这一层染成红色，其余为黑色
+        size_type red_depth = 0;
+        for(size_type m = n; m > 1; m >>= 1)
+            ++red_depth;
+        root() = link_sorted(head, n, 0, red_depth);
+        root()->parent = header_;
+        leftmost() = rb_tree_min(root());
+        rightmost() = rb_tree_max(root());
+        node_count_ = n;
+        return;
+    }
+
+    while(head != nullptr)
+    {
+        base_ptr x = head;
+        head = head->right;
+        x->right = nullptr;
+        node_ptr np = x->get_node_ptr();
+        try
+        {
+            if(unique)
+            {
+                auto res = get_insert_unique_pos(value_traits::get_key(np->value));
+                if(res.second)
+                    insert_node_at(res.first.first, np, res.first.second);
+                else
+                    destroy_node(np);
+            }
+            else
+            {
+                auto res = get_insert_multi_pos(value_traits::get_key(np->value));
+                insert_node_at(res.first, np, res.second);
+            }
+        }
+        catch(...)
+        {
+            destroy_node(np);
+            destroy_chain(head);
+            throw;
+        }
+    }
+}
+
+/* 从链表 chain 中按顺序取出 n 个节点，链接成以返回值为根的平衡子树，depth 为子树根的深度 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::link_sorted(base_ptr& chain, size_type n, size_type depth, size_type red_depth)
+{
+    if(n == 0)
+        return nullptr;
+    const size_type left_count = (n - 1) / 2;
+    base_ptr left = link_sorted(chain, left_count, depth + 1, red_depth);
+    base_ptr x = chain;
+    chain = chain->right;
+    x->left = left;
+    if(left != nullptr)
+        left->parent = x;
+    base_ptr right = link_sorted(chain, n - 1 - left_count, depth + 1, red_depth);
+    x->right = right;
+    if(right != nullptr)
+        right->parent = x;
+    x->color = (depth == red_depth && depth != 0) ? rb_tree_red : rb_tree_black;
+    augment_type()(x);
+    return x;
+}
+
+/* 释放以 right 指针串起来的节点 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::destroy_chain(base_ptr x)
+{
+    while(x != nullptr)
+    {
+        base_ptr next = x->right;
+        destroy_node(x->get_node_ptr());
+        x = next;
+    }
+}
+
+/* 第 k 个节点，按左子树的大小决定向哪一边走 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::nth_node(size_type k) const
+{
+    static_assert(Ranked, "nth requires an rb_tree with Ranked = true");
+    if(k >= node_count_)
+        return header_;
+    base_ptr x = root();
+    while(true)
+    {
+        const size_type left_size = augment_type::size_of(x->left);
+        if(k < left_size)
+        {
+            x = x->left;
+        }
+        else if(k == left_size)
+        {
+            return x;
+        }
+        else
+        {
+            k -= left_size + 1;
+            x = x->right;
+        }
+    }
+}
+
+/* 键值小于 key 的元素个数：与 lower_bound 相同的路径，每次向右走时累加左子树和当前节点 */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type
+rb_tree<T, Compare, Alloc, Ranked>::rank_key(const K& key) const
+{
+    static_assert(Ranked, "rank requires an rb_tree with Ranked = true");
+    size_type r = 0;
+    base_ptr x = root();
+    while(x != nullptr)
+    {
+        if(key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
+        {
+            r += augment_type::size_of(x->left) + 1;
+            x = x->right;
+        }
+        else
+        {
+            x = x->left;
+        }
+    }
+    return r;
+}
+
+/* 迭代器的下标：左子树的大小，加上向上走时每个从右边进入的祖先及其左子树 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type
+rb_tree<T, Compare, Alloc, Ranked>::index_of(const_iterator position) const
+{
+    static_assert(Ranked, "index_of requires an rb_tree with Ranked = true");
+    base_ptr x = position.node;
+    if(x == header_)
+        return node_count_;
+    size_type r = augment_type::size_of(x->left);
+    for(; x != root(); x = x->parent)
+    {
+        if(x == x->parent->right)
+            r += augment_type::size_of(x->parent->left) + 1;
+    }
+    return r;
+}
+
+/* 把键值不小于 key 的元素移到 right 中 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::split(const key_type& key, rb_tree& right)
+{
+    if(this == &right)
+        return;
+    right.clear();
+    if(node_count_ == 0)
+        return;
+    const size_type total = node_count_;
+    base_ptr l, r;
+    size_type lbh, rbh;
+    split_node(root(), rb_tree_black_height(root()), key, false, l, lbh, r, rbh);
+    install_root(l);
+    right.install_root(r);
+    count_split(right, total, m_bool_constant<Ranked>());
+}
+
+/* 把 rhs 接到本树之后 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::join(rb_tree& rhs)
+{
+    if(this == &rhs || rhs.node_count_ == 0)
+        return;
+    if(node_count_ == 0)
+    {
+        swap(rhs);
+        return;
+    }
+    ORANGE_STL_DEBUG(!key_comp_(value_traits::get_key(rhs.leftmost()->get_node_ptr()->value),
+                                value_traits::get_key(rightmost()->get_node_ptr()->value)));
+    size_type bh;
+    auto t = rb_tree_join2(root(), rb_tree_black_height(root()),
+                           rhs.root(), rb_tree_black_height(rhs.root()), bh, augment_type());
+    install_root(t);
+    node_count_ += rhs.node_count_;
+    rhs.install_root(nullptr);
+    rhs.node_count_ = 0;
+}
+
+/* 两次 split 取出中间一段，再把两侧 join 回来 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::extract_range(const key_type& first, const key_type& last, rb_tree& out)
+{
+    if(this == &out)
+        return;
+    out.clear();
+    if(node_count_ == 0)
+        return;
+    const size_type total = node_count_;
+    base_ptr l, mr, m, r;
+    size_type lbh, mrbh, mbh, rbh, bh;
+    split_node(root(), rb_tree_black_height(root()), first, false, l, lbh, mr, mrbh);
+    split_node(mr, mrbh, last, false, m, mbh, r, rbh);
+    install_root(rb_tree_join2(l, lbh, r, rbh, bh, augment_type()));
+    out.install_root(m);
+    count_split(out, total, m_bool_constant<Ranked>());
+}
+
+/* 并集，rhs 中与本树重复的节点被销毁 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::union_unique(rb_tree& rhs)
+{
+    if(this == &rhs || rhs.node_count_ == 0)
+        return;
+    size_type bh, dup = 0;
+    auto t = union_node(root(), rb_tree_black_height(root()),
+                        rhs.root(), rb_tree_black_height(rhs.root()), bh, dup);
+    node_count_ += rhs.node_count_ - dup;
+    install_root(t);
+    rhs.install_root(nullptr);
+    rhs.node_count_ = 0;
+}
+
+/* 交集，不在交集中的节点都被销毁 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::intersection_unique(rb_tree& rhs)
+{
+    if(this == &rhs)
+        return;
+    size_type bh, kept = 0;
+    auto t = intersection_node(root(), rb_tree_black_height(root()),
+                               rhs.root(), rb_tree_black_height(rhs.root()), bh, kept);
+    node_count_ = kept;
+    install_root(t);
+    rhs.install_root(nullptr);
+    rhs.node_count_ = 0;
+}
+
+/* 差集，删去本树中在 rhs 出现的元素，rhs 的节点都被销毁 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::difference_unique(rb_tree& rhs)
+{
+    if(this == &rhs)
+    {
+        clear();
+        return;
+    }
+    size_type bh, removed = 0;
+    auto t = difference_node(root(), rb_tree_black_height(root()),
+                             rhs.root(), rb_tree_black_height(rhs.root()), bh, removed);
+    node_count_ -= removed;
+    install_root(t);
+    rhs.install_root(nullptr);
+    rhs.node_count_ = 0;
+}
+
+/* 把子树 t 拆成键值小于 key 的 l 与其余的 r
+   take_equal 为 true 时等于 key 的节点不放入 r，而是摘下后返回，没有这样的节点时返回 nullptr */
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class K>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::split_node(base_ptr t, size_type bh, const K& key, bool take_equal,
+                                               base_ptr& l, size_type& lbh, base_ptr& r, size_type& rbh)
+{
+    if(t == nullptr)
+    {
+        l = r = nullptr;
+        lbh = rbh = 0;
+        return nullptr;
+    }
+    const size_type cbh = rb_tree_child_bh(t, bh);
+    auto left = t->left;
+    auto right = t->right;
+    const auto& k = value_traits::get_key(t->get_node_ptr()->value);
+    if(key_comp_(k, key))
+    {
+        auto m = split_node(right, cbh, key, take_equal, l, lbh, r, rbh);
+        l = rb_tree_join(left, cbh, t, l, lbh, lbh, augment_type());
+        return m;
+    }
+    if(take_equal && !key_comp_(key, k))
+    {
+        l = left;
+        lbh = cbh;
+        r = right;
+        rbh = cbh;
+        t->left = nullptr;
+        t->right = nullptr;
+        t->parent = nullptr;
+        return t;
+    }
+    auto m = split_node(left, cbh, key, take_equal, l, lbh, r, rbh);
+    r = rb_tree_join(r, rbh, t, right, cbh, rbh, augment_type());
+    return m;
+}
+
+/* 以 a 的根拆开 b，两侧分别递归求并，再以 a 的根 join */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::union_node(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+                                               size_type& bh, size_type& dup)
+{
+    if(b == nullptr)
+    {
+        bh = abh;
+        return a;
+    }
+    if(a == nullptr)
+    {
+        bh = bbh;
+        return b;
+    }
+    const size_type cbh = rb_tree_child_bh(a, abh);
+    auto al = a->left;
+    auto ar = a->right;
+    base_ptr bl, br;
+    size_type blbh, brbh;
+    auto m = split_node(b, bbh, value_traits::get_key(a->get_node_ptr()->value), true, bl, blbh, br, brbh);
+    if(m != nullptr)
+    {
+        destroy_node(m->get_node_ptr());
+        ++dup;
+    }
+    size_type lbh, rbh;
+    auto l = union_node(al, cbh, bl, blbh, lbh, dup);
+    auto r = union_node(ar, cbh, br, brbh, rbh, dup);
+    return rb_tree_join(l, lbh, a, r, rbh, bh, augment_type());
+}
+
+/* 以 a 的根拆开 b，a 的根只在 b 中存在相同键值时保留 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::intersection_node(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+                                                      size_type& bh, size_type& kept)
+{
+    if(a == nullptr || b == nullptr)
+    {
+        erase_since(a);
+        erase_since(b);
+        bh = 0;
+        return nullptr;
+    }
+    const size_type cbh = rb_tree_child_bh(a, abh);
+    auto al = a->left;
+    auto ar = a->right;
+    base_ptr bl, br;
+    size_type blbh, brbh;
+    auto m = split_node(b, bbh, value_traits::get_key(a->get_node_ptr()->value), true, bl, blbh, br, brbh);
+    size_type lbh, rbh;
+    auto l = intersection_node(al, cbh, bl, blbh, lbh, kept);
+    auto r = intersection_node(ar, cbh, br, brbh, rbh, kept);
+    if(m != nullptr)
+    {
+        destroy_node(m->get_node_ptr());
+        ++kept;
+        return rb_tree_join(l, lbh, a, r, rbh, bh, augment_type());
+    }
+    destroy_node(a->get_node_ptr());
+    return rb_tree_join2(l, lbh, r, rbh, bh, augment_type());
+}
+
+/* 以 b 的根拆开 a，两侧分别递归求差，a 中与 b 的根相同的节点被销毁 */
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::difference_node(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+                                                    size_type& bh, size_type& removed)
+{
+    if(a == nullptr || b == nullptr)
+    {
+        erase_since(b);
+        bh = abh;
+        return a;
+    }
+    const size_type cbh = rb_tree_child_bh(b, bbh);
+    auto bl = b->left;
+    auto br = b->right;
+    base_ptr al, ar;
+    size_type albh, arbh;
+    auto m = split_node(a, abh, value_traits::get_key(b->get_node_ptr()->value), true, al, albh, ar, arbh);
+    if(m != nullptr)
+    {
+        destroy_node(m->get_node_ptr());
+        ++removed;
+    }
+    destroy_node(b->get_node_ptr());
+    size_type lbh, rbh;
+    auto l = difference_node(al, albh, bl, cbh, lbh, removed);
+    auto r = difference_node(ar, arbh, br, cbh, rbh, removed);
+    return rb_tree_join2(l, lbh, r, rbh, bh, augment_type());
+}
+
+/* 以 t 作为整棵树，重新设置 header 的三个链接 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::install_root(base_ptr t)
+{
+    root() = t;
+    if(t == nullptr)
+    {
+        leftmost() = header_;
+        rightmost() = header_;
+        return;
+    }
+    t->parent = header_;
+    rb_tree_set_black(t);
+    leftmost() = rb_tree_min(t);
+    rightmost() = rb_tree_max(t);
+}
+
+/* split 之后两棵树共有 total 个节点，维护子树大小时直接读出 */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::count_split(rb_tree& other, size_type total, m_true_type)
+{
+    node_count_ = augment_type::size_of(root());
+    other.node_count_ = total - node_count_;
+}
+
+/* 否则同时遍历两棵树，较小的一棵走完即可得出两者的大小，为 O(min) */
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::count_split(rb_tree& other, size_type total, m_false_type)
+{
+    size_type n = 0;
+    auto a = begin();
+    auto b = other.begin();
+    for(; a != end() && b != other.end(); ++a, ++b)
+        ++n;
+    node_count_ = a == end() ? n : total - n;
+    other.node_count_ = total - node_count_;
+}
+
 /* 重载比较操作符 */
-template <class T, class Compare>
-bool operator==(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator==(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs)
 {
     return lhs.size() == rhs.size() && orange_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T, class Compare>
-bool operator<(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator<(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs)
 {
     return orange_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T, class Compare>
-bool operator!=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator!=(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs)
 {
     return !(lhs==rhs);
 }
 
-template <class T, class Compare>
-bool operator>(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator>(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs)
 {
     return rhs<lhs;
 }
 
-template <class T, class Compare>
-bool operator<=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator<=(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs)
 {
     return !(rhs < lhs);
 }
 
-template <class T, class Compare>
-bool operator>=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator>=(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs)
 {
     return !(lhs < rhs);
 }
 
 /* 重载mystl的swap */
-template <class T, class Compare>
-void swap(rb_tree<T, Compare>& lhs, rb_tree<T, Compare>& rhs) noexcept
+template <class T, class Compare, class Alloc, bool Ranked>
+void swap(rb_tree<T, Compare, Alloc, Ranked>& lhs, rb_tree<T, Compare, Alloc, Ranked>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
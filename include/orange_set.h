@@ -9,9 +9,14 @@
 namespace orange_stl
 {
 
+template <class Key, class Compare, class Alloc, bool Ranked>
+class multiset;
+
+
 // 模板类set，键值不允许重复
-// 参一：键值类型   参二：键值的比较方式，默认使用orange_stl::less
-template <class Key, class Compare = orange_stl::less<Key>>
+// 参一：键值类型   参二：键值的比较方式，默认使用orange_stl::less   参三：空间配置器类型   参四：是否支持 nth、rank 等顺序统计操作
+template <class Key, class Compare = orange_stl::less<Key>, class Alloc = orange_stl::allocator<Key>,
+          bool Ranked = false>
 class set
 {
 public:
@@ -22,9 +27,11 @@ public:
 
 private:
     /* 使用rb_tree作为底层 */
-    typedef orange_stl::rb_tree<value_type, key_compare> base_type;
+    typedef orange_stl::rb_tree<value_type, key_compare, Alloc, Ranked> base_type;
     base_type tree_;
 
+    friend class multiset<Key, Compare, Alloc, Ranked>;
+
 public:
     typedef typename base_type::node_type              node_type;
     typedef typename base_type::const_pointer          pointer;
@@ -38,6 +45,8 @@ public:
     typedef typename base_type::size_type              size_type;
     typedef typename base_type::difference_type        difference_type;
     typedef typename base_type::allocator_type         allocator_type;
+    typedef typename base_type::node_handle_type       node_handle_type;
+    typedef orange_stl::node_insert_return<iterator, node_handle_type> insert_return_type;
 
 public:
     // 构造、复制和移动函数
@@ -59,6 +68,23 @@ public:
     set(set&& rhs) noexcept : tree_(orange_stl::move(rhs.tree_))
     { }
 
+    set& operator=(const set& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    set& operator=(set&& rhs)
+    {
+        tree_ = orange_stl::move(rhs.tree_);
+        return *this;
+    }
+    set& operator=(std::initializer_list<value_type> ilist)
+    {
+        tree_.clear();
+        tree_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
     key_compare key_comp() const
     {
         return tree_.key_comp();
@@ -83,7 +109,7 @@ public:
     }
     iterator end() noexcept
     {
-        return tree.end();
+        return tree_.end();
     }
     const_iterator end() const noexcept
     {
@@ -190,6 +216,63 @@ public:
         tree_.erase(first, last);
     }
 
+    /* 节点句柄相关的操作 */
+    node_handle_type extract(iterator position)
+    {
+        return tree_.extract(position);
+    }
+    node_handle_type extract(const key_type& key)
+    {
+        return tree_.extract(key);
+    }
+    insert_return_type insert(node_handle_type&& nh)
+    {
+        auto res = tree_.insert_unique(orange_stl::move(nh));
+        return insert_return_type{res.position, res.inserted, orange_stl::move(res.node)};
+    }
+    void merge(set& source)
+    {
+        tree_.merge_unique(source.tree_);
+    }
+    void merge(multiset<Key, Compare, Alloc, Ranked>& source)
+    {
+        tree_.merge_unique(source.tree_);
+    }
+
+    /* 基于 join 的整体操作，节点直接在容器之间转移 */
+    // 键值不小于 key 的元素移到返回的容器中，本容器留下小于 key 的元素，O(log n)
+    set split(const key_type& key)
+    {
+        set right;
+        tree_.split(key, right.tree_);
+        return right;
+    }
+    // 把 rhs 接到本容器之后，要求本容器的键值都不大于 rhs 的键值，O(log n)
+    void join(set& rhs)
+    {
+        tree_.join(rhs.tree_);
+    }
+    // 取出键值在 [first, last) 之间的元素
+    set extract_range(const key_type& first, const key_type& last)
+    {
+        set out;
+        tree_.extract_range(first, last, out.tree_);
+        return out;
+    }
+    // 集合运算，rhs 的节点被复用或销毁，运算后 rhs 为空，键值相同时保留本容器的元素
+    void union_with(set& rhs)
+    {
+        tree_.union_unique(rhs.tree_);
+    }
+    void intersection_with(set& rhs)
+    {
+        tree_.intersection_unique(rhs.tree_);
+    }
+    void difference_with(set& rhs)
+    {
+        tree_.difference_unique(rhs.tree_);
+    }
+
     /* set相关的操作 */
     iterator find(const key_type& key)
     {
@@ -232,6 +315,88 @@ public:
     {
         return tree_.equal_range_unique(key);
     }
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+        return tree_.equal_range_unique(key);
+    }
+
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_unique(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_unique(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return tree_.equal_range_unique(key);
+    }
+
+    /* 顺序统计，只在 Ranked 为 true 时可用，均为 O(log n) */
+    iterator nth(size_type k)
+    {
+        return tree_.nth(k);
+    }
+    const_iterator nth(size_type k) const
+    {
+        return tree_.nth(k);
+    }
+    size_type rank(const key_type& key) const
+    {
+        return tree_.rank(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type rank(const K& key) const
+    {
+        return tree_.rank(key);
+    }
+    size_type index_of(const_iterator position) const
+    {
+        return tree_.index_of(position);
+    }
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+        return tree_.distance(first, last);
+    }
 
     void swap(set& rhs) noexcept
     {
@@ -250,51 +415,52 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator==(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator!=(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<=(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>=(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs < rhs);
 }
 
 /* 重载orange_stl 的swap */
-template <class Key, class Compare>
-void sawp(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept
+template <class Key, class Compare, class Alloc, bool Ranked>
+void sawp(set<Key, Compare, Alloc, Ranked>& lhs, set<Key, Compare, Alloc, Ranked>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
 
 /* 模板类multiset 键值允许重复 */
-template <class Key, class Compare = orange_stl::less<Key>>
+template <class Key, class Compare = orange_stl::less<Key>, class Alloc = orange_stl::allocator<Key>,
+          bool Ranked = false>
 class multiset
 {
 public:
@@ -304,8 +470,10 @@ public:
     typedef Compare value_compare;
 private:
     /* 底层红黑树 */
-    typedef orange_stl::rb_tree<value_type, key_compare> base_type;
+    typedef orange_stl::rb_tree<value_type, key_compare, Alloc, Ranked> base_type;
     base_type tree_;
+
+    friend class set<Key, Compare, Alloc, Ranked>;
 public:
     typedef typename base_type::node_type              node_type;
     typedef typename base_type::const_pointer          pointer;
@@ -319,6 +487,7 @@ public:
     typedef typename base_type::size_type              size_type;
     typedef typename base_type::difference_type        difference_type;
     typedef typename base_type::allocator_type         allocator_type;
+    typedef typename base_type::node_handle_type       node_handle_type;
 
 public:
     /* 复制，构造和移动函数 */
@@ -460,6 +629,49 @@ public:
         tree_.erase(first, last);
     }
 
+    // 节点句柄相关的操作
+    node_handle_type extract(iterator position)
+    {
+        return tree_.extract(position);
+    }
+    node_handle_type extract(const key_type& key)
+    {
+        return tree_.extract(key);
+    }
+    iterator insert(node_handle_type&& nh)
+    {
+        return tree_.insert_multi(orange_stl::move(nh));
+    }
+    void merge(multiset& source)
+    {
+        tree_.merge_multi(source.tree_);
+    }
+    void merge(set<Key, Compare, Alloc, Ranked>& source)
+    {
+        tree_.merge_multi(source.tree_);
+    }
+
+    /* 基于 join 的整体操作，节点直接在容器之间转移 */
+    // 键值不小于 key 的元素移到返回的容器中，本容器留下小于 key 的元素，O(log n)
+    multiset split(const key_type& key)
+    {
+        multiset right;
+        tree_.split(key, right.tree_);
+        return right;
+    }
+    // 把 rhs 接到本容器之后，要求本容器的键值都不大于 rhs 的键值，O(log n)
+    void join(multiset& rhs)
+    {
+        tree_.join(rhs.tree_);
+    }
+    // 取出键值在 [first, last) 之间的元素
+    multiset extract_range(const key_type& first, const key_type& last)
+    {
+        multiset out;
+        tree_.extract_range(first, last, out.tree_);
+        return out;
+    }
+
     iterator       find(const key_type& key)              
     { 
         return tree_.find(key); 
@@ -497,11 +709,89 @@ public:
         return tree_.equal_range_multi(key);
     }
 
-    pair<const_iterator, const_iterator> equal_range(const key_type& key_comp) const
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+        return tree_.equal_range_multi(key);
+    }
+
+    /* 异构查找，只在 key_compare 声明了 is_transparent 时参与重载决议，例如 less<void> */
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator find(const K& key)
+    {
+        return tree_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return tree_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type count(const K& key) const
+    {
+        return tree_.count_multi(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator lower_bound(const K& key)
+    {
+        return tree_.lower_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator lower_bound(const K& key) const
+    {
+        return tree_.lower_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    iterator upper_bound(const K& key)
+    {
+        return tree_.upper_bound(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    const_iterator upper_bound(const K& key) const
+    {
+        return tree_.upper_bound(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return tree_.equal_range_multi(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
     {
         return tree_.equal_range_multi(key);
     }
 
+    /* 顺序统计，只在 Ranked 为 true 时可用，均为 O(log n) */
+    iterator nth(size_type k)
+    {
+        return tree_.nth(k);
+    }
+    const_iterator nth(size_type k) const
+    {
+        return tree_.nth(k);
+    }
+    size_type rank(const key_type& key) const
+    {
+        return tree_.rank(key);
+    }
+    template <class K, typename enable_if_transparent<K, key_compare>::type = 0>
+    size_type rank(const K& key) const
+    {
+        return tree_.rank(key);
+    }
+    size_type index_of(const_iterator position) const
+    {
+        return tree_.index_of(position);
+    }
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+        return tree_.distance(first, last);
+    }
+
     void swap(multiset& rhs) noexcept
     {
         tree_.swap(rhs.tree_);
@@ -521,45 +811,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator==(const multiset<Key, Compare, Alloc, Ranked>& lhs, const multiset<Key, Compare, Alloc, Ranked>& rhs)
 {
     return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<(const multiset<Key, Compare, Alloc, Ranked>& lhs, const multiset<Key, Compare, Alloc, Ranked>& rhs)
 {
     return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator!=(const multiset<Key, Compare, Alloc, Ranked>& lhs, const multiset<Key, Compare, Alloc, Ranked>& rhs)
 {
     return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>(const multiset<Key, Compare, Alloc, Ranked>& lhs, const multiset<Key, Compare, Alloc, Ranked>& rhs)
 {
     return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<=(const multiset<Key, Compare, Alloc, Ranked>& lhs, const multiset<Key, Compare, Alloc, Ranked>& rhs)
 {
     return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>=(const multiset<Key, Compare, Alloc, Ranked>& lhs, const multiset<Key, Compare, Alloc, Ranked>& rhs)
 {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(multiset<Key, Compare>& lhs, multiset<Key, Compare>& rhs) noexcept
+template <class Key, class Compare, class Alloc, bool Ranked>
+void swap(multiset<Key, Compare, Alloc, Ranked>& lhs, multiset<Key, Compare, Alloc, Ranked>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
@@ -0,0 +1,519 @@
+#ifndef __ORANGE_STL_SET_ALGO_H__
+#define __ORANGE_STL_SET_ALGO_H__
+
+// 这个头文件包含 set 的四种算法: union, intersection, difference, symmetric_difference
+// 所有函数都要求序列有序
+// set_intersection / set_difference 在两个序列都是随机访问迭代器且长度悬殊时改用galloping(指数查找)，
+// 另外提供针对有序 uint32_t / uint64_t 数组的 SIMD 求交集 simd_set_intersection
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ORANGE_SET_ALGO_SSE2 1
+#endif
+
+#include "orange_algo.h"
+#include "orange_iterator.h"
+
+namespace orange_stl
+{
+
+// 较长序列的长度达到较短序列的多少倍时改用 galloping
+enum { ESetGallopRatio = 16 };
+
+/*****************************************************************************************/
+// gallop_lower_bound
+// 在 [first, last) 中查找第一个不小于 value 的位置，先以 1, 2, 4, ... 的步长向前跳，
+// 再在最后一段中二分查找，代价为 O(log d)，d 为结果到 first 的距离
+/*****************************************************************************************/
+template <class RandomIter, class T, class Compared>
+RandomIter gallop_lower_bound(RandomIter first, RandomIter last, const T& value, Compared comp)
+{
+    typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+    const difference_type len = last - first;
+    if (len == 0 || !comp(*first, value))
+        return first;
+    difference_type lo = 0;   // *(first + lo) < value
+    difference_type hi = 1;
+    while (hi < len && comp(*(first + hi), value))
+    {
+        lo = hi;
+        hi = hi * 2 + 1;
+    }
+    if (hi > len)
+        hi = len;
+    return orange_stl::lower_bound(first + lo + 1, first + hi, value, comp);
+}
+
+template <class RandomIter, class T>
+RandomIter gallop_lower_bound(RandomIter first, RandomIter last, const T& value)
+{
+    return orange_stl::gallop_lower_bound(first, last, value, orange_stl::less<T>());
+}
+
+/*****************************************************************************************/
+// set_union
+// 计算 S1∪S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2,
+                     OutputIter result)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (*first1 < *first2)
+        {
+            *result = *first1;
+            ++first1;
+        }
+        else if (*first2 < *first1)
+        {
+            *result = *first2;
+            ++first2;
+        }
+        else
+        {
+            *result = *first1;
+            ++first1;
+            ++first2;
+        }
+        ++result;
+    }
+    // 将剩余元素拷贝到 result
+    result = orange_stl::copy(first1, last1, result);
+    return orange_stl::copy(first2, last2, result);
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2,
+                     OutputIter result, Compared comp)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first1, *first2))
+        {
+            *result = *first1;
+            ++first1;
+        }
+        else if (comp(*first2, *first1))
+        {
+            *result = *first2;
+            ++first2;
+        }
+        else
+        {
+            *result = *first1;
+            ++first1;
+            ++first2;
+        }
+        ++result;
+    }
+    result = orange_stl::copy(first1, last1, result);
+    return orange_stl::copy(first2, last2, result);
+}
+
+/*****************************************************************************************/
+// set_intersection
+// 计算 S1∩S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+// 输出的元素都来自 S1，重复元素出现 min(m, n) 次
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection_merge(InputIter1 first1, InputIter1 last1,
+                                  InputIter2 first2, InputIter2 last2,
+                                  OutputIter result, Compared comp)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first1, *first2))
+        {
+            ++first1;
+        }
+        else if (comp(*first2, *first1))
+        {
+            ++first2;
+        }
+        else
+        {
+            *result = *first1;
+            ++first1;
+            ++first2;
+            ++result;
+        }
+    }
+    return result;
+}
+
+// galloping 版本：遍历较短的序列，在较长的序列中做指数查找，复杂度为 O(m log(n/m))
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_intersection_gallop(RandomIter1 first1, RandomIter1 last1,
+                                   RandomIter2 first2, RandomIter2 last2,
+                                   OutputIter result, Compared comp)
+{
+    if (last1 - first1 <= last2 - first2)
+    {
+        for (; first1 != last1 && first2 != last2; ++first1)
+        {
+            first2 = orange_stl::gallop_lower_bound(first2, last2, *first1, comp);
+            if (first2 != last2 && !comp(*first1, *first2))
+            {
+                *result = *first1;
+                ++result;
+                ++first2;
+            }
+        }
+    }
+    else
+    {
+        for (; first1 != last1 && first2 != last2; ++first2)
+        {
+            first1 = orange_stl::gallop_lower_bound(first1, last1, *first2, comp);
+            if (first1 != last1 && !comp(*first2, *first1))
+            {
+                *result = *first1;
+                ++result;
+                ++first1;
+            }
+        }
+    }
+    return result;
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection_dispatch(InputIter1 first1, InputIter1 last1,
+                                     InputIter2 first2, InputIter2 last2,
+                                     OutputIter result, Compared comp,
+                                     input_iterator_tag, input_iterator_tag)
+{
+    return orange_stl::set_intersection_merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_intersection_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                     RandomIter2 first2, RandomIter2 last2,
+                                     OutputIter result, Compared comp,
+                                     random_access_iterator_tag, random_access_iterator_tag)
+{
+    const size_t n1 = static_cast<size_t>(last1 - first1);
+    const size_t n2 = static_cast<size_t>(last2 - first2);
+    if (n1 / ESetGallopRatio >= n2 || n2 / ESetGallopRatio >= n1)
+        return orange_stl::set_intersection_gallop(first1, last1, first2, last2, result, comp);
+    return orange_stl::set_intersection_merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result)
+{
+    return orange_stl::set_intersection_dispatch(first1, last1, first2, last2, result,
+                                                 orange_stl::less<typename iterator_traits<InputIter1>::value_type>(),
+                                                 iterator_category(first1), iterator_category(first2));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result, Compared comp)
+{
+    return orange_stl::set_intersection_dispatch(first1, last1, first2, last2, result, comp,
+                                                 iterator_category(first1), iterator_category(first2));
+}
+
+/*****************************************************************************************/
+// set_difference
+// 计算 S1-S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+// 重复元素出现 max(m - n, 0) 次，输出的是 S1 中相等元素的后 m - n 个
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference_merge(InputIter1 first1, InputIter1 last1,
+                                InputIter2 first2, InputIter2 last2,
+                                OutputIter result, Compared comp)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first1, *first2))
+        {
+            *result = *first1;
+            ++first1;
+            ++result;
+        }
+        else if (comp(*first2, *first1))
+        {
+            ++first2;
+        }
+        else
+        {
+            ++first1;
+            ++first2;
+        }
+    }
+    return orange_stl::copy(first1, last1, result);
+}
+
+// galloping 版本
+// S1 较短时逐个在 S2 中指数查找；S2 较短时在 S1 中找到每个 S2 元素的位置，把中间一整段直接拷贝
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_difference_gallop(RandomIter1 first1, RandomIter1 last1,
+                                 RandomIter2 first2, RandomIter2 last2,
+                                 OutputIter result, Compared comp)
+{
+    if (last1 - first1 <= last2 - first2)
+    {
+        for (; first1 != last1 && first2 != last2; ++first1)
+        {
+            first2 = orange_stl::gallop_lower_bound(first2, last2, *first1, comp);
+            if (first2 != last2 && !comp(*first1, *first2))
+            {
+                ++first2;
+            }
+            else
+            {
+                *result = *first1;
+                ++result;
+            }
+        }
+    }
+    else
+    {
+        for (; first1 != last1 && first2 != last2; ++first2)
+        {
+            RandomIter1 pos = orange_stl::gallop_lower_bound(first1, last1, *first2, comp);
+            result = orange_stl::copy(first1, pos, result);
+            first1 = pos;
+            if (first1 != last1 && !comp(*first2, *first1))
+                ++first1;
+        }
+    }
+    return orange_stl::copy(first1, last1, result);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference_dispatch(InputIter1 first1, InputIter1 last1,
+                                   InputIter2 first2, InputIter2 last2,
+                                   OutputIter result, Compared comp,
+                                   input_iterator_tag, input_iterator_tag)
+{
+    return orange_stl::set_difference_merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_difference_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                   RandomIter2 first2, RandomIter2 last2,
+                                   OutputIter result, Compared comp,
+                                   random_access_iterator_tag, random_access_iterator_tag)
+{
+    const size_t n1 = static_cast<size_t>(last1 - first1);
+    const size_t n2 = static_cast<size_t>(last2 - first2);
+    if (n1 / ESetGallopRatio >= n2 || n2 / ESetGallopRatio >= n1)
+        return orange_stl::set_difference_gallop(first1, last1, first2, last2, result, comp);
+    return orange_stl::set_difference_merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result)
+{
+    return orange_stl::set_difference_dispatch(first1, last1, first2, last2, result,
+                                               orange_stl::less<typename iterator_traits<InputIter1>::value_type>(),
+                                               iterator_category(first1), iterator_category(first2));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result, Compared comp)
+{
+    return orange_stl::set_difference_dispatch(first1, last1, first2, last2, result, comp,
+                                               iterator_category(first1), iterator_category(first2));
+}
+
+/*****************************************************************************************/
+// set_symmetric_difference
+// 计算 (S1-S2)∪(S2-S1) 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (*first1 < *first2)
+        {
+            *result = *first1;
+            ++first1;
+            ++result;
+        }
+        else if (*first2 < *first1)
+        {
+            *result = *first2;
+            ++first2;
+            ++result;
+        }
+        else
+        {
+            ++first1;
+            ++first2;
+        }
+    }
+    result = orange_stl::copy(first1, last1, result);
+    return orange_stl::copy(first2, last2, result);
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result, Compared comp)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first1, *first2))
+        {
+            *result = *first1;
+            ++first1;
+            ++result;
+        }
+        else if (comp(*first2, *first1))
+        {
+            *result = *first2;
+            ++first2;
+            ++result;
+        }
+        else
+        {
+            ++first1;
+            ++first2;
+        }
+    }
+    result = orange_stl::copy(first1, last1, result);
+    return orange_stl::copy(first2, last2, result);
+}
+
+/*****************************************************************************************/
+// simd_set_intersection
+// 求两个严格递增的 uint32_t / uint64_t 数组的交集，写入 out，返回交集的元素个数
+// out 至少要能容纳 min(na, nb) 个元素，且不能与 a、b 重叠
+// 长度悬殊时使用 galloping；否则每次取两边各一个块(4 个 uint32_t 或 2 个 uint64_t)，
+// 把 b 块循环移位后与 a 块逐一比较得到匹配掩码，再丢弃末元素较小的那一块
+/*****************************************************************************************/
+template <class UInt>
+size_t set_intersection_scalar(const UInt* a, size_t na, const UInt* b, size_t nb, UInt* out)
+{
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb)
+    {
+        const UInt x = a[i], y = b[j];
+        out[k] = x;
+        k += (x == y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return k;
+}
+
+template <class UInt>
+size_t set_intersection_gallop_scalar(const UInt* a, size_t na, const UInt* b, size_t nb, UInt* out)
+{
+    size_t k = 0;
+    if (na <= nb)
+    {
+        const UInt* cur = b;
+        const UInt* end = b + nb;
+        for (size_t i = 0; i < na && cur != end; ++i)
+        {
+            cur = orange_stl::gallop_lower_bound(cur, end, a[i]);
+            if (cur != end && *cur == a[i])
+                out[k++] = a[i];
+        }
+    }
+    else
+    {
+        const UInt* cur = a;
+        const UInt* end = a + na;
+        for (size_t j = 0; j < nb && cur != end; ++j)
+        {
+            cur = orange_stl::gallop_lower_bound(cur, end, b[j]);
+            if (cur != end && *cur == b[j])
+                out[k++] = b[j];
+        }
+    }
+    return k;
+}
+
+inline size_t simd_set_intersection(const uint32_t* a, size_t na,
+                                    const uint32_t* b, size_t nb, uint32_t* out)
+{
+    if (na / ESetGallopRatio >= nb || nb / ESetGallopRatio >= na)
+        return orange_stl::set_intersection_gallop_scalar(a, na, b, nb, out);
+    size_t i = 0, j = 0, k = 0;
+#ifdef ORANGE_SET_ALGO_SSE2
+    const size_t na4 = na & ~static_cast<size_t>(3);
+    const size_t nb4 = nb & ~static_cast<size_t>(3);
+    while (i < na4 && j < nb4)
+    {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i eq = _mm_cmpeq_epi32(va, vb);
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        const int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        // 输入严格递增，每个元素至多匹配一次，因此每一轮都可以直接输出匹配的 a 元素
+        if (mask != 0)
+        {
+            if (mask & 1) out[k++] = a[i];
+            if (mask & 2) out[k++] = a[i + 1];
+            if (mask & 4) out[k++] = a[i + 2];
+            if (mask & 8) out[k++] = a[i + 3];
+        }
+        const uint32_t amax = a[i + 3], bmax = b[j + 3];
+        i += (amax <= bmax) ? 4 : 0;
+        j += (bmax <= amax) ? 4 : 0;
+    }
+#endif
+    return k + orange_stl::set_intersection_scalar(a + i, na - i, b + j, nb - j, out + k);
+}
+
+inline size_t simd_set_intersection(const uint64_t* a, size_t na,
+                                    const uint64_t* b, size_t nb, uint64_t* out)
+{
+    if (na / ESetGallopRatio >= nb || nb / ESetGallopRatio >= na)
+        return orange_stl::set_intersection_gallop_scalar(a, na, b, nb, out);
+    size_t i = 0, j = 0, k = 0;
+#ifdef ORANGE_SET_ALGO_SSE2
+    const size_t na2 = na & ~static_cast<size_t>(1);
+    const size_t nb2 = nb & ~static_cast<size_t>(1);
+    while (i < na2 && j < nb2)
+    {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        // SSE2 没有 64 位比较，用 32 位比较的结果与交换高低半字后的结果相与
+        __m128i e0 = _mm_cmpeq_epi32(va, vb);
+        e0 = _mm_and_si128(e0, _mm_shuffle_epi32(e0, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m128i e1 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        e1 = _mm_and_si128(e1, _mm_shuffle_epi32(e1, _MM_SHUFFLE(2, 3, 0, 1)));
+        const int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(e0, e1)));
+        if (mask != 0)
+        {
+            if (mask & 1) out[k++] = a[i];
+            if (mask & 2) out[k++] = a[i + 1];
+        }
+        const uint64_t amax = a[i + 1], bmax = b[j + 1];
+        i += (amax <= bmax) ? 2 : 0;
+        j += (bmax <= amax) ? 2 : 0;
+    }
+#endif
+    return k + orange_stl::set_intersection_scalar(a + i, na - i, b + j, nb - j, out + k);
+}
+
+} // namespace orange_stl
+#endif // !__ORANGE_STL_SET_ALGO_H__
@@ -45,7 +45,7 @@ public:
     }
     stack& operator=(stack&& rhs) noexcept(std::is_nothrow_move_assignable<Container>::value)
     { 
-        c_ = mystl::move(rhs.c_); 
+        c_ = orange_stl::move(rhs.c_); 
         return *this;
     }
 
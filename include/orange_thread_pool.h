@@ -0,0 +1,301 @@
+#ifndef __ORANGE_THREAD_POOL_H__
+#define __ORANGE_THREAD_POOL_H__
+
+// 这个头文件包含工作窃取(work-stealing)线程池 thread_pool 与任务组 task_group
+// 每个工作线程持有自己的任务队列：本线程提交的任务压入自己队列的尾部并从尾部取出(LIFO，局部性好)，
+// 空闲线程从其他队列的头部窃取(FIFO，窃取到的通常是较大的任务)
+// 外部线程提交的任务放入共享队列；task_group::wait 在等待期间会参与执行任务，因此任务内部可以嵌套提交与等待
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "orange_vector.h"
+#include "orange_util.h"
+
+namespace orange_stl
+{
+
+// 类：work_queue
+// 以互斥锁保护的环形缓冲区，容量不足时倍增
+class work_queue
+{
+public:
+    typedef std::function<void()> task_type;
+
+private:
+    std::mutex                   mutex_;
+    orange_stl::vector<task_type> buf_;    // 环形缓冲区，容量为 2 的幂
+    size_t                       head_;    // 队头下标
+    size_t                       size_;    // 任务个数
+
+public:
+    work_queue() : buf_(16), head_(0), size_(0) {}
+
+    work_queue(const work_queue&) = delete;
+    work_queue& operator=(const work_queue&) = delete;
+
+    // 压入队尾
+    void push(task_type&& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size_ == buf_.size())
+            grow();
+        buf_[(head_ + size_) & (buf_.size() - 1)] = orange_stl::move(task);
+        ++size_;
+    }
+
+    // 从队尾取出，供队列的拥有者使用
+    bool pop_back(task_type& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size_ == 0)
+            return false;
+        --size_;
+        task = orange_stl::move(buf_[(head_ + size_) & (buf_.size() - 1)]);
+        return true;
+    }
+
+    // 从队头取出，供窃取者使用
+    bool pop_front(task_type& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size_ == 0)
+            return false;
+        task = orange_stl::move(buf_[head_]);
+        head_ = (head_ + 1) & (buf_.size() - 1);
+        --size_;
+        return true;
+    }
+
+private:
+    void grow()
+    {
+        orange_stl::vector<task_type> tmp(buf_.size() * 2);
+        for (size_t i = 0; i < size_; ++i)
+            tmp[i] = orange_stl::move(buf_[(head_ + i) & (buf_.size() - 1)]);
+        buf_.swap(tmp);
+        head_ = 0;
+    }
+};
+
+// 类：thread_pool
+// 线程数为 0 时不创建工作线程，所有任务都由调用 wait / run_one 的线程执行
+class thread_pool
+{
+public:
+    typedef work_queue::task_type task_type;
+
+private:
+    orange_stl::vector<std::thread>  threads_;
+    orange_stl::vector<work_queue*>  queues_;    // 每个工作线程一个队列
+    work_queue                       shared_;    // 外部线程提交的任务
+
+    std::mutex                       mutex_;     // 保护休眠与唤醒
+    std::condition_variable          cond_;
+    std::atomic<size_t>              pending_;   // 已提交尚未取出的任务数
+    bool                             stop_;
+
+public:
+    explicit thread_pool(size_t thread_count = default_thread_count())
+        :pending_(0), stop_(false)
+    {
+        queues_.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i)
+            queues_.push_back(new work_queue);
+        threads_.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i)
+            threads_.push_back(std::thread(&thread_pool::worker_loop, this, i));
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // 等待所有工作线程执行完队列中剩余的任务后退出
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        for (size_t i = 0; i < threads_.size(); ++i)
+            threads_[i].join();
+        for (size_t i = 0; i < queues_.size(); ++i)
+            delete queues_[i];
+    }
+
+    // 工作线程的个数
+    size_t size() const noexcept { return threads_.size(); }
+
+    // 进程范围内共享的线程池，工作线程数为硬件线程数减一(调用者自己也参与执行)
+    static thread_pool& default_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    static size_t default_thread_count()
+    {
+        const size_t n = std::thread::hardware_concurrency();
+        return n > 1 ? n - 1 : 0;
+    }
+
+    // 提交一个任务，工作线程提交到自己的队列，其他线程提交到共享队列
+    void submit(task_type task)
+    {
+        // 先增加计数再入队，保证取出任务时计数不会减到负数
+        pending_.fetch_add(1, std::memory_order_release);
+        const size_t self = current_index();
+        if (self < queues_.size())
+            queues_[self]->push(orange_stl::move(task));
+        else
+            shared_.push(orange_stl::move(task));
+        if (!threads_.empty())
+        {
+            // 加锁后再唤醒，避免与工作线程的检查-休眠之间丢失唤醒
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        cond_.notify_one();
+    }
+
+    // 取出并执行一个任务：先取本线程的队列，再取共享队列，最后从其他线程窃取
+    // 没有可执行的任务时返回 false
+    bool run_one()
+    {
+        task_type task;
+        if (!take(task))
+            return false;
+        task();
+        return true;
+    }
+
+private:
+    // 当前线程在本线程池中的工作线程编号，非工作线程返回 size_t(-1)
+    size_t current_index() const noexcept
+    {
+        return current_pool() == this ? current_slot() : static_cast<size_t>(-1);
+    }
+
+    static const thread_pool*& current_pool() noexcept
+    {
+        static thread_local const thread_pool* pool = nullptr;
+        return pool;
+    }
+
+    static size_t& current_slot() noexcept
+    {
+        static thread_local size_t slot = static_cast<size_t>(-1);
+        return slot;
+    }
+
+    bool take(task_type& task)
+    {
+        if (pending_.load(std::memory_order_acquire) == 0)
+            return false;
+        const size_t self = current_index();
+        const size_t n = queues_.size();
+        bool ok = (self < n && queues_[self]->pop_back(task)) || shared_.pop_front(task);
+        for (size_t i = 1; !ok && i <= n; ++i)
+        {
+            const size_t victim = self < n ? (self + i) % n : i - 1;
+            ok = queues_[victim]->pop_front(task);
+        }
+        if (ok)
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+        return ok;
+    }
+
+    void worker_loop(size_t index)
+    {
+        current_pool() = this;
+        current_slot() = index;
+        for (;;)
+        {
+            if (run_one())
+                continue;
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this] {
+                return stop_ || pending_.load(std::memory_order_acquire) != 0;
+            });
+            if (stop_ && pending_.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+};
+
+// 类：task_group
+// 在线程池上运行一组任务，wait 等待这组任务全部完成，等待期间调用线程也执行任务
+// 任务抛出的第一个异常会在 wait 中重新抛出
+class task_group
+{
+private:
+    thread_pool&        pool_;
+    std::atomic<size_t> running_;
+    std::mutex          mutex_;
+    std::exception_ptr  error_;
+
+public:
+    explicit task_group(thread_pool& pool = thread_pool::default_pool())
+        :pool_(pool), running_(0)
+    {
+    }
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group()
+    {
+        wait_nothrow();
+    }
+
+    template <class Func>
+    void run(Func&& func)
+    {
+        running_.fetch_add(1, std::memory_order_relaxed);
+        task_group* self = this;
+        typename std::decay<Func>::type f(orange_stl::forward<Func>(func));
+        pool_.submit([self, f]() mutable {
+            try
+            {
+                f();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(self->mutex_);
+                if (!self->error_)
+                    self->error_ = std::current_exception();
+            }
+            self->running_.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait()
+    {
+        wait_nothrow();
+        if (error_)
+        {
+            std::exception_ptr e = error_;
+            error_ = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+private:
+    void wait_nothrow()
+    {
+        while (running_.load(std::memory_order_acquire) != 0)
+        {
+            if (!pool_.run_one())
+                std::this_thread::yield();
+        }
+    }
+};
+
+} // namespace orange_stl
+#endif // !__ORANGE_THREAD_POOL_H__
@@ -27,6 +27,27 @@ namespace orange_stl
 
     template <class T1, class T2>
     struct is_pair<orange_stl::pair<T1, T2>> : orange_stl::m_true_type {};
+
+    template <class...>
+    struct m_void
+    {
+        typedef void type;
+    };
+
+    // is_transparent：函数对象是否声明了 is_transparent 成员类型
+    // 声明了的哈希函数与比较函数可以直接接受与键值类型可比较的其他类型，查找时无需构造临时的键值
+    template <class T, class = void>
+    struct is_transparent : orange_stl::m_false_type {};
+
+    template <class T>
+    struct is_transparent<T, typename m_void<typename T::is_transparent>::type>
+        : orange_stl::m_true_type {};
+
+    // 约束关联容器的异构查找重载：Fn1 与 Fn2 都声明了 is_transparent 时才参与重载决议
+    // K 为查找所用的类型，只用于把判断推迟到重载决议时
+    template <class K, class Fn1, class Fn2 = Fn1>
+    struct enable_if_transparent
+        : std::enable_if<is_transparent<Fn1>::value && is_transparent<Fn2>::value, int> {};
 }
 
 
@@ -10,18 +10,26 @@
 namespace orange_stl
 {
 
+template <class Key, class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+class unordered_multimap;
+
 // 模板类unordered_map， 键值不允许重复
 // 参数一表示键值类型，参数二表示哈希表，默认orange_stl::hash
-// 参数三表示键值的比较方式，默认orange_stl::equal_to
+// 参数三表示键值的比较方式，默认orange_stl::equal_to，参数四表示空间配置器类型
+// 参数五表示桶的策略，默认orange_stl::prime_bucket_policy，可换成 power2_bucket_policy 以避免取模运算
 
-template <class Key, class T, class Hash=orange_stl::hash<Key>, class KeyEqual=orange_stl::equal_to<Key>>
+template <class Key, class T, class Hash=orange_stl::hash<Key>, class KeyEqual=orange_stl::equal_to<Key>,
+          class Alloc=orange_stl::allocator<orange_stl::pair<const Key, T>>,
+          class BucketPolicy=orange_stl::prime_bucket_policy>
 class unordered_map
 {
 private:
     // 使用hashtable作为底层机制
-    typedef hashtable<orange_stl::pair<const Key, T>, Hash, KeyEqual> base_type;
+    typedef hashtable<orange_stl::pair<const Key, T>, Hash, KeyEqual, Alloc, BucketPolicy> base_type;
     base_type ht_;
 
+    friend class unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>;
+
 public:
     // 使用 hashtable 的型别
     typedef typename base_type::allocator_type       allocator_type;
@@ -43,6 +51,9 @@ public:
     typedef typename base_type::local_iterator       local_iterator;
     typedef typename base_type::const_local_iterator const_local_iterator;
 
+    typedef typename base_type::node_handle_type     node_handle_type;
+    typedef typename base_type::insert_return_type   insert_return_type;
+
     allocator_type get_allocator() const
     {
         return ht_.get_allocator();
@@ -168,7 +179,7 @@ public:
     }
     pair<iterator, bool> insert(value_type&& value)
     {
-        return ht_emplace_unique(orange_stl::move(value));
+        return ht_.emplace_unique(orange_stl::move(value));
     }
 
     iterator insert(const_iterator hint, const value_type& value)
@@ -199,6 +210,28 @@ public:
         return ht_.erase_unique(key);
     }
 
+    // 节点句柄相关的操作
+    node_handle_type extract(const_iterator it)
+    {
+        return ht_.extract(it);
+    }
+    node_handle_type extract(const key_type& key)
+    {
+        return ht_.extract(key);
+    }
+    insert_return_type insert(node_handle_type&& nh)
+    {
+        return ht_.insert_unique(orange_stl::move(nh));
+    }
+    void merge(unordered_map& source)
+    {
+        ht_.merge_unique(source.ht_);
+    }
+    void merge(unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& source)
+    {
+        ht_.merge_unique(source.ht_);
+    }
+
     void clear()
     {
         ht_.clear();
@@ -226,17 +259,48 @@ public:
 
     mapped_type& operator[](const key_type& key)
     {
-        iterator it=ht_.find(key);
-        if(it.node==nullptr)
-            it = ht_.emplace_unique(key, T{}).first;
-        return it->second;
+        return ht_.try_emplace_unique(key).first->second;
     }
     mapped_type& operator[](key_type&& key)
     {
-        iterator it=ht_.find(key);
-        if(it.node==nullptr)
-            it = ht_.emplace_unique(orange_stl::move(key), T{}).first;
-        return it->second;
+        return ht_.try_emplace_unique(orange_stl::move(key)).first->second;
+    }
+
+    // 键值不存在时插入，只计算一次哈希；插入失败时不会移动 key 与 args
+    template <class ...Args>
+    pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+    {
+        return ht_.try_emplace_unique(key, orange_stl::forward<Args>(args)...);
+    }
+    template <class ...Args>
+    pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+    {
+        return ht_.try_emplace_unique(orange_stl::move(key), orange_stl::forward<Args>(args)...);
+    }
+
+    // 键值不存在时插入，否则赋值
+    template <class M>
+    pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+        return ht_.insert_or_assign_unique(key, orange_stl::forward<M>(obj));
+    }
+    template <class M>
+    pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+    {
+        return ht_.insert_or_assign_unique(orange_stl::move(key), orange_stl::forward<M>(obj));
+    }
+
+    // 返回 key 对应的值，键值不存在时先插入 factory() 的结果
+    template <class Factory>
+    mapped_type& get_or_insert_with(const key_type& key, Factory&& factory)
+    {
+        return ht_.get_or_insert_with_unique(key, orange_stl::forward<Factory>(factory)).first->second;
+    }
+    template <class Factory>
+    mapped_type& get_or_insert_with(key_type&& key, Factory&& factory)
+    {
+        return ht_.get_or_insert_with_unique(orange_stl::move(key),
+                                             orange_stl::forward<Factory>(factory)).first->second;
     }
 
     size_type count(const key_type& key) const
@@ -262,6 +326,48 @@ public:
         return ht_.equal_range_unique(key);
     }
 
+    // 异构查找，只在 hasher 与 key_equal 都声明了 is_transparent 时参与重载决议
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    size_type count(const K& key) const
+    {
+        return ht_.count(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    iterator find(const K& key)
+    {
+        return ht_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return ht_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return ht_.equal_range_unique(key);
+    }
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return ht_.equal_range_unique(key);
+    }
+
+    // 批量查找，依次把 [first, last) 中每个键值的查找结果写入 out，找不到时为 end()
+    // 一组键值的缓存未命中可以重叠，在远大于缓存的表中大量随机查找时比逐个调用 find 快
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+    {
+        return ht_.find_batch(first, last, out);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+    {
+        return ht_.find_batch(first, last, out);
+    }
+
     // buctet interface
     local_iterator begin(size_type n) noexcept
     {
@@ -321,6 +427,24 @@ public:
         ht_.max_load_factor(ml);
     }
 
+    // 渐进式 rehash，见 hashtable::incremental_rehash
+    bool incremental_rehash() const noexcept
+    {
+        return ht_.incremental_rehash();
+    }
+    void incremental_rehash(bool on)
+    {
+        ht_.incremental_rehash(on);
+    }
+    bool rehashing() const noexcept
+    {
+        return ht_.rehashing();
+    }
+    bool rehash_step(size_type count)
+    {
+        return ht_.rehash_step(count);
+    }
+
     void rehash(size_type count)
     {
         return ht_.rehash(count);
@@ -342,33 +466,33 @@ public:
 public:
     friend bool operator==(const unordered_map& lhs, const unordered_map& rhs)
     {
-        return lhs.ht_.equal_range_unique(rhs.ht_);
+        return lhs.ht_.equal_to_unique(rhs.ht_);
     }
     friend bool operator!=(const unordered_map& lhs, const unordered_map& rhs)
     {
-        return !lhs.ht_.equal_range_unique(rhs.ht_);
+        return !lhs.ht_.equal_to_unique(rhs.ht_);
     }
 };
 
 /* 重载比较操作符 */
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator==(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+bool operator==(const unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& rhs)
 {
     return lhs == rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator!=(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+bool operator!=(const unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& rhs)
 {
     return lhs != rhs;
 }
 
 // 重载orange_stl的swap
-template <class Key, class T, class Hash, class KeyEqual>
-void swap(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-          const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void swap(const unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& lhs,
+          const unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& rhs)
 {
     lhs.swap(rhs);
 }
@@ -377,14 +501,18 @@ void swap(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
 // 模板类 unordered_multimap，键值允许重复
 // 参数一代表键值类型，参数二代表哈希函数，缺省使用 orange_stl::hash
 
-template <class Key, class T, class Hash = orange_stl::hash<Key>, class KeyEqual = orange_stl::equal_to<Key>>
+template <class Key, class T, class Hash = orange_stl::hash<Key>, class KeyEqual = orange_stl::equal_to<Key>,
+          class Alloc = orange_stl::allocator<orange_stl::pair<const Key, T>>,
+          class BucketPolicy = orange_stl::prime_bucket_policy>
 class unordered_multimap
 {
 private:
     // 使用hashtable作为底层机制
-    typedef hashtable<pair<const Key, T>, Hash, KeyEqual> base_type;
+    typedef hashtable<pair<const Key, T>, Hash, KeyEqual, Alloc, BucketPolicy> base_type;
     base_type ht_;
 
+    friend class unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>;
+
 public:
     // 使用 hashtable 的型别
     typedef typename base_type::allocator_type       allocator_type;
@@ -406,6 +534,8 @@ public:
     typedef typename base_type::local_iterator       local_iterator;
     typedef typename base_type::const_local_iterator const_local_iterator;
 
+    typedef typename base_type::node_handle_type     node_handle_type;
+
     allocator_type get_allocator() const 
     { 
         return ht_.get_allocator(); 
@@ -437,7 +567,7 @@ public:
                         const size_type bucket_count = 100,
                         const Hash& hash = Hash(),
                         const KeyEqual& equal = KeyEqual())
-        :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+        :ht_(orange_stl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
     {
         for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
             ht_.insert_multi_noresize(*first);
@@ -512,7 +642,7 @@ public:
 
     // emplace
     template <class ...Args>
-    pair<iterator, bool> emplace(Args&& ...args)
+    iterator emplace(Args&& ...args)
     {
         return ht_.emplace_multi(orange_stl::forward<Args>(args)...);
     }
@@ -524,11 +654,11 @@ public:
     }
 
     // insert
-    pair<iterator, bool> insert(const value_type& value)
+    iterator insert(const value_type& value)
     {
         return ht_.insert_multi(value);
     }
-    pair<iterator, bool> insert(value_type&& value)
+    iterator insert(value_type&& value)
     {
         return ht_.emplace_multi(orange_stl::move(value));
     }
@@ -562,6 +692,28 @@ public:
         return ht_.erase_multi(key);
     }
 
+    // 节点句柄相关的操作
+    node_handle_type extract(const_iterator it)
+    {
+        return ht_.extract(it);
+    }
+    node_handle_type extract(const key_type& key)
+    {
+        return ht_.extract(key);
+    }
+    iterator insert(node_handle_type&& nh)
+    {
+        return ht_.insert_multi(orange_stl::move(nh));
+    }
+    void merge(unordered_multimap& source)
+    {
+        ht_.merge_multi(source.ht_);
+    }
+    void merge(unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& source)
+    {
+        ht_.merge_multi(source.ht_);
+    }
+
     void clear()
     {
         ht_.clear();
@@ -596,6 +748,48 @@ public:
         return ht_.equal_range_multi(key);
     }
 
+    // 异构查找，只在 hasher 与 key_equal 都声明了 is_transparent 时参与重载决议
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    size_type count(const K& key) const
+    {
+        return ht_.count(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    iterator find(const K& key)
+    {
+        return ht_.find(key);
+    }
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        return ht_.find(key);
+    }
+
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    pair<iterator, iterator> equal_range(const K& key)
+    {
+        return ht_.equal_range_multi(key);
+    }
+    template <class K, typename enable_if_transparent<K, hasher, key_equal>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+        return ht_.equal_range_multi(key);
+    }
+
+    // 批量查找，依次把 [first, last) 中每个键值的查找结果写入 out，找不到时为 end()
+    // 一组键值的缓存未命中可以重叠，在远大于缓存的表中大量随机查找时比逐个调用 find 快
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+    {
+        return ht_.find_batch(first, last, out);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+    {
+        return ht_.find_batch(first, last, out);
+    }
+
     // buctet interface
     local_iterator begin(size_type n) noexcept
     {
@@ -655,6 +849,24 @@ public:
         ht_.max_load_factor(ml);
     }
 
+    // 渐进式 rehash，见 hashtable::incremental_rehash
+    bool incremental_rehash() const noexcept
+    {
+        return ht_.incremental_rehash();
+    }
+    void incremental_rehash(bool on)
+    {
+        ht_.incremental_rehash(on);
+    }
+    bool rehashing() const noexcept
+    {
+        return ht_.rehashing();
+    }
+    bool rehash_step(size_type count)
+    {
+        return ht_.rehash_step(count);
+    }
+
     void rehash(size_type count)
     {
         return ht_.rehash(count);
@@ -676,33 +888,33 @@ public:
 public:
     friend bool operator==(const unordered_multimap& lhs, const unordered_multimap& rhs)
     {
-        return lhs.ht_.equal_range_multi(rhs.ht_);
+        return lhs.ht_.equal_to_multi(rhs.ht_);
     }
     friend bool operator!=(const unordered_multimap& lhs, const unordered_multimap& rhs)
     {
-        return !lhs.ht_.equal_range_multi(rhs.ht_);
+        return !lhs.ht_.equal_to_multi(rhs.ht_);
     }
 };
 
 /* 重载比较操作符 */
-template <class Key, class T, class Hash, class KeyEqual, class Alloc>
-bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& rhs)
 {
     return lhs==rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual, class Alloc>
-bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& rhs)
 {
     return lhs!=rhs;
 }
 
 // 重载orange_stl的swap
-template <class Key, class T, class Hash, class KeyEqual, class Alloc>
-void swap(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-          const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc, class BucketPolicy>
+void swap(const unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& lhs,
+          const unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy>& rhs)
 {
     lhs.swap(rhs);
 }
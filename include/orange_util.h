@@ -2,6 +2,7 @@
 #define __ORANGE_UTIL_H__
 
 #include <cstddef>
+#include <tuple>
 
 #include "orange_type_traits.h"
 
@@ -72,6 +73,32 @@ void swap(Tp(&a)[N], Tp(&b)[N])
 
 
 
+// -----------------------------------------------------------------//
+//------------------------ index_sequence --------------------------//
+
+// 编译期的下标序列，用于展开 tuple
+template <size_t... I>
+struct index_sequence {};
+
+template <size_t N, size_t... I>
+struct make_index_sequence_imp : make_index_sequence_imp<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct make_index_sequence_imp<0, I...>
+{
+  typedef index_sequence<I...> type;
+};
+
+template <size_t N>
+using make_index_sequence = typename make_index_sequence_imp<N>::type;
+
+// 标记类型：pair 的 first 与 second 分别由两个 tuple 中的参数原位构造
+struct piecewise_construct_t { explicit piecewise_construct_t() = default; };
+constexpr piecewise_construct_t piecewise_construct = piecewise_construct_t();
+//------------------------------------------------------------------//
+
+
+
 // -----------------------------------------------------------------//
 //---------------------------- pair---------------------------------//
 
@@ -124,6 +151,14 @@ struct pair
   pair(const pair& rhs) = default;
   pair(pair&& rhs) = default;
 
+  // piecewise constructiable，以 tuple 中的参数分别原位构造 first 和 second
+  template <class... Args1, class... Args2>
+  pair(piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b)
+    : pair(a, b, make_index_sequence<sizeof...(Args1)>(),
+           make_index_sequence<sizeof...(Args2)>())
+  {
+  }
+
   // implicit constructiable for other type
   template <class Other1, class Other2,
     typename std::enable_if<
@@ -253,6 +288,14 @@ struct pair
     }
   }
 
+private:
+  template <class Tuple1, class Tuple2, size_t... I1, size_t... I2>
+  pair(Tuple1& a, Tuple2& b, index_sequence<I1...>, index_sequence<I2...>)
+    : first(orange_stl::forward<typename std::tuple_element<I1, Tuple1>::type>(std::get<I1>(a))...),
+    second(orange_stl::forward<typename std::tuple_element<I2, Tuple2>::type>(std::get<I2>(b))...)
+  {
+  }
+
 };
 //---------------------end pair--------------------------//
 
@@ -2,6 +2,7 @@
 #define __ORANGE_VECTOR_H__
 
 #include <initializer_list>
+#include "orange_algo.h"
 #include "orange_iterator.h"
 #include "orange_memory.h"
 #include "orange_util.h"
@@ -20,15 +21,16 @@ namespace orange_stl
 #undef min
 #endif
 
-/* vector模板类 */
-template <class T>
+/* vector模板类
+   参数一代表数据类型，参数二代表空间配置器类型，缺省使用 orange_stl::allocator */
+template <class T, class Alloc = orange_stl::allocator<T>>
 class vector
 {
     static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in orange_stl");
 public:
     /* vector 型别定义 */
-    typedef orange_stl::allocator<T> allocator_type;
-    typedef orange_stl::allocator<T> data_allocator;
+    typedef Alloc                                           allocator_type;
+    typedef typename Alloc::template rebind<T>::other       data_allocator;
 
     typedef typename allocator_type::value_type             value_type;
     typedef typename allocator_type::pointer                pointer;
@@ -130,12 +132,12 @@ public:
     }
     reference at(size_type n)
     {
-        THROW_OUT_OF_RANGE_IF(!(n<size()), "vector<T>::at() subscript out of range");
+        THROW_OUT_OF_RANGE_IF(!(n<size()), "vector<T, Alloc>::at() subscript out of range");
         return (*this)[n];
     }
     const_reference at(size_type n) const
     {
-        THROW_OUT_OF_RANGE_IF(!(n<size()), "vector<T>::at() subscript out of range");
+        THROW_OUT_OF_RANGE_IF(!(n<size()), "vector<T, Alloc>::at() subscript out of range");
         return (*this)[n];
     }
     reference front()
@@ -259,8 +261,8 @@ private:
 };
 
 /* 赋值复制操作符 */
-template <class T>
-vector<T>& vector<T>::operator=(const vector& rhs)
+template <class T, class Alloc>
+vector<T, Alloc>& vector<T, Alloc>::operator=(const vector& rhs)
 {
     if(this!=&rhs)
     {
@@ -287,8 +289,8 @@ vector<T>& vector<T>::operator=(const vector& rhs)
 }
 
 /* 移动赋值操作符 */
-template<class T>
-vector<T>& vector<T>::operator=(vector&& rhs) noexcept
+template <class T, class Alloc>
+vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& rhs) noexcept
 {
     destroy_and_recover(begin_, end_, cap_-begin_);
     begin_=rhs.begin_;
@@ -301,15 +303,17 @@ vector<T>& vector<T>::operator=(vector&& rhs) noexcept
 }
 
 /* 预留空间大小，原容量小于要求的时候，才会重新进行分配 */
-template <class T>
-void vector<T>::reserve(size_type n)
+template <class T, class Alloc>
+void vector<T, Alloc>::reserve(size_type n)
 {
     if(capacity() < n)
     {
-        THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than  max_size() int vector<T>::reserve(n)");
+        THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than  max_size() int vector<T, Alloc>::reserve(n)");
         const auto old_size=size();
         auto tmp=data_allocator::allocate(n);
         orange_stl::uninitialized_move(begin_, end_, tmp);
+        data_allocator::destroy(begin_, end_);
+        data_allocator::deallocate(begin_, cap_-begin_);
         begin_=tmp;
         end_=tmp+old_size;
         cap_=begin_+n;
@@ -317,8 +321,8 @@ void vector<T>::reserve(size_type n)
 }
 
 /* 缩小当前容器容量 */
-template <class T>
-void vector<T>::shrink_to_fit()
+template <class T, class Alloc>
+void vector<T, Alloc>::shrink_to_fit()
 {
     if(end_<cap_)
     {
@@ -327,26 +331,28 @@ void vector<T>::shrink_to_fit()
 }
 
 /* 在pos位置构造元素，避免额外的复制或移动的开销 */
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-typename vector<T>::iterator
-vector<T>::emplace(const_iterator pos, Args&& ...args)
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::emplace(const_iterator pos, Args&& ...args)
 {
     ORANGE_STL_DEBUG(pos>=begin() && pos<=end());
     iterator xpos=const_cast<iterator>(pos);
     const size_type n=xpos-begin_;
-    if(end_!=cap && xpos==end)
+    if(end_!=cap_ && xpos==end_)
     {
-        data_allocator::construct(orange_stl:::address_of(*end_), orange_stl::forward<Args>(args)...);
+        data_allocator::construct(orange_stl::address_of(*end_), orange_stl::forward<Args>(args)...);
         ++end_;
     }
     else if(end_!=cap_)
     {
         auto new_end=end_;
-        data_allocator::construct(orange_stl::address_of(*end_), *(end_-1));
+        value_type value_copy(orange_stl::forward<Args>(args)...);/* 先构造，参数可能引用本容器中的元素 */
+        data_allocator::construct(orange_stl::address_of(*end_), orange_stl::move(*(end_-1)));
         ++new_end;
-        orange_stl::copy_backward(xpos, end_-1, end_);
-        *xpos=value_type(orange_stl::forward<Args>>(args)...);
+        orange_stl::move_backward(xpos, end_-1, end_);
+        *xpos=orange_stl::move(value_copy);
+        end_=new_end;
     }
     else
     {
@@ -356,9 +362,9 @@ vector<T>::emplace(const_iterator pos, Args&& ...args)
 }
 
 // 在尾部就地构造元素，避免额外的复制或移动开销
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-void vector<T>::emplace_back(Args&& ...args)
+void vector<T, Alloc>::emplace_back(Args&& ...args)
 {
     if(end_<cap_)
     {
@@ -372,8 +378,8 @@ void vector<T>::emplace_back(Args&& ...args)
 }
 
 /* 在尾部插入元素 */
-template <class T>
-void vector<T>::push_back(const value_type& value)
+template <class T, class Alloc>
+void vector<T, Alloc>::push_back(const value_type& value)
 {
     if(end_!=cap_)
     {
@@ -387,8 +393,8 @@ void vector<T>::push_back(const value_type& value)
 }
 
 /* 弹出尾部元素 */
-template <class T>
-void vector<T>::pop_back()
+template <class T, class Alloc>
+void vector<T, Alloc>::pop_back()
 {
     ORANGE_STL_DEBUG(!empty());
     data_allocator::destroy(end_-1);
@@ -396,16 +402,16 @@ void vector<T>::pop_back()
 }
 
 /* 在pos处插入元素 */
-template <class T>
-typename vector<T>::iterator
-vector<T>::insert(const_iterator pos, const value_type& value)
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::insert(const_iterator pos, const value_type& value)
 {
     ORANGE_STL_DEBUG(pos >= begin() && pos<=end());
     iterator xpos=const_cast<iterator>(pos);
     const size_type n=pos-begin_;
     if(end_!=cap_ && xpos==end_)
     {
-        data_allocator::construct(orange_stl::address(*end_), value);
+        data_allocator::construct(orange_stl::address_of(*end_), value);
         ++end_;
     }
     else if(end_!=cap_)
@@ -426,9 +432,9 @@ vector<T>::insert(const_iterator pos, const value_type& value)
 }
 
 /* 删除pos位置上的元素 */
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator pos)
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::erase(const_iterator pos)
 {
     ORANGE_STL_DEBUG(pos>=begin() && pos<end());
     iterator xpos=begin_+(pos-begin());
@@ -438,21 +444,23 @@ vector<T>::erase(const_iterator pos)
 }
 
 /* 删除[first, last)上的元素 */
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator first, const_iterator last)
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::erase(const_iterator first, const_iterator last)
 {
     ORANGE_STL_DEBUG(first>=begin() && last<=end() && !(last<first));
     const auto n=first-begin();
+    if(first==last)/* 空区间不移动任何元素，否则后面的元素会被移动赋值给自身 */
+        return begin_+n;
     iterator r=begin_+(first-begin());
-    data_allocator::destroy(orange_stl::move(r+(last-first), end_, t), end_);
+    data_allocator::destroy(orange_stl::move(r+(last-first), end_, r), end_);
     end_=end_-(last-first);
     return begin_+n;
 }
 
 /* 重置容器的大小 */
-template <class T>
-void vector<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc>
+void vector<T, Alloc>::resize(size_type new_size, const value_type& value)
 {
     if(new_size<size())
     {
@@ -465,8 +473,8 @@ void vector<T>::resize(size_type new_size, const value_type& value)
 }
 
 /* 与另一个vector进行交换 */
-template <class T>
-void vector<T>::swap(vector<T>& rhs) noexcept
+template <class T, class Alloc>
+void vector<T, Alloc>::swap(vector<T, Alloc>& rhs) noexcept
 {
     if(this!=&rhs)
     {
@@ -478,8 +486,8 @@ void vector<T>::swap(vector<T>& rhs) noexcept
 
 /* 辅助函数
    try_init 函数，若分配失败则忽略，不抛出异常 */
-template <class T>
-void vector<T>::try_init() noexcept
+template <class T, class Alloc>
+void vector<T, Alloc>::try_init() noexcept
 {
     try
     {
@@ -496,8 +504,8 @@ void vector<T>::try_init() noexcept
 }
 
 /* init_space 函数 */
-template <class T>
-void vector<T>::init_space(size_type size, size_type cap)
+template <class T, class Alloc>
+void vector<T, Alloc>::init_space(size_type size, size_type cap)
 {
     try
     {
@@ -515,8 +523,8 @@ void vector<T>::init_space(size_type size, size_type cap)
 }
 
 /* fill_init 函数 */
-template <class T>
-void vector<T>::fill_init(size_type n, const value_type& value)
+template <class T, class Alloc>
+void vector<T, Alloc>::fill_init(size_type n, const value_type& value)
 {
     const size_type init_size=orange_stl::max(static_cast<size_type>(16), n);
     init_space(n, init_size);
@@ -524,9 +532,9 @@ void vector<T>::fill_init(size_type n, const value_type& value)
 }
 
 /* range_init 函数 */
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void vector<T>::range_init(Iter first, Iter last)
+void vector<T, Alloc>::range_init(Iter first, Iter last)
 {
     const size_type init_size = orange_stl::max(static_cast<size_type>(last-first), static_cast<size_type>(16));
     init_space(static_cast<size_type>(last-first), init_size);
@@ -534,17 +542,17 @@ void vector<T>::range_init(Iter first, Iter last)
 }
 
 /* destroy_and_recover */
-template<class T>
-void vector<T>::destroy_and_recover(iterator first, iterator last, size_type n)
+template <class T, class Alloc>
+void vector<T, Alloc>::destroy_and_recover(iterator first, iterator last, size_type n)
 {
     data_allocator::destroy(first, last);
     data_allocator::deallocate(first, n);
 }
 
 /* get_new_cap函数 */
-template <class T>
-typename vector<T>::size_type
-vector<T>::get_new_cap(size_type add_size)
+template <class T, class Alloc>
+typename vector<T, Alloc>::size_type
+vector<T, Alloc>::get_new_cap(size_type add_size)
 {
     const auto old_size = capacity();
     THROW_LENGTH_ERROR_IF(old_size>max_size()-add_size, "vector<T>'s size too big");
@@ -559,8 +567,8 @@ vector<T>::get_new_cap(size_type add_size)
 }
 
 /* fill_assign */
-template <class T>
-void vector<T>::fill_assign(size_type n, const value_type& value)
+template <class T, class Alloc>
+void vector<T, Alloc>::fill_assign(size_type n, const value_type& value)
 {
     if(n>capacity())
     {
@@ -579,9 +587,9 @@ void vector<T>::fill_assign(size_type n, const value_type& value)
 }
 
 /* copy_assign 函数 */
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag)
+void vector<T, Alloc>::copy_assign(IIter first, IIter last, input_iterator_tag)
 {
     auto cur=begin_;
     for(; first!=last && cur!=end_; ++first, ++cur)
@@ -599,9 +607,9 @@ void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag)
 }
 
 /* 用[first, last)为容器赋值 */
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag)
+void vector<T, Alloc>::copy_assign(FIter first, FIter last, forward_iterator_tag)
 {
     const size_type len=orange_stl::distance(first, last);
     if(len>capacity()) 
@@ -626,9 +634,9 @@ void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag)
 }
 
 /* 重新分配空间，并且在pos处就地构造元素 */
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-void vector<T>::reallocate_emplace(iterator pos, Args&& ...args)
+void vector<T, Alloc>::reallocate_emplace(iterator pos, Args&& ...args)
 {
     const auto new_size = get_new_cap(1);
     auto new_begin = data_allocator::allocate(new_size);
@@ -652,8 +660,8 @@ void vector<T>::reallocate_emplace(iterator pos, Args&& ...args)
 }
 
 /* 重新分配空间并在pos处插入元素 */
-template <class T>
-void vector<T>::reallocate_insert(iterator pos, const value_type& value)
+template <class T, class Alloc>
+void vector<T, Alloc>::reallocate_insert(iterator pos, const value_type& value)
 {
     const auto new_size=get_new_cap(1);
     auto new_begin=data_allocator::allocate(new_size);
@@ -678,9 +686,9 @@ void vector<T>::reallocate_insert(iterator pos, const value_type& value)
 }
 
 /* fill_insert */
-template <class T>
-typename vector<T>::iterator
-vector<T>::fill_insert(iterator pos, size_type n, const value_type& value)
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::fill_insert(iterator pos, size_type n, const value_type& value)
 {
     if(n==0) return pos;
     const size_type xpos=pos-begin_;
@@ -700,7 +708,7 @@ vector<T>::fill_insert(iterator pos, size_type n, const value_type& value)
         else
         {
             end_=orange_stl::uninitialized_fill_n(end_, n-after_elems, value_copy);
-            end_=orange_stl:uninitialized_move(pos, old_end, end_);
+            end_=orange_stl::uninitialized_move(pos, old_end, end_);
             orange_stl::uninitialized_fill_n(pos, after_elems, value_copy);
         }
         
@@ -731,9 +739,9 @@ vector<T>::fill_insert(iterator pos, size_type n, const value_type& value)
 }
 
 /* copy_insert函数 */
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void vector<T>::copy_insert(iterator pos, IIter first, IIter last)
+void vector<T, Alloc>::copy_insert(iterator pos, IIter first, IIter last)
 {
     if(first==last) return;
 
@@ -783,8 +791,8 @@ void vector<T>::copy_insert(iterator pos, IIter first, IIter last)
 }
 
 /* resinert */
-template<class T>
-void vector<T>::reinsert(size_type size)
+template <class T, class Alloc>
+void vector<T, Alloc>::reinsert(size_type size)
 {
     auto new_begin = data_allocator::allocate(size);
     try{
@@ -802,40 +810,40 @@ void vector<T>::reinsert(size_type size)
 }
 
 /* 重载比价操作符 */
-template <class T>
-bool operator==(const vector<T>&lhs, const vector<T>& rhs)
+template <class T, class Alloc>
+bool operator==(const vector<T, Alloc>&lhs, const vector<T, Alloc>& rhs)
 {
     return lhs.size()==rhs.size()&&orange_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
-template <class T>
-bool operator<(const vector<T>&lhs, const vector<T>& rhs)
+template <class T, class Alloc>
+bool operator<(const vector<T, Alloc>&lhs, const vector<T, Alloc>& rhs)
 {
     return orange_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
-template <class T>
-bool operator!=(const vector<T>&lhs, const vector<T>& rhs)
+template <class T, class Alloc>
+bool operator!=(const vector<T, Alloc>&lhs, const vector<T, Alloc>& rhs)
 {
     return !(lhs==rhs);
 }
-template <class T>
-bool operator>(const vector<T>&lhs, const vector<T>& rhs)
+template <class T, class Alloc>
+bool operator>(const vector<T, Alloc>&lhs, const vector<T, Alloc>& rhs)
 {
     return rhs<lhs;
 }
-template <class T>
-bool operator<=(const vector<T>&lhs, const vector<T>& rhs)
+template <class T, class Alloc>
+bool operator<=(const vector<T, Alloc>&lhs, const vector<T, Alloc>& rhs)
 {
     return !(rhs<lhs);
 }
-template <class T>
-bool operator>=(const vector<T>&lhs, const vector<T>& rhs)
+template <class T, class Alloc>
+bool operator>=(const vector<T, Alloc>&lhs, const vector<T, Alloc>& rhs)
 {
     return !(lhs<rhs);
 }
 
 /* 重载orange_stl的swap */
-template <class T>
-void swap(vector<T>&lhs, vector<T>& rhs)
+template <class T, class Alloc>
+void swap(vector<T, Alloc>&lhs, vector<T, Alloc>& rhs)
 {
     lhs.swap(rhs);
 }
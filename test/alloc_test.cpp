@@ -0,0 +1,61 @@
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "orange_alloc.h"
+#include "orange_list.h"
+#include "test.h"
+
+// 多线程配置与释放，包括在另一个线程中释放本线程配置的区块
+static void churn(unsigned seed, std::vector<void*>* handoff)
+{
+    std::vector<std::pair<void*, size_t>> live;
+    for(int i = 0; i < 200000; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        const size_t bytes = 1 + (seed >> 8) % 600;
+        if(live.size() < 256 || (seed & 1))
+        {
+            char* p = static_cast<char*>(orange_stl::alloc::allocate(bytes));
+            std::memset(p, static_cast<int>(bytes & 0xff), bytes);
+            live.push_back(std::make_pair(static_cast<void*>(p), bytes));
+        }
+        else
+        {
+            const size_t k = (seed >> 4) % live.size();
+            char* p = static_cast<char*>(live[k].first);
+            EXPECT(static_cast<unsigned char>(p[live[k].second - 1]) == (live[k].second & 0xff));
+            orange_stl::alloc::deallocate(p, live[k].second);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+    for(size_t i = 0; i < live.size(); ++i)
+    {
+        if(handoff != nullptr && live[i].second == 64)
+            handoff->push_back(live[i].first);
+        else
+            orange_stl::alloc::deallocate(live[i].first, live[i].second);
+    }
+}
+
+int main()
+{
+    std::vector<void*> handoff[4];
+    std::vector<std::thread> threads;
+    for(unsigned t = 0; t < 4; ++t)
+        threads.emplace_back(churn, t + 1, &handoff[t]);
+    for(auto& th : threads)
+        th.join();
+    for(auto& v : handoff)
+    {
+        for(void* p : v)
+            orange_stl::alloc::deallocate(p, 64);
+    }
+
+    orange_stl::list<int, orange_stl::pool_allocator<int>> l;
+    for(int i = 0; i < 10000; ++i)
+        l.push_back(i);
+    EXPECT(l.size() == 10000 && l.front() == 0 && l.back() == 9999);
+    return 0;
+}
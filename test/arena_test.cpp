@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "orange_arena.h"
+#include "orange_map.h"
+#include "orange_vector.h"
+#include "test.h"
+
+static bool aligned(const void* p, size_t align)
+{
+    return reinterpret_cast<uintptr_t>(p) % align == 0;
+}
+
+// 对齐填充越过当前内存块末尾时必须换一块新的内存块
+static void test_padding_past_end()
+{
+    orange_stl::monotonic_arena a(1000);
+    char* p = static_cast<char*>(a.allocate(999, 1));
+    std::memset(p, 1, 999);
+    char* q = static_cast<char*>(a.allocate(16, 16));
+    EXPECT(aligned(q, 16));
+    std::memset(q, 2, 16);
+    EXPECT(p[998] == 1);
+    EXPECT(a.bytes_used() == 1015);
+}
+
+// 各种对齐与大小混合配置，写满每一块并检查互不重叠
+static void test_mixed_alignments()
+{
+    const size_t inits[] = {1, 7, 100, 1000, 4096};
+    for(size_t init : inits)
+    {
+        orange_stl::monotonic_arena a(init);
+        std::mt19937 rng(static_cast<unsigned>(init));
+        unsigned char* blocks[2000];
+        size_t sizes[2000];
+        for(int i = 0; i < 2000; ++i)
+        {
+            const size_t align = static_cast<size_t>(1) << (rng() % 9);   // 1 .. 256
+            sizes[i] = rng() % 300;
+            blocks[i] = static_cast<unsigned char*>(a.allocate(sizes[i], align));
+            EXPECT(aligned(blocks[i], align));
+            std::memset(blocks[i], i & 0xff, sizes[i]);
+        }
+        for(int i = 0; i < 2000; ++i)
+        {
+            for(size_t k = 0; k < sizes[i]; ++k)
+                EXPECT(blocks[i][k] == (i & 0xff));
+        }
+    }
+}
+
+static void test_reset()
+{
+    orange_stl::monotonic_arena a(64);
+    for(int round = 0; round < 3; ++round)
+    {
+        for(int i = 0; i < 500; ++i)
+        {
+            void* p = a.allocate(static_cast<size_t>(i % 50) + 1, 8);
+            EXPECT(aligned(p, 8));
+            std::memset(p, round, static_cast<size_t>(i % 50) + 1);
+        }
+        EXPECT(a.bytes_used() > 0);
+        a.reset();
+        EXPECT(a.bytes_used() == 0);
+    }
+    a.release();
+    EXPECT(a.bytes_used() == 0);
+    void* p = a.allocate(10, 64);
+    EXPECT(aligned(p, 64));
+}
+
+struct alignas(64) wide
+{
+    int v[3];
+};
+
+struct other_tag {};
+
+// arena_scope 把容器的配置重定向到调用者的 arena，嵌套的作用域离开时恢复
+static void test_scope()
+{
+    orange_stl::monotonic_arena outer(100), inner(100);
+    {
+        orange_stl::arena_scope<> s1(outer);
+        orange_stl::vector<wide, orange_stl::arena_allocator<wide>> v;
+        for(int i = 0; i < 100; ++i)
+        {
+            wide w = {{i, i, i}};
+            v.push_back(w);
+            EXPECT(aligned(&v.back(), 64));
+        }
+        const size_t outer_used = outer.bytes_used();
+        EXPECT(outer_used >= 100 * sizeof(wide));
+        {
+            orange_stl::arena_scope<> s2(inner);
+            orange_stl::map<int, int, orange_stl::less<int>,
+                            orange_stl::arena_allocator<orange_stl::pair<const int, int>>> m;
+            for(int i = 0; i < 1000; ++i)
+                m[i] = i;
+            EXPECT(m.size() == 1000 && m[999] == 999);
+            EXPECT(inner.bytes_used() > 0);
+            EXPECT(outer.bytes_used() == outer_used);
+        }
+        // 恢复为 outer
+        orange_stl::arena_allocator<wide>::allocate(1);
+        EXPECT(outer.bytes_used() == outer_used + sizeof(wide));
+        EXPECT(v[50].v[2] == 50);
+    }
+
+    // 不同标签的绑定互不影响
+    orange_stl::monotonic_arena tagged(100);
+    {
+        orange_stl::arena_scope<other_tag> s(tagged);
+        typedef orange_stl::arena_allocator<int, other_tag> int_alloc;
+        int* p = int_alloc::allocate(10);
+        p[9] = 1;
+        EXPECT(tagged.bytes_used() == 10 * sizeof(int));
+        EXPECT(int_alloc::allocate(0) == nullptr);
+    }
+    inner.reset();
+    outer.reset();
+    EXPECT(inner.bytes_used() == 0 && outer.bytes_used() == 0);
+}
+
+int main()
+{
+    test_padding_past_end();
+    test_mixed_alignments();
+    test_reset();
+    test_scope();
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <string>
+
+#include "orange_astring.h"
+#include "test.h"
+
+// find / rfind 与 std::string 逐一对照，覆盖空串、越界的 pos 与 count == 0
+int main()
+{
+    const char* hays[] = {"", "a", "abc", "abcabc", "aaaa", "hello world, hello"};
+    const char* needles[] = {"", "a", "bc", "abc", "aa", "hello", "xyz", "abcabcabc"};
+    for(const char* h : hays)
+    {
+        orange_stl::string s(h);
+        std::string ref(h);
+        for(const char* n : needles)
+        {
+            for(size_t pos = 0; pos <= ref.size() + 2; ++pos)
+            {
+                EXPECT(s.find(n, pos) == ref.find(n, pos));
+                EXPECT(s.rfind(n, pos) == ref.rfind(n, pos));
+                for(size_t count = 0; count <= std::char_traits<char>::length(n); ++count)
+                {
+                    EXPECT(s.find(n, pos, count) == ref.find(n, pos, count));
+                    EXPECT(s.rfind(n, pos, count) == ref.rfind(n, pos, count));
+                }
+            }
+            EXPECT(s.rfind(n) == ref.rfind(n));
+        }
+    }
+    // count == 0 时不能读取 str
+    EXPECT(orange_stl::string("abc").rfind(static_cast<const char*>(nullptr), 1, 0) == 1);
+    EXPECT(orange_stl::string("abc").rfind("", 1) == 1);
+
+    // 短字符串与堆上字符串之间的切换
+    orange_stl::string sso("short");
+    sso.append(100, 'x');
+    EXPECT(sso.size() == 105 && sso[4] == 't' && sso[104] == 'x');
+    sso = "tiny";
+    EXPECT(sso.size() == 4 && sso == "tiny");
+    return 0;
+}
@@ -0,0 +1,126 @@
+// btree_map 与 map (红黑树) 的对比：随机插入、命中与不命中各半的查找、顺序遍历、随机删除，以及内存占用
+// 内存占用为通过配置器申请的字节数，不含 malloc 自身的开销
+// 用法: bench_btree [lookups]
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "orange_btree_map.h"
+#include "orange_map.h"
+#include "orange_vector.h"
+#include "test.h"
+
+static size_t g_live_bytes = 0;
+
+// 统计当前配置的字节数的配置器
+template <class T>
+class counting_allocator : public orange_stl::allocator<T>
+{
+public:
+    template <class U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    static T* allocate()
+    {
+        return allocate(1);
+    }
+    static T* allocate(size_t n)
+    {
+        g_live_bytes += n * sizeof(T);
+        return orange_stl::allocator<T>::allocate(n);
+    }
+    static void deallocate(T* ptr)
+    {
+        if(ptr != nullptr)
+            g_live_bytes -= sizeof(T);
+        orange_stl::allocator<T>::deallocate(ptr);
+    }
+    static void deallocate(T* ptr, size_t n)
+    {
+        if(ptr != nullptr)
+            g_live_bytes -= n * sizeof(T);
+        orange_stl::allocator<T>::deallocate(ptr, n);
+    }
+};
+
+typedef counting_allocator<orange_stl::pair<const int, int>> alloc_type;
+typedef orange_stl::btree_map<int, int, orange_stl::less<int>, alloc_type> btree_type;
+typedef orange_stl::map<int, int, orange_stl::less<int>, alloc_type> map_type;
+
+struct result
+{
+    double insert_ms, find_ms, iterate_ms, erase_ms;
+    size_t bytes;
+};
+
+template <class Map>
+static result run(const orange_stl::vector<int>& keys, const orange_stl::vector<int>& probes)
+{
+    result r;
+    Map m;
+    const size_t base = g_live_bytes;
+
+    orange_test::timer t1;
+    for(size_t i = 0; i < keys.size(); ++i)
+        m.insert(orange_stl::make_pair(keys[i], static_cast<int>(i)));
+    r.insert_ms = t1.elapsed_ms();
+    r.bytes = g_live_bytes - base;
+
+    size_t hits = 0;
+    orange_test::timer t2;
+    for(size_t i = 0; i < probes.size(); ++i)
+    {
+        if(m.find(probes[i]) != m.end())
+            ++hits;
+    }
+    r.find_ms = t2.elapsed_ms();
+
+    long long sum = 0;
+    orange_test::timer t3;
+    for(auto it = m.begin(); it != m.end(); ++it)
+        sum += it->second;
+    r.iterate_ms = t3.elapsed_ms();
+
+    orange_test::timer t4;
+    for(size_t i = 0; i < keys.size(); i += 2)
+        m.erase(keys[i]);
+    r.erase_ms = t4.elapsed_ms();
+
+    EXPECT(hits == probes.size() / 2);
+    EXPECT(m.size() == keys.size() / 2);
+    orange_test::do_not_optimize(sum);
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t lookups = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::printf("%10s %8s %12s %12s %12s %12s %14s\n",
+                "N", "tree", "insert (ms)", "find (ms)", "iterate (ms)", "erase (ms)", "bytes/elem");
+    const size_t sizes[] = {1000, 100000, 2000000};
+    for(size_t n : sizes)
+    {
+        // 偶数为键，奇数探测必然不命中；键互不相同
+        std::mt19937 rng(static_cast<unsigned>(n));
+        orange_stl::vector<int> keys(n);
+        for(size_t i = 0; i < n; ++i)
+            keys[i] = static_cast<int>(i * 2);
+        for(size_t i = n; i > 1; --i)
+            orange_stl::swap(keys[i - 1], keys[rng() % i]);
+        orange_stl::vector<int> probes(lookups);
+        for(size_t i = 0; i < lookups; ++i)
+            probes[i] = (i & 1) ? keys[rng() % n] : static_cast<int>(rng() % (2 * n)) | 1;
+
+        const result b = run<btree_type>(keys, probes);
+        const result m = run<map_type>(keys, probes);
+        std::printf("%10zu %8s %12.1f %12.1f %12.2f %12.1f %14.1f\n", n, "btree",
+                    b.insert_ms, b.find_ms, b.iterate_ms, b.erase_ms, static_cast<double>(b.bytes) / n);
+        std::printf("%10zu %8s %12.1f %12.1f %12.2f %12.1f %14.1f\n", n, "map",
+                    m.insert_ms, m.find_ms, m.iterate_ms, m.erase_ms, static_cast<double>(m.bytes) / n);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+// concurrent_unordered_map 与加了一把 std::mutex 的 unordered_map 的吞吐量对比
+// 预先插入 keys 个键，每个线程执行 90% find、10% upsert，键均匀随机，总操作数固定
+// 线程数从 1 加倍到 max_threads，输出每秒百万次操作数
+// 在单核机器上只能比较单次操作的开销，看不到扩展性
+// 用法: bench_concurrent_map [keys] [total_ops] [max_threads]
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "orange_concurrent_unordered_map.h"
+#include "orange_unordered_map.h"
+#include "test.h"
+
+// 用一把互斥锁保护整个 unordered_map，作为对照
+class locked_map
+{
+public:
+    bool find(int key, long long& value) const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = map_.find(key);
+        if(it == map_.end())
+            return false;
+        value = it->second;
+        return true;
+    }
+
+    void upsert(int key, long long value)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        map_[key] = value;
+    }
+
+private:
+    mutable std::mutex                        mutex_;
+    orange_stl::unordered_map<int, long long> map_;
+};
+
+template <class Map>
+static double run(Map& m, size_t keys, size_t total_ops, size_t threads)
+{
+    std::vector<std::thread> pool;
+    std::vector<size_t> hits(threads, 0);
+    orange_test::timer t;
+    for(size_t i = 0; i < threads; ++i)
+    {
+        pool.emplace_back([&, i] {
+            unsigned seed = static_cast<unsigned>(i) * 7919u + 1;
+            const size_t ops = total_ops / threads;
+            long long v;
+            size_t h = 0;
+            for(size_t k = 0; k < ops; ++k)
+            {
+                seed = seed * 1103515245u + 12345u;
+                const int key = static_cast<int>((seed >> 4) % keys);
+                if((seed >> 24) % 10 != 0)
+                    h += m.find(key, v) ? 1 : 0;
+                else
+                    m.upsert(key, static_cast<long long>(k));
+            }
+            hits[i] = h;
+        });
+    }
+    for(auto& th : pool)
+        th.join();
+    const double ms = t.elapsed_ms();
+    size_t total_hits = 0;
+    for(size_t h : hits)
+        total_hits += h;
+    orange_test::do_not_optimize(total_hits);
+    return static_cast<double>(total_ops) / ms / 1000.0;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t total_ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8000000;
+    const size_t max_threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 32;
+
+    orange_stl::concurrent_unordered_map<int, long long> cm;
+    locked_map lm;
+    cm.reserve(keys);
+    for(size_t i = 0; i < keys; ++i)
+    {
+        cm.upsert(static_cast<int>(i), static_cast<long long>(i));
+        lm.upsert(static_cast<int>(i), static_cast<long long>(i));
+    }
+
+    std::printf("keys = %zu, ops = %zu, shards = %zu, hardware_concurrency = %u\n",
+                keys, total_ops, cm.shard_count(), std::thread::hardware_concurrency());
+    std::printf("%8s %18s %18s\n", "threads", "sharded (Mops/s)", "mutex (Mops/s)");
+    for(size_t t = 1; t <= max_threads; t *= 2)
+    {
+        const double sharded = run(cm, keys, total_ops, t);
+        const double locked = run(lm, keys, total_ops, t);
+        std::printf("%8zu %18.2f %18.2f\n", t, sharded, locked);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+// unordered_map::find_batch 与逐个 find 的对比
+// uint64 键，一半命中一半不命中，find_batch 每次处理 256 个键
+// 分别测试 prime_bucket_policy 和 power2_bucket_policy，表的大小从装得进缓存到远大于缓存
+// 用法: bench_find_batch [lookups]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "orange_unordered_map.h"
+#include "orange_vector.h"
+#include "test.h"
+
+enum { EBatchChunk = 256 };
+
+template <class Map>
+static double time_find(const Map& m, const orange_stl::vector<uint64_t>& probes, size_t& hits)
+{
+    orange_test::timer t;
+    hits = 0;
+    for(size_t i = 0; i < probes.size(); ++i)
+    {
+        if(m.find(probes[i]) != m.end())
+            ++hits;
+    }
+    return t.elapsed_ms();
+}
+
+template <class Map>
+static double time_find_batch(const Map& m, const orange_stl::vector<uint64_t>& probes, size_t& hits)
+{
+    typename Map::const_iterator out[EBatchChunk];
+    orange_test::timer t;
+    hits = 0;
+    for(size_t i = 0; i < probes.size(); i += EBatchChunk)
+    {
+        const size_t len = orange_stl::min(probes.size() - i, static_cast<size_t>(EBatchChunk));
+        m.find_batch(probes.begin() + i, probes.begin() + i + len, out);
+        for(size_t j = 0; j < len; ++j)
+        {
+            if(out[j] != m.end())
+                ++hits;
+        }
+    }
+    return t.elapsed_ms();
+}
+
+template <class Policy>
+static void run(const char* policy, size_t n, size_t lookups)
+{
+    typedef orange_stl::unordered_map<uint64_t, uint64_t, orange_stl::hash<uint64_t>,
+                                      orange_stl::equal_to<uint64_t>,
+                                      orange_stl::allocator<orange_stl::pair<const uint64_t, uint64_t>>,
+                                      Policy> map_type;
+    std::mt19937_64 rng(n);
+    orange_stl::vector<uint64_t> keys(n);
+    map_type m;
+    for(size_t i = 0; i < n; ++i)
+    {
+        // 偶数为键，奇数探测必然不命中
+        keys[i] = rng() & ~static_cast<uint64_t>(1);
+        m[keys[i]] = i;
+    }
+    orange_stl::vector<uint64_t> probes(lookups);
+    for(size_t i = 0; i < lookups; ++i)
+        probes[i] = (i & 1) ? keys[rng() % n] : (rng() | 1);
+
+    size_t find_hits, batch_hits;
+    const double find_ms = time_find(m, probes, find_hits);
+    const double batch_ms = time_find_batch(m, probes, batch_hits);
+    EXPECT(find_hits == batch_hits);
+    std::printf("%10zu %8s %12.1f %16.1f\n", n, policy, find_ms, batch_ms);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t lookups = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    std::printf("%10s %8s %12s %16s\n", "N", "policy", "find (ms)", "find_batch (ms)");
+    const size_t sizes[] = {50000, 1000000, 16000000};
+    for(size_t n : sizes)
+    {
+        run<orange_stl::prime_bucket_policy>("prime", n, lookups);
+        run<orange_stl::power2_bucket_policy>("power2", n, lookups);
+    }
+    return 0;
+}
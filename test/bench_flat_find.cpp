@@ -0,0 +1,60 @@
+// flat_hash_map (组匹配的开放寻址) 与 unordered_map (拉链法) 的 find 对比
+// 随机 int 键，一半命中一半不命中
+// 用法: bench_flat_find [lookups]
+// 以 -mavx2 -DORANGE_FLAT_GROUP_AVX2 编译可测 AVX2 版本，以 -mno-sse2 编译可测 8 字节的可移植版本
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "orange_flat_hash_map.h"
+#include "orange_unordered_map.h"
+#include "test.h"
+
+template <class Map>
+static double time_find(const Map& m, const std::vector<int>& probes, size_t& hits)
+{
+    orange_test::timer t;
+    hits = 0;
+    for(size_t i = 0; i < probes.size(); ++i)
+    {
+        if(m.find(probes[i]) != m.end())
+            ++hits;
+    }
+    return t.elapsed_ms();
+}
+
+int main(int argc, char** argv)
+{
+    const size_t lookups = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    std::printf("group width: %d control bytes\n", static_cast<int>(orange_stl::flat_group::width));
+    std::printf("%10s %14s %14s\n", "N", "flat (ms)", "chained (ms)");
+
+    const size_t sizes[] = {1000, 100000, 2000000};
+    for(size_t n : sizes)
+    {
+        std::mt19937 rng(static_cast<unsigned>(n));
+        std::vector<int> keys(n);
+        orange_stl::flat_hash_map<int, int> flat;
+        orange_stl::unordered_map<int, int> chained;
+        for(size_t i = 0; i < n; ++i)
+        {
+            // 偶数为键，奇数探测必然不命中
+            keys[i] = static_cast<int>(rng() & 0x3ffffffe);
+            flat[keys[i]] = static_cast<int>(i);
+            chained[keys[i]] = static_cast<int>(i);
+        }
+
+        std::vector<int> probes(lookups);
+        for(size_t i = 0; i < lookups; ++i)
+            probes[i] = (i & 1) ? keys[rng() % n] : static_cast<int>(rng() | 1);
+
+        size_t flat_hits, chained_hits;
+        const double flat_ms = time_find(flat, probes, flat_hits);
+        const double chained_ms = time_find(chained, probes, chained_hits);
+        EXPECT(flat_hits == chained_hits);
+        std::printf("%10zu %14.1f %14.1f\n", n, flat_ms, chained_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// unordered_map 全表遍历的基准测试
+// 1. 稀疏表：预留大量桶后只插入少量元素，遍历耗时应只与元素个数有关，与桶数无关
+// 2. 删除后的表：插入大量元素再删掉大部分，桶数保持不变
+// 3. 稠密表：正常负载因子下的遍历
+// 同时给出逐桶遍历 (begin(n)/end(n)) 的耗时作为扫描全部桶的参照
+// 稠密表中节点按桶链接，链表顺序与内存中的分配顺序无关，遍历是一串相互依赖的缓存缺失；
+// 逐桶遍历的各个桶之间没有依赖，缺失可以重叠，所以稠密时逐桶反而更快(libstdc++ 的表现相同)
+// 用法: bench_hashtable_traversal [rounds]
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "orange_unordered_map.h"
+#include "test.h"
+
+typedef orange_stl::unordered_map<int, int> map_type;
+
+static double time_walk(const map_type& m, size_t rounds, long long& sum)
+{
+    orange_test::timer t;
+    sum = 0;
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(auto it = m.begin(); it != m.end(); ++it)
+            sum += it->second;
+    }
+    return t.elapsed_ms() / rounds;
+}
+
+static double time_bucket_walk(const map_type& m, size_t rounds, long long& sum)
+{
+    orange_test::timer t;
+    sum = 0;
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        const size_t nb = m.bucket_count();
+        for(size_t b = 0; b < nb; ++b)
+        {
+            for(auto it = m.begin(b); it != m.end(b); ++it)
+                sum += it->second;
+        }
+    }
+    return t.elapsed_ms() / rounds;
+}
+
+static void report(const char* name, const map_type& m, size_t rounds)
+{
+    long long walk_sum, bucket_sum;
+    const double walk_ms = time_walk(m, rounds, walk_sum);
+    const double bucket_ms = time_bucket_walk(m, rounds, bucket_sum);
+    EXPECT(walk_sum == bucket_sum);
+    size_t count = 0;
+    for(auto it = m.begin(); it != m.end(); ++it)
+        ++count;
+    EXPECT(count == m.size());
+    orange_test::do_not_optimize(walk_sum);
+    std::printf("%-10s %10zu %12zu %14.3f %16.3f\n",
+                name, m.size(), m.bucket_count(), walk_ms, bucket_ms);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+    std::printf("%-10s %10s %12s %14s %16s\n",
+                "table", "size", "buckets", "iterate (ms)", "per bucket (ms)");
+
+    std::mt19937 rng(2024);
+    {
+        map_type m;
+        m.reserve(4500000);
+        while(m.size() < 100000)
+            m[static_cast<int>(rng())] = static_cast<int>(m.size());
+        report("sparse", m, rounds);
+    }
+    {
+        map_type m;
+        for(int i = 0; i < 4000000; ++i)
+            m[i] = i;
+        for(int i = 0; i < 4000000; ++i)
+        {
+            if(i % 40 != 0)
+                m.erase(i);
+        }
+        report("erased", m, rounds);
+    }
+    {
+        map_type m;
+        while(m.size() < 1000000)
+            m[static_cast<int>(rng())] = static_cast<int>(m.size());
+        report("dense", m, rounds);
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// lockfree_unordered_map 在读多写少负载下的吞吐量，对照为 concurrent_unordered_map 和加了一把 std::mutex 的 unordered_map
+// 预先插入 keys 个键，每个线程执行 read_pct% 的 find，其余为 insert_or_assign/upsert，键均匀随机，总操作数固定
+// 线程数从 1 加倍到 max_threads，输出每秒百万次操作数
+// 在单核机器上只能比较单次操作的开销，看不到读者的扩展性
+// 用法: bench_lockfree_map [keys] [total_ops] [max_threads] [read_pct]
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "orange_concurrent_unordered_map.h"
+#include "orange_lockfree_unordered_map.h"
+#include "orange_unordered_map.h"
+#include "test.h"
+
+// 三种容器统一成 find/upsert 两个操作
+class lockfree_adapter
+{
+public:
+    explicit lockfree_adapter(size_t keys) : map_(keys) {}
+    bool find(int key, long long& value) const { return map_.find(key, value); }
+    void upsert(int key, long long value)      { map_.insert_or_assign(key, value); }
+
+private:
+    orange_stl::lockfree_unordered_map<int, long long> map_;
+};
+
+class sharded_adapter
+{
+public:
+    explicit sharded_adapter(size_t keys) { map_.reserve(keys); }
+    bool find(int key, long long& value) const { return map_.find(key, value); }
+    void upsert(int key, long long value)      { map_.upsert(key, value); }
+
+private:
+    orange_stl::concurrent_unordered_map<int, long long> map_;
+};
+
+class locked_adapter
+{
+public:
+    explicit locked_adapter(size_t keys) { map_.reserve(keys); }
+
+    bool find(int key, long long& value) const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = map_.find(key);
+        if(it == map_.end())
+            return false;
+        value = it->second;
+        return true;
+    }
+
+    void upsert(int key, long long value)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        map_[key] = value;
+    }
+
+private:
+    mutable std::mutex                        mutex_;
+    orange_stl::unordered_map<int, long long> map_;
+};
+
+template <class Map>
+static double run(Map& m, size_t keys, size_t total_ops, size_t threads, unsigned read_pct)
+{
+    std::vector<std::thread> pool;
+    std::vector<size_t> hits(threads, 0);
+    orange_test::timer t;
+    for(size_t i = 0; i < threads; ++i)
+    {
+        pool.emplace_back([&, i] {
+            unsigned seed = static_cast<unsigned>(i) * 7919u + 1;
+            const size_t ops = total_ops / threads;
+            long long v;
+            size_t h = 0;
+            for(size_t k = 0; k < ops; ++k)
+            {
+                seed = seed * 1103515245u + 12345u;
+                const int key = static_cast<int>((seed >> 4) % keys);
+                if((seed >> 24) % 100 < read_pct)
+                    h += m.find(key, v) ? 1 : 0;
+                else
+                    m.upsert(key, static_cast<long long>(k));
+            }
+            hits[i] = h;
+        });
+    }
+    for(auto& th : pool)
+        th.join();
+    const double ms = t.elapsed_ms();
+    size_t total_hits = 0;
+    for(size_t h : hits)
+        total_hits += h;
+    orange_test::do_not_optimize(total_hits);
+    return static_cast<double>(total_ops) / ms / 1000.0;
+}
+
+template <class Map>
+static void fill(Map& m, size_t keys)
+{
+    for(size_t i = 0; i < keys; ++i)
+        m.upsert(static_cast<int>(i), static_cast<long long>(i));
+}
+
+int main(int argc, char** argv)
+{
+    const size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t total_ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8000000;
+    const size_t max_threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 32;
+    const unsigned read_pct = argc > 4 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 99;
+
+    lockfree_adapter lf(keys);
+    sharded_adapter sh(keys);
+    locked_adapter lk(keys);
+    fill(lf, keys);
+    fill(sh, keys);
+    fill(lk, keys);
+
+    std::printf("keys = %zu, ops = %zu, reads = %u%%, hardware_concurrency = %u\n",
+                keys, total_ops, read_pct, std::thread::hardware_concurrency());
+    std::printf("%8s %18s %18s %18s\n", "threads", "lockfree (Mops/s)", "sharded (Mops/s)", "mutex (Mops/s)");
+    for(size_t t = 1; t <= max_threads; t *= 2)
+    {
+        const double a = run(lf, keys, total_ops, t, read_pct);
+        const double b = run(sh, keys, total_ops, t, read_pct);
+        const double c = run(lk, keys, total_ops, t, read_pct);
+        std::printf("%8zu %18.2f %18.2f %18.2f\n", t, a, b, c);
+    }
+    return 0;
+}
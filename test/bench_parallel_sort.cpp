@@ -0,0 +1,64 @@
+// parallel_sort 的扩展性测试：与单线程 orange_stl::sort 对比，线程数从 1 加倍到 max_threads
+// 线程数为 t 时使用有 t-1 个工作线程的线程池，调用线程也参与执行
+// 用法: bench_parallel_sort [n] [max_threads] [cutoff]
+//
+// 在单核机器上各线程分时运行，此时的耗时就是并行算法的总工作量，
+// 它与 sort 耗时之比是 sample sort 相对串行排序的额外工作，决定了多核上加速比的上限
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include "orange_parallel_algo.h"
+#include "test.h"
+
+static bool is_sorted_vec(const orange_stl::vector<unsigned>& v)
+{
+    for(size_t i = 1; i < v.size(); ++i)
+    {
+        if(v[i] < v[i - 1])
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000000;
+    size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    const size_t cutoff = argc > 3 ? std::strtoul(argv[3], nullptr, 10)
+                                   : static_cast<size_t>(orange_stl::EParallelSortCutoff);
+    if(max_threads == 0)
+        max_threads = 1;
+
+    orange_stl::vector<unsigned> input(n);
+    std::mt19937 rng(12345);
+    for(size_t i = 0; i < n; ++i)
+        input[i] = rng();
+
+    std::printf("n = %zu, hardware_concurrency = %u, cutoff = %zu\n",
+                n, std::thread::hardware_concurrency(), cutoff);
+
+    orange_stl::vector<unsigned> v(input);
+    orange_test::timer serial_timer;
+    orange_stl::sort(v.begin(), v.end());
+    const double serial_ms = serial_timer.elapsed_ms();
+    EXPECT(is_sorted_vec(v));
+    std::printf("%8s %12s %10s\n", "threads", "time (ms)", "speedup");
+    std::printf("%8s %12.1f %10.2f\n", "sort", serial_ms, 1.0);
+
+    for(size_t t = 1; t <= max_threads; t *= 2)
+    {
+        orange_stl::thread_pool pool(t - 1);
+        v = input;
+        orange_test::timer timer;
+        orange_stl::parallel_sort(v.begin(), v.end(), orange_stl::less<unsigned>(), cutoff, pool);
+        const double ms = timer.elapsed_ms();
+        EXPECT(is_sorted_vec(v));
+        std::printf("%8zu %12.1f %10.2f\n", t, ms, serial_ms / ms);
+        if(t < max_threads && t * 2 > max_threads)
+            t = max_threads / 2;
+    }
+    return 0;
+}
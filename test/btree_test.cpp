@@ -0,0 +1,237 @@
+#include <map>
+#include <random>
+#include <set>
+
+#include "orange_btree_map.h"
+#include "orange_btree_set.h"
+#include "test.h"
+
+// 显式实例化全部成员
+template class orange_stl::btree_map<int, int>;
+template class orange_stl::btree_multimap<int, int>;
+template class orange_stl::btree_set<int>;
+template class orange_stl::btree_multiset<int>;
+
+template <class BMap, class SMap>
+static bool same(const BMap& b, const SMap& s)
+{
+    if(b.size() != s.size())
+        return false;
+    auto it = s.begin();
+    for(auto bt = b.begin(); bt != b.end(); ++bt, ++it)
+    {
+        if(bt->first != it->first || bt->second != it->second)
+            return false;
+    }
+    // 反向遍历
+    auto rit = s.rbegin();
+    for(auto rbt = b.rbegin(); rbt != b.rend(); ++rbt, ++rit)
+    {
+        if(rbt->first != rit->first || rbt->second != rit->second)
+            return false;
+    }
+    return true;
+}
+
+// 与 std::map 对比，键的范围较小，保证节点反复分裂与合并
+static void test_map()
+{
+    orange_stl::btree_map<int, int> b;
+    std::map<int, int> s;
+    std::mt19937 rng(3);
+    for(int i = 0; i < 200000; ++i)
+    {
+        const int key = static_cast<int>(rng() % 3000);
+        switch(rng() % 8)
+        {
+        case 0:
+            EXPECT(b.insert(orange_stl::make_pair(key, i)).second == s.insert(std::make_pair(key, i)).second);
+            break;
+        case 1:
+            EXPECT(b.emplace(key, i).second == s.emplace(key, i).second);
+            break;
+        case 2:
+            b[key] = i;
+            s[key] = i;
+            break;
+        case 3:
+            EXPECT(b.insert_or_assign(key, i).second == (s.count(key) == 0));
+            s[key] = i;
+            break;
+        case 4:
+        case 5:
+            EXPECT(b.erase(key) == s.erase(key));
+            break;
+        case 6:
+        {
+            // erase(iterator) 返回下一个位置
+            auto bt = b.lower_bound(key);
+            auto st = s.lower_bound(key);
+            EXPECT((bt == b.end()) == (st == s.end()));
+            if(bt != b.end())
+            {
+                bt = b.erase(bt);
+                st = s.erase(st);
+                EXPECT((bt == b.end()) == (st == s.end()));
+                EXPECT(bt == b.end() || bt->first == st->first);
+            }
+            break;
+        }
+        default:
+        {
+            auto bt = b.find(key);
+            auto st = s.find(key);
+            EXPECT((bt == b.end()) == (st == s.end()));
+            EXPECT(bt == b.end() || bt->second == st->second);
+            auto bu = b.upper_bound(key);
+            auto su = s.upper_bound(key);
+            EXPECT((bu == b.end()) == (su == s.end()));
+            EXPECT(bu == b.end() || bu->first == su->first);
+            EXPECT(b.count(key) == s.count(key));
+            break;
+        }
+        }
+        if(i % 20000 == 0)
+            EXPECT(same(b, s));
+    }
+    EXPECT(same(b, s));
+
+    // erase(first, last)
+    auto bf = b.lower_bound(1000), bl = b.lower_bound(2000);
+    s.erase(s.lower_bound(1000), s.lower_bound(2000));
+    b.erase(bf, bl);
+    EXPECT(same(b, s));
+
+    // 复制、移动、赋值
+    orange_stl::btree_map<int, int> c(b);
+    EXPECT(c == b && same(c, s));
+    orange_stl::btree_map<int, int> m(orange_stl::move(c));
+    EXPECT(m == b && c.empty());
+    c = m;
+    EXPECT(c == b);
+    m = {{1, 1}, {2, 2}};
+    EXPECT(m.size() == 2 && m.at(2) == 2);
+    c = orange_stl::move(m);
+    EXPECT(c.size() == 2);
+    b.clear();
+    EXPECT(b.empty() && b.begin() == b.end());
+
+    // 迭代器的复制赋值
+    orange_stl::btree_map<int, int>::iterator it = c.begin();
+    orange_stl::btree_map<int, int>::iterator it2;
+    it2 = it;
+    orange_stl::btree_map<int, int>::const_iterator cit;
+    cit = it2;
+    orange_stl::btree_map<int, int>::const_iterator cit2;
+    cit2 = cit;
+    EXPECT(cit2 == c.cbegin() && (++it2)->first == 2);
+}
+
+// 与 std::multimap 对比，相等的键保持插入顺序
+static void test_multimap()
+{
+    orange_stl::btree_multimap<int, int> b;
+    std::multimap<int, int> s;
+    std::mt19937 rng(5);
+    for(int i = 0; i < 100000; ++i)
+    {
+        const int key = static_cast<int>(rng() % 500);
+        switch(rng() % 5)
+        {
+        case 0:
+        case 1:
+            b.insert(orange_stl::make_pair(key, i));
+            s.insert(std::make_pair(key, i));
+            break;
+        case 2:
+            b.emplace(key, i);
+            s.emplace(key, i);
+            break;
+        case 3:
+            EXPECT(b.erase(key) == s.erase(key));
+            break;
+        default:
+        {
+            EXPECT(b.count(key) == s.count(key));
+            auto br = b.equal_range(key);
+            auto sr = s.equal_range(key);
+            for(; br.first != br.second && sr.first != sr.second; ++br.first, ++sr.first)
+                EXPECT(br.first->second == sr.first->second);
+            EXPECT(br.first == br.second && sr.first == sr.second);
+            break;
+        }
+        }
+    }
+    EXPECT(same(b, s));
+}
+
+static void test_set()
+{
+    orange_stl::btree_set<int> b;
+    orange_stl::btree_multiset<int> bm;
+    std::set<int> s;
+    std::multiset<int> sm;
+    std::mt19937 rng(9);
+    for(int i = 0; i < 50000; ++i)
+    {
+        const int key = static_cast<int>(rng() % 2000);
+        if(rng() % 3 == 0)
+        {
+            EXPECT(b.erase(key) == s.erase(key));
+            EXPECT(bm.erase(key) == sm.erase(key));
+        }
+        else
+        {
+            EXPECT(b.insert(key).second == s.insert(key).second);
+            bm.insert(key);
+            sm.insert(key);
+        }
+    }
+    EXPECT(b.size() == s.size() && bm.size() == sm.size());
+    auto it = s.begin();
+    for(int v : b)
+        EXPECT(v == *it++);
+    auto mit = sm.begin();
+    for(int v : bm)
+        EXPECT(v == *mit++);
+}
+
+static void test_set_assign()
+{
+    orange_stl::btree_set<int> s;
+    for(int i = 0; i < 1000; ++i)
+        s.insert(i);
+    orange_stl::btree_set<int> t{5};
+    t = s;
+    EXPECT(t == s && t.size() == 1000);
+    t = {9, 7, 7, 8};
+    EXPECT(t.size() == 3 && *t.begin() == 7);
+    t = orange_stl::move(s);
+    EXPECT(t.size() == 1000 && *t.begin() == 0);
+    t.clear();
+    EXPECT(t.empty() && t.begin() == t.end());
+    t.insert(4);
+    EXPECT(t.size() == 1 && t.count(4) == 1);
+
+    orange_stl::btree_multiset<int> ms{3, 1, 3};
+    orange_stl::btree_multiset<int> mt;
+    mt = ms;
+    EXPECT(mt == ms && mt.count(3) == 2);
+    mt = {5, 5, 4};
+    EXPECT(mt.size() == 3 && *mt.begin() == 4 && mt.count(5) == 2);
+    mt = orange_stl::move(ms);
+    EXPECT(mt.size() == 3 && *mt.begin() == 1);
+    mt.clear();
+    EXPECT(mt.empty() && mt.count(3) == 0);
+    mt.insert(2);
+    EXPECT(mt.size() == 1);
+}
+
+int main()
+{
+    test_map();
+    test_multimap();
+    test_set();
+    test_set_assign();
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "orange_concurrent_unordered_map.h"
+#include "test.h"
+
+typedef orange_stl::concurrent_unordered_map<int, long long> map_type;
+
+enum { EThreads = 4, EOps = 40000, EKeysPerThread = 2000, ECounters = 16, EIncrements = 4800 };
+
+// 值总是 key * 1000 + 版本号，读者据此检查读到的值没有被撕裂
+static long long make_value(int key, int version)
+{
+    return static_cast<long long>(key) * 1000 + version % 1000;
+}
+
+// 每个线程只修改自己的键(key % EThreads == tid)，同时用 std::unordered_map 记录期望的内容
+static void writer(map_type& m, int tid, std::unordered_map<int, long long>& model)
+{
+    unsigned seed = static_cast<unsigned>(tid) + 1;
+    for(int i = 0; i < EOps; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        const int key = static_cast<int>((seed >> 8) % EKeysPerThread) * EThreads + tid;
+        const long long value = make_value(key, i);
+        switch((seed >> 4) % 5)
+        {
+        case 0:
+            EXPECT(m.insert(orange_stl::make_pair(key, value)) == (model.count(key) == 0));
+            model.insert(std::make_pair(key, value));
+            break;
+        case 1:
+            EXPECT(m.erase(key) == model.erase(key));
+            break;
+        case 2:
+            EXPECT(m.upsert(key, value) == (model.count(key) == 0));
+            model[key] = value;
+            break;
+        case 3:
+            EXPECT(m.try_emplace(key, value) == (model.count(key) == 0));
+            model.insert(std::make_pair(key, value));
+            break;
+        default:
+        {
+            long long got = -1;
+            const bool found = m.find(key, got);
+            auto it = model.find(key);
+            EXPECT(found == (it != model.end()));
+            EXPECT(!found || got == it->second);
+            break;
+        }
+        }
+    }
+}
+
+// 所有线程共同累加同一组计数器，upsert_with 的读取-修改-写回必须是原子的
+static void incrementer(map_type& m)
+{
+    for(int i = 0; i < EIncrements; ++i)
+        m.upsert_with(-1 - i % ECounters, [](long long& v) { ++v; }, 1LL);
+}
+
+// 读者并发地遍历、查找，检查读到的值与键一致
+static void reader(const map_type& m, const std::atomic<bool>& stop)
+{
+    while(!stop.load(std::memory_order_acquire))
+    {
+        m.for_each([](const orange_stl::pair<const int, long long>& p) {
+            if(p.first >= 0)
+                EXPECT(p.second / 1000 == p.first);
+        });
+        for(int key = 0; key < 200; ++key)
+        {
+            long long v;
+            if(m.find(key, v))
+                EXPECT(v / 1000 == key);
+            m.visit(key, [key](const orange_stl::pair<const int, long long>& p) {
+                EXPECT(p.first == key && p.second / 1000 == key);
+            });
+        }
+        EXPECT(m.size() <= static_cast<size_t>(EThreads * EKeysPerThread + ECounters));
+    }
+}
+
+static void test_rw_spinlock()
+{
+    orange_stl::rw_spinlock lock;
+    long long counter = 0;
+    std::vector<std::thread> threads;
+    for(int t = 0; t < EThreads; ++t)
+    {
+        threads.emplace_back([&] {
+            for(int i = 0; i < 20000; ++i)
+            {
+                if(i % 4 == 0)
+                {
+                    std::lock_guard<orange_stl::rw_spinlock> guard(lock);
+                    ++counter;
+                }
+                else
+                {
+                    orange_stl::shared_lock_guard<orange_stl::rw_spinlock> guard(lock);
+                    EXPECT(counter >= 0);
+                }
+            }
+        });
+    }
+    for(auto& th : threads)
+        th.join();
+    EXPECT(counter == EThreads * 5000);
+    EXPECT(lock.try_lock());
+    EXPECT(!lock.try_lock());
+    lock.unlock();
+}
+
+int main()
+{
+    test_rw_spinlock();
+
+    map_type m(8);
+    EXPECT(m.shard_count() == 8);
+    EXPECT(m.empty());
+
+    std::vector<std::unordered_map<int, long long>> models(EThreads);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < EThreads; ++t)
+        threads.emplace_back(writer, std::ref(m), t, std::ref(models[t]));
+    for(int t = 0; t < EThreads; ++t)
+        threads.emplace_back(incrementer, std::ref(m));
+    std::thread r1(reader, std::cref(m), std::cref(stop));
+    std::thread r2(reader, std::cref(m), std::cref(stop));
+    for(auto& th : threads)
+        th.join();
+    stop.store(true, std::memory_order_release);
+    r1.join();
+    r2.join();
+
+    // 最终内容与各线程的模型之并完全一致
+    size_t expected = ECounters;
+    for(int t = 0; t < EThreads; ++t)
+    {
+        expected += models[t].size();
+        for(auto& kv : models[t])
+        {
+            long long v = -1;
+            EXPECT(m.find(kv.first, v) && v == kv.second);
+        }
+    }
+    EXPECT(m.size() == expected);
+    for(int c = 0; c < ECounters; ++c)
+    {
+        long long v = 0;
+        EXPECT(m.find(-1 - c, v));
+        EXPECT(v == static_cast<long long>(EThreads) * EIncrements / ECounters);
+    }
+    size_t visited = 0;
+    m.for_each([&](const orange_stl::pair<const int, long long>&) { ++visited; });
+    EXPECT(visited == expected);
+
+    EXPECT(m.update(-1, [](long long& v) { v = 0; }));
+    EXPECT(!m.update(-1000, [](long long& v) { v = 0; }));
+    EXPECT(m.count(-1) == 1 && m.contains(-1));
+
+    m.clear();
+    EXPECT(m.empty() && m.size() == 0);
+    m.reserve(10000);
+    EXPECT(m.insert(orange_stl::make_pair(1, 1000LL)));
+    EXPECT(!m.insert(orange_stl::make_pair(1, 1001LL)));
+    return 0;
+}
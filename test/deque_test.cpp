@@ -0,0 +1,85 @@
+#include "orange_deque.h"
+#include "orange_queue.h"
+#include "orange_stack.h"
+#include "test.h"
+
+// 统计配置次数的配置器，用来确认容器确实通过 Alloc 配置内存
+static int g_live_blocks = 0;
+
+template <class T>
+class counting_allocator : public orange_stl::allocator<T>
+{
+public:
+    template <class U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    static T* allocate()
+    {
+        return allocate(1);
+    }
+    static T* allocate(size_t n)
+    {
+        ++g_live_blocks;
+        return orange_stl::allocator<T>::allocate(n);
+    }
+    static void deallocate(T* ptr)
+    {
+        if(ptr != nullptr)
+            --g_live_blocks;
+        orange_stl::allocator<T>::deallocate(ptr);
+    }
+    static void deallocate(T* ptr, size_t n)
+    {
+        if(ptr != nullptr)
+            --g_live_blocks;
+        orange_stl::allocator<T>::deallocate(ptr, n);
+    }
+};
+
+int main()
+{
+    {
+        typedef orange_stl::deque<int, counting_allocator<int>> deque_type;
+        deque_type d;
+        for(int i = 0; i < 1000; ++i)
+            d.push_back(i);
+        for(int i = 1; i <= 1000; ++i)
+            d.push_front(-i);
+        EXPECT(g_live_blocks > 0);
+        EXPECT(d.size() == 2000);
+        EXPECT(d.front() == -1000 && d.back() == 999);
+        d.insert(d.begin() + 1000, 42);
+        EXPECT(d[1000] == 42 && d[1001] == 0);
+        d.emplace(d.begin() + 5, 7);
+        EXPECT(d[5] == 7);
+
+        deque_type copy(d);
+        EXPECT(copy == d);
+        deque_type moved(orange_stl::move(copy));
+        EXPECT(moved.size() == d.size());
+        deque_type assigned;
+        assigned = d;
+        EXPECT(assigned == d);
+        moved = orange_stl::move(assigned);
+        EXPECT(moved == d);
+
+        d.erase(d.begin(), d.begin() + 1500);
+        EXPECT(d.size() == 502);
+        d.clear();
+        EXPECT(d.empty());
+
+        orange_stl::stack<int, deque_type> s;
+        orange_stl::queue<int, deque_type> q;
+        for(int i = 0; i < 100; ++i)
+        {
+            s.push(i);
+            q.push(i);
+        }
+        EXPECT(s.top() == 99 && q.front() == 0);
+    }
+    EXPECT(g_live_blocks == 0);
+    return 0;
+}
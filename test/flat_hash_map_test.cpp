@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <unordered_map>
+
+#include "orange_flat_hash_map.h"
+#include "orange_flat_hash_set.h"
+#include "test.h"
+
+// 与 std::unordered_map 做随机对照
+int main()
+{
+    orange_stl::flat_hash_map<int, int> m;
+    std::unordered_map<int, int> ref;
+    std::srand(4);
+    for(int i = 0; i < 200000; ++i)
+    {
+        const int key = std::rand() % 5000;
+        switch(std::rand() % 4)
+        {
+        case 0:
+        case 1:
+            m[key] = i;
+            ref[key] = i;
+            break;
+        case 2:
+            EXPECT(m.erase(key) == ref.erase(key));
+            break;
+        default:
+        {
+            auto it = m.find(key);
+            auto rit = ref.find(key);
+            EXPECT((it == m.end()) == (rit == ref.end()));
+            if(it != m.end())
+                EXPECT(it->second == rit->second);
+        }
+        }
+        EXPECT(m.size() == ref.size());
+    }
+
+    size_t n = 0;
+    orange_stl::flat_hash_map<int, int>::const_iterator cit;
+    for(cit = m.begin(); cit != m.end(); ++cit)
+    {
+        EXPECT(ref.at(cit->first) == cit->second);
+        ++n;
+    }
+    EXPECT(n == ref.size());
+
+    orange_stl::flat_hash_map<int, int>::iterator it;
+    it = m.begin();
+    it = m.find(-1);
+    EXPECT(it == m.end());
+
+    orange_stl::flat_hash_map<int, int> copy;
+    copy = m;
+    EXPECT(copy == m);
+
+    orange_stl::flat_hash_set<int> s{3, 1, 4, 1, 5};
+    EXPECT(s.size() == 4 && s.count(4) == 1 && s.count(2) == 0);
+    return 0;
+}
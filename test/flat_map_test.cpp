@@ -0,0 +1,164 @@
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+#include "orange_flat_map.h"
+#include "orange_flat_set.h"
+#include "test.h"
+
+typedef orange_stl::allocator<orange_stl::pair<int, int>> pair_alloc;
+
+template <class FMap, class SMap>
+static bool same(const FMap& f, const SMap& s)
+{
+    if(f.size() != s.size())
+        return false;
+    auto it = s.begin();
+    for(auto ft = f.begin(); ft != f.end(); ++ft, ++it)
+    {
+        if((*ft).first != it->first || (*ft).second != it->second)
+            return false;
+    }
+    return true;
+}
+
+// 逐个乱序插入，每次插入都落在已有元素的中间
+template <class FMap>
+static void test_single_inserts()
+{
+    FMap m;
+    m[5];
+    m[3];
+    m[4];
+    m[7];
+    EXPECT(m.size() == 4);
+    int expect[] = {3, 4, 5, 7};
+    int i = 0;
+    for(auto it = m.begin(); it != m.end(); ++it)
+        EXPECT((*it).first == expect[i++]);
+
+    FMap e;
+    EXPECT(e.emplace(10, 1).second);
+    EXPECT(e.emplace(2, 2).second);
+    EXPECT(e.emplace(6, 3).second);
+    EXPECT(!e.emplace(6, 4).second);
+    EXPECT(e.try_emplace(4, 5).second);
+    EXPECT(!e.try_emplace(4, 6).second);
+    EXPECT(e.insert(orange_stl::make_pair(8, 7)).second);
+    EXPECT(e.insert_or_assign(6, 9).second == false);
+    EXPECT(e.size() == 5 && e.at(6) == 9 && e.at(4) == 5 && e.at(8) == 7);
+}
+
+template <class FMap>
+static void test_differential(unsigned seed)
+{
+    FMap f;
+    std::map<int, int> s;
+    std::mt19937 rng(seed);
+    for(int i = 0; i < 20000; ++i)
+    {
+        const int key = static_cast<int>(rng() % 1000);
+        switch(rng() % 6)
+        {
+        case 0:
+            EXPECT(f.emplace(key, i).second == s.emplace(key, i).second);
+            break;
+        case 1:
+            EXPECT(f.try_emplace(key, i).second == (s.count(key) == 0));
+            s.insert(std::make_pair(key, i));
+            break;
+        case 2:
+            f[key] = i;
+            s[key] = i;
+            break;
+        case 3:
+            f.emplace_hint(f.lower_bound(key), key, i);
+            s.emplace_hint(s.lower_bound(key), key, i);
+            break;
+        case 4:
+            EXPECT(f.erase(key) == s.erase(key));
+            break;
+        default:
+            EXPECT(f.count(key) == s.count(key));
+            break;
+        }
+    }
+    EXPECT(same(f, s));
+}
+
+static void test_multimap()
+{
+    orange_stl::flat_multimap<int, int> f;
+    std::multimap<int, int> s;
+    std::mt19937 rng(17);
+    for(int i = 0; i < 10000; ++i)
+    {
+        const int key = static_cast<int>(rng() % 100);
+        if(rng() % 4 == 0)
+        {
+            EXPECT(f.erase(key) == s.erase(key));
+        }
+        else
+        {
+            f.emplace(key, i);
+            s.emplace(key, i);
+        }
+    }
+    EXPECT(same(f, s));
+}
+
+static void test_set()
+{
+    orange_stl::flat_set<std::string> f;
+    std::set<std::string> s;
+    std::mt19937 rng(23);
+    for(int i = 0; i < 5000; ++i)
+    {
+        const std::string key = std::to_string(rng() % 800);
+        EXPECT(f.insert(key).second == s.insert(key).second);
+    }
+    EXPECT(f.size() == s.size());
+    auto it = s.begin();
+    for(const std::string& v : f)
+        EXPECT(v == *it++);
+}
+
+static void test_set_assign()
+{
+    orange_stl::flat_set<int> s{3, 1, 2};
+    orange_stl::flat_set<int> t;
+    t = s;
+    EXPECT(t == s && t.size() == 3);
+    t = {9, 7, 7, 8};
+    EXPECT(t.size() == 3 && *t.begin() == 7);
+    t = orange_stl::move(s);
+    EXPECT(t.size() == 3 && *t.begin() == 1);
+    t.clear();
+    EXPECT(t.empty() && t.begin() == t.end());
+    t.insert(4);
+    EXPECT(t.size() == 1 && t.count(4) == 1);
+
+    orange_stl::flat_multiset<int> ms{3, 1, 3};
+    orange_stl::flat_multiset<int> mt;
+    mt = ms;
+    EXPECT(mt == ms && mt.count(3) == 2);
+    mt = {5, 5, 4};
+    EXPECT(mt.size() == 3 && *mt.begin() == 4 && mt.count(5) == 2);
+    mt = orange_stl::move(ms);
+    EXPECT(mt.size() == 3 && *mt.begin() == 1);
+    mt.clear();
+    EXPECT(mt.empty() && mt.count(3) == 0);
+}
+
+int main()
+{
+    test_single_inserts<orange_stl::flat_map<int, int>>();
+    test_single_inserts<orange_stl::flat_map<int, int, orange_stl::less<int>, pair_alloc, orange_stl::flat_split>>();
+    test_differential<orange_stl::flat_map<int, int>>(1);
+    test_differential<orange_stl::flat_map<int, int, orange_stl::less<int>, pair_alloc, orange_stl::flat_split>>(2);
+    test_multimap();
+    test_set();
+    test_set_assign();
+    return 0;
+}
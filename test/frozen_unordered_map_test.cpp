@@ -0,0 +1,145 @@
+#include <random>
+#include <stdexcept>
+
+#include "orange_astring.h"
+#include "orange_frozen_unordered_map.h"
+#include "orange_vector.h"
+#include "test.h"
+
+typedef orange_stl::frozen_unordered_map<int, int> frozen_map;
+typedef orange_stl::pair<int, int> item;
+
+// 只取低两位的哈希，用来构造哈希值相同的不同键值
+struct low_bits_hash
+{
+    size_t operator()(int key) const { return static_cast<size_t>(key & 3); }
+};
+
+static bool throws_out_of_range(const frozen_map& m, int key)
+{
+    try
+    {
+        m.at(key);
+    }
+    catch(const std::out_of_range&)
+    {
+        return true;
+    }
+    return false;
+}
+
+static void test_small()
+{
+    const frozen_map empty;
+    EXPECT(empty.empty() && empty.size() == 0 && empty.begin() == empty.end());
+    EXPECT(empty.find(0) == empty.end() && empty.count(7) == 0);
+    EXPECT(throws_out_of_range(empty, 0));
+
+    const frozen_map none(static_cast<const item*>(nullptr), static_cast<const item*>(nullptr));
+    EXPECT(none.empty() && none.find(1) == none.end());
+
+    frozen_map one{{42, 1}};
+    EXPECT(one.size() == 1 && one.begin()->first == 42);
+    EXPECT(one.at(42) == 1 && one.count(42) == 1);
+    EXPECT(one.find(41) == one.end() && one.count(0) == 0);
+    EXPECT(throws_out_of_range(one, 43));
+    one.at(42) = 5;
+    EXPECT(one.find(42)->second == 5);
+}
+
+// 键值重复时保留先出现的元素
+static void test_duplicates()
+{
+    const frozen_map m{{1, 10}, {2, 20}, {1, 11}, {3, 30}, {2, 21}, {1, 12}};
+    EXPECT(m.size() == 3);
+    EXPECT(m.at(1) == 10 && m.at(2) == 20 && m.at(3) == 30);
+
+    const frozen_map same{{7, 1}, {7, 2}, {7, 3}};
+    EXPECT(same.size() == 1 && same.at(7) == 1);
+}
+
+// 大量键值，全部命中，相邻的不存在的键值全部不命中，迭代恰好访问每个元素一次
+static void test_large()
+{
+    std::mt19937 rng(3);
+    orange_stl::vector<item> input;
+    for(int i = 0; i < 20000; ++i)
+        input.push_back(item(static_cast<int>(rng() % 1000000) * 2, i));
+    const frozen_map m(input.begin(), input.end());
+
+    orange_stl::vector<char> seen(2000000, 0);
+    size_t n = 0;
+    for(auto it = m.begin(); it != m.end(); ++it, ++n)
+    {
+        EXPECT(seen[it->first] == 0);
+        seen[it->first] = 1;
+    }
+    EXPECT(n == m.size());
+    for(size_t i = 0; i < input.size(); ++i)
+    {
+        EXPECT(seen[input[i].first] == 1);
+        auto it = m.find(input[i].first);
+        EXPECT(it != m.end() && it->first == input[i].first);
+        EXPECT(m.count(input[i].first + 1) == 0);
+        EXPECT(m.find(input[i].first - 1) == m.end());
+    }
+    // 先出现的元素胜出
+    orange_stl::vector<int> first_value(2000000, -1);
+    for(size_t i = 0; i < input.size(); ++i)
+    {
+        if(first_value[input[i].first] < 0)
+            first_value[input[i].first] = input[i].second;
+    }
+    for(auto it = m.begin(); it != m.end(); ++it)
+        EXPECT(it->second == first_value[it->first]);
+
+    frozen_map copy(m);
+    EXPECT(copy.size() == m.size() && copy.at(input[0].first) == m.at(input[0].first));
+    frozen_map moved(orange_stl::move(copy));
+    EXPECT(copy.empty() && copy.find(input[0].first) == copy.end());
+    EXPECT(moved.size() == m.size());
+    moved = {{1, 2}};
+    EXPECT(moved.size() == 1 && moved.at(1) == 2 && moved.count(input[0].first) == 0);
+}
+
+// hash<string> 与 equal_to<void> 都是透明的，可以直接用 C 风格字符串查找
+static void test_transparent()
+{
+    typedef orange_stl::frozen_unordered_map<orange_stl::string, int, orange_stl::hash<orange_stl::string>,
+                                             orange_stl::equal_to<void>> string_map;
+    const string_map m{{"apple", 1}, {"banana", 2}, {"cherry", 3}, {"", 4}};
+    EXPECT(m.size() == 4);
+    EXPECT(m.find("banana") != m.end() && m.find("banana")->second == 2);
+    EXPECT(m.count("cherry") == 1 && m.count("") == 1);
+    EXPECT(m.find("durian") == m.end() && m.count("appl") == 0 && m.count("apples") == 0);
+    EXPECT(m.at(orange_stl::string("apple")) == 1);
+}
+
+// 哈希值相同的不同键值无法区分，构造抛出 runtime_error；相等的键值哈希值相同是允许的
+static void test_hash_collision()
+{
+    typedef orange_stl::frozen_unordered_map<int, int, low_bits_hash> colliding_map;
+    const colliding_map ok{{0, 1}, {1, 2}, {2, 3}, {3, 4}, {1, 5}};
+    EXPECT(ok.size() == 4 && ok.at(1) == 2 && ok.count(5) == 0);
+
+    bool thrown = false;
+    try
+    {
+        colliding_map bad{{0, 1}, {1, 2}, {4, 3}};
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    EXPECT(thrown);
+}
+
+int main()
+{
+    test_small();
+    test_duplicates();
+    test_large();
+    test_transparent();
+    test_hash_collision();
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <cfloat>
+#include <cstring>
+#include <set>
+
+#include "orange_astring.h"
+#include "orange_functional.h"
+#include "test.h"
+
+// 覆盖每个长度分支：0、1-3、4-16、17-48、大于 48
+static const size_t lengths[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 47, 48, 49, 95, 96, 97, 200, 1000};
+
+static void fill(unsigned char* p, size_t n, unsigned seed)
+{
+    for(size_t i = 0; i < n; ++i)
+        p[i] = static_cast<unsigned char>((i * 131 + seed * 7 + 1) & 0xff);
+}
+
+// 同样的字节放在不同对齐的地址上、之后跟着不同的字节，哈希值都相同
+static void test_deterministic()
+{
+    unsigned char a[1100], b[1100];
+    for(size_t len : lengths)
+    {
+        fill(a, len, 1);
+        const size_t h = orange_stl::hash_bytes(a, len);
+        EXPECT(orange_stl::hash_bytes(a, len) == h);
+        for(size_t off = 1; off < 8; ++off)
+        {
+            std::memset(b, static_cast<int>(off * 37), sizeof(b));
+            std::memcpy(b + off, a, len);
+            EXPECT(orange_stl::hash_bytes(b + off, len) == h);
+        }
+        EXPECT(orange_stl::hash_bytes(a, len, 1) != h);
+    }
+}
+
+// 任意一个字节的任意一位改变，哈希值都随之改变，即每个分支都读到了全部输入
+static void test_every_byte()
+{
+    unsigned char a[1100];
+    for(size_t len : lengths)
+    {
+        fill(a, len, 2);
+        const size_t h = orange_stl::hash_bytes(a, len);
+        for(size_t i = 0; i < len; ++i)
+        {
+            for(int bit = 0; bit < 8; bit += 3)
+            {
+                a[i] ^= static_cast<unsigned char>(1 << bit);
+                EXPECT(orange_stl::hash_bytes(a, len) != h);
+                a[i] ^= static_cast<unsigned char>(1 << bit);
+            }
+        }
+    }
+}
+
+// 同一段缓冲区的不同前缀长度得到不同的哈希值，包括全零的缓冲区
+static void test_lengths()
+{
+    unsigned char zero[101] = {};
+    unsigned char text[101];
+    std::memset(text, 'a', sizeof(text));
+    std::set<size_t> zs, ts;
+    for(size_t len = 0; len <= 100; ++len)
+    {
+        zs.insert(orange_stl::hash_bytes(zero, len));
+        ts.insert(orange_stl::hash_bytes(text, len));
+    }
+    EXPECT(zs.size() == 101 && ts.size() == 101);
+}
+
+// 浮点数：+0.0 与 -0.0 相等；long double 的填充字节不参与哈希
+static void test_floating()
+{
+    EXPECT(orange_stl::hash<float>()(0.0f) == orange_stl::hash<float>()(-0.0f));
+    EXPECT(orange_stl::hash<double>()(0.0) == orange_stl::hash<double>()(-0.0));
+    EXPECT(orange_stl::hash<long double>()(0.0L) == orange_stl::hash<long double>()(-0.0L));
+    EXPECT(orange_stl::hash<double>()(1.0) != orange_stl::hash<double>()(-1.0));
+
+    const long double values[] = {1.0L, -2.5L, 3.0e100L, LDBL_MIN, LDBL_MAX};
+    for(long double v : values)
+    {
+        long double x, y;
+        std::memset(&x, 0x00, sizeof(x));
+        std::memset(&y, 0xff, sizeof(y));
+        // 只写入有效的 10 个字节(x87 扩展精度)，其余保持不同的填充
+        long double t = v;
+#if LDBL_MANT_DIG == 64
+        std::memcpy(&x, &t, 10);
+        std::memcpy(&y, &t, 10);
+#else
+        x = y = t;
+#endif
+        EXPECT(x == y);
+        EXPECT(orange_stl::hash<long double>()(x) == orange_stl::hash<long double>()(y));
+        EXPECT(orange_stl::hash<long double>()(x) != orange_stl::hash<long double>()(x * 2));
+    }
+}
+
+// 字符串与 C 风格字符串的哈希一致
+static void test_string()
+{
+    const char* words[] = {"", "a", "abc", "abcd", "orange_stl", "a somewhat longer string that passes 48 bytes"};
+    for(const char* w : words)
+    {
+        const orange_stl::string s(w);
+        const orange_stl::hash<orange_stl::string> h;
+        EXPECT(h(s) == h(w));
+        EXPECT(h(s) == orange_stl::hash_bytes(w, std::strlen(w)));
+    }
+}
+
+int main()
+{
+    test_deterministic();
+    test_every_byte();
+    test_lengths();
+    test_floating();
+    test_string();
+    return 0;
+}
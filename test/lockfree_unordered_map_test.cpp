@@ -0,0 +1,236 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "orange_lockfree_unordered_map.h"
+#include "test.h"
+
+// 记录存活对象个数的值类型，用来检查被替换的值块和删除的节点最终都被回收且只回收一次
+struct tracked
+{
+    static std::atomic<long> live;
+
+    long long v;
+
+    tracked(long long x = 0) : v(x) { live.fetch_add(1, std::memory_order_relaxed); }
+    tracked(const tracked& rhs) : v(rhs.v) { live.fetch_add(1, std::memory_order_relaxed); }
+    tracked& operator=(const tracked& rhs) { v = rhs.v; return *this; }
+    ~tracked() { live.fetch_sub(1, std::memory_order_relaxed); }
+};
+
+std::atomic<long> tracked::live(0);
+
+typedef orange_stl::lockfree_unordered_map<int, tracked> map_type;
+
+enum { EThreads = 4, EOps = 30000, EKeysPerThread = 1500, ESharedKeys = 3000 };
+
+// 值总是 key * 1000 + 版本号，读者据此检查读到的值属于这个键
+static long long make_value(int key, int version)
+{
+    return static_cast<long long>(key) * 1000 + version % 1000;
+}
+
+// epoch_domain 是函数内的静态对象，在它第一次使用之前登记，atexit 的回调就会在它析构之后执行
+static void check_no_leak()
+{
+    if(tracked::live.load() != 0)
+    {
+        std::fprintf(stderr, "lockfree_unordered_map_test: %ld tracked objects leaked\n", tracked::live.load());
+        std::_Exit(1);
+    }
+}
+
+// 单线程与 std::unordered_map 对比，桶数从 2 翻倍到数千
+static void test_differential()
+{
+    map_type m(2);
+    std::unordered_map<int, long long> model;
+    std::mt19937 rng(11);
+    for(int i = 0; i < 200000; ++i)
+    {
+        const int key = static_cast<int>(rng() % 5000);
+        const long long value = make_value(key, i);
+        switch(rng() % 7)
+        {
+        case 0:
+            EXPECT(m.insert(orange_stl::make_pair(key, tracked(value))) == (model.count(key) == 0));
+            model.insert(std::make_pair(key, value));
+            break;
+        case 1:
+            EXPECT(m.emplace(key, value) == (model.count(key) == 0));
+            model.insert(std::make_pair(key, value));
+            break;
+        case 2:
+            EXPECT(m.try_emplace(key, value) == (model.count(key) == 0));
+            model.insert(std::make_pair(key, value));
+            break;
+        case 3:
+            EXPECT(m.insert_or_assign(key, tracked(value)) == (model.count(key) == 0));
+            model[key] = value;
+            break;
+        case 4:
+            EXPECT(m.erase(key) == model.erase(key));
+            break;
+        case 5:
+        {
+            tracked got;
+            auto it = model.find(key);
+            EXPECT(m.find(key, got) == (it != model.end()));
+            EXPECT(it == model.end() || got.v == it->second);
+            EXPECT(m.count(key) == model.count(key));
+            break;
+        }
+        default:
+        {
+            auto it = model.find(key);
+            bool threw = false;
+            try
+            {
+                EXPECT(m.at(key).v == it->second);
+            }
+            catch(const std::out_of_range&)
+            {
+                threw = true;
+            }
+            EXPECT(threw == (it == model.end()));
+            break;
+        }
+        }
+        EXPECT(m.size() == model.size());
+    }
+    EXPECT(m.bucket_count() >= model.size() / orange_stl::ELockFreeMapLoadFactor);
+
+    size_t visited = 0;
+    m.for_each([&](const orange_stl::pair<const int, tracked>& p) {
+        auto it = model.find(p.first);
+        EXPECT(it != model.end() && it->second == p.second.v);
+        ++visited;
+    });
+    EXPECT(visited == model.size());
+    for(auto& kv : model)
+        EXPECT(m.visit(kv.first, [&](const orange_stl::pair<const int, tracked>& p) { EXPECT(p.second.v == kv.second); }));
+    EXPECT(!m.contains(-1));
+}
+
+// 每个写者只修改自己的键(key % EThreads == tid)，并用 std::unordered_map 记录期望的内容
+static void writer(map_type& m, int tid, std::unordered_map<int, long long>& model)
+{
+    unsigned seed = static_cast<unsigned>(tid) + 1;
+    for(int i = 0; i < EOps; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        const int key = static_cast<int>((seed >> 8) % EKeysPerThread) * EThreads + tid;
+        const long long value = make_value(key, i);
+        switch((seed >> 4) % 4)
+        {
+        case 0:
+            EXPECT(m.emplace(key, value) == (model.count(key) == 0));
+            model.insert(std::make_pair(key, value));
+            break;
+        case 1:
+            EXPECT(m.erase(key) == model.erase(key));
+            break;
+        case 2:
+            EXPECT(m.insert_or_assign(key, value) == (model.count(key) == 0));
+            model[key] = value;
+            break;
+        default:
+        {
+            tracked got;
+            auto it = model.find(key);
+            EXPECT(m.find(key, got) == (it != model.end()));
+            EXPECT(it == model.end() || got.v == it->second);
+            break;
+        }
+        }
+    }
+}
+
+// 所有线程争抢同一组键，插入成功的次数减去删除成功的次数等于最后剩下的键数
+static void contender(map_type& m, std::atomic<int>& inserted, std::atomic<int>& erased, int tid)
+{
+    int ins = 0, era = 0;
+    for(int k = 0; k < ESharedKeys; ++k)
+    {
+        const int key = -1 - (k * 7 + tid * 13) % ESharedKeys;
+        ins += m.try_emplace(key, static_cast<long long>(key) * 1000) ? 1 : 0;
+    }
+    for(int k = 0; k < ESharedKeys; ++k)
+    {
+        const int key = -1 - (k * 11 + tid * 17) % ESharedKeys;
+        era += static_cast<int>(m.erase(key));
+    }
+    inserted.fetch_add(ins);
+    erased.fetch_add(era);
+}
+
+// 读者并发地遍历和查找，读到的值必须属于对应的键
+static void reader(const map_type& m, const std::atomic<bool>& stop)
+{
+    while(!stop.load(std::memory_order_acquire))
+    {
+        m.for_each([](const orange_stl::pair<const int, tracked>& p) {
+            EXPECT(p.second.v / 1000 == p.first);
+        });
+        for(int key = -50; key < 200; ++key)
+        {
+            tracked v;
+            if(m.find(key, v))
+                EXPECT(v.v / 1000 == key);
+        }
+    }
+}
+
+static void test_concurrent()
+{
+    map_type m(2);
+    std::vector<std::unordered_map<int, long long>> models(EThreads);
+    std::atomic<int> inserted(0), erased(0);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < EThreads; ++t)
+        threads.emplace_back(writer, std::ref(m), t, std::ref(models[t]));
+    for(int t = 0; t < EThreads; ++t)
+        threads.emplace_back(contender, std::ref(m), std::ref(inserted), std::ref(erased), t);
+    std::thread r1(reader, std::cref(m), std::cref(stop));
+    std::thread r2(reader, std::cref(m), std::cref(stop));
+    for(auto& th : threads)
+        th.join();
+    stop.store(true, std::memory_order_release);
+    r1.join();
+    r2.join();
+
+    int shared_left = 0;
+    for(int k = 1; k <= ESharedKeys; ++k)
+        shared_left += static_cast<int>(m.count(-k));
+    EXPECT(inserted.load() >= ESharedKeys);
+    EXPECT(inserted.load() - erased.load() == shared_left);
+    size_t expected = static_cast<size_t>(shared_left);
+    for(int t = 0; t < EThreads; ++t)
+    {
+        expected += models[t].size();
+        for(auto& kv : models[t])
+        {
+            tracked v;
+            EXPECT(m.find(kv.first, v) && v.v == kv.second);
+        }
+    }
+    EXPECT(m.size() == expected);
+    size_t visited = 0;
+    m.for_each([&](const orange_stl::pair<const int, tracked>&) { ++visited; });
+    EXPECT(visited == expected);
+}
+
+int main()
+{
+    std::atexit(check_no_leak);
+    test_differential();
+    test_concurrent();
+    orange_stl::epoch_domain::instance().synchronize();
+    return 0;
+}
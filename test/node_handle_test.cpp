@@ -0,0 +1,184 @@
+#include <string>
+
+#include "orange_astring.h"
+#include "orange_map.h"
+#include "orange_set.h"
+#include "orange_unordered_map.h"
+#include "orange_unordered_set.h"
+#include "test.h"
+
+// 统计存活对象的个数，检查句柄析构时销毁了它持有的元素
+struct tracked
+{
+    static int live;
+    int v;
+
+    tracked(int x = 0) : v(x) { ++live; }
+    tracked(const tracked& rhs) : v(rhs.v) { ++live; }
+    tracked& operator=(const tracked& rhs) { v = rhs.v; return *this; }
+    ~tracked() { --live; }
+};
+int tracked::live = 0;
+
+template <class K>
+static K make_key(int i);
+
+template <>
+int make_key<int>(int i)
+{
+    return i;
+}
+
+// 字符串的哈希不是 is_fast_hash，无序容器的节点中缓存了哈希值
+template <>
+orange_stl::string make_key<orange_stl::string>(int i)
+{
+    return orange_stl::string(std::to_string(i).c_str());
+}
+
+template <class Map>
+static void test_unique_map()
+{
+    typedef typename Map::key_type K;
+    {
+        Map m;
+        for(int i = 1; i <= 3; ++i)
+            m.emplace(make_key<K>(i), tracked(i * 10));
+        const int live = tracked::live;
+
+        auto nh = m.extract(make_key<K>(2));
+        EXPECT(!nh.empty() && nh.key() == make_key<K>(2) && nh.mapped().v == 20);
+        EXPECT(m.size() == 2 && m.count(make_key<K>(2)) == 0 && tracked::live == live);
+
+        // 修改键值后重新插入，不复制元素
+        nh.key() = make_key<K>(5);
+        nh.mapped().v = 50;
+        auto r = m.insert(orange_stl::move(nh));
+        EXPECT(r.inserted && r.node.empty() && nh.empty());
+        EXPECT(r.position->first == make_key<K>(5) && r.position->second.v == 50);
+        EXPECT(m.find(make_key<K>(5)) == r.position && m.size() == 3 && tracked::live == live);
+
+        // 不存在的键值与空句柄
+        auto none = m.extract(make_key<K>(9));
+        EXPECT(none.empty() && !none);
+        auto r0 = m.insert(orange_stl::move(none));
+        EXPECT(!r0.inserted && r0.position == m.end() && r0.node.empty());
+
+        // 键值已存在时节点交还给 node，已有的元素不变
+        auto dup = m.extract(m.find(make_key<K>(1)));
+        dup.key() = make_key<K>(3);
+        auto r2 = m.insert(orange_stl::move(dup));
+        EXPECT(!r2.inserted && !r2.node.empty());
+        EXPECT(r2.position->first == make_key<K>(3) && r2.position->second.v == 30);
+        EXPECT(r2.node.key() == make_key<K>(3) && r2.node.mapped().v == 10);
+        EXPECT(m.size() == 2 && m.count(make_key<K>(1)) == 0);
+
+        // 句柄析构时销毁仍然持有的元素
+        {
+            typename Map::node_handle_type gone(orange_stl::move(r2.node));
+            EXPECT(tracked::live == live);
+        }
+        EXPECT(tracked::live == live - 1);
+    }
+    EXPECT(tracked::live == 0);
+
+    // merge 时键值已存在的元素留在源容器中
+    Map a, b;
+    for(int i = 1; i <= 3; ++i)
+        a.emplace(make_key<K>(i), tracked(i));
+    for(int i = 3; i <= 5; ++i)
+        b.emplace(make_key<K>(i), tracked(-i));
+    a.merge(b);
+    EXPECT(a.size() == 5 && b.size() == 1);
+    EXPECT(a.find(make_key<K>(3))->second.v == 3 && a.find(make_key<K>(5))->second.v == -5);
+    EXPECT(b.begin()->first == make_key<K>(3) && b.begin()->second.v == -3);
+    EXPECT(tracked::live == 6);
+}
+
+template <class Map, class MultiMap>
+static void test_multi_map()
+{
+    typedef typename Map::key_type K;
+    MultiMap m;
+    m.emplace(make_key<K>(1), tracked(1));
+    m.emplace(make_key<K>(1), tracked(2));
+    m.emplace(make_key<K>(2), tracked(3));
+
+    auto nh = m.extract(make_key<K>(1));
+    EXPECT(!nh.empty() && nh.key() == make_key<K>(1));
+    EXPECT(m.size() == 2 && m.count(make_key<K>(1)) == 1);
+    nh.key() = make_key<K>(2);
+    auto it = m.insert(orange_stl::move(nh));
+    EXPECT(nh.empty() && it->first == make_key<K>(2) && m.count(make_key<K>(2)) == 2);
+    EXPECT(m.insert(typename MultiMap::node_handle_type()) == m.end());
+
+    // 多重容器之间 merge 转移全部元素
+    MultiMap other;
+    other.emplace(make_key<K>(2), tracked(4));
+    other.emplace(make_key<K>(7), tracked(5));
+    m.merge(other);
+    EXPECT(other.empty() && m.size() == 5 && m.count(make_key<K>(2)) == 3);
+
+    // 合并进不允许重复的容器时，重复的键值只取一个，其余留在源容器
+    Map u;
+    u.emplace(make_key<K>(7), tracked(0));
+    u.merge(m);
+    EXPECT(u.size() == 3 && u.find(make_key<K>(7))->second.v == 0);
+    EXPECT(m.size() == 3 && m.count(make_key<K>(2)) == 2 && m.count(make_key<K>(7)) == 1);
+    EXPECT(m.count(make_key<K>(1)) == 0 && m.find(make_key<K>(7))->second.v == 5);
+}
+
+template <class Set, class MultiSet>
+static void test_sets()
+{
+    typedef typename Set::key_type K;
+    Set s;
+    for(int i = 1; i <= 4; ++i)
+        s.insert(make_key<K>(i));
+    auto nh = s.extract(s.find(make_key<K>(4)));
+    EXPECT(nh.value() == make_key<K>(4) && s.size() == 3);
+    nh.value() = make_key<K>(8);
+    auto r = s.insert(orange_stl::move(nh));
+    EXPECT(r.inserted && *r.position == make_key<K>(8) && s.count(make_key<K>(8)) == 1);
+    auto dup = s.extract(make_key<K>(1));
+    dup.value() = make_key<K>(2);
+    auto r2 = s.insert(orange_stl::move(dup));
+    EXPECT(!r2.inserted && r2.node.value() == make_key<K>(2) && s.size() == 3);
+
+    MultiSet ms;
+    ms.insert(make_key<K>(2));
+    ms.insert(make_key<K>(2));
+    ms.insert(make_key<K>(9));
+    auto mh = ms.extract(make_key<K>(9));
+    mh.value() = make_key<K>(2);
+    ms.insert(orange_stl::move(mh));
+    EXPECT(ms.count(make_key<K>(2)) == 3 && ms.count(make_key<K>(9)) == 0);
+
+    // 合并进集合时重复的元素留下，集合合并进多重集合时全部转移
+    s.merge(ms);
+    EXPECT(s.size() == 3 && ms.size() == 3 && ms.count(make_key<K>(2)) == 3);
+    ms.merge(s);
+    EXPECT(s.empty() && ms.size() == 6 && ms.count(make_key<K>(2)) == 4);
+}
+
+int main()
+{
+    typedef orange_stl::string str;
+    test_unique_map<orange_stl::map<int, tracked>>();
+    test_unique_map<orange_stl::map<str, tracked>>();
+    test_unique_map<orange_stl::unordered_map<int, tracked>>();
+    test_unique_map<orange_stl::unordered_map<str, tracked>>();
+    EXPECT(tracked::live == 0);
+
+    test_multi_map<orange_stl::map<int, tracked>, orange_stl::multimap<int, tracked>>();
+    test_multi_map<orange_stl::map<str, tracked>, orange_stl::multimap<str, tracked>>();
+    test_multi_map<orange_stl::unordered_map<int, tracked>, orange_stl::unordered_multimap<int, tracked>>();
+    test_multi_map<orange_stl::unordered_map<str, tracked>, orange_stl::unordered_multimap<str, tracked>>();
+    EXPECT(tracked::live == 0);
+
+    test_sets<orange_stl::set<int>, orange_stl::multiset<int>>();
+    test_sets<orange_stl::set<str>, orange_stl::multiset<str>>();
+    test_sets<orange_stl::unordered_set<int>, orange_stl::unordered_multiset<int>>();
+    test_sets<orange_stl::unordered_set<str>, orange_stl::unordered_multiset<str>>();
+    return 0;
+}
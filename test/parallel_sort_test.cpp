@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "orange_parallel_algo.h"
+#include "test.h"
+
+// 用很小的 cutoff 让每种数据都走到样本排序和过大桶的递归，结果与 std::sort 比较
+static void check(const std::vector<unsigned>& data, size_t workers, size_t cutoff)
+{
+    orange_stl::thread_pool pool(workers);
+    orange_stl::vector<unsigned> v(data.data(), data.data() + data.size());
+    orange_stl::parallel_sort(v.begin(), v.end(), orange_stl::less<unsigned>(), cutoff, pool);
+    std::vector<unsigned> expect(data);
+    std::sort(expect.begin(), expect.end());
+    EXPECT(v.size() == expect.size());
+    EXPECT(std::equal(expect.begin(), expect.end(), v.begin()));
+
+    // 降序比较器
+    v.assign(data.data(), data.data() + data.size());
+    orange_stl::parallel_sort(v.begin(), v.end(), orange_stl::greater<unsigned>(), cutoff, pool);
+    EXPECT(std::equal(expect.rbegin(), expect.rend(), v.begin()));
+}
+
+int main()
+{
+    std::mt19937 rng(7);
+    const size_t n = 200000;
+    std::vector<unsigned> random(n), few(n), sorted(n), equal(n, 42u), skewed(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        random[i] = rng();
+        few[i] = rng() % 5;                        // 大量与分割点相等的元素
+        sorted[i] = static_cast<unsigned>(n - i);  // 逆序
+        skewed[i] = rng() % 8 == 0 ? static_cast<unsigned>(rng()) : 7u;  // 一个极大的桶
+    }
+
+    const size_t workers[] = {0, 1, 3, 7};
+    for(size_t w : workers)
+    {
+        for(size_t cutoff : {size_t(64), size_t(4096), size_t(orange_stl::EParallelSortCutoff)})
+        {
+            check(random, w, cutoff);
+            check(few, w, cutoff);
+            check(sorted, w, cutoff);
+            check(equal, w, cutoff);
+            check(skewed, w, cutoff);
+        }
+    }
+    check(std::vector<unsigned>(100, 1u), 3, 16);
+    check(std::vector<unsigned>{3u, 1u, 2u}, 3, 0);
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "orange_set.h"
+#include "orange_set_algo.h"
+#include "test.h"
+
+// 按 key 比较，idx 记录元素来自哪个序列的第几个，用来检查重复元素取自哪一边
+struct rec
+{
+    int key;
+    int idx;
+};
+
+struct rec_less
+{
+    bool operator()(const rec& a, const rec& b) const { return a.key < b.key; }
+};
+
+static bool same(const std::vector<rec>& a, const std::vector<rec>& b)
+{
+    if(a.size() != b.size())
+        return false;
+    for(size_t i = 0; i < a.size(); ++i)
+    {
+        if(a[i].key != b[i].key || a[i].idx != b[i].idx)
+            return false;
+    }
+    return true;
+}
+
+static std::vector<rec> make_seq(std::mt19937& rng, size_t n, int range, int tag)
+{
+    std::vector<int> keys(n);
+    for(size_t i = 0; i < n; ++i)
+        keys[i] = static_cast<int>(rng() % range);
+    std::sort(keys.begin(), keys.end());
+    std::vector<rec> v(n);
+    for(size_t i = 0; i < n; ++i)
+        v[i] = rec{keys[i], tag + static_cast<int>(i)};
+    return v;
+}
+
+// 长度比跨过 ESetGallopRatio 的两侧，并含有大量重复元素，结果必须与 std 逐个元素一致
+static void test_gallop_dispatch()
+{
+    const size_t sizes[][2] = {{0, 0}, {0, 50}, {50, 0}, {1, 1}, {1, 5000}, {5000, 1},
+                               {15, 240}, {16, 256}, {17, 256}, {256, 16}, {100, 3000},
+                               {3000, 100}, {1000, 1000}, {7, 100000}};
+    std::mt19937 rng(9);
+    for(auto& sz : sizes)
+    {
+        const int ranges[] = {10, 1000, 1000000};
+        for(int range : ranges)
+        {
+            const std::vector<rec> a = make_seq(rng, sz[0], range, 0);
+            const std::vector<rec> b = make_seq(rng, sz[1], range, 1000000);
+            std::vector<rec> got(a.size() + b.size()), want(a.size() + b.size());
+            const rec* a0 = a.data();
+            const rec* b0 = b.data();
+
+            got.resize(orange_stl::set_intersection(a0, a0 + a.size(), b0, b0 + b.size(),
+                                                    got.data(), rec_less()) - got.data());
+            want.resize(std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                                              want.begin(), rec_less()) - want.begin());
+            EXPECT(same(got, want));
+
+            got.resize(a.size() + b.size());
+            want.resize(a.size() + b.size());
+            got.resize(orange_stl::set_difference(a0, a0 + a.size(), b0, b0 + b.size(),
+                                                  got.data(), rec_less()) - got.data());
+            want.resize(std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                                            want.begin(), rec_less()) - want.begin());
+            EXPECT(same(got, want));
+
+            got.resize(a.size() + b.size());
+            want.resize(a.size() + b.size());
+            got.resize(orange_stl::set_difference(b0, b0 + b.size(), a0, a0 + a.size(),
+                                                  got.data(), rec_less()) - got.data());
+            want.resize(std::set_difference(b.begin(), b.end(), a.begin(), a.end(),
+                                            want.begin(), rec_less()) - want.begin());
+            EXPECT(same(got, want));
+        }
+    }
+
+    // 双向迭代器走逐个归并的版本
+    orange_stl::multiset<int> x{1, 1, 2, 3, 5, 8, 8, 8}, y{1, 8, 8, 9};
+    int out[16];
+    EXPECT(orange_stl::set_intersection(x.begin(), x.end(), y.begin(), y.end(), out) - out == 3);
+    EXPECT(out[0] == 1 && out[1] == 8 && out[2] == 8);
+    EXPECT(orange_stl::set_difference(x.begin(), x.end(), y.begin(), y.end(), out) - out == 5);
+    EXPECT(out[0] == 1 && out[1] == 2 && out[2] == 3 && out[3] == 5 && out[4] == 8);
+
+    // 单个元素的 galloping 查找
+    const int s[] = {1, 3, 3, 3, 7, 9, 12};
+    for(int v = 0; v <= 13; ++v)
+        EXPECT(orange_stl::gallop_lower_bound(s, s + 7, v) == std::lower_bound(s, s + 7, v));
+}
+
+template <class UInt>
+static std::vector<UInt> make_strict(std::mt19937_64& rng, size_t n, uint64_t range, bool high_bits)
+{
+    std::vector<UInt> v(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        uint64_t x = rng() % range;
+        // 低 32 位取值范围很小，高 32 位不同的元素必须被区分开
+        if(high_bits)
+            x |= (rng() % 4) << 32;
+        v[i] = static_cast<UInt>(x);
+    }
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+template <class UInt>
+static void check_simd(const std::vector<UInt>& a, const std::vector<UInt>& b)
+{
+    std::vector<UInt> got(std::min(a.size(), b.size()) + 1), want(got.size());
+    const size_t k = orange_stl::simd_set_intersection(a.data(), a.size(), b.data(), b.size(), got.data());
+    want.resize(std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), want.begin()) - want.begin());
+    got.resize(k);
+    EXPECT(got == want);
+}
+
+static void test_simd_intersection()
+{
+    const size_t sizes[][2] = {{0, 0}, {0, 9}, {9, 0}, {1, 1}, {3, 3}, {4, 4}, {5, 7},
+                               {31, 33}, {100, 1600}, {1600, 100}, {2, 5000}, {4000, 4000}};
+    std::mt19937_64 rng(13);
+    for(auto& sz : sizes)
+    {
+        const uint64_t ranges[] = {8, 64, 10000, 1ULL << 32};
+        for(uint64_t range : ranges)
+        {
+            check_simd(make_strict<uint32_t>(rng, sz[0], range, false),
+                       make_strict<uint32_t>(rng, sz[1], range, false));
+            check_simd(make_strict<uint64_t>(rng, sz[0], range, false),
+                       make_strict<uint64_t>(rng, sz[1], range, false));
+            check_simd(make_strict<uint64_t>(rng, sz[0], range, true),
+                       make_strict<uint64_t>(rng, sz[1], range, true));
+        }
+    }
+
+    // 低 32 位相同、高 32 位不同的元素不算交集
+    const uint64_t hi = 1ULL << 32;
+    const std::vector<uint64_t> a{1, 2, hi + 3, hi + 4, 2 * hi + 5, 2 * hi + 6};
+    const std::vector<uint64_t> b{hi + 1, hi + 2, 3, hi + 4, 3 * hi + 5, 2 * hi + 6};
+    std::vector<uint64_t> b_sorted(b);
+    std::sort(b_sorted.begin(), b_sorted.end());
+    uint64_t out[6];
+    const size_t k = orange_stl::simd_set_intersection(a.data(), a.size(), b_sorted.data(), b_sorted.size(), out);
+    EXPECT(k == 2 && out[0] == hi + 4 && out[1] == 2 * hi + 6);
+
+    // 完全相同与完全不相交
+    std::vector<uint32_t> same_v;
+    for(uint32_t i = 0; i < 1003; ++i)
+        same_v.push_back(i * 3);
+    check_simd(same_v, same_v);
+    std::vector<uint32_t> odd, even;
+    for(uint32_t i = 0; i < 1000; ++i)
+    {
+        odd.push_back(2 * i + 1);
+        even.push_back(2 * i);
+    }
+    check_simd(odd, even);
+}
+
+int main()
+{
+    test_gallop_dispatch();
+    test_simd_intersection();
+    return 0;
+}
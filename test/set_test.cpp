@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+
+#include "orange_astring.h"
+#include "orange_map.h"
+#include "orange_set.h"
+#include "test.h"
+
+template <class OSet, class SSet>
+static bool same(const OSet& o, const SSet& s)
+{
+    if(o.size() != s.size())
+        return false;
+    auto it = s.begin();
+    for(auto ot = o.begin(); ot != o.end(); ++ot, ++it)
+    {
+        if(*ot != *it)
+            return false;
+    }
+    return true;
+}
+
+static void test_set_assign()
+{
+    orange_stl::set<int> s{3, 1, 2};
+    orange_stl::set<int> t;
+    t = s;
+    EXPECT(t == s && t.size() == 3);
+    t = {4, 5};
+    EXPECT(t.size() == 2 && *t.begin() == 4 && *t.rbegin() == 5);
+    t = {9, 7, 7, 8};   // 无序且有重复的初始化列表
+    EXPECT(t.size() == 3 && *t.begin() == 7);
+    t = orange_stl::move(s);
+    EXPECT(t.size() == 3 && *t.begin() == 1);
+    t = t;
+    EXPECT(t.size() == 3);
+}
+
+// 向非空容器区间插入，逐个元素带提示插入
+static void test_range_insert()
+{
+    std::mt19937 rng(29);
+    int data[3000];
+    for(int& v : data)
+        v = static_cast<int>(rng() % 1000);
+
+    orange_stl::multiset<int> ms{500, 0, 999};
+    std::multiset<int> sms{500, 0, 999};
+    ms.insert(data, data + 3000);
+    sms.insert(data, data + 3000);
+    EXPECT(same(ms, sms));
+
+    orange_stl::set<int> s{500, 0, 999};
+    std::set<int> ss{500, 0, 999};
+    s.insert(data, data + 3000);
+    ss.insert(data, data + 3000);
+    EXPECT(same(s, ss));
+
+    // 提示位置为 begin() 与 end() 的插入
+    orange_stl::multiset<int> h{5, 6};
+    h.emplace_hint(h.begin(), 1);
+    h.emplace_hint(h.begin(), 7);
+    h.emplace_hint(h.end(), 9);
+    h.emplace_hint(h.end(), 2);
+    h.insert(h.begin(), 5);
+    const int expect[] = {1, 2, 5, 5, 6, 7, 9};
+    EXPECT(h.size() == 7);
+    int i = 0;
+    for(int v : h)
+        EXPECT(v == expect[i++]);
+
+    orange_stl::multimap<int, int> mm{{2, 0}, {1, 0}};
+    const orange_stl::pair<int, int> more[] = {{1, 1}, {0, 1}, {3, 1}, {2, 1}};
+    mm.insert(more, more + 4);
+    EXPECT(mm.size() == 6 && mm.count(1) == 2 && mm.count(2) == 2);
+    EXPECT(mm.begin()->first == 0 && mm.rbegin()->first == 3);
+}
+
+typedef orange_stl::set<int, orange_stl::less<int>, orange_stl::allocator<int>, true> ranked_set;
+typedef orange_stl::multiset<int, orange_stl::less<int>, orange_stl::allocator<int>, true> ranked_multiset;
+
+// 逐个元素检查 nth、index_of、rank 与 distance，间接检查每个节点维护的子树大小
+template <class OSet>
+static bool ranks_ok(const OSet& o)
+{
+    size_t i = 0, first = 0;
+    typename OSet::const_iterator prev = o.end();
+    for(auto it = o.begin(); it != o.end(); prev = it, ++it, ++i)
+    {
+        if(prev == o.end() || *prev != *it)
+            first = i;
+        if(o.nth(i) != it || o.index_of(it) != i || o.rank(*it) != first)
+            return false;
+        if(o.distance(o.begin(), it) != static_cast<std::ptrdiff_t>(i))
+            return false;
+    }
+    return o.nth(o.size()) == o.end() && o.index_of(o.end()) == o.size() &&
+           o.distance(o.begin(), o.end()) == static_cast<std::ptrdiff_t>(o.size());
+}
+
+// 随机插入与删除，和 std 的结果比较顺序统计
+static void test_ranked()
+{
+    ranked_multiset o;
+    std::multiset<int> s;
+    std::mt19937 rng(31);
+    for(int i = 1; i <= 6000; ++i)
+    {
+        const int v = static_cast<int>(rng() % 500);
+        switch(rng() % 4)
+        {
+        case 0:
+            EXPECT(o.erase(v) == s.erase(v));
+            break;
+        case 1:
+            if(!o.empty())
+            {
+                const size_t k = rng() % o.size();
+                auto st = s.begin();
+                std::advance(st, k);
+                EXPECT(*o.nth(k) == *st);
+                o.erase(o.nth(k));
+                s.erase(st);
+            }
+            break;
+        default:
+            o.insert(v);
+            s.insert(v);
+            break;
+        }
+        if(i % 500 == 0)
+            EXPECT(same(o, s) && ranks_ok(o));
+    }
+
+    ranked_set u;
+    std::set<int> su;
+    for(int i = 0; i < 2000; ++i)
+    {
+        const int v = static_cast<int>(rng() % 10000) * 2;
+        u.insert(v);
+        su.insert(v);
+    }
+    EXPECT(same(u, su) && ranks_ok(u));
+    // 不存在的键值的 rank 为 lower_bound 的下标
+    for(int key = -1; key < 20002; key += 37)
+        EXPECT(u.rank(key) == static_cast<size_t>(std::distance(su.begin(), su.lower_bound(key))));
+    EXPECT(u.distance(u.lower_bound(100), u.lower_bound(5000)) ==
+           std::distance(su.lower_bound(100), su.lower_bound(5000)));
+}
+
+// 不维护子树大小的树上只检查元素本身
+template <class Key, class Compare, class Alloc>
+static bool ranks_ok(const orange_stl::set<Key, Compare, Alloc, false>&)
+{
+    return true;
+}
+template <class Key, class Compare, class Alloc>
+static bool ranks_ok(const orange_stl::multiset<Key, Compare, Alloc, false>&)
+{
+    return true;
+}
+
+template <class OSet, class SSet>
+static OSet make(const SSet& s)
+{
+    OSet o;
+    for(int v : s)
+        o.insert(o.end(), v);
+    return o;
+}
+
+template <class SSet>
+static SSet below(const SSet& s, int key)
+{
+    return SSet(s.begin(), s.lower_bound(key));
+}
+
+template <class SSet>
+static SSet from(const SSet& s, int key)
+{
+    return SSet(s.lower_bound(key), s.end());
+}
+
+// split 与 join 互为逆操作：空树、全部在左、全部在右以及中间的切分点
+template <class OSet, class SSet>
+static void test_split_join(unsigned seed)
+{
+    OSet empty;
+    OSet r0 = empty.split(5);
+    EXPECT(empty.empty() && r0.empty());
+    empty.join(r0);
+    EXPECT(empty.empty());
+
+    std::mt19937 rng(seed);
+    OSet o;
+    SSet s;
+    for(int i = 0; i < 3000; ++i)
+    {
+        const int v = static_cast<int>(rng() % 2000);
+        o.insert(v);
+        s.insert(v);
+    }
+    const int keys[] = {-1, 0, 1, 1000, 1999, 2000, 5000};
+    for(int i = 0; i < 40; ++i)
+    {
+        const int key = i < 7 ? keys[i] : static_cast<int>(rng() % 2100) - 50;
+        OSet right = o.split(key);
+        EXPECT(same(o, below(s, key)));
+        EXPECT(same(right, from(s, key)));
+        EXPECT(ranks_ok(o) && ranks_ok(right));
+        o.join(right);
+        EXPECT(right.empty());
+        EXPECT(same(o, s));
+        EXPECT(ranks_ok(o));
+        // join 之后的树仍然可以正常插入与删除
+        const int v = static_cast<int>(rng() % 2000);
+        o.insert(v);
+        s.insert(v);
+        EXPECT(o.erase(key) == s.erase(key));
+    }
+    EXPECT(same(o, s) && ranks_ok(o));
+
+    // 大小悬殊的两棵树相接
+    OSet big = o.split(1000);
+    OSet small{3000, 3001};
+    big.join(small);
+    EXPECT(big.size() == from(s, 1000).size() + 2 && *big.rbegin() == 3001 && ranks_ok(big));
+    OSet tiny{-10};
+    tiny.join(o);
+    EXPECT(*tiny.begin() == -10 && tiny.size() == below(s, 1000).size() + 1 && ranks_ok(tiny));
+
+    // 区间取出
+    for(int i = 0; i < 20; ++i)
+    {
+        const int a = static_cast<int>(rng() % 2000) - 100;
+        const int b = a + static_cast<int>(rng() % 600);
+        OSet w = big;
+        OSet mid = w.extract_range(a, b);
+        SSet sw;
+        for(int v : big)
+            sw.insert(v);
+        SSet smid(sw.lower_bound(a), sw.lower_bound(b));
+        sw.erase(sw.lower_bound(a), sw.lower_bound(b));
+        EXPECT(same(mid, smid) && same(w, sw));
+        EXPECT(ranks_ok(mid) && ranks_ok(w));
+    }
+}
+
+// 集合运算与 std::set_* 比较，包括大小悬殊与互不相交的情形
+template <class OSet>
+static void test_set_ops()
+{
+    typedef std::set<int> SSet;
+    std::mt19937 rng(41);
+    const size_t sizes[][2] = {{0, 0}, {0, 100}, {100, 0}, {5000, 10}, {10, 5000}, {3000, 3000}, {1, 1}};
+    for(auto& sz : sizes)
+    {
+        for(int range = 50; range <= 20000; range *= 20)
+        {
+            SSet sa, sb;
+            for(size_t i = 0; i < sz[0]; ++i)
+                sa.insert(static_cast<int>(rng() % range));
+            for(size_t i = 0; i < sz[1]; ++i)
+                sb.insert(static_cast<int>(rng() % range));
+            SSet su, si, sd;
+            std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(), std::inserter(su, su.end()));
+            std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::inserter(si, si.end()));
+            std::set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(), std::inserter(sd, sd.end()));
+
+            const OSet a = make<OSet>(sa), b = make<OSet>(sb);
+            OSet u = a, ub = b;
+            u.union_with(ub);
+            EXPECT(same(u, su) && ub.empty() && ranks_ok(u));
+            OSet in = a, ib = b;
+            in.intersection_with(ib);
+            EXPECT(same(in, si) && ib.empty() && ranks_ok(in));
+            OSet d = a, db = b;
+            d.difference_with(db);
+            EXPECT(same(d, sd) && db.empty() && ranks_ok(d));
+        }
+    }
+
+    // 互不相交与完全在一侧
+    OSet lo{1, 2, 3}, hi{10, 11};
+    lo.union_with(hi);
+    EXPECT(lo.size() == 5 && *lo.rbegin() == 11 && ranks_ok(lo));
+    OSet x{1, 2, 3}, y{10, 11};
+    x.intersection_with(y);
+    EXPECT(x.empty());
+}
+
+// 键值相同时保留本容器的元素
+static void test_map_ops()
+{
+    typedef orange_stl::map<int, int, orange_stl::less<int>,
+                            orange_stl::allocator<orange_stl::pair<const int, int>>, true> ranked_map;
+    ranked_map a, b, c;
+    for(int k = 1; k <= 3; ++k)
+    {
+        a.emplace(k, 1);
+        b.emplace(k + 1, 2);
+    }
+    a.union_with(b);
+    EXPECT(a.size() == 4 && a[2] == 1 && a[3] == 1 && a[4] == 2);
+    EXPECT(a.nth(3)->first == 4 && a.rank(3) == 2);
+    c.emplace(2, 2);
+    c.emplace(4, 2);
+    a.intersection_with(c);
+    EXPECT(a.size() == 2 && a[2] == 1 && a[4] == 2);
+    ranked_map right = a.split(3);
+    EXPECT(a.size() == 1 && right.size() == 1 && right.begin()->first == 4);
+}
+
+// 只在需要时构造，失败时不移动参数
+struct counted
+{
+    static int constructed;
+    int v;
+
+    counted() : v(0) { ++constructed; }
+    counted(int x) : v(x) { ++constructed; }
+    counted(const counted& rhs) : v(rhs.v) { ++constructed; }
+    counted& operator=(const counted& rhs) { v = rhs.v; return *this; }
+};
+int counted::constructed = 0;
+
+template <class Map>
+static void test_upsert()
+{
+    Map m;
+    int calls = 0;
+    auto make = [&calls]() { ++calls; return counted(7); };
+    counted& a = m.get_or_insert_with(1, make);
+    EXPECT(a.v == 7 && calls == 1 && m.size() == 1);
+    a.v = 8;
+    counted::constructed = 0;
+    EXPECT(m.get_or_insert_with(1, make).v == 8 && calls == 1);
+    EXPECT(m[1].v == 8 && counted::constructed == 0);
+
+    // 键值已存在时 try_emplace 不构造元素，insert_or_assign 赋值
+    auto r = m.try_emplace(1, 9);
+    EXPECT(!r.second && r.first->second.v == 8 && counted::constructed == 0);
+    r = m.try_emplace(2, 9);
+    EXPECT(r.second && r.first->second.v == 9 && counted::constructed == 1);
+    r = m.insert_or_assign(2, counted(10));
+    EXPECT(!r.second && r.first->second.v == 10 && m.size() == 2);
+    r = m.insert_or_assign(3, counted(11));
+    EXPECT(r.second && m.at(3).v == 11 && m.size() == 3);
+    EXPECT(m[4].v == 0 && m.size() == 4);
+}
+
+// 右值键值在插入失败时保持不变
+template <class Map>
+static void test_upsert_keys()
+{
+    Map m;
+    typename Map::key_type k("a key long enough to live on the heap");
+    m.try_emplace(k, 1);
+    typename Map::key_type k2(k);
+    EXPECT(!m.try_emplace(orange_stl::move(k2), 2).second && k2 == k && m.at(k) == 1);
+    EXPECT(m.get_or_insert_with(orange_stl::move(k2), []() { return 3; }) == 1 && k2 == k);
+    EXPECT(!m.insert_or_assign(orange_stl::move(k2), 4).second && k2 == k && m.at(k) == 4);
+}
+
+// 统计构造次数的键值，异构查找不应构造临时的键值
+struct name
+{
+    static int made;
+    std::string s;
+
+    name(const char* p) : s(p) { ++made; }
+    name(const name& rhs) : s(rhs.s) { ++made; }
+};
+int name::made = 0;
+
+static bool operator<(const name& a, const name& b) { return a.s < b.s; }
+static bool operator<(const name& a, const char* b) { return a.s < b; }
+static bool operator<(const char* a, const name& b) { return a < b.s; }
+
+// less<void> 是透明的，可以直接用 C 风格字符串查找
+static void test_transparent()
+{
+    orange_stl::set<name, orange_stl::less<void>> s;
+    orange_stl::multiset<name, orange_stl::less<void>> ms;
+    const char* words[] = {"pear", "apple", "fig", "kiwi", "apple"};
+    for(const char* w : words)
+    {
+        s.insert(name(w));
+        ms.insert(name(w));
+    }
+    name::made = 0;
+    EXPECT(s.find("fig") != s.end() && s.find("fig")->s == "fig");
+    EXPECT(s.find("grape") == s.end() && s.count("apple") == 1 && ms.count("apple") == 2);
+    EXPECT(s.lower_bound("b")->s == "fig" && s.upper_bound("kiwi")->s == "pear");
+    EXPECT(s.upper_bound("pear") == s.end());
+    auto r = ms.equal_range("apple");
+    EXPECT(orange_stl::distance(r.first, r.second) == 2 && r.second->s == "fig");
+    EXPECT(name::made == 0);
+
+    // 不透明的比较函数只能先构造键值
+    orange_stl::set<name> plain;
+    plain.insert(name("fig"));
+    name::made = 0;
+    EXPECT(plain.count("fig") == 1 && name::made == 1);
+
+    orange_stl::map<orange_stl::string, int, orange_stl::less<void>> m;
+    m["alpha"] = 1;
+    m["beta"] = 2;
+    EXPECT(m.find("beta")->second == 2 && m.count("gamma") == 0);
+    EXPECT(m.lower_bound("b")->first == "beta" && m.upper_bound("alpha")->first == "beta");
+}
+
+int main()
+{
+    test_set_assign();
+    test_range_insert();
+    test_ranked();
+    test_split_join<ranked_set, std::set<int>>(1);
+    test_split_join<ranked_multiset, std::multiset<int>>(2);
+    test_split_join<orange_stl::set<int>, std::set<int>>(3);
+    test_split_join<orange_stl::multiset<int>, std::multiset<int>>(4);
+    test_set_ops<ranked_set>();
+    test_set_ops<orange_stl::set<int>>();
+    test_map_ops();
+    test_upsert<orange_stl::map<int, counted>>();
+    test_upsert_keys<orange_stl::map<orange_stl::string, int>>();
+    test_transparent();
+    return 0;
+}
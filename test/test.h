@@ -0,0 +1,56 @@
+#ifndef __ORANGE_TEST_H__
+#define __ORANGE_TEST_H__
+
+// 测试与基准程序共用的检查宏和计时器
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#define EXPECT(expr)                                                              \
+    do                                                                            \
+    {                                                                             \
+        if(!(expr))                                                               \
+        {                                                                         \
+            std::fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #expr); \
+            std::exit(1);                                                         \
+        }                                                                         \
+    } while(0)
+
+namespace orange_test
+{
+
+// 以毫秒计时
+class timer
+{
+public:
+    timer() : start_(std::chrono::steady_clock::now()) {}
+
+    double elapsed_ms() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 防止被测结果被编译器优化掉
+template <class T>
+struct sink
+{
+    static const volatile T* volatile ptr;
+};
+
+template <class T>
+const volatile T* volatile sink<T>::ptr = nullptr;
+
+template <class T>
+void do_not_optimize(const T& value)
+{
+    sink<T>::ptr = &value;
+}
+
+} // namespace orange_test
+
+#endif // !__ORANGE_TEST_H__
@@ -0,0 +1,397 @@
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "orange_astring.h"
+#include "orange_unordered_map.h"
+#include "orange_unordered_set.h"
+#include "test.h"
+
+// 显式实例化全部成员，保证四个容器的每个成员函数都能编译
+template class orange_stl::unordered_map<int, int>;
+template class orange_stl::unordered_multimap<int, int>;
+template class orange_stl::unordered_set<int>;
+template class orange_stl::unordered_multiset<int>;
+
+static void test_multi()
+{
+    orange_stl::unordered_multimap<int, int> mm{{1, 10}, {2, 20}, {1, 11}};
+    mm.insert(orange_stl::make_pair(3, 30));
+    mm.emplace(1, 12);
+    EXPECT(mm.size() == 5);
+    EXPECT(mm.count(1) == 3);
+    auto range = mm.equal_range(1);
+    int sum = 0;
+    for(auto it = range.first; it != range.second; ++it)
+        sum += it->second;
+    EXPECT(sum == 33);
+    EXPECT(mm.erase(1) == 3 && mm.size() == 2);
+
+    orange_stl::unordered_multiset<int> ms{5, 5, 6};
+    ms.insert(5);
+    EXPECT(ms.count(5) == 3 && ms.size() == 4);
+
+    std::vector<int> keys{5, 7, 6};
+    std::vector<orange_stl::unordered_multiset<int>::iterator> found(keys.size());
+    ms.find_batch(keys.begin(), keys.end(), found.begin());
+    EXPECT(found[0] != ms.end() && *found[0] == 5);
+    EXPECT(found[1] == ms.end());
+    EXPECT(found[2] != ms.end() && *found[2] == 6);
+
+    orange_stl::unordered_multiset<int> copy(ms);
+    EXPECT(copy == ms);
+}
+
+// 遍历恰好访问每个元素一次，且与 model 一致
+template <class Map>
+static bool visits_once(const Map& m, const std::map<int, int>& model)
+{
+    std::vector<char> seen(1 << 18, 0);
+    size_t n = 0;
+    for(auto it = m.begin(); it != m.end(); ++it, ++n)
+    {
+        if(seen[it->first] || model.count(it->first) == 0 || model.at(it->first) != it->second)
+            return false;
+        seen[it->first] = 1;
+    }
+    return n == model.size() && m.size() == model.size();
+}
+
+// 迁移进行中交替插入、删除与查找
+static void test_incremental_rehash()
+{
+    orange_stl::unordered_map<int, int> m;
+    m.incremental_rehash(true);
+    EXPECT(m.incremental_rehash() && !m.rehashing());
+    std::map<int, int> model;
+    std::mt19937 rng(5);
+    int migrations = 0;
+    for(int i = 0; i < 40000; ++i)
+    {
+        const int key = static_cast<int>(rng() % 30000);
+        const bool was_rehashing = m.rehashing();
+        switch(rng() % 5)
+        {
+        case 0:
+            EXPECT(m.erase(key) == model.erase(key));
+            break;
+        case 1:
+        {
+            auto it = m.find(key);
+            EXPECT((it == m.end()) == (model.count(key) == 0));
+            if(it != m.end())
+                EXPECT(it->second == model[key]);
+            const auto& cm = m;
+            EXPECT(cm.count(key) == model.count(key));
+            break;
+        }
+        default:
+            EXPECT(m.emplace(key, i).second == model.emplace(key, i).second);
+            break;
+        }
+        if(!was_rehashing && m.rehashing())
+            ++migrations;
+        if(m.rehashing() && i % 97 == 0)
+            EXPECT(visits_once(m, model));
+    }
+    EXPECT(migrations > 3);
+    EXPECT(visits_once(m, model));
+
+    // 迁移中途的 rehash 一次完成剩余的迁移
+    while(!m.rehashing())
+    {
+        const int key = static_cast<int>(model.size()) + 40000;
+        m.emplace(key, key);
+        model.emplace(key, key);
+    }
+    const size_t target = m.bucket_count() * 2;
+    m.rehash(target);
+    EXPECT(!m.rehashing() && m.bucket_count() >= target);
+    EXPECT(visits_once(m, model));
+
+    // 逐步迁移直到完成，关闭该模式时也会完成迁移
+    while(!m.rehashing())
+    {
+        const int key = static_cast<int>(model.size()) + 40000;
+        m.emplace(key, key);
+        model.emplace(key, key);
+    }
+    while(m.rehash_step(2048))
+        EXPECT(m.rehashing() && visits_once(m, model));
+    EXPECT(!m.rehashing() && visits_once(m, model));
+    while(!m.rehashing())
+    {
+        const int key = static_cast<int>(model.size()) + 40000;
+        m.emplace(key, key);
+        model.emplace(key, key);
+    }
+    m.incremental_rehash(false);
+    EXPECT(!m.rehashing() && visits_once(m, model));
+
+    // 重复键值在迁移中仍然相邻
+    orange_stl::unordered_multiset<int> ms;
+    ms.incremental_rehash(true);
+    for(int i = 0; i < 5000; ++i)
+    {
+        ms.insert(i % 700);
+        if(ms.rehashing())
+        {
+            const int k = static_cast<int>(rng() % 700);
+            const size_t expect = k <= i % 700 ? static_cast<size_t>(i / 700 + 1) : static_cast<size_t>(i / 700);
+            auto r = ms.equal_range(k);
+            size_t n = 0;
+            for(auto it = r.first; it != r.second; ++it, ++n)
+                EXPECT(*it == k);
+            EXPECT(n == expect && ms.count(k) == expect);
+        }
+    }
+}
+
+typedef orange_stl::unordered_map<int, int, orange_stl::hash<int>, orange_stl::equal_to<int>,
+                                  orange_stl::allocator<orange_stl::pair<const int, int>>,
+                                  orange_stl::power2_bucket_policy> power2_map;
+
+// 2 的幂个桶：桶个数始终是 2 的幂，元素都在自己的桶中，有规律的键值也能打散
+static void test_power2_policy()
+{
+    power2_map m;
+    std::map<int, int> model;
+    for(int i = 0; i < 20000; ++i)
+    {
+        // 步长为 1024 的键值取低位会全部落在同一个桶
+        const int key = (i % 2 == 0) ? i * 1024 : i;
+        m.emplace(key, i);
+        model.emplace(key, i);
+        const size_t bc = m.bucket_count();
+        EXPECT(bc >= 8 && (bc & (bc - 1)) == 0);
+    }
+    EXPECT(m.load_factor() <= m.max_load_factor());
+    size_t n = 0;
+    for(auto it = m.begin(); it != m.end(); ++it)
+        ++n;
+    EXPECT(n == model.size() && m.size() == model.size());
+    size_t longest = 0;
+    for(size_t b = 0; b < m.bucket_count(); ++b)
+    {
+        longest = orange_stl::max(longest, m.bucket_size(b));
+        for(auto it = m.begin(b); it != m.end(b); ++it)
+            EXPECT(m.bucket(it->first) == b);
+    }
+    EXPECT(longest <= 12);
+    for(auto& kv : model)
+        EXPECT(m.at(kv.first) == kv.second);
+
+    m.rehash(100000);
+    EXPECT(m.bucket_count() == 131072);
+    m.reserve(10);
+    EXPECT(m.bucket_count() == 131072);
+    for(auto& kv : model)
+        EXPECT(m.find(kv.first) != m.end() && m.count(kv.first + 1024 * 40000) == 0);
+    power2_map small;
+    EXPECT(small.find(0) == small.end());
+    small.rehash(9);
+    EXPECT(small.bucket_count() == 16);
+}
+
+static int g_hash_calls = 0;
+static int g_equal_calls = 0;
+
+// 不是 is_fast_hash，节点中缓存哈希值
+struct counting_hash
+{
+    size_t operator()(int key) const
+    {
+        ++g_hash_calls;
+        return orange_stl::hash<int>()(key);
+    }
+};
+
+// 声明为便宜的哈希函数，节点中不缓存哈希值
+struct fast_counting_hash : counting_hash {};
+
+struct counting_equal
+{
+    bool operator()(int a, int b) const
+    {
+        ++g_equal_calls;
+        return a == b;
+    }
+};
+
+// 所有键值的哈希值都相同，缓存的哈希值无法区分，只能依靠 key_equal
+struct constant_hash
+{
+    size_t operator()(int) const { return 42; }
+};
+
+namespace orange_stl
+{
+template <>
+struct is_fast_hash<fast_counting_hash> : m_true_type {};
+}
+
+static void test_cached_hash()
+{
+    typedef orange_stl::unordered_map<int, int, counting_hash, counting_equal> cached_map;
+    cached_map m;
+    for(int i = 0; i < 10000; ++i)
+        m.emplace(i, i);
+
+    // rehash 使用缓存的哈希值，不再调用哈希函数
+    g_hash_calls = 0;
+    m.rehash(m.bucket_count() * 4);
+    EXPECT(g_hash_calls == 0);
+
+    // 不命中时哈希值不同，不调用 key_equal；命中时恰好调用一次
+    g_hash_calls = g_equal_calls = 0;
+    for(int i = 10000; i < 20000; ++i)
+        EXPECT(m.find(i) == m.end());
+    EXPECT(g_hash_calls == 10000 && g_equal_calls == 0);
+    g_equal_calls = 0;
+    for(int i = 0; i < 10000; ++i)
+        EXPECT(m.find(i)->second == i);
+    EXPECT(g_equal_calls == 10000);
+
+    // 不缓存时 rehash 需要重新计算每个元素的哈希值
+    orange_stl::unordered_map<int, int, fast_counting_hash, counting_equal> f;
+    for(int i = 0; i < 1000; ++i)
+        f.emplace(i, i);
+    g_hash_calls = 0;
+    f.rehash(f.bucket_count() * 4);
+    EXPECT(g_hash_calls >= 1000);
+    for(int i = 0; i < 1000; ++i)
+        EXPECT(f.at(i) == i);
+
+    // 哈希值全部相同时仍然正确，相等的元素在 rehash 之后保持相邻
+    orange_stl::unordered_multiset<int, constant_hash> c;
+    for(int i = 0; i < 300; ++i)
+        c.insert(i % 100);
+    c.rehash(c.bucket_count() * 8);
+    for(int k = 0; k < 100; ++k)
+    {
+        auto r = c.equal_range(k);
+        size_t n = 0;
+        for(auto it = r.first; it != r.second; ++it, ++n)
+            EXPECT(*it == k);
+        EXPECT(n == 3);
+    }
+    EXPECT(c.count(100) == 0 && c.find(-1) == c.end());
+    EXPECT(c.erase(7) == 3 && c.size() == 297);
+}
+
+// 只在需要时构造，失败时不移动参数
+struct counted
+{
+    static int constructed;
+    int v;
+
+    counted() : v(0) { ++constructed; }
+    counted(int x) : v(x) { ++constructed; }
+    counted(const counted& rhs) : v(rhs.v) { ++constructed; }
+    counted& operator=(const counted& rhs) { v = rhs.v; return *this; }
+};
+int counted::constructed = 0;
+
+template <class Map>
+static void test_upsert()
+{
+    Map m;
+    int calls = 0;
+    auto make = [&calls]() { ++calls; return counted(7); };
+    counted& a = m.get_or_insert_with(1, make);
+    EXPECT(a.v == 7 && calls == 1 && m.size() == 1);
+    a.v = 8;
+    counted::constructed = 0;
+    EXPECT(m.get_or_insert_with(1, make).v == 8 && calls == 1);
+    EXPECT(m[1].v == 8 && counted::constructed == 0);
+
+    // 键值已存在时 try_emplace 不构造元素，insert_or_assign 赋值
+    auto r = m.try_emplace(1, 9);
+    EXPECT(!r.second && r.first->second.v == 8 && counted::constructed == 0);
+    r = m.try_emplace(2, 9);
+    EXPECT(r.second && r.first->second.v == 9 && counted::constructed == 1);
+    r = m.insert_or_assign(2, counted(10));
+    EXPECT(!r.second && r.first->second.v == 10 && m.size() == 2);
+    r = m.insert_or_assign(3, counted(11));
+    EXPECT(r.second && m.at(3).v == 11 && m.size() == 3);
+    EXPECT(m[4].v == 0 && m.size() == 4);
+}
+
+// 右值键值在插入失败时保持不变
+template <class Map>
+static void test_upsert_keys()
+{
+    Map m;
+    typename Map::key_type k("a key long enough to live on the heap");
+    m.try_emplace(k, 1);
+    typename Map::key_type k2(k);
+    EXPECT(!m.try_emplace(orange_stl::move(k2), 2).second && k2 == k && m.at(k) == 1);
+    EXPECT(m.get_or_insert_with(orange_stl::move(k2), []() { return 3; }) == 1 && k2 == k);
+    EXPECT(!m.insert_or_assign(orange_stl::move(k2), 4).second && k2 == k && m.at(k) == 4);
+}
+
+// 统计构造次数的键值，异构查找不应构造临时的键值
+struct name
+{
+    static int made;
+    std::string s;
+
+    name(const char* p) : s(p) { ++made; }
+    name(const name& rhs) : s(rhs.s) { ++made; }
+};
+int name::made = 0;
+
+static bool operator==(const name& a, const name& b) { return a.s == b.s; }
+static bool operator==(const name& a, const char* b) { return a.s == b; }
+
+struct name_hash
+{
+    typedef int is_transparent;
+    size_t operator()(const name& n) const { return orange_stl::hash_bytes(n.s.data(), n.s.size()); }
+    size_t operator()(const char* p) const { return orange_stl::hash_bytes(p, std::strlen(p)); }
+};
+
+// 哈希函数与 equal_to<void> 都是透明的，可以直接用 C 风格字符串查找
+static void test_transparent()
+{
+    orange_stl::unordered_map<name, int, name_hash, orange_stl::equal_to<void>> m;
+    orange_stl::unordered_multiset<name, name_hash, orange_stl::equal_to<void>> ms;
+    const char* words[] = {"pear", "apple", "fig", "kiwi", "apple"};
+    for(int i = 0; i < 5; ++i)
+    {
+        m.emplace(name(words[i]), i);
+        ms.insert(name(words[i]));
+    }
+    name::made = 0;
+    EXPECT(m.find("fig") != m.end() && m.find("fig")->second == 2);
+    EXPECT(m.find("grape") == m.end() && m.count("apple") == 1 && m.find("apple")->second == 1);
+    EXPECT(ms.count("apple") == 2 && ms.count("plum") == 0);
+    auto r = ms.equal_range("apple");
+    EXPECT(orange_stl::distance(r.first, r.second) == 2 && r.first->s == "apple");
+    EXPECT(name::made == 0);
+
+    // 不透明的哈希函数只能先构造键值
+    orange_stl::unordered_set<name, name_hash> plain;
+    plain.insert(name("fig"));
+    name::made = 0;
+    EXPECT(plain.count("fig") == 1 && name::made == 1);
+
+    orange_stl::unordered_map<orange_stl::string, int, orange_stl::hash<orange_stl::string>,
+                              orange_stl::equal_to<void>> sm;
+    sm["alpha"] = 1;
+    EXPECT(sm.find("alpha")->second == 1 && sm.count("beta") == 0);
+}
+
+int main()
+{
+    test_multi();
+    test_incremental_rehash();
+    test_power2_policy();
+    test_cached_hash();
+    test_upsert<orange_stl::unordered_map<int, counted>>();
+    test_upsert_keys<orange_stl::unordered_map<orange_stl::string, int>>();
+    test_transparent();
+    return 0;
+}
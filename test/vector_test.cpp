@@ -0,0 +1,43 @@
+#include <string>
+
+#include "orange_vector.h"
+#include "test.h"
+
+int main()
+{
+    // 容量足够时在中间 emplace
+    orange_stl::vector<int> v;
+    v.reserve(16);
+    v.emplace(v.begin(), 5);
+    v.emplace(v.begin(), 3);
+    v.emplace(v.begin() + 1, 4);
+    v.emplace(v.end(), 7);
+    EXPECT(v.size() == 4);
+    EXPECT(v[0] == 3 && v[1] == 4 && v[2] == 5 && v[3] == 7);
+
+    // 参数引用容器中的元素，移动其他元素之前就要构造好新元素
+    orange_stl::vector<std::string> s;
+    s.reserve(8);
+    s.push_back("a");
+    s.push_back("b");
+    s.push_back("c");
+    s.emplace(s.begin(), s.back());
+    EXPECT(s.size() == 4 && s[0] == "c" && s[1] == "a" && s[3] == "c");
+    s.emplace(s.begin() + 1, s[2]);
+    EXPECT(s.size() == 5 && s[1] == "b" && s[2] == "a" && s[3] == "b");
+    s.insert(s.begin(), s[4]);
+    EXPECT(s.size() == 6 && s[0] == "c" && s[1] == "c");
+
+    // 容量不足时重新配置
+    orange_stl::vector<std::string> r(2, "x");
+    r.shrink_to_fit();
+    r.emplace(r.begin() + 1, 3, 'y');
+    EXPECT(r.size() == 3 && r[1] == "yyy" && r[2] == "x");
+
+    // 删除空区间不改变任何元素
+    orange_stl::vector<std::string> e{"hello", "world"};
+    EXPECT(e.erase(e.begin(), e.begin()) == e.begin());
+    e.erase(e.begin() + 1, e.begin() + 1);
+    EXPECT(e.size() == 2 && e[0] == "hello" && e[1] == "world");
+    return 0;
+}